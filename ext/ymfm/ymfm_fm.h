@@ -190,6 +190,10 @@ public:
 	// master clocking function
 	void clock(uint32_t env_counter, int32_t lfo_raw_pm);
 
+	// true if the envelope has fully released, so clocking the operator
+	// has no audible effect until the next key on
+	bool settled() const { return (m_env_state == EG_RELEASE && m_env_attenuation == 0x3ff && !m_ssg_inverted); }
+
 	// return the current phase value
 	uint32_t phase() const { return m_phase >> 10; }
 
@@ -372,6 +376,14 @@ public:
 	// master clocking function
 	uint32_t clock(uint32_t chanmask);
 
+	// true if every operator has settled and no register was modified since
+	// the last prepare, meaning the output stays zero until the next write
+	bool idle() const;
+
+	// equivalent of calling clock(ALL_CHANNELS) 'samples' times while idle();
+	// advances the global counters, noise and LFO but skips the operators
+	void clock_idle(uint32_t samples);
+
 	// compute sum of channel outputs
 	void output(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const;
 
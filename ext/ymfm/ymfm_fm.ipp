@@ -1321,6 +1321,52 @@ uint32_t fm_engine_base<RegisterType>::clock(uint32_t chanmask)
 }
 
 
+//-------------------------------------------------
+//  idle - return true if no channel can produce
+//  output until a register is written
+//-------------------------------------------------
+
+template<class RegisterType>
+bool fm_engine_base<RegisterType>::idle() const
+{
+	if (m_active_channels != 0 || m_modified_channels != 0)
+		return false;
+
+	for (uint32_t opnum = 0; opnum < OPERATORS; opnum++)
+		if (m_operator[opnum] != nullptr && !m_operator[opnum]->settled())
+			return false;
+
+	return true;
+}
+
+
+//-------------------------------------------------
+//  clock_idle - clock the engine forward while
+//  idle, leaving out the operator pipeline
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_engine_base<RegisterType>::clock_idle(uint32_t samples)
+{
+	// settled operators only advance their phase, which is reset on the
+	// next key on, and channel feedback was already shifted out when they
+	// went inactive; the periodic prepare sweep finds nothing to do
+	for (uint32_t samp = 0; samp < samples; samp++)
+	{
+		m_total_clocks++;
+		if (m_prepare_count++ >= 4096)
+			m_prepare_count = 0;
+
+		if (RegisterType::EG_CLOCK_DIVIDER == 1)
+			m_env_counter += 4;
+		else if (bitfield(++m_env_counter, 0, 2) == RegisterType::EG_CLOCK_DIVIDER)
+			m_env_counter += 4 - RegisterType::EG_CLOCK_DIVIDER;
+
+		m_regs.clock_noise_and_lfo();
+	}
+}
+
+
 //-------------------------------------------------
 //  output - compute a sum over the relevant
 //  channels
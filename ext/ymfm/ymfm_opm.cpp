@@ -522,6 +522,16 @@ void ym2151::write(uint32_t offset, uint8_t data)
 
 void ym2151::generate(output_data *output, uint32_t numsamples)
 {
+	// with all operators released the output is silent until the next
+	// register write, which can't happen within a block
+	if (idle())
+	{
+		generate_idle(numsamples);
+		for (uint32_t samp = 0; samp < numsamples; samp++)
+			output[samp].clear();
+		return;
+	}
+
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
 		// clock the system
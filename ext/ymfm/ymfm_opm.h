@@ -281,6 +281,12 @@ public:
 	// generate one sample of sound
 	void generate(output_data *output, uint32_t numsamples = 1);
 
+	// true if the output stays silent until the next register write
+	bool idle() const { return m_fm.idle(); }
+
+	// advance the chip by numsamples of silence; only valid while idle()
+	void generate_idle(uint32_t numsamples) { m_fm.clock_idle(numsamples); }
+
 protected:
 	// variants
 	enum opm_variant
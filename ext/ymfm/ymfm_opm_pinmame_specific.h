@@ -15,7 +15,10 @@ extern "C" uint8_t ymfm_ym2151_read(void* obj, uint32_t offset);
 
 extern "C" void ymfm_ym2151_write(void* obj, uint32_t offset, uint8_t data);
 
-extern "C" void ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples);
+extern "C" int ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples);
+
+extern "C" int ymfm_ym2151_save_state(void* obj, uint8_t* data, int size);
+extern "C" void ymfm_ym2151_load_state(void* obj, const uint8_t* data, int size);
 
 // classes
 
@@ -57,6 +60,16 @@ public:
 
 	void timercallback(int param) { m_engine->engine_timer_expired(param); }
 
+	// time left on a timer, negative if it is not running
+	double timer_left(int tnum) const { return m_timer[tnum]->enabled ? timer_timeleft(m_timer[tnum]) : -1.; }
+	void set_timer_left(int tnum, double left)
+	{
+		if (left >= 0.)
+			timer_adjust(m_timer[tnum], left, tnum, TIME_NEVER);
+		else
+			timer_enable(m_timer[tnum], 0);
+	}
+
 private:
 	void(*irqhandler)(int irq);		/* IRQ function handler */
 	mem_write_handler porthandler;	/* port write function handler */
@@ -104,8 +117,58 @@ uint8_t ymfm_ym2151_read(void* obj, uint32_t offset) { return ((ymfm_ym2151*)obj
 
 void ymfm_ym2151_write(void* obj, uint32_t offset, uint8_t data) { ((ymfm_ym2151*)obj)->chip->write(offset,data); }
 
-void ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples)
+// save states: the ymfm chip state followed by the time left on both timers,
+// which live outside of the chip. Returns the size of the state, data is only
+// written if it fits into 'size' bytes
+int ymfm_ym2151_save_state(void* obj, uint8_t* data, int size)
 {
+	ymfm_ym2151* const ym = (ymfm_ym2151*)obj;
+	std::vector<uint8_t> buffer;
+	ymfm::ymfm_saved_state state(buffer, true);
+	ym->chip->save_restore(state);
+
+	double left[2] = { ym->intf.timer_left(0), ym->intf.timer_left(1) };
+	const int total = (int)(buffer.size() + sizeof(left));
+	if (data && size >= total)
+	{
+		memcpy(data, buffer.data(), buffer.size());
+		memcpy(data + buffer.size(), left, sizeof(left));
+	}
+	return total;
+}
+
+void ymfm_ym2151_load_state(void* obj, const uint8_t* data, int size)
+{
+	ymfm_ym2151* const ym = (ymfm_ym2151*)obj;
+	double left[2];
+	if (size < (int)sizeof(left))
+		return;
+
+	std::vector<uint8_t> buffer(data, data + size - sizeof(left));
+	ymfm::ymfm_saved_state state(buffer, false);
+	ym->chip->save_restore(state);
+
+	memcpy(left, data + buffer.size(), sizeof(left));
+	ym->intf.set_timer_left(0, left[0]);
+	ym->intf.set_timer_left(1, left[1]);
+}
+
+// returns 1 if the chip was idle, i.e. the block was rendered as silence
+// without running the operators
+int ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples)
+{
+	ymfm::ym2151* const chip = ((ymfm_ym2151*)obj)->chip;
+
+	// nothing can sound until the next register write, so the chip only has
+	// to advance its counters and the conversion can be skipped as well
+	if (chip->idle())
+	{
+		chip->generate_idle(numsamples);
+		memset(output[0], 0, numsamples * sizeof(int16_t));
+		memset(output[1], 0, numsamples * sizeof(int16_t));
+		return 1;
+	}
+
 #if 0 // allocate mem
 	ymfm::ym2151::output_data* const __restrict o = new ymfm::ym2151::output_data[numsamples];
 	((ymfm_ym2151*)obj)->chip->generate(o, numsamples);
@@ -131,4 +194,5 @@ void ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples)
 		}
 	}
 #endif
+	return 0;
 }
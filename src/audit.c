@@ -304,6 +304,9 @@ int AuditRomSet (int game, tAuditRecord **audit)
 			}
 		}
 
+	/* remember the hashes computed for the verification cache */
+	mame_fverify_cache_flush();
+
         #ifdef MESS
         if (!count)
                 return -1;
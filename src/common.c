@@ -10,9 +10,18 @@
 #include "png.h"
 #include "harddisk.h"
 #include "artwork.h"
+#include "workpool.h"
 #include <stdarg.h>
 #include <ctype.h>
 
+#if (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || defined(__x86_64__)
+ #include <emmintrin.h>
+ #define SSE_ROMLOAD_OPT
+#elif (defined(_M_ARM) || defined(_M_ARM64) || defined(__arm__) || defined(__arm64__) || defined(__aarch64__)) && (!defined(__ARM_ARCH) || __ARM_ARCH >= 7) && (!defined(_MSC_VER) || defined(__clang__)) //!! disable sse2neon if MSVC&non-clang
+ #include "../ext/sse2neon.h"
+ #define SSE_ROMLOAD_OPT // uses sse2neon then
+#endif
+
 
 //#define LOG_LOAD
 
@@ -48,6 +57,25 @@ struct malloc_info
 	void *ptr;
 };
 
+/* one ROM_REGION of the load plan; every region is loaded on its own
+   rom_load_data so that independent regions can be read on different threads */
+struct rom_load_task
+{
+	const struct RomModule *region;	/* region header */
+	int deferred;					/* load on the main thread, after the others */
+	int result;						/* process_rom_entries() result */
+	int numfiles;					/* entries in data.files */
+	struct rom_load_data data;		/* per-region counts, messages and buffers */
+};
+
+/* a region to byte swap / invert after loading */
+struct rom_post_process
+{
+	UINT8 *base;
+	UINT32 length;
+	const struct RomModule *region;
+};
+
 
 
 /***************************************************************************
@@ -1272,12 +1300,121 @@ static int display_rom_load_results(struct rom_load_data *romdata)
 }
 
 
+/*-------------------------------------------------
+	rom_swap16 / rom_swap32 / rom_invert - bulk
+	byte swapping and inverting of ROM data
+-------------------------------------------------*/
+
+static void rom_swap16(UINT8 *dst, const UINT8 *src, UINT32 length)
+{
+	UINT32 i = 0;
+#ifdef SSE_ROMLOAD_OPT
+	for (; i + 16 <= length; i += 16)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+	}
+#endif
+	for (; i + 2 <= length; i += 2)
+	{
+		const UINT8 temp = src[i];
+		dst[i] = src[i + 1];
+		dst[i + 1] = temp;
+	}
+}
+
+static void rom_swap32(UINT8 *base, UINT32 length)
+{
+	UINT32 i = 0;
+#ifdef SSE_ROMLOAD_OPT
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i *)(base + i));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128((__m128i *)(base + i), v);
+	}
+#endif
+	for (; i + 4 <= length; i += 4)
+	{
+		UINT8 temp = base[i];
+		base[i] = base[i + 3];
+		base[i + 3] = temp;
+		temp = base[i + 1];
+		base[i + 1] = base[i + 2];
+		base[i + 2] = temp;
+	}
+}
+
+static void rom_invert(UINT8 *base, UINT32 length)
+{
+	UINT32 i = 0;
+#ifdef SSE_ROMLOAD_OPT
+	const __m128i ones = _mm_set1_epi8((char)0xff);
+	for (; i + 16 <= length; i += 16)
+		_mm_storeu_si128((__m128i *)(base + i), _mm_xor_si128(_mm_loadu_si128((const __m128i *)(base + i)), ones));
+#endif
+	for (; i < length; i++)
+		base[i] ^= 0xff;
+}
+
+
+#ifdef SSE_ROMLOAD_OPT
+/*-------------------------------------------------
+	rom_spread_bytes - store bytes to every 2nd or
+	4th byte of the destination (ROM_LOAD16_BYTE,
+	ROM_LOAD32_BYTE), keeping the bytes in between;
+	returns the number of bytes handled
+-------------------------------------------------*/
+
+static int rom_spread_bytes(UINT8 *dst, const UINT8 *src, int count, int step)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int i;
+
+	/* each block also touches the step-1 bytes after its last byte, so
+	   stop while there is still a byte to store beyond the block */
+	if (step == 2)
+	{
+		const __m128i keep = _mm_set1_epi16((short)0xff00);
+		for (i = 0; i + 16 < count; i += 16, src += 16, dst += 32)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i *)src);
+			const __m128i d0 = _mm_loadu_si128((const __m128i *)dst);
+			const __m128i d1 = _mm_loadu_si128((const __m128i *)(dst + 16));
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(d0, keep), _mm_unpacklo_epi8(v, zero)));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_and_si128(d1, keep), _mm_unpackhi_epi8(v, zero)));
+		}
+	}
+	else
+	{
+		const __m128i keep = _mm_set1_epi32((int)0xffffff00);
+		for (i = 0; i + 16 < count; i += 16, src += 16, dst += 64)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i *)src);
+			const __m128i lo = _mm_unpacklo_epi8(v, zero);
+			const __m128i hi = _mm_unpackhi_epi8(v, zero);
+			const __m128i d0 = _mm_loadu_si128((const __m128i *)dst);
+			const __m128i d1 = _mm_loadu_si128((const __m128i *)(dst + 16));
+			const __m128i d2 = _mm_loadu_si128((const __m128i *)(dst + 32));
+			const __m128i d3 = _mm_loadu_si128((const __m128i *)(dst + 48));
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_and_si128(d0, keep), _mm_unpacklo_epi16(lo, zero)));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_and_si128(d1, keep), _mm_unpackhi_epi16(lo, zero)));
+			_mm_storeu_si128((__m128i *)(dst + 32), _mm_or_si128(_mm_and_si128(d2, keep), _mm_unpacklo_epi16(hi, zero)));
+			_mm_storeu_si128((__m128i *)(dst + 48), _mm_or_si128(_mm_and_si128(d3, keep), _mm_unpackhi_epi16(hi, zero)));
+		}
+	}
+	return i;
+}
+#endif
+
+
 /*-------------------------------------------------
 	region_post_process - post-process a region,
 	byte swapping and inverting data as necessary
 -------------------------------------------------*/
 
-static void region_post_process(struct rom_load_data *romdata, const struct RomModule *regiondata)
+static void region_post_process(UINT8 *regionbase, UINT32 regionlength, const struct RomModule *regiondata)
 {
 	int type = ROMREGION_GETTYPE(regiondata);
 	int datawidth = ROMREGION_GETWIDTH(regiondata) / 8;
@@ -1301,10 +1438,8 @@ static void region_post_process(struct rom_load_data *romdata, const struct RomM
 	/* if the region is inverted, do that now */
 	if (ROMREGION_ISINVERTED(regiondata))
 	{
-		int i;
 		debugload("+ Inverting region\n");
-		for (i = 0, base = romdata->regionbase; i < romdata->regionlength; i++)
-			*base++ ^= 0xff;
+		rom_invert(regionbase, regionlength);
 	}
 
 	/* swap the endianness if we need to */
@@ -1314,20 +1449,37 @@ static void region_post_process(struct rom_load_data *romdata, const struct RomM
 	if (datawidth > 1 && littleendian)
 #endif
 	{
-		int i;
+		UINT32 i;
 		debugload("+ Byte swapping region\n");
-		for (i = 0, base = romdata->regionbase; i < romdata->regionlength; i += datawidth)
-		{
-			UINT8 temp[8];
-			int j;
-			memcpy(temp, base, datawidth);
-			for (j = datawidth - 1; j >= 0; j--)
-				*base++ = temp[j];
-		}
+		if (datawidth == 2)
+			rom_swap16(regionbase, regionbase, regionlength);
+		else if (datawidth == 4)
+			rom_swap32(regionbase, regionlength);
+		else
+			for (i = 0, base = regionbase; i < regionlength; i += datawidth)
+			{
+				UINT8 temp[8];
+				int j;
+				memcpy(temp, base, datawidth);
+				for (j = datawidth - 1; j >= 0; j--)
+					*base++ = temp[j];
+			}
 	}
 }
 
 
+/*-------------------------------------------------
+	region_post_process_job - workpool job for
+	region_post_process
+-------------------------------------------------*/
+
+static void region_post_process_job(void *param, int index)
+{
+	const struct rom_post_process *post = (const struct rom_post_process *)param + index;
+	region_post_process(post->base, post->length, post->region);
+}
+
+
 /*-------------------------------------------------
 	open_rom_file - open a ROM file, searching
 	up the parent and loading by checksum
@@ -1418,6 +1570,14 @@ static int read_rom_data(struct rom_load_data *romdata, const struct RomModule *
 	if (datamask == 0xff && (groupsize == 1 || !reversed) && skip == 0)
 		return rom_fread(romdata, base, numbytes);
 
+	/* byte swapped 16-bit loads (ROM_LOAD16_WORD_SWAP) are read in place and swapped */
+	if (datamask == 0xff && groupsize == 2 && reversed && skip == 0)
+	{
+		int actual = rom_fread(romdata, base, numbytes);
+		rom_swap16(base, base, (UINT32)actual);
+		return actual;
+	}
+
 	/* chunky reads for complex loads */
 	skip += groupsize;
 	while (numbytes)
@@ -1439,8 +1599,19 @@ static int read_rom_data(struct rom_load_data *romdata, const struct RomModule *
 		{
 			/* non-grouped data */
 			if (groupsize == 1)
-				for (i = 0; i < bytesleft; i++, base += skip)
+			{
+				i = 0;
+#ifdef SSE_ROMLOAD_OPT
+				if (skip == 2 || skip == 4)
+				{
+					i = rom_spread_bytes(base, bufptr, bytesleft, skip);
+					base += i * skip;
+					bufptr += i;
+				}
+#endif
+				for (; i < bytesleft; i++, base += skip)
 					*base = *bufptr++;
+			}
 
 			/* grouped data -- non-reversed case */
 			else if (!reversed)
@@ -1617,11 +1788,11 @@ static int process_rom_entries(struct rom_load_data *romdata, const struct RomMo
 				const struct RomModule *baserom = romp;
 				int explength = 0;
 
-				/* open the file */
-				debugload("Opening ROM file: %s\n", ROM_GETNAME(romp));
-				if (!open_rom_file(romdata, romp)) {
+				/* use the file the load plan opened, the plan closes it */
+				debugload("Using ROM file: %s\n", ROM_GETNAME(romp));
+				romdata->file = romdata->files[romdata->nextfile++];
+				if (!romdata->file)
 					handle_missing_file(romdata, romp);
-				}
 
 				/* loop until we run out of reloads */
 				do
@@ -1663,13 +1834,8 @@ static int process_rom_entries(struct rom_load_data *romdata, const struct RomMo
 				}
 				while (ROMENTRY_ISRELOAD(romp));
 
-				/* close the file */
-				if (romdata->file)
-				{
-					debugload("Closing ROM file\n");
-					mame_fclose(romdata->file);
-					romdata->file = NULL;
-				}
+				/* done with the file */
+				romdata->file = NULL;
 			}
 			else
 			{
@@ -1681,8 +1847,6 @@ static int process_rom_entries(struct rom_load_data *romdata, const struct RomMo
 
 	/* error case */
 fatalerror:
-	if (romdata->file)
-		mame_fclose(romdata->file);
 	romdata->file = NULL;
 	return 0;
 }
@@ -1815,6 +1979,109 @@ fatalerror:
 }
 
 
+/*-------------------------------------------------
+	plan_rom_entries - open the files of a ROM
+	region up front, in load order
+-------------------------------------------------*/
+
+static int plan_rom_entries(struct rom_load_data *romdata, struct rom_load_task *task)
+{
+	const struct RomModule *romp;
+	int count = 0;
+
+	/* count the files; copies need the other regions loaded first, so they
+	   are loaded after them on the main thread */
+	for (romp = task->region + 1; !ROMENTRY_ISREGIONEND(romp); romp++)
+	{
+		if (ROMENTRY_ISCOPY(romp))
+			task->deferred = 1;
+		else if (ROMENTRY_ISFILE(romp))
+			count++;
+	}
+
+	task->data.files = (void **)calloc(count ? count : 1, sizeof(void *));
+	if (!task->data.files)
+		return 0;
+
+	/* the file layer and the status display aren't thread safe, so all
+	   opens (and the hash checks they imply) happen here on the main thread */
+	count = 0;
+	for (romp = task->region + 1; !ROMENTRY_ISREGIONEND(romp); romp++)
+		if (ROMENTRY_ISFILE(romp) && (!ROM_GETBIOSFLAGS(romp) || (ROM_GETBIOSFLAGS(romp) == (system_bios+1)))) /* alternate bios sets */
+		{
+			debugload("Opening ROM file: %s\n", ROM_GETNAME(romp));
+			romdata->file = NULL;
+			open_rom_file(romdata, romp);
+			task->data.files[count++] = romdata->file;
+
+			/* missing files are reported and filled with rand(), neither of
+			   which the workers may do */
+			if (!romdata->file)
+				task->deferred = 1;
+			romdata->file = NULL;
+		}
+	task->numfiles = count;
+	return 1;
+}
+
+
+/*-------------------------------------------------
+	load_region_job - workpool job loading one
+	region of the load plan
+-------------------------------------------------*/
+
+static void load_region_job(void *param, int index)
+{
+	struct rom_load_task *task = ((struct rom_load_task **)param)[index];
+	task->result = process_rom_entries(&task->data, task->region + 1);
+}
+
+
+/*-------------------------------------------------
+	free_rom_load_plan - close the files of the
+	plan and free it; the file layer isn't thread
+	safe, so this is left to the main thread
+-------------------------------------------------*/
+
+static void free_rom_load_plan(struct rom_load_task *tasks, int numtasks)
+{
+	int i, j;
+
+	if (!tasks)
+		return;
+
+	for (i = 0; i < numtasks; i++)
+		if (tasks[i].data.files)
+		{
+			debugload("Closing the ROM files of region %02X\n", (int)ROMREGION_GETTYPE(tasks[i].region));
+			for (j = 0; j < tasks[i].numfiles; j++)
+				if (tasks[i].data.files[j])
+					mame_fclose(tasks[i].data.files[j]);
+			free(tasks[i].data.files);
+		}
+	free(tasks);
+}
+
+
+/*-------------------------------------------------
+	append_rom_load_messages - append a region's
+	messages to the accumulated ones
+-------------------------------------------------*/
+
+static void append_rom_load_messages(struct rom_load_data *romdata, const char *text)
+{
+	/* leave room for the final verdict added by display_rom_load_results */
+	size_t used = strlen(romdata->errorbuf);
+	size_t avail = (used + 128 < sizeof(romdata->errorbuf)) ? sizeof(romdata->errorbuf) - 128 - used : 0;
+	size_t length = strlen(text);
+
+	if (length > avail)
+		length = avail;
+	memcpy(&romdata->errorbuf[used], text, length);
+	romdata->errorbuf[used + length] = 0;
+}
+
+
 /*-------------------------------------------------
 	rom_load - new, more flexible ROM
 	loading system
@@ -1825,7 +2092,11 @@ int rom_load(const struct RomModule *romp)
 	const struct RomModule *regionlist[REGION_MAX];
 	const struct RomModule *region;
 	static struct rom_load_data romdata;
-	int regnum;
+	struct rom_load_task *tasks;
+	struct rom_load_task **order;
+	struct rom_post_process post[REGION_MAX];
+	int numtasks = 0, numorder = 0, numpost = 0;
+	int regnum, i, j;
 
 	/* reset the region list */
 	for (regnum = 0;regnum < REGION_MAX;regnum++)
@@ -1841,8 +2112,19 @@ int rom_load(const struct RomModule *romp)
 	/* determine the correct biosset to load based on options.bios string */
 	system_bios = determine_bios_rom(Machine->gamedrv->bios);
 
-	/* loop until we hit the end */
-	for (region = romp, regnum = 0; region; region = rom_next_region(region), regnum++)
+	/* one load task per region */
+	for (region = romp, regnum = 0; region; region = rom_next_region(region))
+		regnum++;
+	tasks = (struct rom_load_task *)calloc(regnum ? regnum : 1, sizeof(*tasks));
+	order = (struct rom_load_task **)malloc((regnum ? regnum : 1) * sizeof(*order));
+	if (!tasks || !order)
+	{
+		printf("Error: unable to allocate memory for the ROM load plan\n");
+		goto fatalerror;
+	}
+
+	/* first pass: allocate the regions and open their files, in order */
+	for (region = romp; region; region = rom_next_region(region))
 	{
 		size_t regiontype = ROMREGION_GETTYPE(region);
 
@@ -1852,7 +2134,7 @@ int rom_load(const struct RomModule *romp)
 		if (!ROMENTRY_ISREGION(region))
 		{
 			printf("Error: missing ROM_REGION header\n");
-			return 1;
+			goto fatalerror;
 		}
 
 		/* if sound is disabled and it's a sound-only region, skip it */
@@ -1863,7 +2145,7 @@ int rom_load(const struct RomModule *romp)
 		if (new_memory_region(regiontype, ROMREGION_GETLENGTH(region), ROMREGION_GETFLAGS(region)))
 		{
 			printf("Error: unable to allocate memory for region %u\n", (unsigned int)regiontype);
-			return 1;
+			goto fatalerror;
 		}
 
 		/* remember the base and length */
@@ -1885,35 +2167,23 @@ int rom_load(const struct RomModule *romp)
 			fill_random(romdata.regionbase, romdata.regionlength);
 #endif
 
-		/* now process the entries in the region */
+		/* plan the entries in the region */
 		if (ROMREGION_ISROMDATA(region))
 		{
-#ifdef PINMAME
-			// if loading of rom for this region fails, check if this is a SOUNDONLY region; 
-			// if so, disable sound
-			int lastErrorCount = romdata.errors;
-			if (!process_rom_entries(&romdata, region + 1))
-				return 1;
-
-			if ( lastErrorCount!=romdata.errors && ROMREGION_ISSOUNDONLY(region) ) {
-				// make a warning out of the error(s) for this region
-				romdata.errors = lastErrorCount;
-
-				romdata.warnings++;
-				sprintf(&romdata.errorbuf[strlen(romdata.errorbuf)], "SOUND WAS DISABLED DUE TO PROBLEMS WITH SOUND ROMS\n");
-
-				// disable sound
-				Machine->sample_rate = 0;
+			struct rom_load_task *task = &tasks[numtasks++];
+			task->region = region;
+			task->data.regionbase = romdata.regionbase;
+			task->data.regionlength = romdata.regionlength;
+			if (!plan_rom_entries(&romdata, task))
+			{
+				printf("Error: unable to allocate memory for region %u\n", (unsigned int)regiontype);
+				goto fatalerror;
 			}
-#else
-			if (!process_rom_entries(&romdata, region + 1))
-				return 1;
-#endif
 		}
 		else if (ROMREGION_ISDISKDATA(region))
 		{
 			if (!process_disk_entries(&romdata, region + 1))
-				return 1;
+				goto fatalerror;
 		}
 
 		/* add this region to the list */
@@ -1921,18 +2191,87 @@ int rom_load(const struct RomModule *romp)
 			regionlist[regiontype] = region;
 	}
 
+	/* load the independent regions in parallel, biggest first; the workers
+	   only read, verify and copy, files are closed on this thread */
+	for (i = 0; i < numtasks; i++)
+		if (!tasks[i].deferred)
+		{
+			for (j = numorder++; j > 0 && order[j - 1]->data.regionlength < tasks[i].data.regionlength; j--)
+				order[j] = order[j - 1];
+			order[j] = &tasks[i];
+		}
+	workpool_run(numorder, load_region_job, order);
+
+	/* then the ones copying from other regions or missing files, in order */
+	for (i = 0; i < numtasks; i++)
+		if (tasks[i].deferred)
+			tasks[i].result = process_rom_entries(&tasks[i].data, tasks[i].region + 1);
+
+	/* merge the results in region order, as if the regions had been loaded one after the other */
+	for (i = 0; i < numtasks; i++)
+	{
+		struct rom_load_task *task = &tasks[i];
+		size_t regiontype = ROMREGION_GETTYPE(task->region);
+
+#ifdef PINMAME
+		// sound was disabled by an earlier region; drop this SOUNDONLY region
+		// as if it had been skipped in the first place
+		if (Machine->sample_rate == 0 && ROMREGION_ISSOUNDONLY(task->region))
+		{
+			free_memory_region((int)regiontype);
+			if (regiontype < REGION_MAX)
+				regionlist[regiontype] = NULL;
+			continue;
+		}
+#endif
+
+		if (!task->result)
+			goto fatalerror;
+
+		romdata.warnings += task->data.warnings;
+		append_rom_load_messages(&romdata, task->data.errorbuf);
+
+#ifdef PINMAME
+		// if loading of rom for this region fails, check if this is a SOUNDONLY region;
+		// if so, disable sound
+		if ( task->data.errors && ROMREGION_ISSOUNDONLY(task->region) ) {
+			// make a warning out of the error(s) for this region
+			romdata.warnings++;
+			append_rom_load_messages(&romdata, "SOUND WAS DISABLED DUE TO PROBLEMS WITH SOUND ROMS\n");
+
+			// disable sound
+			Machine->sample_rate = 0;
+		}
+		else
+#endif
+			romdata.errors += task->data.errors;
+	}
+	free_rom_load_plan(tasks, numtasks);
+	free(order);
+
 	/* post-process the regions */
 	for (regnum = 0; regnum < REGION_MAX; regnum++)
 		if (regionlist[regnum])
 		{
 			debugload("Post-processing region %02X\n", regnum);
-			romdata.regionlength = memory_region_length(regnum);
-			romdata.regionbase = memory_region(regnum);
-			region_post_process(&romdata, regionlist[regnum]);
+			post[numpost].base = memory_region(regnum);
+			post[numpost].length = memory_region_length(regnum);
+			post[numpost].region = regionlist[regnum];
+			numpost++;
 		}
+	workpool_run(numpost, region_post_process_job, post);
+
+	/* remember the hashes computed for the verification cache */
+	mame_fverify_cache_flush();
 
 	/* display the results and exit */
 	return display_rom_load_results(&romdata);
+
+	/* error case */
+fatalerror:
+	free_rom_load_plan(tasks, numtasks);
+	free(order);
+	return 1;
 }
 
 
@@ -85,6 +85,9 @@ struct rom_load_data
 
 	char errorbuf[4096];		/* accumulated errors */
 	UINT8 tempbuf[65536];		/* temporary buffer */
+
+	void ** files;				/* files opened up front by the load plan */
+	int nextfile;				/* next entry in files */
 };
 
 
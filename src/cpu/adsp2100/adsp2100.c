@@ -114,6 +114,7 @@
 #  include "cpuexec.h"
 #endif /* WPCDCSSPEEDUP */
 #include "mamedbg.h"
+#include "state.h"
 #include "adsp2100.h"
 
 
@@ -560,6 +561,9 @@ void adsp2100_init(void)
 	/* create the tables */
 	if (!create_tables())
 		exit(-1);
+
+	/* everything up to the IRQ callback is plain register state */
+	state_save_register_UINT8("adsp2100", cpu_getactivecpu(), "regs", (UINT8 *)&adsp2100, offsetof(adsp2100_Regs, irq_callback));
 }
 
 void adsp2100_reset(void *param)
@@ -1965,13 +1969,7 @@ const char *adsp2100_info( void *context, int regnum )
 
 unsigned adsp2100_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
-	extern unsigned dasm2100(char *, unsigned);
 	return dasm2100(buffer, pc);
-#else
-	sprintf(buffer, "$%06X", RWORD_PGM(pc));
-	return 1;
-#endif
 }
 
 #if (HAS_ADSP2101)
@@ -2049,13 +2047,7 @@ const char *adsp2101_info(void *context, int regnum)
 
 unsigned adsp2101_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
-	extern unsigned dasm2100(char *, unsigned);
 	return dasm2100(buffer, pc);
-#else
-	sprintf(buffer, "$%06X", RWORD_PGM(pc));
-	return 1;
-#endif
 }
 
 void adsp2101_set_rx_callback(RX_CALLBACK cb)
@@ -2145,13 +2137,7 @@ const char *adsp2105_info(void *context, int regnum)
 
 unsigned adsp2105_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
-	extern unsigned dasm2100(char *, unsigned);
-    return dasm2100(buffer, pc);
-#else
-	sprintf(buffer, "$%06X", RWORD_PGM(pc));
-	return 1;
-#endif
+	return dasm2100(buffer, pc);
 }
 
 void adsp2105_set_rx_callback(RX_CALLBACK cb)
@@ -2261,13 +2247,7 @@ const char *adsp2115_info(void *context, int regnum)
 
 unsigned adsp2115_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
-	extern unsigned dasm2100(char *, unsigned);
 	return dasm2100(buffer, pc);
-#else
-	sprintf(buffer, "$%06X", RWORD_PGM(pc));
-	return 1;
-#endif
 }
 
 void adsp2115_set_rx_callback(RX_CALLBACK cb)
@@ -120,6 +120,7 @@ extern unsigned adsp2100_dasm(char *buffer, unsigned pc);
 #ifdef MAME_DEBUG
 extern unsigned DasmADSP2100(char *buffer, unsigned pc);
 #endif
+extern unsigned dasm2100(char *buffer, unsigned pc);
 
 #if (HAS_ADSP2101)
 /**************************************************************************
@@ -364,13 +364,8 @@ const char *arm7_info(void *context, int regnum)
 
 unsigned arm7_dasm(char *buffer, unsigned int pc)
 {
-#ifdef MAME_DEBUG
 	arm7_disasm( buffer, pc, READ32(pc)); //&ADDRESS_MASK) );
 	return 4;
-#else
-	sprintf(buffer, "$%08x", READ32(pc));
-	return 4;
-#endif
 }
 
 void arm7_init(void)
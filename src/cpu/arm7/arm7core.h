@@ -379,13 +379,11 @@ EXTERN WRITE32_HANDLER((*arm7_coproc_rt_w_callback));	//holder for the co proces
 EXTERN void (*arm7_coproc_dt_r_callback)(data32_t insn, data32_t* prn, data32_t (*read32)(int addr));		
 EXTERN void (*arm7_coproc_dt_w_callback)(data32_t insn, data32_t* prn, void (*write32)(int addr, data32_t data));
 
-#ifdef MAME_DEBUG
 extern void arm7_disasm( char *pBuf, data32_t pc, data32_t opcode );
 
 //custom dasm callback handlers for co-processor instructions
 EXTERN char *(*arm7_dasm_cop_dt_callback)( char *pBuf, data32_t opcode, char *pConditionCode, char *pBuf0 );
 EXTERN char *(*arm7_dasm_cop_rt_callback)( char *pBuf, data32_t opcode, char *pConditionCode, char *pBuf0 );
 EXTERN char *(*arm7_dasm_cop_do_callback)( char *pBuf, data32_t opcode, char *pConditionCode, char *pBuf0 );
-#endif
 
 #endif /* ARM7CORE_H */
@@ -35,8 +35,6 @@
 #include <stdio.h>
 #include "arm7core.h"
 
-#ifdef MAME_DEBUG
-
 //custom dasm callback handlers for co-processor instructions (setup in the core)
 extern char *(*arm7_dasm_cop_dt_callback)( char *pBuf, data32_t opcode, char *pConditionCode, char *pBuf0 );
 extern char *(*arm7_dasm_cop_rt_callback)( char *pBuf, data32_t opcode, char *pConditionCode, char *pBuf0 );
@@ -640,5 +638,3 @@ void arm7_disasm( char *pBuf, data32_t pc, data32_t opcode )
 		pBuf += sprintf( pBuf, "Undefined" );
 	}
 }
-
-#endif	//MAME_DEBUG
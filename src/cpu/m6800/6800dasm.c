@@ -25,8 +25,6 @@
 #include "mamedbg.h"
 #include "m6800.h"
 
-#ifdef MAME_DEBUG
-
 enum addr_mode {
 	inh,	/* inherent */
 	rel,	/* relative */
@@ -272,5 +270,3 @@ unsigned Dasm680x (int subtype, char *buf, unsigned pc)
 			return 1;
 	}
 }
-
-#endif
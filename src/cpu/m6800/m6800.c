@@ -151,8 +151,10 @@ typedef struct
 	PAIR	timer_over;
 }   m6800_Regs;
 
-/* 680x registers */
-static m6800_Regs m6800;
+/* 680x registers, the core works on the context m6800_active points to */
+static m6800_Regs m6800_regs;
+static m6800_Regs *m6800_active = &m6800_regs;
+#define m6800	(*m6800_active)
 
 #define m6801   m6800
 #define m6802   m6800
@@ -657,7 +659,7 @@ void m6800_exit(void)
  ****************************************************************************/
 unsigned m6800_get_context(void *dst)
 {
-	if( dst )
+	if( dst && dst != m6800_active )
 		*(m6800_Regs*)dst = m6800;
 	return sizeof(m6800_Regs);
 }
@@ -668,13 +670,22 @@ unsigned m6800_get_context(void *dst)
  ****************************************************************************/
 void m6800_set_context(void *src)
 {
-	if( src )
+	if( src && src != m6800_active )
 		m6800 = *(m6800_Regs*)src;
 	CHANGE_PC();
 	CHECK_IRQ_LINES(); /* HJB 990417 */
 }
 
 
+/****************************************************************************
+ * Run on the given context buffer instead of the internal one
+ ****************************************************************************/
+void m6800_set_context_ptr(void *src)
+{
+	m6800_active = src ? (m6800_Regs*)src : &m6800_regs;
+}
+
+
 /****************************************************************************
  * Return a specific register
  ****************************************************************************/
@@ -1143,12 +1154,7 @@ const char *m6800_info(void *context, int regnum)
 
 unsigned m6800_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(6800,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readop(pc) );
-	return 1;
-#endif
 }
 
 /****************************************************************************
@@ -1168,6 +1174,7 @@ void m6801_exit(void) { m6800_exit(); }
 int  m6801_execute(int cycles) { return m6803_execute(cycles); }
 unsigned m6801_get_context(void *dst) { return m6800_get_context(dst); }
 void m6801_set_context(void *src) { m6800_set_context(src); }
+void m6801_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned m6801_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void m6801_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void m6801_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -1199,12 +1206,7 @@ const char *m6801_info(void *context, int regnum)
 }
 unsigned m6801_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(6801,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 
 #endif
@@ -1225,6 +1227,7 @@ void m6802_exit(void) { m6800_exit(); }
 int  m6802_execute(int cycles) { return m6800_execute(cycles); }
 unsigned m6802_get_context(void *dst) { return m6800_get_context(dst); }
 void m6802_set_context(void *src) { m6800_set_context(src); }
+void m6802_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned m6802_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void m6802_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void m6802_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -1257,12 +1260,7 @@ const char *m6802_info(void *context, int regnum)
 
 unsigned m6802_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(6802,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 
 #endif
@@ -1580,6 +1578,7 @@ int m6803_execute(int cycles)
 #if (HAS_M6803)
 unsigned m6803_get_context(void *dst) { return m6800_get_context(dst); }
 void m6803_set_context(void *src) { m6800_set_context(src); }
+void m6803_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned m6803_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void m6803_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void m6803_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -1612,12 +1611,7 @@ const char *m6803_info(void *context, int regnum)
 
 unsigned m6803_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(6803,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 #endif
 
@@ -1637,6 +1631,7 @@ void m6808_exit(void) { m6800_exit(); }
 int  m6808_execute(int cycles) { return m6800_execute(cycles); }
 unsigned m6808_get_context(void *dst) { return m6800_get_context(dst); }
 void m6808_set_context(void *src) { m6800_set_context(src); }
+void m6808_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned m6808_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void m6808_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void m6808_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -1669,12 +1664,7 @@ const char *m6808_info(void *context, int regnum)
 
 unsigned m6808_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(6808,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 #endif
 
@@ -1987,6 +1977,7 @@ int hd63701_execute(int cycles)
 
 unsigned hd63701_get_context(void *dst) { return m6800_get_context(dst); }
 void hd63701_set_context(void *src) { m6800_set_context(src); }
+void hd63701_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned hd63701_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void hd63701_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void hd63701_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -2041,12 +2032,7 @@ WRITE_HANDLER( hd63701_internal_registers_w )
 
 unsigned hd63701_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(63701,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 #endif
 
@@ -2360,6 +2346,7 @@ int nsc8105_execute(int cycles)
 
 unsigned nsc8105_get_context(void *dst) { return m6800_get_context(dst); }
 void nsc8105_set_context(void *src) { m6800_set_context(src); }
+void nsc8105_set_context_ptr(void *src) { m6800_set_context_ptr(src); }
 unsigned nsc8105_get_reg(int regnum) { return m6800_get_reg(regnum); }
 void nsc8105_set_reg(int regnum, unsigned val) { m6800_set_reg(regnum,val); }
 void nsc8105_set_irq_line(int irqline, int state) { m6800_set_irq_line(irqline,state); }
@@ -2392,12 +2379,7 @@ const char *nsc8105_info(void *context, int regnum)
 
 unsigned nsc8105_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
 	return Dasm680x(8105,buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readmem16(pc) );
-	return 1;
-#endif
 }
 #endif
 
@@ -34,6 +34,7 @@ void m6800_exit(void);
 int	m6800_execute(int cycles);
 unsigned m6800_get_context(void *dst);
 void m6800_set_context(void *src);
+void m6800_set_context_ptr(void *src);
 unsigned m6800_get_reg(int regnum);
 void m6800_set_reg(int regnum, unsigned val);
 void m6800_set_irq_line(int irqline, int state);
@@ -65,6 +66,7 @@ void m6801_exit(void);
 int	m6801_execute(int cycles);
 unsigned m6801_get_context(void *dst);
 void m6801_set_context(void *src);
+void m6801_set_context_ptr(void *src);
 unsigned m6801_get_reg(int regnum);
 void m6801_set_reg(int regnum, unsigned val);
 void m6801_set_irq_line(int irqline, int state);
@@ -97,6 +99,7 @@ void m6802_exit(void);
 int	m6802_execute(int cycles);
 unsigned m6802_get_context(void *dst);
 void m6802_set_context(void *src);
+void m6802_set_context_ptr(void *src);
 unsigned m6802_get_reg(int regnum);
 void m6802_set_reg(int regnum, unsigned val);
 void m6802_set_irq_line(int irqline, int state);
@@ -130,6 +133,7 @@ void m6803_exit(void);
 int	m6803_execute(int cycles);
 unsigned m6803_get_context(void *dst);
 void m6803_set_context(void *src);
+void m6803_set_context_ptr(void *src);
 unsigned m6803_get_reg(int regnum);
 void m6803_set_reg(int regnum, unsigned val);
 void m6803_set_irq_line(int irqline, int state);
@@ -180,6 +184,7 @@ void m6808_exit(void);
 int	m6808_execute(int cycles);
 unsigned m6808_get_context(void *dst);
 void m6808_set_context(void *src);
+void m6808_set_context_ptr(void *src);
 unsigned m6808_get_reg(int regnum);
 void m6808_set_reg(int regnum, unsigned val);
 void m6808_set_irq_line(int irqline, int state);
@@ -214,6 +219,7 @@ void hd63701_exit(void);
 int	hd63701_execute(int cycles);
 unsigned hd63701_get_context(void *dst);
 void hd63701_set_context(void *src);
+void hd63701_set_context_ptr(void *src);
 unsigned hd63701_get_reg(int regnum);
 void hd63701_set_reg(int regnum, unsigned val);
 void hd63701_set_irq_line(int irqline, int state);
@@ -263,6 +269,7 @@ void nsc8105_exit(void);
 int	nsc8105_execute(int cycles);
 unsigned nsc8105_get_context(void *dst);
 void nsc8105_set_context(void *src);
+void nsc8105_set_context_ptr(void *src);
 unsigned nsc8105_get_reg(int regnum);
 void nsc8105_set_reg(int regnum, unsigned val);
 void nsc8105_set_irq_line(int irqline, int state);
@@ -303,8 +310,6 @@ unsigned nsc8105_dasm(char *buffer, unsigned pc);
 #    define TRUE (!FALSE)
 #endif
 
-#ifdef	MAME_DEBUG
 unsigned Dasm680x(int subtype, char *buf, unsigned pc);
-#endif
 
 #endif /* _M6800_H */
@@ -14,9 +14,6 @@
 /* Please send all bug reports, update ideas and data files to: */
 /* sriddle@ionet.net */
 #include <stdio.h>
-
-#ifdef MAME_DEBUG
-
 #include <string.h>
 #include "osd_cpu.h"
 #include "cpuintrf.h"
@@ -721,5 +718,3 @@ unsigned Dasm6809 (char *buffer, unsigned pc)
 
 	return p;
 }
-
-#endif
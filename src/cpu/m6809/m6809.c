@@ -135,8 +135,10 @@ typedef struct
 #define CC_IF   0x40        /* Inhibit FIRQ */
 #define CC_E    0x80        /* entire state pushed */
 
-/* 6809 registers */
-static m6809_Regs m6809;
+/* 6809 registers, the core works on the context m6809_active points to */
+static m6809_Regs m6809_regs;
+static m6809_Regs *m6809_active = &m6809_regs;
+#define m6809	(*m6809_active)
 int m6809_slapstic = 0;
 
 #define pPPC    m6809.ppc
@@ -422,7 +424,7 @@ INLINE void WM16( UINT32 Addr, PAIR *p )
  ****************************************************************************/
 unsigned m6809_get_context(void *dst)
 {
-	if( dst )
+	if( dst && dst != m6809_active )
 		*(m6809_Regs*)dst = m6809;
 	return sizeof(m6809_Regs);
 }
@@ -432,13 +434,21 @@ unsigned m6809_get_context(void *dst)
  ****************************************************************************/
 void m6809_set_context(void *src)
 {
-	if( src )
+	if( src && src != m6809_active )
 		m6809 = *(m6809_Regs*)src;
 	CHANGE_PC;
 
     CHECK_IRQ_LINES;
 }
 
+/****************************************************************************
+ * Run on the given context buffer instead of the internal one
+ ****************************************************************************/
+void m6809_set_context_ptr(void *src)
+{
+	m6809_active = src ? (m6809_Regs*)src : &m6809_regs;
+}
+
 
 /****************************************************************************/
 /* Return a specific register                                               */
@@ -659,12 +669,7 @@ const char *m6809_info(void *context, int regnum)
 
 unsigned m6809_dasm(char *buffer, unsigned pc)
 {
-#ifdef MAME_DEBUG
-    return Dasm6809(buffer,pc);
-#else
-	sprintf( buffer, "$%02X", cpu_readop(pc) );
-	return 1;
-#endif
+	return Dasm6809(buffer,pc);
 }
 
 /* includes the static function prototypes and the master opcode table */
@@ -27,6 +27,7 @@ extern void m6809_exit(void);
 extern int m6809_execute(int cycles);  /* NS 970908 */
 extern unsigned m6809_get_context(void *dst);
 extern void m6809_set_context(void *src);
+extern void m6809_set_context_ptr(void *src);
 extern unsigned m6809_get_reg(int regnum);
 extern void m6809_set_reg(int regnum, unsigned val);
 extern void m6809_set_irq_line(int irqline, int state);
@@ -66,8 +67,6 @@ extern unsigned m6809_dasm(char *buffer, unsigned pc);
 #    define TRUE (!FALSE)
 #endif
 
-#ifdef MAME_DEBUG
 extern unsigned Dasm6809 (char *buffer, unsigned pc);
-#endif
 
 #endif /* _M6809_H */
@@ -13,6 +13,7 @@
 #include "video.h"
 #include "mamedbg.h"
 #include "hiscore.h"
+#include "pcprof.h"
 
 #if (HAS_M68000 || HAS_M68010 || HAS_M68020 || HAS_M68EC020)
 #include "cpu/m68000/m68000.h"
@@ -140,6 +141,10 @@ struct cpuinfo
 	UINT64 	totalcycles;			/* total CPU cycles executed */
 	double	localtime;				/* local time, relative to the timer system's global time */
 	double	clockscale;				/* current active clock scale factor */
+	double	runtime;				/* emulated time executed since the last reset */
+	double	stalltime;				/* emulated time spent suspended since the last reset */
+	cycles_t hosttime;				/* host time spent executing, in osd_cycles() */
+	UINT64	executed;				/* cycles executed, not reset with the machine */
 	
 	int 	vblankint_countdown;	/* number of vblank callbacks left until we interrupt */
 	int 	vblankint_multiplier;	/* number of vblank callbacks per interrupt */
@@ -172,6 +177,7 @@ static int timetrig_yield = 0;
 
 static int cycles_running;
 static int cycles_stolen;
+static int sample_countdown[MAX_CPU];
 
 
 
@@ -207,6 +213,27 @@ static double perfect_interleave;
 
 
 
+/*************************************
+ *
+ *	Interleave auto-tuning
+ *
+ *************************************/
+
+/* timeslices may get this much shorter or longer than the driver's */
+#define AUTOINTERLEAVE_RANGE	8
+
+static double base_timeslice_period;
+static int sched_instrumented;			/* driver notes all of its cross-CPU traffic */
+static double sched_window_start;
+static UINT32 sched_window_slices;
+static UINT32 sched_window_events;
+static struct cpu_sched_stats sched_stats;
+
+/* called at the start of every timeslice */
+static void (*timeslice_hook)(void);
+
+
+
 /*************************************
  *
  *	Save/load variables
@@ -215,6 +242,8 @@ static double perfect_interleave;
 
 static int loadsave_schedule;
 static char *loadsave_schedule_name;
+static void (*volatile loadsave_callback)(void);
+static double loadsave_time;
 
 
 
@@ -225,6 +254,7 @@ static char *loadsave_schedule_name;
  *************************************/
 
 static void cpu_timeslice(void);
+static void cpu_autointerleave(void);
 static void cpu_inittimers(void);
 static void cpu_vblankreset(void);
 static void cpu_vblankcallback(int param);
@@ -233,6 +263,8 @@ static void end_interleave_boost(int param);
 static void compute_perfect_interleave(void);
 
 static void handle_loadsave(void);
+static void loadsave_presave(void);
+static void loadsave_postload(void);
 
 #ifdef PINMAME
 void run_one_timeslice(void) {
@@ -290,6 +322,9 @@ int cpu_init(void)
 	/* save some stuff in tag 0 */
 	state_save_set_current_tag(0);
 	state_save_register_INT32("cpu", 0, "watchdog count", &watchdog_counter, 1);
+	state_save_register_double("cpu", 0, "time", &loadsave_time, 1);
+	state_save_register_func_presave(loadsave_presave);
+	state_save_register_func_postload(loadsave_postload);
 
 	/* reset the IRQ lines and save those */
 	if (cpuint_init())
@@ -340,6 +375,7 @@ static void cpu_pre_run(void)
 		/* reset the total number of cycles */
 		cpu[cpunum].totalcycles = 0;
 		cpu[cpunum].localtime = 0;
+		cpu[cpunum].runtime = cpu[cpunum].stalltime = 0;
 	}
 
 	vblank = 0;
@@ -374,6 +410,20 @@ static void cpu_pre_run(void)
 
 static void cpu_post_run(void)
 {
+	int cpunum;
+
+	/* report how the scheduler did */
+	if (sched_stats.time > 0)
+	{
+		logerror("Scheduler: %.0f slices/s, %.0f cross-CPU events/s, timeslice %.1f us (driver %.1f us)\n",
+				(double)sched_stats.slices / sched_stats.time, (double)sched_stats.events / sched_stats.time,
+				timeslice_period * 1e6, base_timeslice_period * 1e6);
+		for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+			logerror("  CPU #%d: ran %.1f%%, stalled %.1f%%\n", cpunum,
+					100.0 * cpu[cpunum].runtime / sched_stats.time,
+					100.0 * cpu[cpunum].stalltime / sched_stats.time);
+	}
+
 	/* write hi scores to disk - No scores saving if cheat */
 	hs_close();
 
@@ -400,6 +450,9 @@ void cpu_run(void)
 		mame_debug_init();
 #endif
 
+	perf_counters_reset();
+	pcprof_start();
+
 	/* loop over multiple resets, until the user quits */
 	time_to_quit = 0;
 	while (!time_to_quit)
@@ -414,7 +467,7 @@ void cpu_run(void)
 			profiler_mark(PROFILER_EXTRA);
 
 			/* if we have a load/save scheduled, handle it */
-			if (loadsave_schedule != LOADSAVE_NONE)
+			if (loadsave_schedule != LOADSAVE_NONE || loadsave_callback)
 				handle_loadsave();
 			
 			/* execute CPUs */
@@ -427,6 +480,8 @@ void cpu_run(void)
 		cpu_post_run();
 	}
 
+	pcprof_stop();
+
 #ifdef MAME_DEBUG
 	/* shut down the debugger */
 	if (mame_debug)
@@ -473,6 +528,63 @@ void machine_reset(void)
 #pragma mark SAVE/RESTORE
 #endif
 
+/*************************************
+ *
+ *	Save/load all tags
+ *
+ *************************************/
+
+static void save_state_tags(void)
+{
+	int cpunum;
+
+	/* write tag 0 */
+	state_save_set_current_tag(0);
+	state_save_save_continue();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* save the CPU data */
+		state_save_set_current_tag(cpunum + 1);
+		state_save_save_continue();
+
+		cpuintrf_pop_context();
+	}
+}
+
+
+static void load_state_tags(void)
+{
+	int cpunum;
+
+	/* read tag 0 */
+	state_save_set_current_tag(0);
+	state_save_load_continue();
+
+	/* loop over CPUs */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		cpuintrf_push_context(cpunum);
+
+		/* make sure banking is set */
+		activecpu_reset_banking();
+
+		/* load the CPU data */
+		state_save_set_current_tag(cpunum + 1);
+		state_save_load_continue();
+
+		cpuintrf_pop_context();
+	}
+}
+
+
+
 /*************************************
  *
  *	Handle saves at runtime
@@ -488,29 +600,9 @@ static void handle_save(void)
 
 	if (file)
 	{
-		int cpunum;
-
 		/* write the save state */
 		state_save_save_begin(file);
-
-		/* write tag 0 */
-		state_save_set_current_tag(0);
-		state_save_save_continue();
-
-		/* loop over CPUs */
-		for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-		{
-			cpuintrf_push_context(cpunum);
-
-			/* make sure banking is set */
-			activecpu_reset_banking();
-
-			/* save the CPU data */
-			state_save_set_current_tag(cpunum + 1);
-			state_save_save_continue();
-
-			cpuintrf_pop_context();
-		}
+		save_state_tags();
 
 		/* finish and close */
 		state_save_save_finish();
@@ -546,26 +638,7 @@ static void handle_load(void)
 		/* start loading */
 		if (!state_save_load_begin(file))
 		{
-			int cpunum;
-
-			/* read tag 0 */
-			state_save_set_current_tag(0);
-			state_save_load_continue();
-
-			/* loop over CPUs */
-			for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
-			{
-				cpuintrf_push_context(cpunum);
-
-				/* make sure banking is set */
-				activecpu_reset_banking();
-
-				/* load the CPU data */
-				state_save_set_current_tag(cpunum + 1);
-				state_save_load_continue();
-
-				cpuintrf_pop_context();
-			}
+			load_state_tags();
 
 			/* finish and close */
 			state_save_load_finish();
@@ -591,6 +664,8 @@ static void handle_load(void)
 
 static void handle_loadsave(void)
 {
+	void (*callback)(void) = loadsave_callback;
+
 	/* it's one or the other */
 	if (loadsave_schedule == LOADSAVE_SAVE)
 		handle_save();
@@ -599,6 +674,33 @@ static void handle_loadsave(void)
 
 	/* reset the schedule */
 	cpu_loadsave_reset();
+
+	/* in-memory saves and loads are run by their requester */
+	if (callback)
+	{
+		loadsave_callback = NULL;
+		(*callback)();
+	}
+}
+
+
+
+/*************************************
+ *
+ *	Keep the emulated time across
+ *	save and load
+ *
+ *************************************/
+
+static void loadsave_presave(void)
+{
+	loadsave_time = timer_get_time();
+}
+
+
+static void loadsave_postload(void)
+{
+	timer_set_global_time(loadsave_time);
 }
 
 
@@ -638,6 +740,69 @@ void cpu_loadsave_schedule(int type, char id)
 
 
 
+/*************************************
+ *
+ *	Schedules a function to be called
+ *	at the next point where the state
+ *	can be saved or loaded; may be
+ *	called from another thread
+ *
+ *************************************/
+
+void cpu_loadsave_schedule_callback(void (*callback)(void))
+{
+	loadsave_callback = callback;
+}
+
+
+
+/*************************************
+ *
+ *	Saves/loads the state to/from
+ *	memory or the snapshot ring; only
+ *	valid from a function scheduled
+ *	with the above
+ *
+ *************************************/
+
+void *cpu_loadsave_save_memory(size_t *size)
+{
+	state_save_save_begin_memory();
+	save_state_tags();
+	return state_save_save_finish_memory(size);
+}
+
+
+int cpu_loadsave_load_memory(const void *data, size_t size)
+{
+	if (state_save_load_begin_memory(data, size))
+		return 1;
+	load_state_tags();
+	state_save_load_finish();
+	return 0;
+}
+
+
+
+int cpu_loadsave_snapshot(void)
+{
+	state_save_snapshot_begin();
+	save_state_tags();
+	return state_save_snapshot_finish();
+}
+
+
+int cpu_loadsave_rewind(int back)
+{
+	if (state_save_snapshot_load_begin(back))
+		return 1;
+	load_state_tags();
+	state_save_load_finish();
+	return 0;
+}
+
+
+
 /*************************************
  *
  *	Unschedules any saves or loads
@@ -802,6 +967,45 @@ void cpunum_set_halt_line(int cpunum, int state)
 #pragma mark CPU SCHEDULING
 #endif
 
+/*************************************
+ *
+ *	Execute a CPU in chunks, sampling
+ *	its PC for the profiler
+ *
+ *************************************/
+
+static int cpu_execute_sampled(int cpunum, int cycles)
+{
+	int done = 0;
+
+	while (done < cycles)
+	{
+		int stolen = cycles_stolen;
+		int chunk, ran;
+
+		if (sample_countdown[cpunum] <= 0)
+			sample_countdown[cpunum] = pcprof_interval;
+		chunk = (cycles - done < sample_countdown[cpunum]) ? cycles - done : sample_countdown[cpunum];
+
+		/* cycles_running covers the chunks before, so the local time
+		   and the total cycles seen from within the core stay right */
+		cycles_running = done + chunk;
+		ran = cpunum_execute(cpunum, chunk);
+		done += ran;
+
+		sample_countdown[cpunum] -= ran - (cycles_stolen - stolen);
+		if (sample_countdown[cpunum] <= 0)
+			pcprof_sample(cpunum);
+
+		/* the CPU gave up the rest of the timeslice */
+		if (cycles_stolen != stolen)
+			break;
+	}
+	return done;
+}
+
+
+
 /*************************************
  *
  *	Execute all the CPUs for one
@@ -811,8 +1015,15 @@ void cpunum_set_halt_line(int cpunum, int state)
 
 static void cpu_timeslice(void)
 {
-	double target = timer_time_until_next_timer();
+	double target;
 	int cpunum, ran;
+
+	/* let the host hand over work that has to land at an exact time,
+	   before the length of this slice is fixed */
+	if (timeslice_hook)
+		(*timeslice_hook)();
+
+	target = timer_time_until_next_timer();
 	
 	LOG(("------------------\n"));
 	LOG(("cpu_timeslice: target = %.9f\n", target));
@@ -839,15 +1050,24 @@ static void cpu_timeslice(void)
 			/* run for the requested number of cycles */
 			if (cycles_running > 0)
 			{
+				cycles_t start = osd_cycles();
+
 				profiler_mark(PROFILER_CPU1 + cpunum);
 				cycles_stolen = 0;
-				ran = cpunum_execute(cpunum, cycles_running);
+				if (pcprof_interval)
+					ran = cpu_execute_sampled(cpunum, cycles_running);
+				else
+					ran = cpunum_execute(cpunum, cycles_running);
 				ran -= cycles_stolen;
 				profiler_mark(PROFILER_END);
+
+				cpu[cpunum].hosttime += osd_cycles() - start;
+				cpu[cpunum].executed += ran;
 				
 				/* account for these cycles */
 				cpu[cpunum].totalcycles += ran;
 				cpu[cpunum].localtime += TIME_IN_CYCLES(ran, cpunum);
+				cpu[cpunum].runtime += TIME_IN_CYCLES(ran, cpunum);
 				LOG(("         %d ran, %d total, time = %.9f\n", ran, (INT32)cpu[cpunum].totalcycles, cpu[cpunum].localtime));
 				
 				/* if the new local CPU time is less than our target, move the target up */
@@ -863,6 +1083,9 @@ static void cpu_timeslice(void)
 	/* update the local times of all CPUs */
 	for (cpunum = 0; Machine->drv->cpu[cpunum].cpu_type != CPU_DUMMY; cpunum++)
 	{
+		if (cpu[cpunum].suspend)
+			cpu[cpunum].stalltime += target;
+
 		/* if we're suspended and counting, process */
 		if (cpu[cpunum].suspend && cpu[cpunum].eatcycles && cpu[cpunum].localtime < target)
 		{
@@ -887,6 +1110,11 @@ static void cpu_timeslice(void)
 	
 	/* update the global time */
 	timer_adjust_global_time(target);
+	sched_stats.time += target;
+	perf_counters.emulated_time += target;
+	sched_stats.slices++;
+	sched_window_slices++;
+	cpu_autointerleave();
 
 	/* huh? something for the debugger */
 	#ifdef MAME_DEBUG
@@ -948,6 +1176,52 @@ double cpunum_get_localtime(int cpunum)
 
 
 
+/*************************************
+ *
+ *	Return the time a CPU executed or
+ *	spent suspended since the last
+ *	reset
+ *
+ *************************************/
+
+double cpunum_get_runtime(int cpunum)
+{
+	VERIFY_CPUNUM(0, cpunum_get_runtime);
+	return cpu[cpunum].runtime;
+}
+
+
+double cpunum_get_stalltime(int cpunum)
+{
+	VERIFY_CPUNUM(0, cpunum_get_stalltime);
+	return cpu[cpunum].stalltime;
+}
+
+
+
+/*************************************
+ *
+ *	Return the host time a CPU took
+ *	and the cycles it executed since
+ *	the emulation started
+ *
+ *************************************/
+
+double cpunum_get_hosttime(int cpunum)
+{
+	VERIFY_CPUNUM(0, cpunum_get_hosttime);
+	return (double)cpu[cpunum].hosttime / (double)osd_cycles_per_second();
+}
+
+
+UINT64 cpunum_get_executed(int cpunum)
+{
+	VERIFY_CPUNUM(0, cpunum_get_executed);
+	return cpu[cpunum].executed;
+}
+
+
+
 /*************************************
  *
  *	Set a suspend reason for the 
@@ -1060,6 +1334,71 @@ void cpu_boost_interleave(double timeslice_time, double boost_duration)
 
 	/* adjust the end timer */
 	timer_adjust(interleave_boost_timer_end, boost_duration, 0, TIME_NEVER);
+
+	/* a boost always means the CPUs are talking */
+	cpu_note_communication();
+}
+
+
+
+/*************************************
+ *
+ *	Set the timeslice hook
+ *
+ *************************************/
+
+void cpu_set_timeslice_hook(void (*hook)(void))
+{
+	timeslice_hook = hook;
+}
+
+
+
+/*************************************
+ *
+ *	Note cross-CPU communication
+ *
+ *************************************/
+
+void cpu_note_communication(void)
+{
+	sched_stats.events++;
+	sched_window_events++;
+
+	/* traffic on a relaxed schedule: go back to the driver's interleave right away */
+	if (options.autointerleave && timeslice_period > base_timeslice_period)
+	{
+		timeslice_period = base_timeslice_period;
+		timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+	}
+}
+
+
+
+/*************************************
+ *
+ *	Declare that the driver notes all
+ *	of its cross-CPU communication
+ *
+ *************************************/
+
+void cpu_communication_instrumented(void)
+{
+	sched_instrumented = 1;
+}
+
+
+
+/*************************************
+ *
+ *	Return the scheduler statistics
+ *
+ *************************************/
+
+void cpu_get_sched_stats(struct cpu_sched_stats *stats)
+{
+	*stats = sched_stats;
+	stats->timeslice = timeslice_period;
 }
 
 
@@ -1731,6 +2070,60 @@ static double cpu_computerate(double value)
 
 
 
+/*************************************
+ *
+ *	Adapt the timeslice length to the
+ *	cross-CPU traffic of the last frame
+ *
+ *************************************/
+
+static void cpu_autointerleave(void)
+{
+	double period = timeslice_period;
+
+	if (sched_stats.time - sched_window_start < 1.0 / Machine->drv->frames_per_second)
+		return;
+
+	if (options.autointerleave)
+	{
+		/* only a driver noting all of its traffic may look quiet, others never slice
+		   coarser than their MDRV_INTERLEAVE */
+		double longest = sched_instrumented ? base_timeslice_period * AUTOINTERLEAVE_RANGE : base_timeslice_period;
+
+		/* more than one exchange per slice: slice finer; silence: slice coarser */
+		if (sched_window_events > sched_window_slices)
+			period *= 0.5;
+		else if (sched_window_events == 0)
+			period *= 2.0;
+		else if (period > base_timeslice_period)
+			period = base_timeslice_period;
+
+		if (period < base_timeslice_period / AUTOINTERLEAVE_RANGE)
+			period = base_timeslice_period / AUTOINTERLEAVE_RANGE;
+		if (period > longest)
+			period = longest;
+		if (period != timeslice_period)
+		{
+			LOG(("cpu_autointerleave: %d events in %d slices, timeslice %.9f\n", sched_window_events, sched_window_slices, period));
+			timeslice_period = period;
+			timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+		}
+	}
+
+	/* switched off while tuned: back to the driver's interleave */
+	else if (timeslice_period != base_timeslice_period)
+	{
+		timeslice_period = base_timeslice_period;
+		timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+	}
+
+	/* start the next window */
+	sched_window_start = sched_stats.time;
+	sched_window_slices = sched_window_events = 0;
+}
+
+
+
 /*************************************
  *
  *	Callback to force a timeslice
@@ -1813,6 +2206,13 @@ static void cpu_inittimers(void)
 	timeslice_period = TIME_IN_HZ(Machine->drv->frames_per_second * ipfd);
 	timeslice_timer = timer_alloc(cpu_timeslicecallback);
 	timer_adjust(timeslice_timer, timeslice_period, 0, timeslice_period);
+
+	/* the driver's interleave is where auto-tuning starts */
+	base_timeslice_period = timeslice_period;
+	sched_instrumented = 0;
+	memset(&sched_stats, 0, sizeof(sched_stats));
+	sched_window_start = 0;
+	sched_window_slices = sched_window_events = 0;
 	
 	/* allocate timers to handle interleave boosts */
 	interleave_boost_timer = timer_alloc(NULL);
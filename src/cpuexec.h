@@ -114,6 +114,16 @@ void cpu_loadsave_schedule(int type, char id);
 void cpu_loadsave_schedule_file(int type, const char *name);
 void cpu_loadsave_reset(void);
 
+/* Run a function at the next point where the state is consistent; the
+   in-memory save/load below may only be called from that function */
+void cpu_loadsave_schedule_callback(void (*callback)(void));
+void *cpu_loadsave_save_memory(size_t *size);
+int cpu_loadsave_load_memory(const void *data, size_t size);
+
+/* Take a snapshot into the state ring, or go back to one (0 = newest) */
+int cpu_loadsave_snapshot(void);
+int cpu_loadsave_rewind(int back);
+
 
 
 /*************************************
@@ -186,6 +196,14 @@ void activecpu_abort_timeslice(void);
 /* Returns the current local time for a CPU, relative to the current timeslice */
 double cpunum_get_localtime(int cpunum);
 
+/* Returns the time a CPU executed or spent suspended since the last reset */
+double cpunum_get_runtime(int cpunum);
+double cpunum_get_stalltime(int cpunum);
+
+/* Returns the host seconds a CPU took and the cycles it executed since the emulation started */
+double cpunum_get_hosttime(int cpunum);
+UINT64 cpunum_get_executed(int cpunum);
+
 /* Returns the current scaling factor for a CPU's clock speed */
 double cpunum_get_clockscale(int cpunum);
 
@@ -195,6 +213,29 @@ void cpunum_set_clockscale(int cpunum, double clockscale);
 /* Temporarily boosts the interleave factor */
 void cpu_boost_interleave(double timeslice_time, double boost_duration);
 
+/* Notes cross-CPU communication (latches, shared RAM) for interleave auto-tuning */
+void cpu_note_communication(void);
+
+/* Declares, from machine_init, that every latch, shared RAM and cross-CPU
+   interrupt of the driver calls cpu_note_communication(); auto-tuning only
+   lengthens the timeslices of such drivers */
+void cpu_communication_instrumented(void);
+
+/* Installs a function called at the start of every timeslice, NULL removes it */
+void cpu_set_timeslice_hook(void (*hook)(void));
+
+/* Scheduler statistics since the last reset, in emulated time */
+struct cpu_sched_stats
+{
+	double		time;					/* time covered */
+	double		timeslice;				/* current timeslice period */
+	UINT64		slices;					/* timeslices run */
+	UINT64		events;					/* cross-CPU communication events */
+};
+
+/* Returns the scheduler statistics */
+void cpu_get_sched_stats(struct cpu_sched_stats *stats);
+
 /* Backwards compatibility */
 #define timer_suspendcpu(cpunum, suspend, reason)	do { if (suspend) cpunum_suspend(cpunum, reason, 1); else cpunum_resume(cpunum, reason); } while (0)
 #define timer_holdcpu(cpunum, suspend, reason)		do { if (suspend) cpunum_suspend(cpunum, reason, 0); else cpunum_resume(cpunum, reason); } while (0)
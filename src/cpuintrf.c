@@ -353,6 +353,23 @@ static unsigned dummy_dasm(char *buffer, unsigned pc);
 		shift, bits, CPU_IS_##endian, align, maxinst							   \
 	}
 
+/* CPU0 for cores that run on a context pointer */
+#define CPU5(cpu,name,nirq,dirq,oc,datawidth,mem,shift,bits,endian,align,maxinst) \
+	{																			   \
+		CPU_##cpu,																   \
+		name##_init, name##_reset, name##_exit, name##_execute, NULL,			   \
+		name##_get_context, name##_set_context, NULL, NULL, 					   \
+		name##_get_reg, name##_set_reg,			   \
+		name##_set_irq_line, name##_set_irq_callback,		   \
+		name##_info, name##_dasm, 										   \
+		nirq, dirq, &name##_ICount, oc, 							   \
+		datawidth,																   \
+		(mem_read_handler)cpu_readmem##mem, (mem_write_handler)cpu_writemem##mem, NULL, NULL,						   \
+		0, cpu_setopbase##mem,													   \
+		shift, bits, CPU_IS_##endian, align, maxinst,							   \
+		name##_set_context_ptr													   \
+	}
+
 /* CPUs which have the _burn function */
 #define CPU1(cpu,name,nirq,dirq,oc,datawidth,mem,shift,bits,endian,align,maxinst)	 \
 	{																			   \
@@ -546,25 +563,25 @@ const struct cpu_interface cpuintrf[] =
 #endif
 
 #if (HAS_M6800)
-	CPU0(M6800,    m6800,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(M6800,    m6800,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6801)
-	CPU0(M6801,    m6801,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(M6801,    m6801,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6802)
-	CPU0(M6802,    m6802,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(M6802,    m6802,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6803)
-	CPU0(M6803,    m6803,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(M6803,    m6803,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6808)
-	CPU0(M6808,    m6808,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(M6808,    m6808,	 1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_HD63701)
-	CPU0(HD63701,  hd63701,  1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(HD63701,  hd63701,  1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_NSC8105)
-	CPU0(NSC8105,  nsc8105,  1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
+	CPU5(NSC8105,  nsc8105,  1,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6805)
 	CPU0(M6805,    m6805,	 1,  0,1.00, 8, 16,	  0,11,BE,1, 3	),
@@ -579,7 +596,7 @@ const struct cpu_interface cpuintrf[] =
 	CPU0(HD6309,   hd6309,	 2,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
 #endif
 #if (HAS_M6809)
-	CPU0(M6809,    m6809,	 2,  0,1.00, 8, 16,	  0,16,BE,1, 5	),
+	CPU5(M6809,    m6809,	 2,  0,1.00, 8, 16,	  0,16,BE,1, 5	),
 #endif
 #if (HAS_KONAMI)
 	CPU0(KONAMI,   konami,	 2,  0,1.00, 8, 16,	  0,16,BE,1, 4	),
@@ -832,8 +849,9 @@ INLINE void set_cpu_context(int cpunum)
 	int newfamily = cpu[cpunum].family;
 	int oldcontext = cpu_active_context[newfamily];
 
-	/* if we need to change contexts, save the one that was there */
-	if (oldcontext != cpunum && oldcontext != -1)
+	/* if we need to change contexts, save the one that was there; */
+	/* cores running on a context pointer already work in place */
+	if (oldcontext != cpunum && oldcontext != -1 && !cpu[oldcontext].intf.set_context_ptr)
 		(*cpu[oldcontext].intf.get_context)(cpu[oldcontext].context);
 
 	/* swap memory spaces */
@@ -843,7 +861,13 @@ INLINE void set_cpu_context(int cpunum)
 	/* if the new CPU's context is not swapped in, do it now */
 	if (oldcontext != cpunum)
 	{
-		(*cpu[cpunum].intf.set_context)(cpu[cpunum].context);
+		if (cpu[cpunum].intf.set_context_ptr)
+		{
+			(*cpu[cpunum].intf.set_context_ptr)(cpu[cpunum].context);
+			(*cpu[cpunum].intf.set_context)(NULL);
+		}
+		else
+			(*cpu[cpunum].intf.set_context)(cpu[cpunum].context);
 		cpu_active_context[newfamily] = cpunum;
 	}
 }
@@ -971,10 +995,14 @@ int cpuintrf_init_cpu(int cpunum, int cputype)
 	/* zap the context buffer */
 	memset(cpu[cpunum].context, 0, size);
 
-	/* initialize the CPU and stash the context */
+	/* initialize the CPU and stash the context; pointer based cores */
+	/* initialize (and register their state) right in the buffer */
 	activecpu = cpunum;
+	if (cpu[cpunum].intf.set_context_ptr)
+		(*cpu[cpunum].intf.set_context_ptr)(cpu[cpunum].context);
 	(*cpu[cpunum].intf.init)();
-	(*cpu[cpunum].intf.get_context)(cpu[cpunum].context);
+	if (!cpu[cpunum].intf.set_context_ptr)
+		(*cpu[cpunum].intf.get_context)(cpu[cpunum].context);
 	activecpu = -1;
 
 	/* clear out the registered CPU for this family */
@@ -1000,6 +1028,10 @@ void cpuintrf_exit_cpu(int cpunum)
 	if (cpu[cpunum].intf.exit)
 		(*cpu[cpunum].intf.exit)();
 
+	/* pointer based cores must not keep running on the buffer */
+	if (cpu[cpunum].intf.set_context_ptr)
+		(*cpu[cpunum].intf.set_context_ptr)(NULL);
+
 	/* free the context buffer for that CPU */
 	if (cpu[cpunum].context)
 		free(cpu[cpunum].context);
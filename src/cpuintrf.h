@@ -508,6 +508,10 @@ struct cpu_interface
 	unsigned	endianess;
 	unsigned	align_unit;
 	unsigned	max_inst_len;
+
+	/* optional: run in place on a context buffer, so switching is a pointer */
+	/* swap; set_context(NULL) is called afterwards to finish the switch */
+	void		(*set_context_ptr)(void *reg);
 };
 
 
@@ -46,19 +46,59 @@
 #define FILEFLAG_VERIFY_ONLY	0x10
 #define FILEFLAG_NOZIP			0x20
 
+/* ROM verification cache, stored in the cfg folder */
+#define VERIFY_CACHE_NAME		"romverify"
+#define VERIFY_CACHE_BUCKETS	4096
+#define VERIFY_CACHE_ALL		((1 << HASH_NUM_FUNCTIONS) - 1)
+
 
 #ifdef MAME_DEBUG
 #define DEBUG_COOKIE			0xbaadf00d
 #endif
 
 
+/***************************************************************************
+	TYPE DEFINITIONS
+***************************************************************************/
+
+/* hashes of a ROM file, valid as long as the file's size, timestamp and
+   (for ZIP members) central directory CRC are unchanged */
+typedef struct _verify_cache_entry verify_cache_entry;
+struct _verify_cache_entry
+{
+	verify_cache_entry *next;
+	char *name;				/* rompath relative file, or "zip|member" */
+	UINT64 size;
+	INT64 mtime;
+	UINT32 zipcrc;
+	UINT8 saved;			/* already written to the cache file */
+	char hash[HASH_BUF_SIZE];
+};
+
+
+
+/***************************************************************************
+	GLOBAL VARIABLES
+***************************************************************************/
+
+static verify_cache_entry *verify_cache[VERIFY_CACHE_BUCKETS];
+static int verify_cache_loaded;
+static int verify_cache_dirty;
+static int verify_cache_rewrite;
+
+
+
 /***************************************************************************
 	PROTOTYPES
 ***************************************************************************/
 
 static mame_file *generic_fopen(int pathtype, const char *gamename, const char *filename, const char* hash, UINT32 flags);
 static const char *get_extension_for_filetype(int filetype);
-static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **p, UINT64 *size, char* hash);
+static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **p, UINT64 *size, char* hash, const char* cached);
+static int zipped_file_load(mame_file *file);
+static unsigned verify_cache_functions(const char *hash);
+static const char *verify_cache_find(const char *name, UINT64 size, INT64 mtime, UINT32 zipcrc, unsigned functions);
+static void verify_cache_store(const char *name, UINT64 size, INT64 mtime, UINT32 zipcrc, const char *hash);
 
 
 /***************************************************************************
@@ -214,6 +254,28 @@ mame_file *mame_fopen_rom(const char *gamename, const char *filename, const char
 }
 
 
+/***************************************************************************
+	mame_fopen_ram
+***************************************************************************/
+
+/* Empty in-memory file that grows as it is written, e.g. to capture what an
+   nvram_handler saves; mame_fdata() returns the contents */
+mame_file *mame_fopen_ram(void)
+{
+	mame_file *file = malloc(sizeof(*file));
+	if (file)
+	{
+		memset(file, 0, sizeof(*file));
+		file->type = RAM_FILE;
+#ifdef DEBUG_COOKIE
+		file->debug_cookie = DEBUG_COOKIE;
+#endif
+	}
+	return file;
+}
+
+
+
 /***************************************************************************
 	mame_fclose
 ***************************************************************************/
@@ -234,8 +296,10 @@ void mame_fclose(mame_file *file)
 
 		case ZIPPED_FILE:
 		case RAM_FILE:
-			if (file->data)
+			if (file->data && !file->mapped)
 				free(file->data);
+			if (file->zipmap)
+				zipmap_close(file->zipmap);
 			break;
 	}
 
@@ -320,6 +384,20 @@ UINT32 mame_fread(mame_file *file, void *buffer, size_t length)
 			return osd_fread(file->file, buffer, length);
 
 		case ZIPPED_FILE:
+			/* a member read whole is inflated straight into the caller's buffer */
+			if (!file->data && file->zipent && file->offset == 0 && length >= file->length)
+			{
+				if (zipmap_read(file->zipmap, file->zipent, buffer) != 0)
+					return 0;
+				if (length > file->length)
+					file->eof = 1;
+				file->offset = file->length;
+				return file->length;
+			}
+			if (zipped_file_load(file) != 0)
+				return 0;
+			/* fall through */
+
 		case RAM_FILE:
 			if (file->data)
 			{
@@ -481,6 +559,18 @@ const char* mame_fhash(mame_file *file)
 
 
 
+/***************************************************************************
+	mame_fdata
+***************************************************************************/
+
+/* Contents of a RAM file, NULL for anything else or if nothing was written */
+const UINT8 *mame_fdata(mame_file *file)
+{
+	return (file->type == RAM_FILE) ? file->data : NULL;
+}
+
+
+
 /***************************************************************************
 	mame_fgetc
 ***************************************************************************/
@@ -497,8 +587,12 @@ int mame_fgetc(mame_file *file)
 				return buffer;
 			return EOF;
 
-		case RAM_FILE:
 		case ZIPPED_FILE:
+			if (zipped_file_load(file) != 0)
+				return EOF;
+			/* fall through */
+
+		case RAM_FILE:
 			if (file->offset < file->length)
 				return file->data[file->offset++];
 			else
@@ -883,8 +977,27 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 			/* if we need checksums, load it into RAM and compute it along the way */
 			if (flags & FILEFLAG_HASH)
 			{
-				if (checksum_file(pathtype, pathindex, name, &file.data, &file.length, file.hash) == 0)
+				UINT64 size;
+				INT64 mtime;
+				const char *cached = NULL;
+
+				/* checksum_file() computes every function for plain files */
+				if (osd_get_file_stamp(pathtype, pathindex, name, &size, &mtime) == 0)
+					cached = verify_cache_find(name, size, mtime, 0, VERIFY_CACHE_ALL);
+
+				/* verify-only with a cache hit: no need to read the file at all */
+				if (cached && (flags & FILEFLAG_VERIFY_ONLY))
+				{
+					hash_data_copy(file.hash, cached);
+					file.length = size;
+					file.type = RAM_FILE;
+					break;
+				}
+
+				if (checksum_file(pathtype, pathindex, name, &file.data, &file.length, file.hash, cached) == 0)
 				{
+					if (!cached && file.length == size)
+						verify_cache_store(name, size, mtime, 0, file.hash);
 					file.type = RAM_FILE;
 					break;
 				}
@@ -956,41 +1069,113 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 				/* full load case */
 				else
 				{
+					UINT64 zipsize;
+					INT64 zipmtime;
+					UINT32 expcrc = 0, zipcrc;
+					unsigned functions = verify_cache_functions(hash);
+					const char *cached = NULL;
+					char key[1024];
+					ZIPMAP *map;
 					int err;
 
-					/* Try loading the file */
-					err = load_zipped_file(pathtype, pathindex, name, tempname, &file.data, &ziplength);
+					/* look up the member's hashes, keyed by the ZIP's stamp and
+					   the CRC recorded in its central directory */
+					if (hash)
+					{
+						UINT8 crcs[4];
+						if (hash_data_extract_binary_checksum(hash, HASH_CRC, crcs) != 0)
+							expcrc = ((UINT32)crcs[0] << 24) | ((UINT32)crcs[1] << 16) | ((UINT32)crcs[2] << 8) | crcs[3];
+					}
+					zipcrc = expcrc;
+					sprintf(key, "%s|%s", name, tempname);
+					if (osd_get_file_stamp(pathtype, pathindex, name, &zipsize, &zipmtime) != 0 ||
+						checksum_zipped_file(pathtype, pathindex, name, tempname, &ziplength, &zipcrc) != 0)
+						zipcrc = 0;
+					else
+						cached = verify_cache_find(key, zipsize, zipmtime, zipcrc, functions);
+
+					/* A mapped ZIP doesn't read the member yet: stored members are
+					   used in place, deflated ones are inflated on the first read */
+					map = zipmap_open(pathtype, pathindex, name);
+					if (map)
+					{
+						file.zipent = zipmap_find(map, tempname);
+						if (!file.zipent)
+							file.zipent = zipmap_find_crc(map, expcrc);
+
+						if (file.zipent)
+						{
+							file.zipmap = map;
+							file.data = (UINT8 *)zipmap_stored(map, file.zipent);
+							file.mapped = file.data != NULL;
+							ziplength = file.zipent->uncompressed_size;
+							err = 0;
+						}
+						else
+						{
+							zipmap_close(map);
+							err = -1;
+						}
+					}
 
-					/* If it failed, since this is a ZIP file, we can try to load by CRC 
-					   if an expected hash has been provided. unzip.c uses this ugly hack 
-					   of specifying the CRC as filename. */
-					if (err && hash)
+					/* Try loading the file */
+					else
 					{
-						char crcn[9];
+						err = load_zipped_file(pathtype, pathindex, name, tempname, &file.data, &ziplength);
+
+						/* If it failed, since this is a ZIP file, we can try to load by CRC 
+						   if an expected hash has been provided. unzip.c uses this ugly hack 
+						   of specifying the CRC as filename. */
+						if (err && hash)
+						{
+							char crcn[9];
 
-						hash_data_extract_printable_checksum(hash, HASH_CRC, crcn);
+							hash_data_extract_printable_checksum(hash, HASH_CRC, crcn);
 
-						err = load_zipped_file(pathtype, pathindex, name, crcn, &file.data, &ziplength);
+							err = load_zipped_file(pathtype, pathindex, name, crcn, &file.data, &ziplength);
+						}
 					}
 
 					if (err == 0)
 					{
-						unsigned functions;
-
 						LOG(("Using (mame_fopen) zip file for %s\n", filename));
 						file.length = ziplength;
 						file.type = ZIPPED_FILE;
+
 						/* Since we already loaded the file, we can easily calculate the
 						   checksum of all the functions. In practice, we use only the
-						   functions for which we have an expected checksum to compare with. */
-						functions = hash_data_used_functions(hash);
-
-						/* If user asked for CRC only, and there is an expected checksum
-						   for CRC in the driver, compute only CRC. */
-						if (options.crc_only && (functions & HASH_CRC))
-							functions = HASH_CRC;
-
-						hash_compute(file.hash, file.data, file.length, functions);
+						   functions for which we have an expected checksum to compare with
+						   (see verify_cache_functions()), and nothing at all if the cache
+						   still holds them. */
+						if (cached)
+							hash_data_copy(file.hash, cached);
+
+						/* If only the CRC is wanted, trust the one in the central
+						   directory instead of computing it */
+						else if (functions == HASH_CRC && zipcrc && !options.full_verify)
+						{
+							UINT8 crcs[4];
+							crcs[0] = (UINT8)(zipcrc >> 24);
+							crcs[1] = (UINT8)(zipcrc >> 16);
+							crcs[2] = (UINT8)(zipcrc >> 8);
+							crcs[3] = (UINT8)(zipcrc >> 0);
+							hash_data_clear(file.hash);
+							hash_data_insert_binary_checksum(file.hash, HASH_CRC, crcs);
+						}
+						else if (zipped_file_load(&file) == 0)
+						{
+							hash_compute(file.hash, file.data, file.length, functions);
+							if (zipcrc)
+								verify_cache_store(key, zipsize, zipmtime, zipcrc, file.hash);
+						}
+
+						/* a member that can't be inflated isn't found here */
+						else
+						{
+							zipmap_close(file.zipmap);
+							memset(&file, 0, sizeof(file));
+							continue;
+						}
 						break;
 					}
 				}
@@ -1017,11 +1202,39 @@ static mame_file *generic_fopen(int pathtype, const char *gamename, const char *
 
 
 
+/***************************************************************************
+	zipped_file_load
+***************************************************************************/
+
+static int zipped_file_load(mame_file *file)
+{
+	UINT8 *data;
+
+	/* already in memory */
+	if (file->data || !file->zipent)
+		return 0;
+
+	data = malloc(file->length ? file->length : 1);
+	if (!data)
+		return -1;
+
+	if (zipmap_read(file->zipmap, file->zipent, data) != 0)
+	{
+		free(data);
+		return -1;
+	}
+
+	file->data = data;
+	return 0;
+}
+
+
+
 /***************************************************************************
 	checksum_file
 ***************************************************************************/
 
-static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **p, UINT64 *size, char* hash)
+static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **p, UINT64 *size, char* hash, const char* cached)
 {
 	UINT64 length;
 	UINT8 *data;
@@ -1073,11 +1286,17 @@ static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **
 	*size = length;
 	/* compute the checksums (only the functions for which we have an expected
 	   checksum). Take also care of crconly: if the user asked, we will calculate
-	   only the CRC, but only if there is an expected CRC for this file. */
-	functions = hash_data_used_functions(hash);
-	if (options.crc_only && (functions & HASH_CRC))
-		functions = HASH_CRC;
-	hash_compute(hash, data, length, functions);
+	   only the CRC, but only if there is an expected CRC for this file. Skip
+	   all of it if the verification cache already knows them. */
+	if (cached)
+		hash_data_copy(hash, cached);
+	else
+	{
+		functions = hash_data_used_functions(hash);
+		if (options.crc_only && (functions & HASH_CRC))
+			functions = HASH_CRC;
+		hash_compute(hash, data, length, functions);
+	}
 
 	/* if the caller wants the data, give it away, otherwise free it */
 	if (p)
@@ -1089,6 +1308,294 @@ static int checksum_file(int pathtype, int pathindex, const char *file, UINT8 **
 	osd_fclose(f);
 	return 0;
 }
+
+
+
+/***************************************************************************
+	verify_cache_functions - the hash functions
+	generic_fopen() computes for a given
+	expected hash
+***************************************************************************/
+
+static unsigned verify_cache_functions(const char *hash)
+{
+	unsigned functions = hash_data_used_functions(hash);
+
+	if (options.crc_only && (functions & HASH_CRC))
+		functions = HASH_CRC;
+
+	/* zero means all of them to hash_compute() */
+	return functions ? functions : VERIFY_CACHE_ALL;
+}
+
+
+
+/***************************************************************************
+	verify_cache_bucket
+***************************************************************************/
+
+static verify_cache_entry **verify_cache_bucket(const char *name)
+{
+	UINT32 h = 5381;
+
+	while (*name)
+		h = h * 33 + (UINT8)*name++;
+	return &verify_cache[h % VERIFY_CACHE_BUCKETS];
+}
+
+
+
+/***************************************************************************
+	verify_cache_insert
+***************************************************************************/
+
+static verify_cache_entry *verify_cache_insert(const char *name, UINT64 size, INT64 mtime, UINT32 zipcrc, const char *hash)
+{
+	verify_cache_entry **bucket = verify_cache_bucket(name);
+	verify_cache_entry *entry;
+
+	for (entry = *bucket; entry; entry = entry->next)
+		if (!strcmp(entry->name, name))
+			break;
+
+	if (!entry)
+	{
+		entry = malloc(sizeof(*entry));
+		if (!entry)
+			return NULL;
+		entry->name = malloc(strlen(name) + 1);
+		if (!entry->name)
+		{
+			free(entry);
+			return NULL;
+		}
+		strcpy(entry->name, name);
+		entry->next = *bucket;
+		*bucket = entry;
+	}
+
+	entry->size = size;
+	entry->mtime = mtime;
+	entry->zipcrc = zipcrc;
+	entry->saved = 0;
+	hash_data_copy(entry->hash, hash);
+	return entry;
+}
+
+
+
+/***************************************************************************
+	verify_cache_load - read the cache file; later
+	lines replace earlier ones for the same file
+***************************************************************************/
+
+static UINT64 verify_cache_parse_hex(const char *s, int digits)
+{
+	UINT64 value = 0;
+
+	while (digits--)
+	{
+		char c = *s++;
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+			value |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			value |= c - 'A' + 10;
+	}
+	return value;
+}
+
+static void verify_cache_load(void)
+{
+	mame_file *file;
+	char *data, *line, *next;
+	UINT64 length;
+	int lines = 0, entries = 0;
+	int i;
+
+	verify_cache_loaded = 1;
+
+	/* without a readable file the first flush creates it from scratch,
+	   appending needs an existing file */
+	file = mame_fopen(VERIFY_CACHE_NAME, NULL, FILETYPE_CONFIG, 0);
+	if (!file)
+	{
+		verify_cache_rewrite = 1;
+		return;
+	}
+
+	length = mame_fsize(file);
+	data = malloc((size_t)length + 1);
+	if (!data || mame_fread(file, data, (size_t)length) != length)
+	{
+		free(data);
+		mame_fclose(file);
+		verify_cache_rewrite = 1;
+		return;
+	}
+	mame_fclose(file);
+	data[length] = 0;
+
+	/* each line is "size mtime zipcrc hash name" with fixed width hex numbers */
+	for (line = data; *line; line = next)
+	{
+		char *hash, *name, *end;
+		verify_cache_entry *entry;
+
+		next = strchr(line, '\n');
+		if (next)
+			*next++ = 0;
+		else
+			next = line + strlen(line);
+		if (line[0] && line[strlen(line) - 1] == '\r')
+			line[strlen(line) - 1] = 0;
+
+		lines++;
+		if (strlen(line) < 16 + 1 + 16 + 1 + 8 + 1 || line[16] != ' ' || line[33] != ' ' || line[42] != ' ')
+			continue;
+		hash = line + 43;
+		end = strchr(hash, ' ');
+		if (!end || end - hash >= HASH_BUF_SIZE)
+			continue;
+		*end = 0;
+		name = end + 1;
+		if (!*name || !hash_verify_string(hash))
+			continue;
+
+		entry = verify_cache_insert(name, verify_cache_parse_hex(line, 16), (INT64)verify_cache_parse_hex(line + 17, 16),
+			(UINT32)verify_cache_parse_hex(line + 34, 8), hash);
+		if (entry)
+			entry->saved = 1;
+	}
+	free(data);
+
+	/* compact the file once stale lines outnumber the live ones */
+	for (i = 0; i < VERIFY_CACHE_BUCKETS; i++)
+	{
+		verify_cache_entry *entry;
+		for (entry = verify_cache[i]; entry; entry = entry->next)
+			entries++;
+	}
+	if (lines > 2 * entries + 64)
+		verify_cache_rewrite = verify_cache_dirty = 1;
+}
+
+
+
+/***************************************************************************
+	verify_cache_find - return the cached hashes
+	of a file if they are still valid and hold
+	all the requested functions
+***************************************************************************/
+
+static const char *verify_cache_find(const char *name, UINT64 size, INT64 mtime, UINT32 zipcrc, unsigned functions)
+{
+	verify_cache_entry *entry;
+
+	if (options.full_verify)
+		return NULL;
+
+	if (!verify_cache_loaded)
+		verify_cache_load();
+
+	for (entry = *verify_cache_bucket(name); entry; entry = entry->next)
+		if (!strcmp(entry->name, name))
+		{
+			if (entry->size != size || entry->mtime != mtime || entry->zipcrc != zipcrc)
+				return NULL;
+			if ((hash_data_used_functions(entry->hash) & functions) != functions)
+				return NULL;
+			return entry->hash;
+		}
+
+	return NULL;
+}
+
+
+
+/***************************************************************************
+	verify_cache_store
+***************************************************************************/
+
+static void verify_cache_store(const char *name, UINT64 size, INT64 mtime, UINT32 zipcrc, const char *hash)
+{
+	if (!verify_cache_loaded)
+		verify_cache_load();
+
+	if (verify_cache_insert(name, size, mtime, zipcrc, hash))
+		verify_cache_dirty = 1;
+}
+
+
+
+/***************************************************************************
+	mame_fverify_cache_flush - append the hashes
+	computed since the last flush to the cache
+	file
+***************************************************************************/
+
+void mame_fverify_cache_flush(void)
+{
+	mame_file *file;
+	int i;
+
+	if (!verify_cache_dirty)
+		return;
+
+	if (verify_cache_rewrite)
+		file = generic_fopen(FILETYPE_CONFIG, NULL, VERIFY_CACHE_NAME, 0, FILEFLAG_OPENWRITE);
+	else
+		file = generic_fopen(FILETYPE_CONFIG, NULL, VERIFY_CACHE_NAME, 0, FILEFLAG_OPENREAD | FILEFLAG_OPENWRITE);
+	if (!file)
+		return;
+	mame_fseek(file, 0, SEEK_END);
+
+	for (i = 0; i < VERIFY_CACHE_BUCKETS; i++)
+	{
+		verify_cache_entry *entry;
+		for (entry = verify_cache[i]; entry; entry = entry->next)
+			if (!entry->saved || verify_cache_rewrite)
+			{
+				mame_fprintf(file, "%08x%08x %08x%08x %08x %s %s\n",
+					(UINT32)(entry->size >> 32), (UINT32)entry->size,
+					(UINT32)((UINT64)entry->mtime >> 32), (UINT32)entry->mtime,
+					entry->zipcrc, entry->hash, entry->name);
+				entry->saved = 1;
+			}
+	}
+
+	mame_fclose(file);
+	verify_cache_dirty = verify_cache_rewrite = 0;
+}
+
+
+
+/***************************************************************************
+	mame_freplace - write a whole file by
+	replacing the existing one atomically;
+	doesn't use the OSD file table, so it can
+	be called from any thread
+***************************************************************************/
+
+int mame_freplace(int filetype, const char *filename, const void *data, UINT32 length)
+{
+	int pathcount = osd_get_path_count(filetype);
+	int pathindex;
+	char name[1024];
+
+	compose_path(name, NULL, filename, get_extension_for_filetype(filetype));
+
+	/* first path that takes it wins, like generic_fopen() for writing */
+	for (pathindex = 0; pathindex < pathcount; pathindex++)
+		if (osd_replace_file(filetype, pathindex, name, data, length) == 0)
+			return 0;
+	return 1;
+}
+
+
+
 /***************************************************************************
 	mame_fputs
 ***************************************************************************/
@@ -72,6 +72,9 @@ struct _mame_file
 	UINT64 length;
 	UINT8 eof;
 	UINT8 type;
+	UINT8 mapped;						/* data points into zipmap */
+	struct _ZIPMAP *zipmap;				/* mapped ZIP holding the member */
+	const struct zipent *zipent;		/* member, inflated on first read */
 	char hash[HASH_BUF_SIZE];
 };
 
@@ -85,6 +88,7 @@ typedef struct _mame_file mame_file;
 int mame_faccess(const char *filename, int filetype);
 mame_file *mame_fopen(const char *gamename, const char *filename, int filetype, int openforwrite);
 mame_file *mame_fopen_rom(const char *gamename, const char *filename, const char* exphash);
+mame_file *mame_fopen_ram(void);
 UINT32 mame_fread(mame_file *file, void *buffer, size_t length);
 UINT32 mame_fwrite(mame_file *file, const void *buffer, size_t length);
 UINT32 mame_fread_swap(mame_file *file, void *buffer, size_t length);
@@ -105,6 +109,9 @@ void mame_fclose(mame_file *file);
 int mame_fchecksum(const char *gamename, const char *filename, unsigned int *length, char* hash);
 UINT64 mame_fsize(mame_file *file);
 const char *mame_fhash(mame_file *file);
+const UINT8 *mame_fdata(mame_file *file);
+void mame_fverify_cache_flush(void);
+int mame_freplace(int filetype, const char *filename, const void *data, UINT32 length);
 int mame_fgetc(mame_file *file);
 int mame_ungetc(int c, mame_file *file);
 char *mame_fgets(char *s, int n, mame_file *file);
@@ -0,0 +1,382 @@
+// license:BSD-3-Clause
+
+// Emulation throughput benchmark: runs a list of games unthrottled for a
+// fixed emulated time, with sound and display output on or off, reports
+// the results as JSON and fails when a game got slower than the baseline.
+// Without sound the sound CPUs aren't emulated either, like -nosound.
+//
+// pinmame_bench [-p vpmPath] [-s seconds] [-c full,sound,video,bare]
+//               [-o results.json] [-b baseline.json] [-t percent]
+//               [generation=]game ...
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include "libpinmame.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+typedef struct {
+	const char* p_name;
+	bool sound;
+	bool video;
+} BenchConfig;
+
+typedef struct {
+	std::string generation;
+	std::string game;
+	const BenchConfig* p_config;
+	PINMAME_STATUS status;
+	PinmamePerfStats stats;
+	uint64_t peakRssKb;
+} BenchResult;
+
+static const BenchConfig _configs[] = {
+	{ "full", true, true },
+	{ "sound", true, false },
+	{ "video", false, true },
+	{ "bare", false, false },
+};
+
+// one game per hardware generation
+static const char* const _defaultGames[] = {
+	"S11=taxi_l4",
+	"WPC=fh_l9",
+	"WPC95/DCS=mm_109c",
+	"DE=lw3_208",
+	"Whitestar=lotr",
+	"GTS3=sfight2",
+	"SAM=wof_500",
+	"Capcom=bsv103",
+	"BY35=eballd14",
+};
+
+static volatile uint64_t _displayBytes;
+
+void PINMAMECALLBACK OnDisplayUpdated(int index, void* p_displayData, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+	// look at the frame the way a client would, so it isn't free
+	if (p_displayData)
+		_displayBytes += ((const uint8_t*)p_displayData)[0];
+}
+
+int PINMAMECALLBACK OnAudioAvailable(PinmameAudioInfo* p_audioInfo, const void* p_userData)
+{
+	return p_audioInfo->samplesPerFrame;
+}
+
+int PINMAMECALLBACK OnAudioUpdated(void* p_buffer, int samples, const void* p_userData)
+{
+	return samples;
+}
+
+void PINMAMECALLBACK OnLogMessage(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData)
+{
+	if (logLevel == PINMAME_LOG_LEVEL_ERROR) {
+		char buffer[1024];
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		fprintf(stderr, "ERROR: %s\n", buffer);
+	}
+}
+
+// Peak resident set of the process. On Linux it is reset before each run,
+// elsewhere it is the peak of all runs so far
+static void ResetPeakRss()
+{
+#if defined(__linux__)
+	FILE* p_file = fopen("/proc/self/clear_refs", "w");
+
+	if (p_file) {
+		fputs("5", p_file);
+		fclose(p_file);
+	}
+#endif
+}
+
+static uint64_t GetPeakRssKb()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize / 1024;
+#elif defined(__linux__)
+	FILE* p_file = fopen("/proc/self/status", "r");
+	char line[256];
+	unsigned long long kb = 0;
+
+	if (!p_file)
+		return 0;
+	while (fgets(line, sizeof(line), p_file))
+		if (sscanf(line, "VmHWM: %llu kB", &kb) == 1)
+			break;
+	fclose(p_file);
+	return kb;
+#else
+	struct rusage usage;
+
+	getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static BenchResult Run(const std::string& vpmPath, const std::string& generation, const std::string& game, const BenchConfig* p_config, double seconds)
+{
+	BenchResult result = { generation, game, p_config, PINMAME_STATUS_OK };
+	memset(&result.stats, 0, sizeof(result.stats));
+
+	PinmameConfig config = {
+		PINMAME_AUDIO_FORMAT_INT16,
+		p_config->sound ? 48000 : 0,
+		"",
+		nullptr,
+		nullptr,
+		p_config->video ? &OnDisplayUpdated : nullptr,
+		p_config->sound ? &OnAudioAvailable : nullptr,
+		p_config->sound ? &OnAudioUpdated : nullptr,
+		nullptr,
+		nullptr,
+		nullptr,
+		nullptr,
+		nullptr,
+		&OnLogMessage,
+		nullptr,
+	};
+	snprintf((char*)config.vpmPath, PINMAME_MAX_PATH, "%s", vpmPath.c_str());
+
+	PinmameSetConfig(&config);
+	PinmameSetHandleKeyboard(0);
+	PinmameSetHandleMechanics(0);
+	PinmameSetSoundMode(PINMAME_SOUND_MODE_DEFAULT);
+	PinmameSetThrottle(0);
+
+	ResetPeakRss();
+
+	result.status = PinmameRun(game.c_str());
+	if (result.status != PINMAME_STATUS_OK)
+		return result;
+
+	while (!PinmameIsRunning())
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	while (PinmameIsRunning()) {
+		if (PinmameGetPerfStats(&result.stats) == PINMAME_STATUS_OK && result.stats.emulatedTime >= seconds)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	result.peakRssKb = GetPeakRssKb();
+
+	PinmameStop();
+	while (PinmameIsRunning())
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	if (result.stats.emulatedTime < seconds)
+		result.status = PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	return result;
+}
+
+static double Speed(const BenchResult& result)
+{
+	return (result.stats.hostTime > 0) ? result.stats.emulatedTime / result.stats.hostTime : 0;
+}
+
+// One result per line, so the baseline can be read back without a JSON parser
+static void WriteResult(FILE* p_file, const BenchResult& result, bool last)
+{
+	const PinmamePerfStats& stats = result.stats;
+	const int cpus = (stats.cpus < PINMAME_MAX_CPUS) ? stats.cpus : PINMAME_MAX_CPUS;
+	uint64_t measuredNs = stats.mixerNs + stats.pwmNs + stats.displayNs + stats.throttleNs;
+
+	fprintf(p_file, "    { \"game\": \"%s\", \"generation\": \"%s\", \"config\": \"%s\", \"status\": %d, \"speed\": %.4f, \"emulated\": %.4f, \"host\": %.4f, ",
+		result.game.c_str(), result.generation.c_str(), result.p_config->p_name, result.status, Speed(result), stats.emulatedTime, stats.hostTime);
+
+	fprintf(p_file, "\"cpuNs\": [");
+	for (int i = 0; i < cpus; i++) {
+		fprintf(p_file, "%s%llu", i ? ", " : "", (unsigned long long)stats.cpuNs[i]);
+		measuredNs += stats.cpuNs[i];
+	}
+	fprintf(p_file, "], \"cpuCycles\": [");
+	for (int i = 0; i < cpus; i++)
+		fprintf(p_file, "%s%llu", i ? ", " : "", (unsigned long long)stats.cpuCycles[i]);
+
+	const uint64_t hostNs = (uint64_t)(stats.hostTime * 1e9);
+
+	fprintf(p_file, "], \"timerCallbacks\": %llu, \"mixerNs\": %llu, \"pwmNs\": %llu, \"displayNs\": %llu, \"throttleNs\": %llu, \"otherNs\": %llu, \"peakRssKb\": %llu }%s\n",
+		(unsigned long long)stats.timerCallbacks,
+		(unsigned long long)stats.mixerNs,
+		(unsigned long long)stats.pwmNs,
+		(unsigned long long)stats.displayNs,
+		(unsigned long long)stats.throttleNs,
+		(unsigned long long)((hostNs > measuredNs) ? hostNs - measuredNs : 0),
+		(unsigned long long)result.peakRssKb,
+		last ? "" : ",");
+}
+
+static bool GetString(const char* p_line, const char* p_key, std::string& value)
+{
+	const char* p = strstr(p_line, p_key);
+
+	if (!p || !(p = strchr(p + strlen(p_key), '"')))
+		return false;
+
+	const char* p_end = strchr(++p, '"');
+	if (!p_end)
+		return false;
+
+	value.assign(p, p_end - p);
+	return true;
+}
+
+// Compares against a previous output, returns the number of regressions
+static int Compare(const char* p_baseline, const std::vector<BenchResult>& results, double threshold)
+{
+	FILE* p_file = fopen(p_baseline, "r");
+	char line[4096];
+	int regressions = 0;
+
+	if (!p_file) {
+		fprintf(stderr, "Can't read baseline %s\n", p_baseline);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), p_file)) {
+		std::string game, config;
+		const char* p_speed = strstr(line, "\"speed\":");
+		double speed;
+
+		if (!GetString(line, "\"game\":", game) || !GetString(line, "\"config\":", config) || !p_speed || sscanf(p_speed + 8, "%lf", &speed) != 1 || speed <= 0)
+			continue;
+
+		for (const BenchResult& result : results) {
+			if (result.game != game || config != result.p_config->p_name || result.status != PINMAME_STATUS_OK)
+				continue;
+
+			const double change = (Speed(result) / speed - 1.0) * 100.0;
+			const bool regressed = change < -threshold;
+
+			fprintf(stderr, "%-10s %-5s %8.2fx -> %8.2fx %+6.1f%%%s\n", game.c_str(), config.c_str(), speed, Speed(result), change, regressed ? "  REGRESSION" : "");
+			if (regressed)
+				regressions++;
+		}
+	}
+
+	fclose(p_file);
+	return regressions;
+}
+
+static int Usage()
+{
+	fprintf(stderr, "usage: pinmame_bench [-p vpmPath] [-s seconds] [-c full,sound,video,bare] [-o results.json] [-b baseline.json] [-t percent] [generation=]game ...\n");
+	return 2;
+}
+
+int main(int argc, char** argv)
+{
+	std::string vpmPath;
+	double seconds = 30.0;
+	std::string configs = "full,bare";
+	const char* p_output = nullptr;
+	const char* p_baseline = nullptr;
+	double threshold = 10.0;
+	std::vector<std::string> games;
+
+#if defined(_WIN32) || defined(_WIN64)
+	vpmPath = std::string(getenv("HOMEDRIVE") ? getenv("HOMEDRIVE") : "") + (getenv("HOMEPATH") ? getenv("HOMEPATH") : "") + "\\pinmame\\";
+#else
+	vpmPath = std::string(getenv("HOME") ? getenv("HOME") : "") + "/.pinmame/";
+#endif
+
+	for (int i = 1; i < argc; i++) {
+		const bool hasValue = (i + 1 < argc);
+
+		if (!strcmp(argv[i], "-p") && hasValue)
+			vpmPath = argv[++i];
+		else if (!strcmp(argv[i], "-s") && hasValue)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-c") && hasValue)
+			configs = argv[++i];
+		else if (!strcmp(argv[i], "-o") && hasValue)
+			p_output = argv[++i];
+		else if (!strcmp(argv[i], "-b") && hasValue)
+			p_baseline = argv[++i];
+		else if (!strcmp(argv[i], "-t") && hasValue)
+			threshold = atof(argv[++i]);
+		else if (argv[i][0] == '-')
+			return Usage();
+		else
+			games.push_back(argv[i]);
+	}
+
+	if (seconds <= 0)
+		return Usage();
+
+	if (games.empty())
+		games.assign(_defaultGames, _defaultGames + sizeof(_defaultGames) / sizeof(_defaultGames[0]));
+
+	std::vector<const BenchConfig*> runConfigs;
+	for (const BenchConfig& config : _configs) {
+		const std::string list = "," + configs + ",";
+		if (list.find(std::string(",") + config.p_name + ",") != std::string::npos)
+			runConfigs.push_back(&config);
+	}
+	if (runConfigs.empty())
+		return Usage();
+
+	std::vector<BenchResult> results;
+
+	for (const std::string& entry : games) {
+		const size_t pos = entry.find('=');
+		const std::string generation = (pos != std::string::npos) ? entry.substr(0, pos) : "";
+		const std::string game = (pos != std::string::npos) ? entry.substr(pos + 1) : entry;
+
+		for (const BenchConfig* p_config : runConfigs) {
+			results.push_back(Run(vpmPath, generation, game, p_config, seconds));
+
+			const BenchResult& result = results.back();
+			if (result.status == PINMAME_STATUS_OK)
+				fprintf(stderr, "%-10s %-5s %8.2fx real time\n", game.c_str(), p_config->p_name, Speed(result));
+			else
+				fprintf(stderr, "%-10s %-5s failed, status=%d\n", game.c_str(), p_config->p_name, result.status);
+		}
+	}
+
+	FILE* p_file = p_output ? fopen(p_output, "w") : stdout;
+	if (!p_file) {
+		fprintf(stderr, "Can't write %s\n", p_output);
+		return 1;
+	}
+
+	fprintf(p_file, "{\n  \"seconds\": %.2f,\n  \"results\": [\n", seconds);
+	for (size_t i = 0; i < results.size(); i++)
+		WriteResult(p_file, results[i], i + 1 == results.size());
+	fprintf(p_file, "  ]\n}\n");
+
+	if (p_output)
+		fclose(p_file);
+
+	const int regressions = p_baseline ? Compare(p_baseline, results, threshold) : 0;
+
+	if (regressions)
+		fprintf(stderr, "%d regression(s) over %.1f%%\n", regressions, threshold);
+
+	// games that couldn't run (missing ROMs) are reported, but only
+	// regressions fail the suite
+	return regressions ? 1 : 0;
+}
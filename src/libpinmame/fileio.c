@@ -24,6 +24,7 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <errno.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -536,6 +537,193 @@ int osd_get_path_info(int pathtype, int pathindex, const char *filename)
 
 
 
+//============================================================
+//	osd_get_file_stamp
+//============================================================
+
+int osd_get_file_stamp(int pathtype, int pathindex, const char *filename, UINT64 *size, INT64 *mtime)
+{
+	TCHAR fullpath[1024];
+#if defined(_WIN32) || defined(_WIN64)
+	WIN32_FILE_ATTRIBUTE_DATA data;
+#else
+	struct stat st;
+#endif
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+#if defined(_WIN32) || defined(_WIN64)
+	if (!GetFileAttributesEx(fullpath, GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return -1;
+
+	*size = ((UINT64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	*mtime = (INT64)(((UINT64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+#else
+	if (stat(fullpath, &st) != 0 || S_ISDIR(st.st_mode))
+		return -1;
+
+	*size = st.st_size;
+	*mtime = st.st_mtime;
+#endif
+	return 0;
+}
+
+
+
+//============================================================
+//	osd_map_file
+//============================================================
+
+const void *osd_map_file(int pathtype, int pathindex, const char *filename, UINT64 *size)
+{
+	TCHAR fullpath[1024];
+	const void *base = NULL;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE handle, mapping;
+	LARGE_INTEGER length;
+#else
+	struct stat st;
+	int fd;
+#endif
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+#if defined(_WIN32) || defined(_WIN64)
+	handle = CreateFile(fullpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	/* empty files can't be mapped; the view keeps the mapping alive once the handles are closed */
+	if (GetFileSizeEx(handle, &length) && length.QuadPart > 0)
+	{
+		mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping)
+		{
+			base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(handle);
+
+	if (base)
+		*size = length.QuadPart;
+#else
+	fd = open(fullpath, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	/* empty files can't be mapped; the mapping stays valid once the descriptor is closed */
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+	{
+		base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED)
+			base = NULL;
+	}
+	close(fd);
+
+	if (base)
+		*size = st.st_size;
+#endif
+	return base;
+}
+
+
+
+//============================================================
+//	osd_unmap_file
+//============================================================
+
+void osd_unmap_file(const void *base, UINT64 size)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	UnmapViewOfFile(base);
+#else
+	munmap((void *)base, size);
+#endif
+}
+
+
+
+//============================================================
+//	osd_replace_file
+//============================================================
+
+int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length)
+{
+	TCHAR fullpath[1024], temppath[1024 + 4];
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE handle;
+	DWORD written = 0;
+	BOOL ok;
+#else
+	UINT32 done = 0;
+	int fd, ok;
+#endif
+
+	/* compose the full path, and the temporary next to it */
+	compose_path(fullpath, pathtype, pathindex, filename);
+#if defined(_WIN32) || defined(_WIN64)
+	_tcscpy(temppath, fullpath);
+	_tcscat(temppath, TEXT(".tmp"));
+#else
+	strcpy(temppath, fullpath);
+	strcat(temppath, ".tmp");
+#endif
+
+#if defined(_WIN32) || defined(_WIN64)
+	handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PATH_NOT_FOUND)
+	{
+		create_path(temppath, 1);
+		handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	}
+	if (handle == INVALID_HANDLE_VALUE)
+		return 1;
+
+	ok = WriteFile(handle, data, length, &written, NULL) && written == length && FlushFileBuffers(handle);
+	CloseHandle(handle);
+
+	/* only replace the old file once the new one is complete on disk */
+	if (!ok || !MoveFileEx(temppath, fullpath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFile(temppath);
+		return 1;
+	}
+#else
+	fd = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1 && errno == ENOENT)
+	{
+		create_path(temppath, 1);
+		fd = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	}
+	if (fd == -1)
+		return 1;
+
+	while (done < length)
+	{
+		ssize_t result = write(fd, (const UINT8 *)data + done, length - done);
+		if (result <= 0)
+			break;
+		done += result;
+	}
+	ok = (done == length && fsync(fd) == 0);
+	if (close(fd) != 0)
+		ok = 0;
+
+	/* only replace the old file once the new one is complete on disk */
+	if (!ok || rename(temppath, fullpath) != 0)
+	{
+		unlink(temppath);
+		return 1;
+	}
+#endif
+	return 0;
+}
+
+
+
 //============================================================
 //	osd_fopen
 //============================================================
@@ -574,12 +762,10 @@ osd_file *osd_fopen(int pathtype, int pathindex, const char *filename, const cha
 		access = GENERIC_READ | GENERIC_WRITE;
 #else
 		access = O_RDONLY; 
-	else if (strchr(mode, 'w')) {
-		access = O_WRONLY; 
-		access |= (O_CREAT | O_TRUNC);
-	}
-	else if (strchr(mode, '+'))
-		access = O_RDWR;
+	if (strchr(mode, 'w'))
+		access = O_WRONLY | O_CREAT | O_TRUNC;
+	if (strchr(mode, '+'))
+		access = (access & ~O_WRONLY) | O_RDWR;
 #endif
 
 	/* compose the full path */
@@ -601,7 +787,7 @@ osd_file *osd_fopen(int pathtype, int pathindex, const char *filename, const cha
 	file->handle = open(fullpath, access, 0666);
 
 	if (file->handle == INVALID_HANDLE_VALUE) {
-		if (!(access & O_WRONLY) || errno != ENOENT) {
+		if (!(access & (O_WRONLY | O_RDWR)) || errno != ENOENT) {
 			return NULL;
 		}
 #endif
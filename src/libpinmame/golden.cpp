@@ -0,0 +1,404 @@
+// license:BSD-3-Clause
+
+// Golden output traces: runs games headless for a number of emulated seconds
+// with scripted switch input and hashes the lamps, solenoids, displays and
+// audio of every frame. -r records <dir>/<game>.golden, otherwise the run is
+// checked against it and the first diverging frame is reported. ROMs are
+// read from the vpmPath given at runtime, none are needed in the tree.
+//
+// pinmame_golden -p vpmPath -g dir [-s seconds] [-r] game ...
+//
+// NVRAM, cfg and highscores go to <dir>/scratch and are deleted before each
+// run, so every run starts from a factory reset.
+// <dir>/<game>.sw, if present, scripts the switches, one change per line:
+// <emulated seconds> <switch> <0|1>
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "libpinmame.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <direct.h>
+#define MKDIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MKDIR(path) mkdir(path, 0755)
+#endif
+
+#define GOLDEN_MAGIC "pinmame golden trace 1"
+
+enum {
+	GOLDEN_LAMPS,
+	GOLDEN_SOLENOIDS,
+	GOLDEN_DISPLAYS,
+	GOLDEN_AUDIO,
+	GOLDEN_STREAMS
+};
+
+static const char* const _streamNames[GOLDEN_STREAMS] = { "lamps", "solenoids", "displays", "audio" };
+
+typedef struct {
+	uint32_t hash[GOLDEN_STREAMS];
+} GoldenFrame;
+
+typedef struct {
+	double time;
+	int swNo;
+	int state;
+} GoldenSwitch;
+
+// everything below is written by the emulation thread while a game runs
+static std::vector<GoldenFrame> _frames;
+static GoldenFrame _frame = {};
+static bool _frameOpen = false;
+static std::vector<uint32_t> _displayHashes;
+static std::vector<GoldenSwitch> _script;
+static size_t _scriptPos = 0;
+static double _fps = 0;
+static int _channels = 1;
+static double _seconds = 0;
+static size_t _maxFrames = 0;
+static std::atomic<size_t> _frameCount(0);
+static std::vector<PinmameLampState> _lampStates;
+static std::vector<PinmameSolenoidState> _solenoidStates;
+static std::vector<PinmameGIState> _giStates;
+
+static uint32_t Hash(uint32_t hash, const void* p_data, size_t size)
+{
+	const uint8_t* p = (const uint8_t*)p_data;
+
+	// FNV-1a
+	while (size--)
+		hash = (hash ^ *p++) * 16777619u;
+	return hash;
+}
+
+static uint32_t DisplayHash()
+{
+	return Hash(2166136261u, _displayHashes.data(), _displayHashes.size() * sizeof(uint32_t));
+}
+
+void PINMAMECALLBACK OnDisplayUpdated(int index, void* p_displayData, PinmameDisplayLayout* p_displayLayout, const void* p_userData)
+{
+	// no data: the display didn't change
+	if (!p_displayData || index < 0)
+		return;
+
+	size_t size;
+	if (p_displayLayout->type == PINMAME_DISPLAY_TYPE_VIDEO)
+		size = (size_t)p_displayLayout->width * p_displayLayout->height * 3;
+	else if ((p_displayLayout->type & PINMAME_DISPLAY_TYPE_DMD) == PINMAME_DISPLAY_TYPE_DMD)
+		size = (size_t)p_displayLayout->width * p_displayLayout->height;
+	else
+		size = (size_t)p_displayLayout->length * sizeof(uint16_t);
+
+	if (_displayHashes.size() <= (size_t)index)
+		_displayHashes.resize(index + 1, 0);
+	_displayHashes[index] = Hash(2166136261u, p_displayData, size);
+
+	if (_frameOpen)
+		_frame.hash[GOLDEN_DISPLAYS] = DisplayHash();
+}
+
+int PINMAMECALLBACK OnAudioAvailable(PinmameAudioInfo* p_audioInfo, const void* p_userData)
+{
+	_fps = p_audioInfo->framesPerSecond;
+	_channels = p_audioInfo->channels;
+	if (!_maxFrames)
+		_maxFrames = (size_t)(_seconds * _fps + 0.5);
+	return p_audioInfo->samplesPerFrame;
+}
+
+// Called once per emulated frame, before the displays are drawn, so this
+// closes the previous frame and opens the next one
+int PINMAMECALLBACK OnAudioUpdated(void* p_buffer, int samples, const void* p_userData)
+{
+	if (_frameOpen && _frames.size() < _maxFrames) {
+		_frames.push_back(_frame);
+		_frameCount = _frames.size();
+	}
+
+	const double time = _fps ? _frames.size() / _fps : 0;
+
+	while (_scriptPos < _script.size() && _script[_scriptPos].time <= time) {
+		PinmameSetSwitch(_script[_scriptPos].swNo, _script[_scriptPos].state);
+		_scriptPos++;
+	}
+
+	_frame.hash[GOLDEN_AUDIO] = Hash(2166136261u, p_buffer, (size_t)samples * _channels * sizeof(int16_t));
+
+	// polled on the emulation thread, so the changes line up with the frame
+	uint32_t hash = 2166136261u;
+	int count = PinmameGetChangedLamps(_lampStates.data());
+	if (count > 0)
+		hash = Hash(hash, _lampStates.data(), count * sizeof(PinmameLampState));
+	count = PinmameGetChangedGIs(_giStates.data());
+	if (count > 0)
+		hash = Hash(hash, _giStates.data(), count * sizeof(PinmameGIState));
+	_frame.hash[GOLDEN_LAMPS] = hash;
+
+	hash = 2166136261u;
+	count = PinmameGetChangedSolenoids(_solenoidStates.data());
+	if (count > 0)
+		hash = Hash(hash, _solenoidStates.data(), count * sizeof(PinmameSolenoidState));
+	_frame.hash[GOLDEN_SOLENOIDS] = hash;
+
+	_frame.hash[GOLDEN_DISPLAYS] = DisplayHash();
+	_frameOpen = true;
+
+	return samples;
+}
+
+void PINMAMECALLBACK OnLogMessage(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData)
+{
+	if (logLevel == PINMAME_LOG_LEVEL_ERROR) {
+		char buffer[1024];
+		vsnprintf(buffer, sizeof(buffer), format, args);
+		fprintf(stderr, "ERROR: %s\n", buffer);
+	}
+}
+
+static void LoadScript(const std::string& path)
+{
+	FILE* p_file = fopen(path.c_str(), "r");
+	char line[256];
+
+	_script.clear();
+	if (!p_file)
+		return;
+
+	while (fgets(line, sizeof(line), p_file)) {
+		GoldenSwitch sw;
+		if (line[0] != '#' && sscanf(line, "%lf %d %d", &sw.time, &sw.swNo, &sw.state) == 3)
+			_script.push_back(sw);
+	}
+	fclose(p_file);
+
+	// stable, so changes of one switch at the same time keep their order
+	std::stable_sort(_script.begin(), _script.end(), [](const GoldenSwitch& a, const GoldenSwitch& b) { return a.time < b.time; });
+}
+
+static PINMAME_STATUS Run(const std::string& vpmPath, const std::string& scratchPath, const std::string& game, double seconds, size_t frames)
+{
+	PinmameConfig config = {
+		PINMAME_AUDIO_FORMAT_INT16,
+		48000,
+		"",
+		nullptr,
+		nullptr,
+		&OnDisplayUpdated,
+		&OnAudioAvailable,
+		&OnAudioUpdated,
+		nullptr,
+		nullptr,
+		nullptr,
+		nullptr,
+		nullptr,
+		&OnLogMessage,
+		nullptr,
+	};
+	snprintf((char*)config.vpmPath, PINMAME_MAX_PATH, "%s", vpmPath.c_str());
+
+	PinmameSetConfig(&config);
+	PinmameSetHandleKeyboard(0);
+	PinmameSetHandleMechanics(1);
+	PinmameSetDmdMode(PINMAME_DMD_MODE_RAW);
+	PinmameSetSoundMode(PINMAME_SOUND_MODE_DEFAULT);
+	PinmameSetThrottle(0);
+
+	// nothing saved by an earlier run may leak into this one
+	PinmameSetPath(PINMAME_FILE_TYPE_NVRAM, scratchPath.c_str());
+	PinmameSetPath(PINMAME_FILE_TYPE_CONFIG, scratchPath.c_str());
+	PinmameSetPath(PINMAME_FILE_TYPE_HIGHSCORE, scratchPath.c_str());
+	remove((scratchPath + "/" + game + ".nv").c_str());
+	remove((scratchPath + "/" + game + ".cfg").c_str());
+	remove((scratchPath + "/" + game + ".hi").c_str());
+
+	_frames.clear();
+	_frameOpen = false;
+	_displayHashes.clear();
+	_scriptPos = 0;
+	_fps = 0;
+	_lampStates.resize(PinmameGetMaxLamps());
+	_solenoidStates.resize(PinmameGetMaxSolenoids());
+	_giStates.resize(PinmameGetMaxGIs());
+	_seconds = seconds;
+	_maxFrames = frames;
+	_frameCount = 0;
+
+	const PINMAME_STATUS status = PinmameRun(game.c_str());
+	if (status != PINMAME_STATUS_OK)
+		return status;
+
+	while (!PinmameIsRunning())
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	// when recording, the frame count is known once the sound is set up
+	while (PinmameIsRunning() && !(_maxFrames && _frameCount >= _maxFrames))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	PinmameStop();
+	while (PinmameIsRunning())
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	return (_maxFrames && _frames.size() >= _maxFrames) ? PINMAME_STATUS_OK : PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+}
+
+// Only frames differing from the one before are stored
+static bool Save(const std::string& path, const std::string& game)
+{
+	FILE* p_file = fopen(path.c_str(), "w");
+
+	if (!p_file)
+		return false;
+
+	fprintf(p_file, "%s\ngame %s\nfps %.6f\nframes %zu\n", GOLDEN_MAGIC, game.c_str(), _fps, _frames.size());
+
+	for (size_t i = 0; i < _frames.size(); i++) {
+		if (i && !memcmp(&_frames[i], &_frames[i - 1], sizeof(GoldenFrame)))
+			continue;
+		fprintf(p_file, "%zu %08x %08x %08x %08x\n", i,
+			_frames[i].hash[GOLDEN_LAMPS], _frames[i].hash[GOLDEN_SOLENOIDS], _frames[i].hash[GOLDEN_DISPLAYS], _frames[i].hash[GOLDEN_AUDIO]);
+	}
+
+	return fclose(p_file) == 0;
+}
+
+static bool Load(const std::string& path, std::vector<GoldenFrame>& frames)
+{
+	FILE* p_file = fopen(path.c_str(), "r");
+	char line[256];
+	size_t count = 0;
+
+	if (!p_file)
+		return false;
+
+	if (!fgets(line, sizeof(line), p_file) || strncmp(line, GOLDEN_MAGIC, strlen(GOLDEN_MAGIC))) {
+		fclose(p_file);
+		return false;
+	}
+
+	while (fgets(line, sizeof(line), p_file)) {
+		size_t frame;
+		GoldenFrame hashes;
+
+		if (sscanf(line, "frames %zu", &count) == 1)
+			continue;
+		if (sscanf(line, "%zu %x %x %x %x", &frame, &hashes.hash[0], &hashes.hash[1], &hashes.hash[2], &hashes.hash[3]) != 5 || frame < frames.size())
+			continue;
+
+		// repeat the previous frame up to this one
+		while (!frames.empty() && frames.size() < frame)
+			frames.push_back(frames.back());
+		frames.push_back(hashes);
+	}
+	fclose(p_file);
+
+	while (!frames.empty() && frames.size() < count)
+		frames.push_back(frames.back());
+
+	return !frames.empty();
+}
+
+static int Usage()
+{
+	fprintf(stderr, "usage: pinmame_golden -p vpmPath -g dir [-s seconds] [-r] game ...\n");
+	return 2;
+}
+
+int main(int argc, char** argv)
+{
+	std::string vpmPath;
+	std::string dir;
+	double seconds = 20.0;
+	bool record = false;
+	std::vector<std::string> games;
+
+	for (int i = 1; i < argc; i++) {
+		const bool hasValue = (i + 1 < argc);
+
+		if (!strcmp(argv[i], "-p") && hasValue)
+			vpmPath = argv[++i];
+		else if (!strcmp(argv[i], "-g") && hasValue)
+			dir = argv[++i];
+		else if (!strcmp(argv[i], "-s") && hasValue)
+			seconds = atof(argv[++i]);
+		else if (!strcmp(argv[i], "-r"))
+			record = true;
+		else if (argv[i][0] == '-')
+			return Usage();
+		else
+			games.push_back(argv[i]);
+	}
+
+	if (vpmPath.empty() || dir.empty() || games.empty() || seconds <= 0)
+		return Usage();
+
+	if (dir.back() != '/' && dir.back() != '\\')
+		dir += '/';
+
+	const std::string scratchPath = dir + "scratch";
+	MKDIR(scratchPath.c_str());
+
+	int failures = 0;
+
+	for (const std::string& game : games) {
+		const std::string goldenPath = dir + game + ".golden";
+		std::vector<GoldenFrame> golden;
+
+		if (!record && !Load(goldenPath, golden)) {
+			fprintf(stderr, "%-10s no golden trace at %s\n", game.c_str(), goldenPath.c_str());
+			failures++;
+			continue;
+		}
+
+		LoadScript(dir + game + ".sw");
+
+		// a check runs exactly the recorded frames
+		const PINMAME_STATUS status = Run(vpmPath, scratchPath, game, seconds, record ? 0 : golden.size());
+
+		if (status != PINMAME_STATUS_OK) {
+			fprintf(stderr, "%-10s failed to run, status=%d\n", game.c_str(), status);
+			failures++;
+			continue;
+		}
+
+		if (record) {
+			if (!Save(goldenPath, game)) {
+				fprintf(stderr, "%-10s can't write %s\n", game.c_str(), goldenPath.c_str());
+				failures++;
+			}
+			else
+				printf("%-10s recorded %zu frames, %zu switch changes\n", game.c_str(), _frames.size(), _script.size());
+			continue;
+		}
+
+		const size_t frames = (golden.size() < _frames.size()) ? golden.size() : _frames.size();
+		size_t frame = 0;
+
+		while (frame < frames && !memcmp(&golden[frame], &_frames[frame], sizeof(GoldenFrame)))
+			frame++;
+
+		if (frame == frames) {
+			printf("%-10s %zu frames match\n", game.c_str(), frames);
+			continue;
+		}
+
+		printf("%-10s diverges at frame %zu (%.3fs):", game.c_str(), frame, frame / _fps);
+		for (int stream = 0; stream < GOLDEN_STREAMS; stream++)
+			if (golden[frame].hash[stream] != _frames[frame].hash[stream])
+				printf(" %s", _streamNames[stream]);
+		printf("\n");
+		failures++;
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,515 @@
+// license:BSD-3-Clause
+
+#include "inputlog.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <string.h>
+
+extern "C" {
+#include "driver.h"
+#include "core.h"
+#include "vpintf.h"
+#include <zlib.h>
+
+extern void libpinmame_log_info(const char* format, ...);
+extern void libpinmame_log_error(const char* format, ...);
+}
+
+// Switch changes are applied, and replayed, on a 1 ms emulated tick, so a
+// replay sees them at exactly the same point of the emulation
+#define INPUTLOG_TICK_HZ 1000
+
+// Outputs and NVRAM are checksummed every 100 ms of emulated time. A
+// divergence lies between the last matching and the first failing checkpoint
+#define INPUTLOG_CHECKPOINT_TICKS 100
+
+// Log layout: magic, game name, checkpoint interval, NVRAM image at the
+// start, then records of a tag, the ticks since the previous record as a
+// varint and a payload
+#define INPUTLOG_RECORD_SWITCH     'S'   // varint swNo << 1 | state
+#define INPUTLOG_RECORD_CHECKPOINT 'C'   // crc32 of the outputs
+#define INPUTLOG_RECORD_END        'E'
+
+static const char _inputLogMagic[8] = { 'P', 'M', 'I', 'N', 'P', 'T', '0', '1' };
+
+typedef struct {
+	int swNo;
+	int state;
+} InputLogSwitchEvent;
+
+static PINMAME_INPUT_LOG_MODE _inputLogMode = PINMAME_INPUT_LOG_MODE_OFF;
+static mame_file* _p_inputLogFile = nullptr;
+static std::vector<UINT8> _inputLogData;     // playback: the whole log, recording: records of the current tick
+static size_t _inputLogPos = 0;
+static int _inputLogStarted = 0;
+static int _inputLogFinished = 0;
+static UINT32 _inputLogTick = 0;
+static UINT32 _inputLogLastTick = 0;         // tick of the last record written or read
+static UINT32 _inputLogCheckpointTicks = INPUTLOG_CHECKPOINT_TICKS;
+static int _inputLogNextRecord = 0;          // playback: tag of the next record, read ahead
+static UINT32 _inputLogNextTick = 0;
+static std::vector<UINT8> _inputLogNVRAM;
+
+static std::mutex _inputLogMutex;
+static std::vector<InputLogSwitchEvent> _inputLogPending;   // recording: changes since the last tick
+static PinmameInputLogStatus _inputLogStatus;
+
+/******************************************************
+ * Encoding helpers
+ ******************************************************/
+
+static void PutVarint(std::vector<UINT8>& data, UINT32 value)
+{
+	while (value >= 0x80) {
+		data.push_back((UINT8)(value | 0x80));
+		value >>= 7;
+	}
+	data.push_back((UINT8)value);
+}
+
+static void Put32(std::vector<UINT8>& data, const UINT32 value)
+{
+	for (int i = 0; i < 4; i++)
+		data.push_back((UINT8)(value >> (i * 8)));
+}
+
+static bool GetVarint(UINT32* const p_value)
+{
+	UINT32 value = 0;
+
+	for (int shift = 0; shift < 32 && _inputLogPos < _inputLogData.size(); shift += 7) {
+		const UINT8 byte = _inputLogData[_inputLogPos++];
+		value |= (UINT32)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*p_value = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool Get32(UINT32* const p_value)
+{
+	if (_inputLogData.size() - _inputLogPos < 4)
+		return false;
+
+	*p_value = 0;
+	for (int i = 0; i < 4; i++)
+		*p_value |= (UINT32)_inputLogData[_inputLogPos++] << (i * 8);
+	return true;
+}
+
+/******************************************************
+ * OutputChecksum
+ ******************************************************/
+
+static UINT32 OutputChecksum()
+{
+	const UINT32 sols[2] = { coreGlobals.solenoids, coreGlobals.solenoids2 };
+	uLong crc = crc32(0L, Z_NULL, 0);
+
+	crc = crc32(crc, (const Bytef*)sols, sizeof(sols));
+	crc = crc32(crc, (const Bytef*)coreGlobals.lampMatrix, sizeof(coreGlobals.lampMatrix));
+	crc = crc32(crc, (const Bytef*)coreGlobals.segments, sizeof(coreGlobals.segments));
+	crc = crc32(crc, (const Bytef*)coreGlobals.gi, sizeof(coreGlobals.gi));
+
+	const int size = core_getNvram(NULL);
+	if (size > 0) {
+		_inputLogNVRAM.resize(size);
+		core_getNvram(_inputLogNVRAM.data());
+		crc = crc32(crc, _inputLogNVRAM.data(), size);
+	}
+
+	return (UINT32)crc;
+}
+
+/******************************************************
+ * Recording
+ ******************************************************/
+
+static void PutRecord(const int tag)
+{
+	_inputLogData.push_back((UINT8)tag);
+	PutVarint(_inputLogData, _inputLogTick - _inputLogLastTick);
+	_inputLogLastTick = _inputLogTick;
+}
+
+static void FlushRecords()
+{
+	if (_inputLogData.empty())
+		return;
+
+	if (mame_fwrite(_p_inputLogFile, _inputLogData.data(), (UINT32)_inputLogData.size()) != _inputLogData.size())
+		libpinmame_log_error("Unable to write input log");
+
+	_inputLogData.clear();
+}
+
+static void WriteHeader()
+{
+	char gameName[16] = { 0 };
+	strncpy(gameName, Machine->gamedrv->name, sizeof(gameName) - 1);
+
+	// whatever the driver saves right now is what the replay has to load
+	mame_file* const p_nvram = mame_fopen_ram();
+	UINT32 nvramSize = 0;
+
+	if (p_nvram && Machine->drv->nvram_handler) {
+		(*Machine->drv->nvram_handler)(p_nvram, 1);
+		nvramSize = (UINT32)mame_fsize(p_nvram);
+	}
+
+	_inputLogData.insert(_inputLogData.end(), _inputLogMagic, _inputLogMagic + sizeof(_inputLogMagic));
+	_inputLogData.insert(_inputLogData.end(), gameName, gameName + sizeof(gameName));
+	Put32(_inputLogData, _inputLogCheckpointTicks);
+	Put32(_inputLogData, nvramSize);
+	if (nvramSize)
+		_inputLogData.insert(_inputLogData.end(), mame_fdata(p_nvram), mame_fdata(p_nvram) + nvramSize);
+
+	if (p_nvram)
+		mame_fclose(p_nvram);
+
+	FlushRecords();
+}
+
+static void RecordTick()
+{
+	std::vector<InputLogSwitchEvent> events;
+	{
+		std::lock_guard<std::mutex> lock(_inputLogMutex);
+		events.swap(_inputLogPending);
+	}
+
+	// a switch changes at most once per tick so no edge gets lost, further
+	// changes of it wait for the next tick
+	std::vector<InputLogSwitchEvent> later;
+	std::vector<int> changed;
+
+	for (const InputLogSwitchEvent& event : events) {
+		if (std::find(changed.begin(), changed.end(), event.swNo) != changed.end()) {
+			later.push_back(event);
+			continue;
+		}
+		changed.push_back(event.swNo);
+
+		vp_putSwitch(event.swNo, event.state);
+		PutRecord(INPUTLOG_RECORD_SWITCH);
+		PutVarint(_inputLogData, ((UINT32)event.swNo << 1) | (event.state ? 1 : 0));
+	}
+
+	if (!later.empty()) {
+		std::lock_guard<std::mutex> lock(_inputLogMutex);
+		_inputLogPending.insert(_inputLogPending.begin(), later.begin(), later.end());
+	}
+
+	const bool checkpoint = (_inputLogTick % _inputLogCheckpointTicks) == 0;
+	if (checkpoint) {
+		PutRecord(INPUTLOG_RECORD_CHECKPOINT);
+		Put32(_inputLogData, OutputChecksum());
+	}
+
+	FlushRecords();
+
+	if (!changed.empty() || checkpoint) {
+		std::lock_guard<std::mutex> lock(_inputLogMutex);
+		_inputLogStatus.switchEvents += (int)changed.size();
+		_inputLogStatus.checkpoints += checkpoint ? 1 : 0;
+	}
+}
+
+/******************************************************
+ * Playback
+ ******************************************************/
+
+static void ReadRecordHeader()
+{
+	UINT32 ticks;
+
+	if (_inputLogPos >= _inputLogData.size()) {
+		_inputLogNextRecord = INPUTLOG_RECORD_END;
+		_inputLogNextTick = _inputLogLastTick;
+		libpinmame_log_error("Input log is truncated at %.3fs", _inputLogLastTick / (double)INPUTLOG_TICK_HZ);
+		return;
+	}
+
+	_inputLogNextRecord = _inputLogData[_inputLogPos++];
+	if (!GetVarint(&ticks))
+		ticks = 0;
+
+	_inputLogNextTick = _inputLogLastTick + ticks;
+}
+
+static void Checkpoint(const UINT32 expected)
+{
+	const UINT32 crc = OutputChecksum();
+	const double time = _inputLogTick / (double)INPUTLOG_TICK_HZ;
+
+	std::lock_guard<std::mutex> lock(_inputLogMutex);
+
+	_inputLogStatus.checkpoints++;
+
+	if (crc == expected) {
+		if (!_inputLogStatus.divergences)
+			_inputLogStatus.lastMatchTime = time;
+		return;
+	}
+
+	if (!_inputLogStatus.divergences++) {
+		_inputLogStatus.firstDivergenceTime = time;
+		libpinmame_log_error("Input log replay diverged between %.3fs and %.3fs", _inputLogStatus.lastMatchTime, time);
+	}
+}
+
+static void PlaybackTick()
+{
+	while (!_inputLogFinished && _inputLogNextTick == _inputLogTick) {
+		UINT32 value;
+
+		_inputLogLastTick = _inputLogNextTick;
+
+		switch (_inputLogNextRecord) {
+			case INPUTLOG_RECORD_SWITCH:
+				if (!GetVarint(&value))
+					break;
+				vp_putSwitch((int)(value >> 1), value & 1);
+				{
+					std::lock_guard<std::mutex> lock(_inputLogMutex);
+					_inputLogStatus.switchEvents++;
+				}
+				break;
+
+			case INPUTLOG_RECORD_CHECKPOINT:
+				if (Get32(&value))
+					Checkpoint(value);
+				break;
+
+			case INPUTLOG_RECORD_END:
+				_inputLogFinished = 1;
+				{
+					std::lock_guard<std::mutex> lock(_inputLogMutex);
+					_inputLogStatus.finished = 1;
+				}
+				libpinmame_log_info("Input log replayed, %d of %d checkpoints diverged", _inputLogStatus.divergences, _inputLogStatus.checkpoints);
+				return;
+
+			default:
+				libpinmame_log_error("Input log is corrupt at %.3fs", _inputLogTick / (double)INPUTLOG_TICK_HZ);
+				_inputLogFinished = 1;
+				return;
+		}
+
+		ReadRecordHeader();
+	}
+}
+
+static bool ReadHeader(const char* const p_gameName)
+{
+	char gameName[16];
+	UINT32 nvramSize;
+
+	if (_inputLogData.size() < sizeof(_inputLogMagic) + sizeof(gameName) + 8
+		|| memcmp(_inputLogData.data(), _inputLogMagic, sizeof(_inputLogMagic)))
+		return false;
+
+	_inputLogPos = sizeof(_inputLogMagic);
+	memcpy(gameName, &_inputLogData[_inputLogPos], sizeof(gameName));
+	gameName[sizeof(gameName) - 1] = '\0';
+	_inputLogPos += sizeof(gameName);
+
+	if (strcmp(gameName, p_gameName)) {
+		libpinmame_log_error("Input log was recorded with %s", gameName);
+		return false;
+	}
+
+	if (!Get32(&_inputLogCheckpointTicks) || !Get32(&nvramSize) || _inputLogData.size() - _inputLogPos < nvramSize)
+		return false;
+
+	if (nvramSize) {
+		options.nvram = mame_fopen_ram();
+		if (!options.nvram)
+			return false;
+		mame_fwrite(options.nvram, &_inputLogData[_inputLogPos], nvramSize);
+		mame_fseek(options.nvram, 0, SEEK_SET);
+		_inputLogPos += nvramSize;
+	}
+
+	ReadRecordHeader();
+
+	return true;
+}
+
+/******************************************************
+ * InputLogTick
+ ******************************************************/
+
+static void InputLogTick(int param)
+{
+	_inputLogTick++;
+
+	if (_inputLogMode == PINMAME_INPUT_LOG_MODE_RECORD)
+		RecordTick();
+	else
+		PlaybackTick();
+}
+
+/******************************************************
+ * InputLogOpen
+ ******************************************************/
+
+bool InputLogOpen(const PINMAME_INPUT_LOG_MODE mode, const char* const p_name, const char* const p_gameName)
+{
+	InputLogClose();
+
+	memset(&_inputLogStatus, 0, sizeof(_inputLogStatus));
+	_inputLogStatus.mode = mode;
+	_inputLogStatus.firstDivergenceTime = -1.0;
+
+	if (mode == PINMAME_INPUT_LOG_MODE_OFF)
+		return true;
+
+	_inputLogTick = 0;
+	_inputLogLastTick = 0;
+	_inputLogCheckpointTicks = INPUTLOG_CHECKPOINT_TICKS;
+	_inputLogData.clear();
+	_inputLogPending.clear();
+
+	if (mode == PINMAME_INPUT_LOG_MODE_RECORD) {
+		_p_inputLogFile = mame_fopen(p_name, 0, FILETYPE_INPUTLOG, 1);
+		if (!_p_inputLogFile) {
+			libpinmame_log_error("Unable to create input log %s", p_name);
+			return false;
+		}
+	}
+	else {
+		mame_file* const p_file = mame_fopen(p_name, 0, FILETYPE_INPUTLOG, 0);
+		if (!p_file) {
+			libpinmame_log_error("Unable to open input log %s", p_name);
+			return false;
+		}
+
+		_inputLogData.resize((size_t)mame_fsize(p_file));
+		const bool read = mame_fread(p_file, _inputLogData.data(), (UINT32)_inputLogData.size()) == _inputLogData.size();
+		mame_fclose(p_file);
+
+		if (!read || !ReadHeader(p_gameName) || !_inputLogCheckpointTicks) {
+			libpinmame_log_error("Input log %s is invalid", p_name);
+			InputLogClose();
+			return false;
+		}
+	}
+
+	_inputLogMode = mode;
+
+	return true;
+}
+
+/******************************************************
+ * InputLogStart
+ ******************************************************/
+
+void InputLogStart()
+{
+	if (_inputLogMode == PINMAME_INPUT_LOG_MODE_OFF)
+		return;
+
+	if (!_inputLogStarted) {
+		_inputLogStarted = 1;
+
+		if (_inputLogMode == PINMAME_INPUT_LOG_MODE_RECORD)
+			WriteHeader();
+	}
+
+	// machine resets free all timers; resets are not logged, so a replay
+	// only matches up to the first one
+	timer_pulse(TIME_IN_HZ(INPUTLOG_TICK_HZ), 0, InputLogTick);
+}
+
+/******************************************************
+ * InputLogClose
+ ******************************************************/
+
+void InputLogClose()
+{
+	if (_p_inputLogFile) {
+		if (_inputLogStarted) {
+			PutRecord(INPUTLOG_RECORD_END);
+			FlushRecords();
+		}
+
+		mame_fclose(_p_inputLogFile);
+		_p_inputLogFile = nullptr;
+	}
+
+	if (options.nvram) {
+		mame_fclose(options.nvram);
+		options.nvram = NULL;
+	}
+
+	_inputLogMode = PINMAME_INPUT_LOG_MODE_OFF;
+	_inputLogStarted = 0;
+	_inputLogFinished = 0;
+	_inputLogData.clear();
+	_inputLogData.shrink_to_fit();
+}
+
+/******************************************************
+ * InputLogSwitch
+ ******************************************************/
+
+bool InputLogSwitch(const int swNo, const int state)
+{
+	switch (_inputLogMode) {
+		case PINMAME_INPUT_LOG_MODE_RECORD: {
+			std::lock_guard<std::mutex> lock(_inputLogMutex);
+			_inputLogPending.push_back({ swNo, state });
+			return true;
+		}
+		case PINMAME_INPUT_LOG_MODE_PLAYBACK:
+			// the log is the only input
+			return true;
+		default:
+			return false;
+	}
+}
+
+/******************************************************
+ * InputLogGetSwitch
+ ******************************************************/
+
+bool InputLogGetSwitch(const int swNo, int* const p_state)
+{
+	if (_inputLogMode != PINMAME_INPUT_LOG_MODE_RECORD)
+		return false;
+
+	std::lock_guard<std::mutex> lock(_inputLogMutex);
+	for (auto it = _inputLogPending.rbegin(); it != _inputLogPending.rend(); ++it) {
+		if (it->swNo == swNo) {
+			*p_state = it->state;
+			return true;
+		}
+	}
+	return false;
+}
+
+/******************************************************
+ * InputLogFinished
+ ******************************************************/
+
+bool InputLogFinished()
+{
+	return _inputLogFinished != 0;
+}
+
+/******************************************************
+ * InputLogGetStatus
+ ******************************************************/
+
+void InputLogGetStatus(PinmameInputLogStatus* const p_status)
+{
+	std::lock_guard<std::mutex> lock(_inputLogMutex);
+	*p_status = _inputLogStatus;
+}
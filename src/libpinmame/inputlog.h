@@ -0,0 +1,29 @@
+// license:BSD-3-Clause
+
+// Switch input record/playback keyed to emulated time
+
+#pragma once
+
+#include "libpinmame.h"
+
+// Open the log for the next run of p_gameName. For playback the recorded
+// NVRAM becomes options.nvram. Returns false if the log can't be used
+bool InputLogOpen(const PINMAME_INPUT_LOG_MODE mode, const char* const p_name, const char* const p_gameName);
+
+// Emulation started or was reset, (re)arms the tick timer
+void InputLogStart();
+
+// Emulation ended, writes the end of a recording and closes the log
+void InputLogClose();
+
+// Switch change from the client. Returns false if it should be applied directly
+bool InputLogSwitch(const int swNo, const int state);
+
+// State of the latest change of a switch waiting for the next tick of a
+// recording; false if none is
+bool InputLogGetSwitch(const int swNo, int* const p_state);
+
+// Playback reached the end of the log
+bool InputLogFinished();
+
+void InputLogGetStatus(PinmameInputLogStatus* const p_status);
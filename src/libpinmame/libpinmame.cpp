@@ -1,10 +1,20 @@
 // license:BSD-3-Clause
 
 #include "libpinmame.h"
+#include "romaudit.h"
+#include "inputlog.h"
+#include "switchqueue.h"
 
 #include "../../ext/libsamplerate/samplerate.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #if defined(_WIN32) || defined(_WIN64)
@@ -20,8 +30,11 @@ extern "C" {
 #include "video.h"
 #include "audit.h"
 #include "mech.h"
+#include "state.h"
+#include <zlib.h>
 
 extern int throttle;
+extern int fastfrms;
 extern int autoframeskip;
 extern int allow_sleep;
 
@@ -32,7 +45,7 @@ int g_fPause = 0;
 PINMAME_DMD_MODE g_fDmdMode = PINMAME_DMD_MODE_BRIGHTNESS;
 PINMAME_SOUND_MODE g_fSoundMode = PINMAME_SOUND_MODE_DEFAULT;
 
-char g_szGameName[256] = {0}; //!! not set yet
+char g_szGameName[256] = {0};
 }
 
 int _isRunning = 0;
@@ -40,6 +53,8 @@ int _timeToQuit = 0;
 PinmameConfig* _p_Config = nullptr;
 std::thread* _p_gameThread = nullptr;
 void* _p_userData = nullptr;
+// outside PinmameConfig so that the struct keeps the size older clients copy in
+std::atomic<PinmameOnNVRAMChangedCallback> _cb_OnNVRAMChanged(nullptr);
 
 int _mechInit[MECH_MAXMECH];
 PinmameMechInfo _mechInfo[MECH_MAXMECH];
@@ -55,6 +70,58 @@ typedef struct {
 
 std::vector<PinmameDisplay*> _displays;
 
+typedef struct {
+	std::vector<int> byName;     // driver numbers sorted case-insensitively by name
+	std::vector<int> cloneStart; // clones of game n are clones[cloneStart[n]] .. clones[cloneStart[n + 1] - 1]
+	std::vector<int> clones;
+} GameIndex;
+
+GameIndex _gameIndex;
+std::once_flag _gameIndexOnce;
+
+typedef enum {
+	STATE_REQUEST_NONE = 0,
+	STATE_REQUEST_SAVE = 1,
+	STATE_REQUEST_LOAD = 2,
+	STATE_REQUEST_REWIND = 3
+} STATE_REQUEST;
+
+// A state request of an API caller; lives on the caller's stack and is
+// only touched under _stateMutex while it is posted
+typedef struct {
+	void* p_data;    // save: the state taken, load: the state to restore
+	size_t size;
+	int steps;       // rewind
+	int result;
+} StateJob;
+
+std::mutex _stateMutex;
+std::condition_variable _stateDone;
+STATE_REQUEST _stateRequest = STATE_REQUEST_NONE;
+StateJob* _p_stateJob = nullptr;
+int _stateStarted = 0;
+
+int _warmStartSeconds = 0;
+int _throttle = 1;
+UINT32 _warmStartKey = 0;
+void* _p_warmStartData = nullptr;
+size_t _warmStartSize = 0;
+int _warmStartSavePending = 0;
+
+int _rewindSnapshots = 0;
+int _rewindInterval = 0;
+int _rewindSnapshotPending = 0;
+int _rewindTaken = 0;
+double _rewindTime = 0;
+
+PINMAME_INPUT_LOG_MODE _inputLogMode = PINMAME_INPUT_LOG_MODE_OFF;
+std::string _inputLogName;
+std::string _pcProfileFile;
+std::string _memTraceFile;
+std::string _memTraceFilter;
+
+static const char _warmStartMagic[8] = { 'P', 'M', 'B', 'O', 'O', 'T', '0', '1' };
+
 static const PinmameKeyboardInfo _keyboardInfo[] = {
 	{ "A", PINMAME_KEYCODE_A, KEYCODE_A },
 	{ "B", PINMAME_KEYCODE_B, KEYCODE_B },
@@ -176,24 +243,92 @@ char* ComposePath(const char* const path, const char* const file)
 	return newPath;
 }
 
+/******************************************************
+ * BuildGameIndex
+ ******************************************************/
+
+void BuildGameIndex()
+{
+	int gameCount = 0;
+	while (drivers[gameCount])
+		gameCount++;
+
+	_gameIndex.byName.resize(gameCount);
+	for (int gameNum = 0; gameNum < gameCount; gameNum++)
+		_gameIndex.byName[gameNum] = gameNum;
+
+	// stable, so duplicate names still resolve to the first driver like the old linear scan did
+	std::stable_sort(_gameIndex.byName.begin(), _gameIndex.byName.end(), [](const int a, const int b) {
+		return strcasecmp(drivers[a]->name, drivers[b]->name) < 0;
+	});
+
+	std::unordered_map<const struct GameDriver*, int> driverToNum;
+	driverToNum.reserve(gameCount);
+	for (int gameNum = 0; gameNum < gameCount; gameNum++)
+		driverToNum[drivers[gameNum]] = gameNum;
+
+	// clone_of pointing at driver_0 or a NOT_A_DRIVER container is not a parent we can list
+	std::vector<int> parent(gameCount, -1);
+	_gameIndex.cloneStart.assign(gameCount + 1, 0);
+	for (int gameNum = 0; gameNum < gameCount; gameNum++) {
+		const struct GameDriver* const p_cloneOf = drivers[gameNum]->clone_of;
+		if (!p_cloneOf || (p_cloneOf->flags & NOT_A_DRIVER))
+			continue;
+		auto it = driverToNum.find(p_cloneOf);
+		if (it == driverToNum.end())
+			continue;
+		parent[gameNum] = it->second;
+		_gameIndex.cloneStart[it->second + 1]++;
+	}
+
+	for (int gameNum = 0; gameNum < gameCount; gameNum++)
+		_gameIndex.cloneStart[gameNum + 1] += _gameIndex.cloneStart[gameNum];
+
+	_gameIndex.clones.resize(_gameIndex.cloneStart[gameCount]);
+	std::vector<int> fill(_gameIndex.cloneStart.begin(), _gameIndex.cloneStart.end() - 1);
+	for (int gameNum = 0; gameNum < gameCount; gameNum++) {
+		if (parent[gameNum] >= 0)
+			_gameIndex.clones[fill[parent[gameNum]]++] = gameNum;
+	}
+}
+
 /******************************************************
  * GetGameNumFromString
  ******************************************************/
 
 int GetGameNumFromString(const char* const name)
 {
-	int gameNum = 0;
+	if (!name)
+		return -1;
 
-	while (drivers[gameNum]) {
-		if (!strcasecmp(drivers[gameNum]->name, name))
-			break;
-		gameNum++;
-	}
+	std::call_once(_gameIndexOnce, BuildGameIndex);
+
+	auto it = std::lower_bound(_gameIndex.byName.begin(), _gameIndex.byName.end(), name, [](const int gameNum, const char* const p_name) {
+		return strcasecmp(drivers[gameNum]->name, p_name) < 0;
+	});
 
-	if (!drivers[gameNum])
+	if (it == _gameIndex.byName.end() || strcasecmp(drivers[*it]->name, name))
 		return -1;
 
-	return gameNum;
+	return *it;
+}
+
+/******************************************************
+ * GetGame
+ ******************************************************/
+
+void GetGame(const int gameNum, PinmameGame* const p_game)
+{
+	memset(p_game, 0, sizeof(PinmameGame));
+
+	p_game->name = drivers[gameNum]->name;
+	if (drivers[gameNum]->clone_of)
+		p_game->clone_of = drivers[gameNum]->clone_of->name;
+	p_game->description = drivers[gameNum]->description;
+	p_game->year = drivers[gameNum]->year;
+	p_game->manufacturer = drivers[gameNum]->manufacturer;
+	p_game->flags = drivers[gameNum]->flags;
+	p_game->found = RomsetMissing(gameNum) == 0;
 }
 
 /******************************************************
@@ -346,7 +481,7 @@ extern "C" int osd_start_audio_stream(const int stereo)
 
 extern "C" int osd_update_audio_stream(INT16* p_buffer)
 {
-	if(!_p_Config->cb_OnAudioUpdated || g_fSoundMode != PINMAME_SOUND_MODE_DEFAULT)
+	if(!_p_Config->cb_OnAudioUpdated || g_fSoundMode == PINMAME_SOUND_MODE_ALTSOUND)
 		return 0;
 
 	const int samplesThisFrame = mixer_samples_this_frame();
@@ -406,7 +541,7 @@ extern "C" void osd_exit(void)
 
 extern "C" int libpinmame_time_to_quit(void)
 {
-	return _timeToQuit;
+	return _timeToQuit || InputLogFinished();
 }
 
 /******************************************************
@@ -507,6 +642,15 @@ extern "C" void libpinmame_snd_cmd_log(int boardNo, int cmd)
 	(*(_p_Config->cb_OnSoundCommand))(boardNo, cmd, _p_userData);
 }
 
+/******************************************************
+ * libpinmame_get_vpm_path
+ ******************************************************/
+
+extern "C" const char* libpinmame_get_vpm_path()
+{
+	return _p_Config ? _p_Config->vpmPath : nullptr;
+}
+
 /******************************************************
  * libpinmame_forward_console_data
  ******************************************************/
@@ -520,17 +664,21 @@ extern "C" void libpinmame_forward_console_data(void* p_data, int size)
 }
 
 /******************************************************
- * OnStateChange
+ * libpinmame_nvram_changed
+ *
+ * Called on the emulation thread with the NVRAM image
+ * (the .nv file contents) whenever the background
+ * saver finds it changed.
  ******************************************************/
 
-extern "C" void OnStateChange(const int state)
+extern "C" void libpinmame_nvram_changed(const void* p_data, int size)
 {
-	_isRunning = state;
+	PinmameOnNVRAMChangedCallback callback = _cb_OnNVRAMChanged;
 
-	if (!_p_Config->cb_OnStateUpdated)
+	if (!callback)
 		return;
 
-	(*(_p_Config->cb_OnStateUpdated))(state, _p_userData);
+	(*callback)(p_data, size, _p_userData);
 }
 
 /******************************************************
@@ -621,6 +769,255 @@ extern "C" void libpinmame_update_mech(const int mechNo, mech_tMechData* p_mechD
 	}
 }
 
+/******************************************************
+ * IsStateComplete
+ ******************************************************/
+
+int IsStateComplete()
+{
+	// the driver and its boards, only the WPC, Whitestar and System 11/DE ones so far
+	if (!state_save_is_machine_complete())
+		return 0;
+
+	for (int cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++) {
+		if (!state_save_tag_registered(cpunum + 1))
+			return 0;
+	}
+
+	return 1;
+}
+
+/******************************************************
+ * GetWarmStartKey
+ ******************************************************/
+
+UINT32 GetWarmStartKey()
+{
+	// ROMs, plus the RAM contents just loaded from NVRAM
+	uLong crc = crc32(0L, Z_NULL, 0);
+
+	for (int region = 0; region < MAX_MEMORY_REGIONS; region++) {
+		if (Machine->memory_region[region].base)
+			crc = crc32(crc, Machine->memory_region[region].base, Machine->memory_region[region].length);
+	}
+
+	const int settings[] = { _warmStartSeconds, options.samplerate, options.cheat, (int)g_fSoundMode };
+	crc = crc32(crc, (const Bytef*)settings, sizeof(settings));
+
+	return (UINT32)crc;
+}
+
+/******************************************************
+ * WarmStartLoad
+ ******************************************************/
+
+void WarmStartLoad()
+{
+	if (cpu_loadsave_load_memory(_p_warmStartData, _warmStartSize))
+		libpinmame_log_error("Warm start snapshot of %s is invalid, booting normally", Machine->gamedrv->name);
+	else
+		libpinmame_log_info("Warm started %s", Machine->gamedrv->name);
+
+	free(_p_warmStartData);
+	_p_warmStartData = nullptr;
+}
+
+/******************************************************
+ * WarmStartSave
+ ******************************************************/
+
+void WarmStartSave()
+{
+	size_t size;
+	void* const p_data = cpu_loadsave_save_memory(&size);
+
+	if (!p_data)
+		return;
+
+	mame_file* const file = mame_fopen(Machine->gamedrv->name, "boot", FILETYPE_STATE, 1);
+
+	if (file) {
+		const UINT32 header[2] = { _warmStartKey, (UINT32)size };
+
+		if (mame_fwrite(file, _warmStartMagic, sizeof(_warmStartMagic)) != sizeof(_warmStartMagic)
+			|| mame_fwrite(file, header, sizeof(header)) != sizeof(header)
+			|| mame_fwrite(file, p_data, size) != size)
+			libpinmame_log_error("Unable to write warm start snapshot of %s", Machine->gamedrv->name);
+		else
+			libpinmame_log_info("Saved warm start snapshot of %s", Machine->gamedrv->name);
+
+		mame_fclose(file);
+	}
+
+	free(p_data);
+}
+
+/******************************************************
+ * TakeSnapshot
+ ******************************************************/
+
+void TakeSnapshot()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	if (!cpu_loadsave_snapshot()) {
+		_rewindTaken++;
+		_rewindTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+/******************************************************
+ * StateCallback
+ *
+ * The only function scheduled with
+ * cpu_loadsave_schedule_callback(), so requests from
+ * the emulation thread and from API callers can't
+ * replace each other. Runs between timeslices.
+ ******************************************************/
+
+void StateCallback()
+{
+	std::lock_guard<std::mutex> lock(_stateMutex);
+
+	if (_p_warmStartData)
+		WarmStartLoad();
+
+	if (_warmStartSavePending) {
+		_warmStartSavePending = 0;
+		WarmStartSave();
+	}
+
+	if (_rewindSnapshotPending) {
+		_rewindSnapshotPending = 0;
+		TakeSnapshot();
+	}
+
+	// a caller that gave up has already taken its request back
+	StateJob* const p_job = _p_stateJob;
+
+	switch (_stateRequest) {
+		case STATE_REQUEST_SAVE:
+			p_job->p_data = cpu_loadsave_save_memory(&p_job->size);
+			p_job->result = p_job->p_data ? 0 : 1;
+			break;
+		case STATE_REQUEST_LOAD:
+			p_job->result = cpu_loadsave_load_memory(p_job->p_data, p_job->size);
+			break;
+		case STATE_REQUEST_REWIND:
+			p_job->result = cpu_loadsave_rewind(p_job->steps);
+			break;
+		default:
+			return;
+	}
+
+	_stateRequest = STATE_REQUEST_NONE;
+	_p_stateJob = nullptr;
+	_stateDone.notify_all();
+}
+
+void WarmStartSaveTimer(int param)
+{
+	std::lock_guard<std::mutex> lock(_stateMutex);
+
+	_warmStartSavePending = 1;
+	cpu_loadsave_schedule_callback(StateCallback);
+}
+
+void RewindTimer(int param)
+{
+	std::lock_guard<std::mutex> lock(_stateMutex);
+
+	_rewindSnapshotPending = 1;
+	cpu_loadsave_schedule_callback(StateCallback);
+}
+
+/******************************************************
+ * WarmStart
+ *
+ * Restores the snapshot taken _warmStartSeconds after
+ * the last boot with the same ROMs, NVRAM and settings,
+ * or schedules taking one.
+ ******************************************************/
+
+void WarmStart()
+{
+	_warmStartKey = GetWarmStartKey();
+
+	mame_file* const file = mame_fopen(Machine->gamedrv->name, "boot", FILETYPE_STATE, 0);
+
+	if (file) {
+		char magic[sizeof(_warmStartMagic)];
+		UINT32 header[2];
+
+		if (mame_fread(file, magic, sizeof(magic)) == sizeof(magic)
+			&& !memcmp(magic, _warmStartMagic, sizeof(magic))
+			&& mame_fread(file, header, sizeof(header)) == sizeof(header)
+			&& header[0] == _warmStartKey) {
+			void* const p_data = malloc(header[1]);
+
+			if (p_data && mame_fread(file, p_data, header[1]) == header[1]) {
+				std::lock_guard<std::mutex> lock(_stateMutex);
+
+				_p_warmStartData = p_data;
+				_warmStartSize = header[1];
+				cpu_loadsave_schedule_callback(StateCallback);
+			}
+			else
+				free(p_data);
+		}
+
+		mame_fclose(file);
+	}
+
+	if (!_p_warmStartData)
+		timer_set(TIME_IN_SEC(_warmStartSeconds), 0, WarmStartSaveTimer);
+}
+
+/******************************************************
+ * OnStateChange
+ ******************************************************/
+
+extern "C" void OnStateChange(const int state)
+{
+	_isRunning = state;
+
+	// Called again on every machine reset, which also frees the timers.
+	// Only games where the driver, its boards and every CPU save their state are supported.
+	if (state && IsStateComplete()) {
+		if (!_stateStarted) {
+			_stateStarted = 1;
+
+			if (_rewindSnapshots > 0) {
+				std::lock_guard<std::mutex> lock(_stateMutex);
+				state_save_ring_init(_rewindSnapshots);
+			}
+
+			// a replay has to start from the recorded NVRAM, not from a snapshot
+			if (_warmStartSeconds > 0 && _inputLogMode == PINMAME_INPUT_LOG_MODE_OFF)
+				WarmStart();
+		}
+
+		if (_rewindSnapshots > 0)
+			timer_pulse(TIME_IN_MSEC(_rewindInterval), 0, RewindTimer);
+	}
+	else if (state && !_stateStarted) {
+		_stateStarted = 1;
+
+		if (_warmStartSeconds > 0 || _rewindSnapshots > 0)
+			libpinmame_log_info("Save states not supported by %s", Machine->gamedrv->name);
+	}
+
+	if (state) {
+		InputLogStart();
+		SwitchQueueStart();
+	}
+
+	if (!_p_Config->cb_OnStateUpdated)
+		return;
+
+	(*(_p_Config->cb_OnStateUpdated))(state, _p_userData);
+}
+
 /******************************************************
  * StartGame
  ******************************************************/
@@ -632,8 +1029,21 @@ int StartGame(const int gameNum)
 	memset(_mechInit, 0, sizeof(_mechInit));
 	memset(_mechInfo, 0, sizeof(_mechInfo));
 
+	_stateStarted = 0;
+	_rewindTaken = 0;
+	_rewindTime = 0;
+
 	err = run_game(gameNum);
 
+	free(_p_warmStartData);
+	_p_warmStartData = nullptr;
+	_warmStartSavePending = 0;
+	_rewindSnapshotPending = 0;
+
+	SwitchQueueStop();
+	InputLogClose();
+	throttle = 1;
+
 	OnStateChange(0);
 
 	return err;
@@ -654,16 +1064,7 @@ PINMAMEAPI PINMAME_STATUS PinmameGetGame(const char* const p_name, PinmameGameCa
 		return PINMAME_STATUS_GAME_NOT_FOUND;
 
 	PinmameGame game;
-	memset(&game, 0, sizeof(PinmameGame));
-
-	game.name = drivers[gameNum]->name;
-	if (drivers[gameNum]->clone_of)
-		game.clone_of = drivers[gameNum]->clone_of->name;
-	game.description = drivers[gameNum]->description;
-	game.year = drivers[gameNum]->year;
-	game.manufacturer = drivers[gameNum]->manufacturer;
-	game.flags = drivers[gameNum]->flags;
-	game.found = RomsetMissing(gameNum) == 0;
+	GetGame(gameNum, &game);
 
 	if (callback)
 		(*callback)(&game, p_userData);
@@ -684,16 +1085,7 @@ PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const vo
 
 	while (drivers[gameNum]) {
 		PinmameGame game;
-		memset(&game, 0, sizeof(PinmameGame));
-
-		game.name = drivers[gameNum]->name;
-		if (drivers[gameNum]->clone_of)
-			game.clone_of = drivers[gameNum]->clone_of->name;
-		game.description = drivers[gameNum]->description;
-		game.year = drivers[gameNum]->year;
-		game.manufacturer = drivers[gameNum]->manufacturer;
-		game.flags = drivers[gameNum]->flags;
-		game.found = RomsetMissing(gameNum) == 0;
+		GetGame(gameNum, &game);
 
 		if (callback)
 			(*callback)(&game, p_userData);
@@ -704,6 +1096,80 @@ PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const vo
 	return PINMAME_STATUS_OK;
 }
 
+/******************************************************
+ * PinmameGetGamesByName
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetGamesByName(const char* const* const p_names, const int count, PinmameGameCallback callback, const void* p_userData)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	PINMAME_STATUS status = PINMAME_STATUS_OK;
+
+	for (int index = 0; index < count; index++) {
+		const int gameNum = GetGameNumFromString(p_names[index]);
+
+		if (gameNum < 0) {
+			status = PINMAME_STATUS_GAME_NOT_FOUND;
+			continue;
+		}
+
+		PinmameGame game;
+		GetGame(gameNum, &game);
+
+		if (callback)
+			(*callback)(&game, p_userData);
+	}
+
+	return status;
+}
+
+/******************************************************
+ * PinmameGetGameClones
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetGameClones(const char* const p_name, PinmameGameCallback callback, const void* p_userData)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	const int gameNum = GetGameNumFromString(p_name);
+
+	if (gameNum < 0)
+		return PINMAME_STATUS_GAME_NOT_FOUND;
+
+	for (int index = _gameIndex.cloneStart[gameNum]; index < _gameIndex.cloneStart[gameNum + 1]; index++) {
+		PinmameGame game;
+		GetGame(_gameIndex.clones[index], &game);
+
+		if (callback)
+			(*callback)(&game, p_userData);
+	}
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameAuditGames
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameAuditGames(const PINMAME_AUDIT_MODE mode, const char* const p_reportPath, PinmameAuditSummary* const p_summary)
+{
+	if (!_p_Config)
+		return PINMAME_STATUS_CONFIG_NOT_SET;
+
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	libpinmame_log_info("PinmameAuditGames(): mode=%d, reportPath=%s", mode, p_reportPath ? p_reportPath : "");
+
+	if (!RomAuditRun(mode, p_reportPath, p_summary))
+		return PINMAME_STATUS_FILE_ERROR;
+
+	return PINMAME_STATUS_OK;
+}
+
 /******************************************************
  * PinmameSetConfig
  ******************************************************/
@@ -786,6 +1252,242 @@ PINMAMEAPI void PinmameSetCheat(const int cheat)
 	options.cheat = cheat;
 }
 
+/******************************************************
+ * PinmameGetFullRomVerify
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetFullRomVerify()
+{
+	return options.full_verify;
+}
+
+/******************************************************
+ * PinmameSetFullRomVerify
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetFullRomVerify(const int fullVerify)
+{
+	options.full_verify = fullVerify;
+}
+
+/******************************************************
+ * PinmameGetWarmStart
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetWarmStart()
+{
+	return _warmStartSeconds;
+}
+
+/******************************************************
+ * PinmameSetWarmStart
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetWarmStart(const int bootSeconds)
+{
+	_warmStartSeconds = (bootSeconds > 0) ? bootSeconds : 0;
+}
+
+/******************************************************
+ * PinmameGetThrottle
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetThrottle()
+{
+	return _throttle;
+}
+
+/******************************************************
+ * PinmameSetThrottle
+ *
+ * 0 runs the following games as fast as the host
+ * allows, e.g. for benchmarks. Takes effect with the
+ * next PinmameRun().
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetThrottle(const int enabled)
+{
+	_throttle = enabled ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameGetNVRAMAutosave
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetNVRAMAutosave()
+{
+	return options.nvram_autosave;
+}
+
+/******************************************************
+ * PinmameSetNVRAMAutosave
+ *
+ * Saves changed NVRAM every intervalMs in the
+ * background, 0 saves on exit only. Takes effect
+ * with the next PinmameRun().
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetNVRAMAutosave(const int intervalMs)
+{
+	options.nvram_autosave = (intervalMs > 0) ? intervalMs : 0;
+}
+
+/******************************************************
+ * PinmameSetNVRAMChangedCallback
+ *
+ * Called on the emulation thread with the NVRAM image
+ * each time the autosave finds it changed, NULL stops
+ * the calls. Can be changed while running.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetNVRAMChangedCallback(PinmameOnNVRAMChangedCallback callback)
+{
+	_cb_OnNVRAMChanged = callback;
+}
+
+/******************************************************
+ * PinmameGetAutoInterleave
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetAutoInterleave()
+{
+	return options.autointerleave;
+}
+
+/******************************************************
+ * PinmameSetAutoInterleave
+ *
+ * Lets the scheduler lengthen the timeslices while the
+ * CPUs don't talk to each other and shorten them under
+ * heavy traffic. Can be changed while running.
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetAutoInterleave(const int autoInterleave)
+{
+	options.autointerleave = autoInterleave ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameGetPCProfile
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetPCProfile()
+{
+	return options.pcprofile;
+}
+
+/******************************************************
+ * PinmameSetPCProfile
+ *
+ * Samples the PC of every CPU each cycles cycles of
+ * the following runs, 0 to stop. At the end of a run
+ * the profile is written to p_path as folded stacks,
+ * for flame graph tools.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSetPCProfile(const int cycles, const char* const p_path)
+{
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	if (cycles > 0 && (!p_path || !*p_path))
+		return PINMAME_STATUS_FILE_ERROR;
+
+	_pcProfileFile = (cycles > 0) ? p_path : "";
+	options.pcprofile = (cycles > 0) ? cycles : 0;
+	options.pcprofile_file = (char*)_pcProfileFile.c_str();
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetMemTrace
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetMemTrace()
+{
+	return (options.memtrace_file && *options.memtrace_file) ? 1 : 0;
+}
+
+/******************************************************
+ * PinmameSetMemTrace
+ *
+ * Traces the memory accesses of the following runs to
+ * the gzip'ed file p_path, NULL to stop. p_filter
+ * selects what is traced, e.g. "io" for the I/O
+ * handlers only or "0:3fb0-3fff" for an address range
+ * of the first CPU; NULL traces everything. The file
+ * format is described in memtrace.h.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSetMemTrace(const char* const p_path, const char* const p_filter)
+{
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	_memTraceFile = p_path ? p_path : "";
+	_memTraceFilter = p_filter ? p_filter : "";
+	options.memtrace_file = _memTraceFile.empty() ? NULL : (char*)_memTraceFile.c_str();
+	options.memtrace_filter = _memTraceFilter.empty() ? NULL : (char*)_memTraceFilter.c_str();
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetRewind
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetRewind()
+{
+	return _rewindSnapshots;
+}
+
+/******************************************************
+ * PinmameSetRewind
+ ******************************************************/
+
+PINMAMEAPI void PinmameSetRewind(const int snapshots, const int intervalMs)
+{
+	_rewindSnapshots = (snapshots > 0) ? snapshots : 0;
+	_rewindInterval = (intervalMs > 0) ? intervalMs : 1;
+}
+
+/******************************************************
+ * PinmameSetInputLog
+ *
+ * Records the switch changes of the following runs to,
+ * or replays them from, inp/<p_name>.inp. Takes effect
+ * with the next PinmameRun().
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSetInputLog(const PINMAME_INPUT_LOG_MODE mode, const char* const p_name)
+{
+	if (_isRunning)
+		return PINMAME_STATUS_GAME_ALREADY_RUNNING;
+
+	if (mode != PINMAME_INPUT_LOG_MODE_OFF && (!p_name || !*p_name))
+		return PINMAME_STATUS_FILE_ERROR;
+
+	_inputLogMode = mode;
+	_inputLogName = (mode != PINMAME_INPUT_LOG_MODE_OFF) ? p_name : "";
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetInputLogStatus
+ *
+ * Progress of the running, or result of the last,
+ * recording or replay.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetInputLogStatus(PinmameInputLogStatus* const p_status)
+{
+	InputLogGetStatus(p_status);
+
+	return PINMAME_STATUS_OK;
+}
+
 /******************************************************
  * PinmameGetHandleKeyboard
  ******************************************************/
@@ -851,11 +1553,22 @@ PINMAMEAPI PINMAME_SOUND_MODE PinmameGetSoundMode()
 
 /******************************************************
  * PinmameSetSoundMode
+ *
+ * The built-in altsound mixer is only compiled into
+ * some platforms' builds, elsewhere its mode is
+ * refused and the current mode kept.
  ******************************************************/
 
-PINMAMEAPI void PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode)
+PINMAMEAPI PINMAME_STATUS PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode)
 {
+#if !defined(VPINMAME_ALTSOUND) || !defined(ALTSOUND_INTERNAL_MIXER)
+	if (soundMode == PINMAME_SOUND_MODE_ALTSOUND_INTERNAL)
+		return PINMAME_STATUS_SOUND_MODE_NOT_SUPPORTED;
+#endif
+
 	g_fSoundMode = soundMode;
+
+	return PINMAME_STATUS_OK;
 }
 
 /******************************************************
@@ -877,6 +1590,21 @@ PINMAMEAPI PINMAME_STATUS PinmameRun(const char* const p_name)
 
 	vp_init();
 
+	strncpy(g_szGameName, drivers[gameNum]->name, sizeof(g_szGameName) - 1);
+
+	if (!InputLogOpen(_inputLogMode, _inputLogName.c_str(), drivers[gameNum]->name))
+		return PINMAME_STATUS_FILE_ERROR;
+
+	// replays run as fast as the host allows
+	if (_inputLogMode == PINMAME_INPUT_LOG_MODE_PLAYBACK || !_throttle) {
+		throttle = 0;
+		fastfrms = -1;
+	}
+
+#ifdef VPINMAME_ALTSOUND
+	pmoptions.sound_mode = (g_fSoundMode == PINMAME_SOUND_MODE_ALTSOUND_INTERNAL) ? 1 : 0;
+#endif
+
 	_p_gameThread = new std::thread(StartGame, gameNum);
 
 	return PINMAME_STATUS_OK;
@@ -928,6 +1656,172 @@ PINMAMEAPI int PinmameIsPaused()
 	return g_fPause;
 }
 
+/******************************************************
+ * RunStateRequest
+ *
+ * Hands the request to StateCallback() and waits for
+ * the emulation thread to process it. Requests of
+ * several callers run one after the other; p_job is
+ * only shared under _stateMutex, so a caller giving
+ * up can't leave the callback with a stale job.
+ ******************************************************/
+
+PINMAME_STATUS RunStateRequest(const STATE_REQUEST request, StateJob* const p_job)
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	if (g_fPause)
+		return PINMAME_STATUS_EMULATOR_PAUSED;
+
+	// the emulation thread would wait for itself
+	if (!IsStateComplete() || (_p_gameThread && std::this_thread::get_id() == _p_gameThread->get_id()))
+		return PINMAME_STATUS_STATE_NOT_SUPPORTED;
+
+	std::unique_lock<std::mutex> lock(_stateMutex);
+
+	// wait for the request of another caller
+	while (_stateRequest != STATE_REQUEST_NONE && _isRunning && !_timeToQuit && !g_fPause)
+		_stateDone.wait_for(lock, std::chrono::milliseconds(10));
+
+	if (_stateRequest != STATE_REQUEST_NONE)
+		return _isRunning ? PINMAME_STATUS_EMULATOR_PAUSED : PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	_stateRequest = request;
+	_p_stateJob = p_job;
+	cpu_loadsave_schedule_callback(StateCallback);
+
+	while (_p_stateJob == p_job && _isRunning && !_timeToQuit && !g_fPause)
+		_stateDone.wait_for(lock, std::chrono::milliseconds(10));
+
+	if (_p_stateJob == p_job) {
+		_stateRequest = STATE_REQUEST_NONE;
+		_p_stateJob = nullptr;
+		_stateDone.notify_all();
+
+		return _isRunning ? PINMAME_STATUS_EMULATOR_PAUSED : PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+	}
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameSaveState
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameSaveState(void* const p_buffer, const int bufferSize, int* const p_stateSize)
+{
+	StateJob job = { nullptr, 0, 0, 0 };
+	const PINMAME_STATUS status = RunStateRequest(STATE_REQUEST_SAVE, &job);
+
+	if (status != PINMAME_STATUS_OK)
+		return status;
+
+	if (job.result)
+		return PINMAME_STATUS_STATE_INVALID;
+
+	if (p_stateSize)
+		*p_stateSize = (int)job.size;
+
+	const bool fits = p_buffer && job.size <= (size_t)bufferSize;
+
+	if (fits)
+		memcpy(p_buffer, job.p_data, job.size);
+
+	free(job.p_data);
+
+	return fits ? PINMAME_STATUS_OK : PINMAME_STATUS_BUFFER_TOO_SMALL;
+}
+
+/******************************************************
+ * PinmameLoadState
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameLoadState(const void* const p_buffer, const int size)
+{
+	if (!p_buffer || size <= 0)
+		return PINMAME_STATUS_STATE_INVALID;
+
+	StateJob job = { (void*)p_buffer, (size_t)size, 0, 0 };
+	const PINMAME_STATUS status = RunStateRequest(STATE_REQUEST_LOAD, &job);
+
+	if (status != PINMAME_STATUS_OK)
+		return status;
+
+	return job.result ? PINMAME_STATUS_STATE_INVALID : PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameRewind
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameRewind(const int steps)
+{
+	StateJob job = { nullptr, 0, steps, 0 };
+	const PINMAME_STATUS status = RunStateRequest(STATE_REQUEST_REWIND, &job);
+
+	if (status != PINMAME_STATUS_OK)
+		return status;
+
+	return job.result ? PINMAME_STATUS_STATE_INVALID : PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetRewindStats
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetRewindStats(PinmameRewindStats* const p_stats)
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	std::lock_guard<std::mutex> lock(_stateMutex);
+
+	size_t memory;
+	state_save_ring_info(&p_stats->snapshots, &memory);
+
+	p_stats->taken = _rewindTaken;
+	p_stats->memory = memory;
+	p_stats->snapshotsPerSecond = (_rewindTime > 0) ? _rewindTaken / _rewindTime : 0;
+
+	return PINMAME_STATUS_OK;
+}
+
+/******************************************************
+ * PinmameGetPerfStats
+ *
+ * Where the host time went since the game started. The
+ * counters are read without stopping the emulation, so
+ * they can be a timeslice apart.
+ ******************************************************/
+
+PINMAMEAPI PINMAME_STATUS PinmameGetPerfStats(PinmamePerfStats* const p_stats)
+{
+	if (!_isRunning)
+		return PINMAME_STATUS_EMULATOR_NOT_RUNNING;
+
+	const double nsPerCycle = 1e9 / (double)osd_cycles_per_second();
+
+	memset(p_stats, 0, sizeof(PinmamePerfStats));
+
+	p_stats->cpus = cpu_gettotalcpu();
+	for (int cpunum = 0; cpunum < p_stats->cpus && cpunum < PINMAME_MAX_CPUS; cpunum++) {
+		p_stats->cpuCycles[cpunum] = cpunum_get_executed(cpunum);
+		p_stats->cpuNs[cpunum] = (uint64_t)(cpunum_get_hosttime(cpunum) * 1e9);
+	}
+
+	p_stats->timerCallbacks = perf_counters.timer_callbacks;
+	p_stats->mixerNs = (uint64_t)(perf_counters.mixer_time * nsPerCycle);
+	p_stats->pwmNs = (uint64_t)(perf_counters.pwm_time * nsPerCycle);
+	p_stats->displayNs = (uint64_t)(perf_counters.display_time * nsPerCycle);
+	p_stats->throttleNs = (uint64_t)(perf_counters.throttle_time * nsPerCycle);
+	p_stats->emulatedTime = perf_counters.emulated_time;
+	p_stats->hostTime = (osd_cycles() - perf_counters.start) * nsPerCycle / 1e9;
+	p_stats->speedPercent = mame_get_performance_info()->game_speed_percent;
+
+	return PINMAME_STATUS_OK;
+}
+
 /******************************************************
  * PinmameStop
  ******************************************************/
@@ -969,15 +1863,29 @@ PINMAMEAPI PINMAME_HARDWARE_GEN PinmameGetHardwareGen()
 
 /******************************************************
  * PinmameGetSwitch
+ *
+ * Includes changes still waiting in the queue (see
+ * PinmameQueueSwitches) or for the next tick of an
+ * input log recording.
  ******************************************************/
 
 PINMAMEAPI int PinmameGetSwitch(const int swNo)
 {
-	return (_isRunning) ? vp_getSwitch(swNo) : 0;
+	if (!_isRunning)
+		return 0;
+
+	int state;
+	if (SwitchQueueGet(swNo, &state) || InputLogGetSwitch(swNo, &state))
+		return state;
+
+	return vp_getSwitch(swNo);
 }
 
 /******************************************************
  * PinmameSetSwitch
+ *
+ * Applied right away, also while paused; use
+ * PinmameQueueSwitches for timestamped changes.
  ******************************************************/
 
 PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state)
@@ -985,7 +1893,8 @@ PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state)
 	if (!_isRunning)
 		return;
 
-	vp_putSwitch(swNo, state ? 1 : 0);
+	if (!InputLogSwitch(swNo, state ? 1 : 0))
+		vp_putSwitch(swNo, state ? 1 : 0);
 }
 
 /******************************************************
@@ -997,8 +1906,47 @@ PINMAMEAPI void PinmameSetSwitches(const PinmameSwitchState* const p_states, con
 	if (!_isRunning)
 		return;
 
-	for (int i = 0; i < numSwitches; ++i)
-		vp_putSwitch(p_states[i].swNo, p_states[i].state ? 1 : 0);
+	for (int i = 0; i < numSwitches; ++i) {
+		if (!InputLogSwitch(p_states[i].swNo, p_states[i].state ? 1 : 0))
+			vp_putSwitch(p_states[i].swNo, p_states[i].state ? 1 : 0);
+	}
+}
+
+/******************************************************
+ * PinmameGetHostTime
+ *
+ * Seconds on the clock switch events are timestamped
+ * with.
+ ******************************************************/
+
+PINMAMEAPI double PinmameGetHostTime()
+{
+	return SwitchQueueHostTime();
+}
+
+/******************************************************
+ * PinmameQueueSwitches
+ *
+ * Queues switch changes without blocking, safe to call
+ * from any thread. Each change is applied at the
+ * emulated time matching its timestamp, keeping the
+ * spacing between changes, and every edge of a switch
+ * is held for at least 1 ms of emulated time so the
+ * game sees it. Returns the number of events queued,
+ * less than numEvents if the queue is full.
+ ******************************************************/
+
+PINMAMEAPI int PinmameQueueSwitches(const PinmameSwitchEvent* const p_events, const int numEvents)
+{
+	if (!_isRunning)
+		return 0;
+
+	for (int i = 0; i < numEvents; ++i) {
+		if (!SwitchQueuePush(p_events[i].time, p_events[i].swNo, p_events[i].state ? 1 : 0))
+			return i;
+	}
+
+	return numEvents;
 }
 
 /******************************************************
@@ -1271,6 +2219,51 @@ PINMAMEAPI int PinmameGetNewSoundCommands(PinmameSoundCommand* const p_newComman
 	return count;
 }
 
+/******************************************************
+ * PinmameGetMaxNVRAM
+ *
+ * Size of the NVRAM of the running game, 0 if it
+ * has none.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetMaxNVRAM()
+{
+	if (!_isRunning)
+		return 0;
+
+	return core_getNvram(NULL);
+}
+
+/******************************************************
+ * PinmameGetNVRAM
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetNVRAM(uint8_t* const p_nvram)
+{
+	if (!_isRunning)
+		return -1;
+
+	return core_getNvram(p_nvram);
+}
+
+/******************************************************
+ * PinmameGetChangedNVRAM
+ *
+ * Copies the bytes changed since the last call into
+ * p_nvram (PinmameGetMaxNVRAM() bytes, usually filled
+ * by PinmameGetNVRAM() first) and returns the number
+ * of changed ranges. Changes not fitting in maxRanges
+ * are returned by the next call.
+ ******************************************************/
+
+PINMAMEAPI int PinmameGetChangedNVRAM(uint8_t* const p_nvram, PinmameNVRAMRange* const p_changedRanges, const int maxRanges)
+{
+	if (!_isRunning)
+		return -1;
+
+	return core_getChangedNvram(p_nvram, (core_tNvramRange*)p_changedRanges, maxRanges);
+}
+
 /******************************************************
  * PinmameGetDIP
  ******************************************************/
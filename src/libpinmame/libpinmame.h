@@ -15,6 +15,7 @@
 
 #define PINMAME_MAX_PATH 512
 #define PINMAME_MAX_MECHSW 20
+#define PINMAME_MAX_CPUS 8 // from driver.h
 #define PINMAME_ACCUMULATOR_SAMPLES 8192 // from mixer.c
 
 typedef enum {
@@ -30,7 +31,13 @@ typedef enum {
 	PINMAME_STATUS_GAME_ALREADY_RUNNING = 3,
 	PINMAME_STATUS_EMULATOR_NOT_RUNNING = 4,
 	PINMAME_STATUS_MECH_HANDLE_MECHANICS = 5,
-	PINMAME_STATUS_MECH_NO_INVALID = 6
+	PINMAME_STATUS_MECH_NO_INVALID = 6,
+	PINMAME_STATUS_EMULATOR_PAUSED = 7,
+	PINMAME_STATUS_STATE_NOT_SUPPORTED = 8,
+	PINMAME_STATUS_STATE_INVALID = 9,
+	PINMAME_STATUS_BUFFER_TOO_SMALL = 10,
+	PINMAME_STATUS_FILE_ERROR = 11,
+	PINMAME_STATUS_SOUND_MODE_NOT_SUPPORTED = 12
 } PINMAME_STATUS;
 
 typedef enum {
@@ -48,7 +55,8 @@ typedef enum {
 
 typedef enum {
 	PINMAME_SOUND_MODE_DEFAULT = 0,
-	PINMAME_SOUND_MODE_ALTSOUND = 1
+	PINMAME_SOUND_MODE_ALTSOUND = 1,
+	PINMAME_SOUND_MODE_ALTSOUND_INTERNAL = 2   // altsound packs played by the built-in mixer, output via OnAudioUpdated (builds with ALTSOUND_INTERNAL_MIXER only)
 } PINMAME_SOUND_MODE;
 
 typedef enum {
@@ -56,6 +64,17 @@ typedef enum {
 	PINMAME_AUDIO_FORMAT_FLOAT = 1
 } PINMAME_AUDIO_FORMAT;
 
+typedef enum {
+	PINMAME_AUDIT_MODE_QUICK = 0,   // zip members are checked against the CRCs stored in the zip
+	PINMAME_AUDIT_MODE_FULL = 1     // every ROM is read and hashed
+} PINMAME_AUDIT_MODE;
+
+typedef enum {
+	PINMAME_INPUT_LOG_MODE_OFF = 0,
+	PINMAME_INPUT_LOG_MODE_RECORD = 1,     // switch changes are applied on a 1 ms emulated tick and logged with output checksums
+	PINMAME_INPUT_LOG_MODE_PLAYBACK = 2    // the log replaces all switch input, runs unthrottled and stops at its end
+} PINMAME_INPUT_LOG_MODE;
+
 typedef enum {
 	PINMAME_DISPLAY_TYPE_SEG16 = 0,                  // 16 segments
 	PINMAME_DISPLAY_TYPE_SEG16R = 1,                 // 16 segments with comma and period reversed
@@ -330,6 +349,12 @@ typedef struct {
 	int state;
 } PinmameSwitchState;
 
+typedef struct {
+	double time;                  // PinmameGetHostTime() when the switch changed, 0 for as soon as possible
+	int swNo;
+	int state;
+} PinmameSwitchEvent;
+
 typedef struct {
 	int solNo;
 	int state;
@@ -381,6 +406,11 @@ typedef struct {
 typedef struct {
 	int sndNo;
 } PinmameSoundCommand;
+
+typedef struct {
+	int offset;
+	int length;
+} PinmameNVRAMRange;
 	
 typedef struct {
 	const char* name;
@@ -388,6 +418,46 @@ typedef struct {
 	unsigned int standardcode;
 } PinmameKeyboardInfo;
 
+typedef struct {
+	int snapshots;
+	int taken;
+	uint64_t memory;
+	double snapshotsPerSecond;
+} PinmameRewindStats;
+
+typedef struct {
+	int cpus;
+	uint64_t cpuCycles[PINMAME_MAX_CPUS];   // emulated cycles each CPU ran
+	uint64_t cpuNs[PINMAME_MAX_CPUS];       // host time spent executing each CPU
+	uint64_t timerCallbacks;
+	uint64_t mixerNs;                       // mixing and resampling the sound
+	uint64_t pwmNs;                         // integrating the PWM outputs
+	uint64_t displayNs;                     // converting the displays
+	uint64_t throttleNs;                    // waiting to keep emulation in step with real time
+	double emulatedTime;                    // emulated seconds since the game started
+	double hostTime;                        // host seconds since the game started
+	double speedPercent;                    // over the last second, 100 for real time
+} PinmamePerfStats;
+
+typedef struct {
+	PINMAME_INPUT_LOG_MODE mode;
+	int switchEvents;
+	int checkpoints;
+	int divergences;              // checkpoints not matching the recording
+	double lastMatchTime;         // emulated seconds of the last matching checkpoint before the first divergence
+	double firstDivergenceTime;   // emulated seconds of the first diverging checkpoint, -1 if none
+	int finished;                 // playback reached the end of the log
+} PinmameInputLogStatus;
+
+typedef struct {
+	int sets;
+	int good;
+	int bestAvailable;
+	int bad;
+	int missing;
+	double seconds;
+} PinmameAuditSummary;
+
 typedef void (PINMAMECALLBACK *PinmameGameCallback)(PinmameGame* p_game, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnStateUpdatedCallback)(int state, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnDisplayAvailableCallback)(int index, int displayCount, PinmameDisplayLayout* p_displayLayout, const void* p_userData);
@@ -401,6 +471,7 @@ typedef void (PINMAMECALLBACK *PinmameOnConsoleDataUpdatedCallback)(void* p_data
 typedef int (PINMAMECALLBACK *PinmameIsKeyPressedFunction)(PINMAME_KEYCODE keycode, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnLogMessageCallback)(PINMAME_LOG_LEVEL logLevel, const char* format, va_list args, const void* p_userData);
 typedef void (PINMAMECALLBACK *PinmameOnSoundCommandCallback)(int boardNo, int cmd, const void* p_userData);
+typedef void (PINMAMECALLBACK *PinmameOnNVRAMChangedCallback)(const void* p_nvram, int size, const void* p_userData);
 
 typedef struct {
 	const PINMAME_AUDIO_FORMAT audioFormat;
@@ -422,10 +493,32 @@ typedef struct {
 
 PINMAMEAPI PINMAME_STATUS PinmameGetGame(const char* const p_name, PinmameGameCallback callback, const void* p_userData);
 PINMAMEAPI PINMAME_STATUS PinmameGetGames(PinmameGameCallback callback, const void* p_userData);
+PINMAMEAPI PINMAME_STATUS PinmameGetGamesByName(const char* const* const p_names, const int count, PinmameGameCallback callback, const void* p_userData);
+PINMAMEAPI PINMAME_STATUS PinmameGetGameClones(const char* const p_name, PinmameGameCallback callback, const void* p_userData);
+PINMAMEAPI PINMAME_STATUS PinmameAuditGames(const PINMAME_AUDIT_MODE mode, const char* const p_reportPath, PinmameAuditSummary* const p_summary);
 PINMAMEAPI void PinmameSetConfig(const PinmameConfig* const p_config);
 PINMAMEAPI void PinmameSetPath(const PINMAME_FILE_TYPE fileType, const char* const p_path);
 PINMAMEAPI int PinmameGetCheat();
 PINMAMEAPI void PinmameSetCheat(const int cheat);
+PINMAMEAPI int PinmameGetFullRomVerify();
+PINMAMEAPI void PinmameSetFullRomVerify(const int fullVerify);
+PINMAMEAPI int PinmameGetWarmStart();
+PINMAMEAPI void PinmameSetWarmStart(const int bootSeconds);
+PINMAMEAPI int PinmameGetThrottle();
+PINMAMEAPI void PinmameSetThrottle(const int enabled);
+PINMAMEAPI int PinmameGetNVRAMAutosave();
+PINMAMEAPI void PinmameSetNVRAMAutosave(const int intervalMs);
+PINMAMEAPI void PinmameSetNVRAMChangedCallback(PinmameOnNVRAMChangedCallback callback);
+PINMAMEAPI int PinmameGetAutoInterleave();
+PINMAMEAPI void PinmameSetAutoInterleave(const int autoInterleave);
+PINMAMEAPI int PinmameGetPCProfile();
+PINMAMEAPI PINMAME_STATUS PinmameSetPCProfile(const int cycles, const char* const p_path);
+PINMAMEAPI int PinmameGetMemTrace();
+PINMAMEAPI PINMAME_STATUS PinmameSetMemTrace(const char* const p_path, const char* const p_filter);
+PINMAMEAPI int PinmameGetRewind();
+PINMAMEAPI void PinmameSetRewind(const int snapshots, const int intervalMs);
+PINMAMEAPI PINMAME_STATUS PinmameSetInputLog(const PINMAME_INPUT_LOG_MODE mode, const char* const p_name);
+PINMAMEAPI PINMAME_STATUS PinmameGetInputLogStatus(PinmameInputLogStatus* const p_status);
 PINMAMEAPI int PinmameGetHandleKeyboard();
 PINMAMEAPI void PinmameSetHandleKeyboard(const int handleKeyboard);
 PINMAMEAPI int PinmameGetHandleMechanics();
@@ -433,17 +526,24 @@ PINMAMEAPI void PinmameSetHandleMechanics(const int handleMechanics);
 PINMAMEAPI PINMAME_DMD_MODE PinmameGetDmdMode();
 PINMAMEAPI void PinmameSetDmdMode(const PINMAME_DMD_MODE dmdMode);
 PINMAMEAPI PINMAME_SOUND_MODE PinmameGetSoundMode();
-PINMAMEAPI void PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode);
+PINMAMEAPI PINMAME_STATUS PinmameSetSoundMode(const PINMAME_SOUND_MODE soundMode);
 PINMAMEAPI PINMAME_STATUS PinmameRun(const char* const p_name);
 PINMAMEAPI int PinmameIsRunning();
 PINMAMEAPI PINMAME_STATUS PinmamePause(const int pause);
 PINMAMEAPI int PinmameIsPaused();
 PINMAMEAPI PINMAME_STATUS PinmameReset();
 PINMAMEAPI void PinmameStop();
+PINMAMEAPI PINMAME_STATUS PinmameSaveState(void* const p_buffer, const int bufferSize, int* const p_stateSize);
+PINMAMEAPI PINMAME_STATUS PinmameLoadState(const void* const p_buffer, const int size);
+PINMAMEAPI PINMAME_STATUS PinmameRewind(const int steps);
+PINMAMEAPI PINMAME_STATUS PinmameGetRewindStats(PinmameRewindStats* const p_stats);
+PINMAMEAPI PINMAME_STATUS PinmameGetPerfStats(PinmamePerfStats* const p_stats);
 PINMAMEAPI PINMAME_HARDWARE_GEN PinmameGetHardwareGen();
 PINMAMEAPI int PinmameGetSwitch(const int swNo);
 PINMAMEAPI void PinmameSetSwitch(const int swNo, const int state);
 PINMAMEAPI void PinmameSetSwitches(const PinmameSwitchState* const p_states, const int numSwitches);
+PINMAMEAPI double PinmameGetHostTime();
+PINMAMEAPI int PinmameQueueSwitches(const PinmameSwitchEvent* const p_events, const int numEvents);
 PINMAMEAPI uint32_t PinmameGetSolenoidMask(const int low);
 PINMAMEAPI void PinmameSetSolenoidMask(const int low, const uint32_t mask);
 PINMAMEAPI PINMAME_MOD_OUTPUT_TYPE PinmameGetModOutputType(const int output, const int no);
@@ -464,6 +564,9 @@ PINMAMEAPI int PinmameGetMech(const int mechNo);
 PINMAMEAPI PINMAME_STATUS PinmameSetMech(const int mechNo, const PinmameMechConfig* const p_mechConfig);
 PINMAMEAPI int PinmameGetMaxSoundCommands();
 PINMAMEAPI int PinmameGetNewSoundCommands(PinmameSoundCommand* const p_newCommands);
+PINMAMEAPI int PinmameGetMaxNVRAM();
+PINMAMEAPI int PinmameGetNVRAM(uint8_t* const p_nvram);
+PINMAMEAPI int PinmameGetChangedNVRAM(uint8_t* const p_nvram, PinmameNVRAMRange* const p_changedRanges, const int maxRanges);
 PINMAMEAPI int PinmameGetDIP(const int dipBank);
 PINMAMEAPI void PinmameSetDIP(const int dipBank, const int value);
 PINMAMEAPI void PinmameSetUserData(const void* p_userData);
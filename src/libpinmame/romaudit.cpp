@@ -0,0 +1,515 @@
+// license:BSD-3-Clause
+
+#include "romaudit.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+extern "C" {
+#include "driver.h"
+#include "audit.h"
+#include "unzip.h"
+#include "workpool.h"
+}
+
+/******************************************************
+ * ROM set sources
+ ******************************************************/
+
+struct AuditSource {
+	int pathindex;
+	bool directory;
+	ZIPMAP* p_zip;
+};
+
+// Everything found for one driver name across the ROM paths, in search order
+struct AuditSet {
+	std::vector<std::unique_ptr<AuditSource>> sources;
+	bool found = false;
+};
+
+struct AuditRom {
+	const char* p_name;
+	const char* p_expHash;
+	unsigned int expLength;
+	unsigned int length;
+	char hash[HASH_BUF_SIZE];
+	int status;
+};
+
+struct AuditResult {
+	int status;
+	std::vector<AuditRom> roms;
+};
+
+/******************************************************
+ * OpenSet - map every zip of a set once
+ ******************************************************/
+
+static void OpenSet(const char* const p_gameName, AuditSet& set)
+{
+	const int pathCount = osd_get_path_count(FILETYPE_ROM);
+	const std::string zipName = std::string(p_gameName) + ".zip";
+
+	for (int pathIndex = 0; pathIndex < pathCount; pathIndex++) {
+		// the fake root driver has no set of its own, but mame_fchecksum()
+		// still finds loose ROMs in the ROM path itself
+		if (!*p_gameName) {
+			auto p_source = std::make_unique<AuditSource>();
+			p_source->pathindex = pathIndex;
+			p_source->directory = true;
+			p_source->p_zip = nullptr;
+			set.sources.push_back(std::move(p_source));
+			continue;
+		}
+
+		if (osd_get_path_info(FILETYPE_ROM, pathIndex, p_gameName) == PATH_IS_DIRECTORY) {
+			auto p_source = std::make_unique<AuditSource>();
+			p_source->pathindex = pathIndex;
+			p_source->directory = true;
+			p_source->p_zip = nullptr;
+			set.sources.push_back(std::move(p_source));
+			set.found = true;
+		}
+
+		if (osd_get_path_info(FILETYPE_ROM, pathIndex, zipName.c_str()) != PATH_IS_FILE)
+			continue;
+
+		set.found = true;
+
+		ZIPMAP* const p_zip = zipmap_open(FILETYPE_ROM, pathIndex, zipName.c_str());
+
+		if (!p_zip)
+			continue;
+
+		auto p_source = std::make_unique<AuditSource>();
+		p_source->pathindex = pathIndex;
+		p_source->directory = false;
+		p_source->p_zip = p_zip;
+		set.sources.push_back(std::move(p_source));
+	}
+}
+
+static void CloseSet(AuditSet& set)
+{
+	for (auto& p_source : set.sources) {
+		if (p_source->p_zip)
+			zipmap_close(p_source->p_zip);
+	}
+
+	set.sources.clear();
+}
+
+/******************************************************
+ * HashPlainFile
+ ******************************************************/
+
+static bool HashPlainFile(const int pathIndex, const std::string& fileName, const UINT64 size, AuditRom& rom, const unsigned int functions)
+{
+	rom.length = (unsigned int)size;
+
+	// empty files can't be mapped
+	if (!size) {
+		hash_compute(rom.hash, nullptr, 0, functions);
+		return true;
+	}
+
+	UINT64 mappedSize;
+	const void* const p_data = osd_map_file(FILETYPE_ROM, pathIndex, fileName.c_str(), &mappedSize);
+
+	if (!p_data)
+		return false;
+
+	rom.length = (unsigned int)mappedSize;
+	hash_compute(rom.hash, (const unsigned char*)p_data, (unsigned int)mappedSize, functions);
+	osd_unmap_file(p_data, mappedSize);
+
+	return true;
+}
+
+/******************************************************
+ * FindRomFile - same search order and checks as
+ * mame_fchecksum() and AuditRomSet()
+ ******************************************************/
+
+static bool FindRomFile(const char* const p_gameName, AuditSet& set, AuditRom& rom, const PINMAME_AUDIT_MODE mode)
+{
+	const unsigned int functions = hash_data_used_functions(rom.p_expHash);
+
+	UINT32 expCrc = 0;
+	UINT8 crcs[4];
+	if (hash_data_extract_binary_checksum(rom.p_expHash, HASH_CRC, crcs))
+		expCrc = ((UINT32)crcs[0] << 24) | ((UINT32)crcs[1] << 16) | ((UINT32)crcs[2] << 8) | crcs[3];
+
+	for (auto& p_source : set.sources) {
+		if (p_source->directory) {
+			const std::string fileName = *p_gameName ? std::string(p_gameName) + "/" + rom.p_name : std::string(rom.p_name);
+			UINT64 size;
+			INT64 mtime;
+
+			if (osd_get_file_stamp(FILETYPE_ROM, p_source->pathindex, fileName.c_str(), &size, &mtime) != 0)
+				continue;
+
+			if (!HashPlainFile(p_source->pathindex, fileName, size, rom, functions))
+				continue;
+
+			return true;
+		}
+
+		// by name first, then by CRC like load_zipped_file()
+		const struct zipent* p_ent = zipmap_find(p_source->p_zip, rom.p_name);
+		if (!p_ent)
+			p_ent = zipmap_find_crc(p_source->p_zip, expCrc);
+		if (!p_ent)
+			continue;
+
+		rom.length = p_ent->uncompressed_size;
+
+		if (mode == PINMAME_AUDIT_MODE_FULL) {
+			// stored members are hashed in place
+			const UINT8* p_data = zipmap_stored(p_source->p_zip, p_ent);
+			std::vector<UINT8> data;
+			if (!p_data) {
+				data.resize(p_ent->uncompressed_size);
+				if (!data.empty() && zipmap_read(p_source->p_zip, p_ent, data.data()) != 0) {
+					rom.status = AUD_MEM_ERROR;
+					return true;
+				}
+				p_data = data.data();
+			}
+			hash_compute(rom.hash, p_data, p_ent->uncompressed_size, functions);
+		}
+		else {
+			crcs[0] = (UINT8)(p_ent->crc32 >> 24);
+			crcs[1] = (UINT8)(p_ent->crc32 >> 16);
+			crcs[2] = (UINT8)(p_ent->crc32 >> 8);
+			crcs[3] = (UINT8)(p_ent->crc32 >> 0);
+			hash_data_clear(rom.hash);
+			hash_data_insert_binary_checksum(rom.hash, HASH_CRC, crcs);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+/******************************************************
+ * AuditGame - AuditRomSet() and VerifyRomSet() on
+ * the sets opened for the driver's family
+ ******************************************************/
+
+static AuditResult AuditGame(const struct GameDriver* p_gameDrv, std::unordered_map<const struct GameDriver*, AuditSet>& sets, const PINMAME_AUDIT_MODE mode)
+{
+	AuditResult result;
+
+	auto getSet = [&sets](const struct GameDriver* p_drv) -> AuditSet& {
+		auto it = sets.find(p_drv);
+		if (it == sets.end()) {
+			it = sets.emplace(p_drv, AuditSet()).first;
+			OpenSet(p_drv->name, it->second);
+		}
+		return it->second;
+	};
+
+	if (!getSet(p_gameDrv).found && !(p_gameDrv->clone_of && getSet(p_gameDrv->clone_of).found)) {
+		result.status = NOTFOUND;
+		return result;
+	}
+
+	for (const struct RomModule* p_region = rom_first_region(p_gameDrv); p_region; p_region = rom_next_region(p_region)) {
+		if (!ROMREGION_ISROMDATA(p_region))
+			continue;
+
+		for (const struct RomModule* p_rom = rom_first_file(p_region); p_rom; p_rom = rom_next_file(p_rom)) {
+			AuditRom rom;
+			rom.p_name = ROM_GETNAME(p_rom);
+			rom.p_expHash = ROM_GETHASHDATA(p_rom);
+			rom.expLength = 0;
+			rom.length = 0;
+			rom.status = 0;
+			hash_data_clear(rom.hash);
+
+			for (const struct RomModule* p_chunk = rom_first_chunk(p_rom); p_chunk; p_chunk = rom_next_chunk(p_chunk))
+				rom.expLength += ROM_GETLENGTH(p_chunk);
+
+			bool found = false;
+			for (const struct GameDriver* p_drv = p_gameDrv; p_drv && !found; p_drv = p_drv->clone_of)
+				found = FindRomFile(p_drv->name, getSet(p_drv), rom, mode);
+
+			if (rom.status)
+				;
+			else if (!found) {
+				if (hash_data_has_info(rom.p_expHash, HASH_INFO_NO_DUMP))
+					rom.status = AUD_NOT_AVAILABLE;
+				else if (ROM_ISOPTIONAL(p_rom))
+					rom.status = AUD_OPTIONAL_ROM_NOT_FOUND;
+				else
+					rom.status = AUD_ROM_NOT_FOUND;
+			}
+			else if (rom.expLength != rom.length)
+				rom.status = AUD_LENGTH_MISMATCH;
+			else if (hash_data_has_info(rom.p_expHash, HASH_INFO_NO_DUMP))
+				rom.status = AUD_ROM_NEED_DUMP;
+			else if (!hash_data_is_equal(rom.p_expHash, rom.hash, 0))
+				rom.status = AUD_BAD_CHECKSUM;
+			else if (hash_data_has_info(rom.p_expHash, HASH_INFO_BAD_DUMP))
+				rom.status = AUD_ROM_NEED_REDUMP;
+			else
+				rom.status = AUD_ROM_GOOD;
+
+			result.roms.push_back(rom);
+		}
+	}
+
+	if (p_gameDrv->clone_of) {
+		int uniqueRomsFound = 0;
+		int cloneRomsFound = 0;
+
+		for (const auto& rom : result.roms) {
+			if (!RomInSet(p_gameDrv->clone_of, rom.p_expHash)) {
+				uniqueRomsFound++;
+				if (rom.status != AUD_ROM_NOT_FOUND)
+					cloneRomsFound++;
+			}
+		}
+
+		if (uniqueRomsFound && !cloneRomsFound) {
+			result.status = CLONE_NOTFOUND;
+			return result;
+		}
+	}
+
+	int archiveStatus = 0;
+	for (const auto& rom : result.roms)
+		archiveStatus |= rom.status;
+
+	if (archiveStatus & (AUD_ROM_NOT_FOUND | AUD_BAD_CHECKSUM | AUD_MEM_ERROR | AUD_LENGTH_MISMATCH))
+		result.status = INCORRECT;
+	else if (archiveStatus & (AUD_ROM_NEED_DUMP | AUD_ROM_NEED_REDUMP | AUD_NOT_AVAILABLE))
+		result.status = BEST_AVAILABLE;
+	else if (archiveStatus & AUD_OPTIONAL_ROM_NOT_FOUND)
+		result.status = MISSING_OPTIONAL;
+	else
+		result.status = CORRECT;
+
+	return result;
+}
+
+/******************************************************
+ * JSON report
+ ******************************************************/
+
+static const char* SetStatusName(const int status)
+{
+	switch (status) {
+		case CORRECT: return "good";
+		case MISSING_OPTIONAL: return "missing_optional";
+		case BEST_AVAILABLE: return "best_available";
+		case INCORRECT: return "bad";
+		case CLONE_NOTFOUND: return "clone_missing";
+		default: return "missing";
+	}
+}
+
+static const char* RomStatusName(const int status)
+{
+	switch (status) {
+		case AUD_ROM_GOOD: return "good";
+		case AUD_ROM_NEED_REDUMP: return "needs_redump";
+		case AUD_ROM_NOT_FOUND: return "not_found";
+		case AUD_NOT_AVAILABLE: return "not_available";
+		case AUD_BAD_CHECKSUM: return "bad_checksum";
+		case AUD_MEM_ERROR: return "read_error";
+		case AUD_LENGTH_MISMATCH: return "length_mismatch";
+		case AUD_ROM_NEED_DUMP: return "no_good_dump";
+		case AUD_OPTIONAL_ROM_NOT_FOUND: return "optional_not_found";
+		default: return "unknown";
+	}
+}
+
+static void WriteJsonString(FILE* p_file, const char* p_string)
+{
+	fputc('"', p_file);
+	for (; *p_string; p_string++) {
+		const unsigned char c = (unsigned char)*p_string;
+		if (c == '"' || c == '\\')
+			fprintf(p_file, "\\%c", c);
+		else if (c < 0x20)
+			fprintf(p_file, "\\u%04x", c);
+		else
+			fputc(c, p_file);
+	}
+	fputc('"', p_file);
+}
+
+static void WriteJsonHash(FILE* p_file, const char* const p_key, const char* const p_hash)
+{
+	char crc[9];
+	char sha1[41];
+
+	fprintf(p_file, ", \"%s\": {", p_key);
+	const bool hasCrc = hash_data_extract_printable_checksum(p_hash, HASH_CRC, crc) != 0;
+	if (hasCrc)
+		fprintf(p_file, "\"crc\": \"%s\"", crc);
+	if (hash_data_extract_printable_checksum(p_hash, HASH_SHA1, sha1))
+		fprintf(p_file, "%s\"sha1\": \"%s\"", hasCrc ? ", " : "", sha1);
+	fputc('}', p_file);
+}
+
+static bool WriteReport(const char* const p_reportPath, const PINMAME_AUDIT_MODE mode, const std::vector<AuditResult>& results, const PinmameAuditSummary& summary, const int threads)
+{
+	FILE* p_file = fopen(p_reportPath, "w");
+	if (!p_file)
+		return false;
+
+	fprintf(p_file, "{\n");
+	fprintf(p_file, "  \"mode\": \"%s\",\n", mode == PINMAME_AUDIT_MODE_FULL ? "full" : "quick");
+	fprintf(p_file, "  \"threads\": %d,\n", threads);
+	fprintf(p_file, "  \"seconds\": %.3f,\n", summary.seconds);
+	fprintf(p_file, "  \"summary\": {\"sets\": %d, \"good\": %d, \"best_available\": %d, \"bad\": %d, \"missing\": %d},\n",
+		summary.sets, summary.good, summary.bestAvailable, summary.bad, summary.missing);
+	fprintf(p_file, "  \"sets\": [");
+
+	for (size_t index = 0; index < results.size(); index++) {
+		const struct GameDriver* const p_gameDrv = drivers[index];
+		const AuditResult& result = results[index];
+
+		fprintf(p_file, "%s\n    {\"name\": ", index ? "," : "");
+		WriteJsonString(p_file, p_gameDrv->name);
+		if (p_gameDrv->clone_of && *p_gameDrv->clone_of->name) {
+			fprintf(p_file, ", \"parent\": ");
+			WriteJsonString(p_file, p_gameDrv->clone_of->name);
+		}
+		fprintf(p_file, ", \"status\": \"%s\"", SetStatusName(result.status));
+
+		// good ROMs are left out to keep the report readable
+		bool first = true;
+		for (const auto& rom : result.roms) {
+			if (rom.status == AUD_ROM_GOOD)
+				continue;
+
+			fprintf(p_file, "%s\n      {\"name\": ", first ? ", \"roms\": [" : ",");
+			WriteJsonString(p_file, rom.p_name);
+			fprintf(p_file, ", \"status\": \"%s\", \"length\": %u, \"expected_length\": %u", RomStatusName(rom.status), rom.length, rom.expLength);
+			WriteJsonHash(p_file, "expected", rom.p_expHash);
+			if (rom.status == AUD_BAD_CHECKSUM)
+				WriteJsonHash(p_file, "found", rom.hash);
+			fputc('}', p_file);
+			first = false;
+		}
+		if (!first)
+			fprintf(p_file, "\n    ]");
+		fputc('}', p_file);
+	}
+
+	fprintf(p_file, "\n  ]\n}\n");
+
+	return fclose(p_file) == 0;
+}
+
+/******************************************************
+ * AuditFamilyJob - workpool job auditing one family;
+ * files and zips are mapped, so workers never touch
+ * the osd file table
+ ******************************************************/
+
+struct AuditJob {
+	const std::vector<std::vector<int>>* p_families;
+	std::vector<AuditResult>* p_results;
+	PINMAME_AUDIT_MODE mode;
+	int pathCount;
+};
+
+static void AuditFamilyJob(void* param, int index)
+{
+	const AuditJob& job = *(const AuditJob*)param;
+	std::unordered_map<const struct GameDriver*, AuditSet> sets;
+
+	for (const int game : (*job.p_families)[index]) {
+		if (job.pathCount)
+			(*job.p_results)[game] = AuditGame(drivers[game], sets, job.mode);
+		else
+			(*job.p_results)[game].status = NOTFOUND;
+	}
+
+	for (auto& set : sets)
+		CloseSet(set.second);
+}
+
+/******************************************************
+ * RomAuditRun
+ ******************************************************/
+
+bool RomAuditRun(const PINMAME_AUDIT_MODE mode, const char* const p_reportPath, PinmameAuditSummary* const p_summary)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	// group clones with their parents, so each family's zips are parsed once
+	std::vector<std::vector<int>> families;
+	std::unordered_map<const struct GameDriver*, size_t> familyIndex;
+
+	int gameCount = 0;
+	for (; drivers[gameCount]; gameCount++) {
+		const struct GameDriver* p_root = drivers[gameCount];
+		while (p_root->clone_of)
+			p_root = p_root->clone_of;
+
+		auto it = familyIndex.find(p_root);
+		if (it == familyIndex.end()) {
+			it = familyIndex.emplace(p_root, families.size()).first;
+			families.emplace_back();
+		}
+		families[it->second].push_back(gameCount);
+	}
+
+	std::vector<AuditResult> results(gameCount);
+
+	// expand the ROM path list before the workers use it
+	const int pathCount = osd_get_path_count(FILETYPE_ROM);
+
+	const int quiet = gUnzipQuiet;
+	gUnzipQuiet = 1;
+
+	AuditJob job = { &families, &results, mode, pathCount };
+	const int threads = workpool_threads((int)families.size());
+	workpool_run((int)families.size(), AuditFamilyJob, &job);
+
+	// don't keep the zips mapped once the audit is done
+	unzip_cache_clear();
+
+	gUnzipQuiet = quiet;
+
+	PinmameAuditSummary summary;
+	memset(&summary, 0, sizeof(summary));
+	summary.sets = gameCount;
+	for (const auto& result : results) {
+		switch (result.status) {
+			case CORRECT:
+			case MISSING_OPTIONAL:
+				summary.good++;
+				break;
+			case BEST_AVAILABLE:
+				summary.bestAvailable++;
+				break;
+			case INCORRECT:
+				summary.bad++;
+				break;
+			default:
+				summary.missing++;
+				break;
+		}
+	}
+	summary.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (p_summary)
+		*p_summary = summary;
+
+	return !p_reportPath || !*p_reportPath || WriteReport(p_reportPath, mode, results, summary, threads);
+}
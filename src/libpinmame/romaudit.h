@@ -0,0 +1,12 @@
+// license:BSD-3-Clause
+
+// Whole-library ROM audit, run on a worker pool
+
+#pragma once
+
+#include "libpinmame.h"
+
+// Audit every driver's ROM set and optionally write a JSON report.
+// Must not be called while a game is running. Returns false if the
+// report could not be written
+bool RomAuditRun(const PINMAME_AUDIT_MODE mode, const char* const p_reportPath, PinmameAuditSummary* const p_summary);
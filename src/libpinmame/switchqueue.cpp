@@ -0,0 +1,291 @@
+// license:BSD-3-Clause
+
+#include "switchqueue.h"
+#include "inputlog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
+
+extern "C" {
+#include "driver.h"
+#include "core.h"
+#include "vpintf.h"
+}
+
+// Capacity of the ring, a power of two. Enough for a 2 kHz physics loop
+// to keep posting through a couple of seconds of stalled emulation
+#define SWITCHQUEUE_SIZE 4096
+
+// Every edge of a switch is held for at least this long, so the matrix
+// scan of the game sees it even if the client toggled faster than that
+#define SWITCHQUEUE_MIN_HOLD TIME_IN_MSEC(1)
+
+// Host timestamps map to emulated time through an offset. It only moves
+// when a change would land in the emulated past, or further ahead than
+// this, e.g. after a pause
+#define SWITCHQUEUE_MAX_LEAD TIME_IN_MSEC(50)
+
+// Switch numbers whose queued state PinmameGetSwitch() can see, beyond the
+// numbers of every generation
+#define SWITCHQUEUE_MAX_SWNO 512
+
+// Bounded multi-producer ring: a cell is free for position pos when its
+// seq is pos, and holds the change for pos when its seq is pos + 1
+typedef struct {
+	std::atomic<UINT32> seq;
+	double time;
+	int swNo;
+	int state;
+} SwitchQueueCell;
+
+typedef struct {
+	double time;   // emulated
+	int swNo;
+	int state;
+} SwitchQueueEvent;
+
+static SwitchQueueCell _switchQueue[SWITCHQUEUE_SIZE];
+static std::atomic<UINT32> _switchQueueHead(0);   // next position to fill
+static UINT32 _switchQueueTail = 0;               // next position to take, emulation thread only
+
+// Per switch, changes posted but not yet in the matrix and the state of the
+// latest one; posters count up, the emulation thread counts down
+typedef struct {
+	std::atomic<int> pending;
+	std::atomic<int> state;
+} SwitchQueueWanted;
+
+static SwitchQueueWanted _switchQueueWanted[SWITCHQUEUE_MAX_SWNO];
+
+static const bool _switchQueueInit = [] {
+	for (UINT32 i = 0; i < SWITCHQUEUE_SIZE; i++)
+		_switchQueue[i].seq.store(i, std::memory_order_relaxed);
+	return true;
+}();
+
+// everything below belongs to the emulation thread
+static mame_timer* _p_switchQueueTimer = nullptr;
+static double _switchQueueArmed = TIME_NEVER;
+static std::vector<SwitchQueueEvent> _switchQueuePending;           // by time
+static std::unordered_map<int, double> _switchQueueLast;            // time of the last change scheduled per switch
+static double _switchQueueOffset = 0.0;
+static int _switchQueueSynced = 0;
+static double _switchQueueLastPoll = 0.0;
+
+/******************************************************
+ * SwitchQueueHostTime
+ ******************************************************/
+
+double SwitchQueueHostTime()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/******************************************************
+ * SwitchQueuePush
+ ******************************************************/
+
+bool SwitchQueuePush(const double time, const int swNo, const int state)
+{
+	UINT32 pos = _switchQueueHead.load(std::memory_order_relaxed);
+
+	for (;;) {
+		SwitchQueueCell& cell = _switchQueue[pos & (SWITCHQUEUE_SIZE - 1)];
+		const INT32 diff = (INT32)(cell.seq.load(std::memory_order_acquire) - pos);
+
+		if (diff == 0) {
+			if (_switchQueueHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				// counted before the cell is published, so it can't be applied first
+				if (swNo >= 0 && swNo < SWITCHQUEUE_MAX_SWNO) {
+					_switchQueueWanted[swNo].state.store(state, std::memory_order_relaxed);
+					_switchQueueWanted[swNo].pending.fetch_add(1, std::memory_order_release);
+				}
+				cell.time = time;
+				cell.swNo = swNo;
+				cell.state = state;
+				cell.seq.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+			return false;
+		else
+			pos = _switchQueueHead.load(std::memory_order_relaxed);
+	}
+}
+
+/******************************************************
+ * SwitchQueueGet
+ ******************************************************/
+
+bool SwitchQueueGet(const int swNo, int* const p_state)
+{
+	if (swNo < 0 || swNo >= SWITCHQUEUE_MAX_SWNO || _switchQueueWanted[swNo].pending.load(std::memory_order_acquire) <= 0)
+		return false;
+
+	*p_state = _switchQueueWanted[swNo].state.load(std::memory_order_relaxed);
+	return true;
+}
+
+/******************************************************
+ * Scheduling
+ ******************************************************/
+
+static void Done(const int swNo)
+{
+	if (swNo >= 0 && swNo < SWITCHQUEUE_MAX_SWNO)
+		_switchQueueWanted[swNo].pending.fetch_sub(1, std::memory_order_release);
+}
+
+static void Arm()
+{
+	const double time = _switchQueuePending.empty() ? TIME_NEVER : _switchQueuePending.front().time;
+
+	if (time == _switchQueueArmed)
+		return;
+
+	_switchQueueArmed = time;
+	timer_adjust(_p_switchQueueTimer, (time == TIME_NEVER) ? TIME_NEVER : time - timer_get_time(), 0, 0);
+}
+
+static void Schedule(double time, const int swNo, const int state)
+{
+	// the state the change follows: the latest one pending, else the matrix,
+	// which the client may also have set directly
+	auto previous = std::find_if(_switchQueuePending.rbegin(), _switchQueuePending.rend(),
+		[swNo](const SwitchQueueEvent& event) { return event.swNo == swNo; });
+	const int previousState = (previous != _switchQueuePending.rend()) ? previous->state : (vp_getSwitch(swNo) ? 1 : 0);
+
+	// never reorder the changes of a switch, and hold each edge
+	auto last = _switchQueueLast.find(swNo);
+	if (last != _switchQueueLast.end())
+		time = std::max(time, last->second + ((previousState != state) ? SWITCHQUEUE_MIN_HOLD : 0.0));
+	_switchQueueLast[swNo] = time;
+
+	const SwitchQueueEvent event = { time, swNo, state };
+	_switchQueuePending.insert(std::upper_bound(_switchQueuePending.begin(), _switchQueuePending.end(), event,
+		[](const SwitchQueueEvent& a, const SwitchQueueEvent& b) { return a.time < b.time; }), event);
+}
+
+static void ApplyDue()
+{
+	// same 1ns slack the timer system uses before it fires a timer
+	const double now = timer_get_time() + TIME_IN_NSEC(1);
+	size_t count = 0;
+
+	while (count < _switchQueuePending.size() && _switchQueuePending[count].time <= now) {
+		const SwitchQueueEvent& event = _switchQueuePending[count++];
+
+		if (!InputLogSwitch(event.swNo, event.state))
+			vp_putSwitch(event.swNo, event.state);
+		Done(event.swNo);
+	}
+
+	_switchQueuePending.erase(_switchQueuePending.begin(), _switchQueuePending.begin() + count);
+}
+
+/******************************************************
+ * SwitchQueueTimer
+ ******************************************************/
+
+static void SwitchQueueTimer(int param)
+{
+	_switchQueueArmed = TIME_NEVER;
+
+	ApplyDue();
+	Arm();
+}
+
+/******************************************************
+ * SwitchQueuePoll
+ *
+ * Runs at the start of every CPU timeslice
+ ******************************************************/
+
+static void SwitchQueuePoll()
+{
+	const double now = timer_get_time();
+	SwitchQueueCell* p_cell = &_switchQueue[_switchQueueTail & (SWITCHQUEUE_SIZE - 1)];
+	bool changed = false;
+
+	// emulated time went back (state load): keep what is pending in step
+	if (now < _switchQueueLastPoll) {
+		const double delta = now - _switchQueueLastPoll;
+
+		for (SwitchQueueEvent& event : _switchQueuePending)
+			event.time += delta;
+		for (auto& last : _switchQueueLast)
+			last.second += delta;
+		_switchQueueOffset += delta;
+		changed = true;
+	}
+	_switchQueueLastPoll = now;
+
+	while (p_cell->seq.load(std::memory_order_acquire) == _switchQueueTail + 1) {
+		double time = now;
+
+		if (p_cell->time > 0.0) {
+			if (!_switchQueueSynced || p_cell->time + _switchQueueOffset < now || p_cell->time + _switchQueueOffset > now + SWITCHQUEUE_MAX_LEAD) {
+				_switchQueueOffset = now - p_cell->time;
+				_switchQueueSynced = 1;
+			}
+			time = p_cell->time + _switchQueueOffset;
+		}
+
+		Schedule(time, p_cell->swNo, p_cell->state ? 1 : 0);
+
+		p_cell->seq.store(_switchQueueTail + SWITCHQUEUE_SIZE, std::memory_order_release);
+		_switchQueueTail++;
+		p_cell = &_switchQueue[_switchQueueTail & (SWITCHQUEUE_SIZE - 1)];
+		changed = true;
+	}
+
+	if (!changed)
+		return;
+
+	ApplyDue();
+	Arm();
+}
+
+/******************************************************
+ * SwitchQueueStart
+ ******************************************************/
+
+void SwitchQueueStart()
+{
+	// machine resets free all timers
+	_p_switchQueueTimer = timer_alloc(SwitchQueueTimer);
+	_switchQueueArmed = TIME_NEVER;
+	_switchQueueLastPoll = timer_get_time();
+	Arm();
+
+	cpu_set_timeslice_hook(SwitchQueuePoll);
+}
+
+/******************************************************
+ * SwitchQueueStop
+ ******************************************************/
+
+void SwitchQueueStop()
+{
+	cpu_set_timeslice_hook(NULL);
+	_p_switchQueueTimer = nullptr;
+
+	SwitchQueueCell* p_cell = &_switchQueue[_switchQueueTail & (SWITCHQUEUE_SIZE - 1)];
+
+	while (p_cell->seq.load(std::memory_order_acquire) == _switchQueueTail + 1) {
+		Done(p_cell->swNo);
+		p_cell->seq.store(_switchQueueTail + SWITCHQUEUE_SIZE, std::memory_order_release);
+		_switchQueueTail++;
+		p_cell = &_switchQueue[_switchQueueTail & (SWITCHQUEUE_SIZE - 1)];
+	}
+
+	for (const SwitchQueueEvent& event : _switchQueuePending)
+		Done(event.swNo);
+	_switchQueuePending.clear();
+	_switchQueueLast.clear();
+	_switchQueueSynced = 0;
+}
@@ -0,0 +1,24 @@
+// license:BSD-3-Clause
+
+// Timestamped switch changes from client threads, applied at the matching
+// emulated time
+
+#pragma once
+
+#include "libpinmame.h"
+
+// Seconds on the clock switch changes are timestamped with
+double SwitchQueueHostTime();
+
+// Queue a switch change, from any thread. time is SwitchQueueHostTime() when
+// the change happened, 0 for as soon as possible. Returns false if full
+bool SwitchQueuePush(const double time, const int swNo, const int state);
+
+// State of the latest change of a switch still queued; false if none is
+bool SwitchQueueGet(const int swNo, int* const p_state);
+
+// Emulation started or was reset, hooks the queue into the CPU timeslices
+void SwitchQueueStart();
+
+// Emulation ended, drops whatever is still queued
+void SwitchQueueStop();
@@ -267,7 +267,54 @@ void PINMAMECALLBACK OnSoundCommand(int boardNo, int cmd, const void* p_userData
 	printf("OnSoundCommand: boardNo=%d, cmd=%d\n", boardNo, cmd);
 }
 
-int main(int, char**)
+int RewindBench(const char* const p_name)
+{
+	PinmameSetRewind(600, 1);
+
+	if (PinmameRun(p_name) != PINMAME_STATUS_OK)
+		return 1;
+
+	std::this_thread::sleep_for(std::chrono::seconds(10));
+
+	PinmameRewindStats stats;
+	if (PinmameGetRewindStats(&stats) == PINMAME_STATUS_OK)
+		printf("RewindBench: snapshots=%d, taken=%d, memory=%llu, snapshotsPerSecond=%.1f\n",
+			stats.snapshots,
+			stats.taken,
+			(unsigned long long)stats.memory,
+			stats.snapshotsPerSecond);
+
+	printf("RewindBench: rewind 300 steps, status=%d\n", PinmameRewind(300));
+
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	PinmameStop();
+
+	return 0;
+}
+
+int Audit(const char* const p_reportPath, const PINMAME_AUDIT_MODE mode)
+{
+	PinmameAuditSummary summary;
+	PINMAME_STATUS status = PinmameAuditGames(mode, p_reportPath, &summary);
+
+	if (status != PINMAME_STATUS_OK) {
+		printf("Audit: status=%d\n", status);
+		return 1;
+	}
+
+	printf("Audit: sets=%d, good=%d, bestAvailable=%d, bad=%d, missing=%d, seconds=%.2f\n",
+		summary.sets,
+		summary.good,
+		summary.bestAvailable,
+		summary.bad,
+		summary.missing,
+		summary.seconds);
+
+	return 0;
+}
+
+int main(int argc, char** argv)
 {
 	system(CLEAR_SCREEN);
 
@@ -304,9 +351,19 @@ int main(int, char**)
 	PinmameSetDmdMode(PINMAME_DMD_MODE_RAW);
 	PinmameSetSoundMode(PINMAME_SOUND_MODE_ALTSOUND);
 
+	if (argc == 3 && !strcmp(argv[1], "--rewind-bench"))
+		return RewindBench(argv[2]);
+
+	if (argc == 3 && (!strcmp(argv[1], "--audit") || !strcmp(argv[1], "--audit-full")))
+		return Audit(argv[2], strcmp(argv[1], "--audit") ? PINMAME_AUDIT_MODE_FULL : PINMAME_AUDIT_MODE_QUICK);
+
 	PinmameGetGames(&Game, NULL);
 	PinmameGetGame("fourx4", &Game, NULL);
 
+	const char* const batch[] = { "fh_906h", "mm_109c", "t2_l8" };
+	PinmameGetGamesByName(batch, sizeof(batch) / sizeof(batch[0]), &Game, NULL);
+	PinmameGetGameClones("fh_l9", &Game, NULL);
+
 	//PinmameRun("mm_109c");
 	//PinmameRun("fh_906h");
 	//PinmameRun("hh7");
@@ -2,17 +2,20 @@
 
 #include "driver.h"
 #include <sys/time.h>
+#include <time.h>
 
+// nanoseconds of the monotonic clock, fine enough to time a single
+// CPU timeslice for the performance counters
 inline cycles_t osd_cycles(void) {
- 	struct timeval current_time;
-	gettimeofday(&current_time, NULL);
-	
-	return ((unsigned long long)current_time.tv_sec * 1000LL + (current_time.tv_usec / 1000LL));
+	struct timespec current_time;
+	clock_gettime(CLOCK_MONOTONIC, &current_time);
+
+	return ((unsigned long long)current_time.tv_sec * 1000000000LL + current_time.tv_nsec);
 }
 
 
 inline cycles_t osd_cycles_per_second(void) {
-	return 1000;
+	return 1000000000;
 }
 
 inline cycles_t osd_profiling_ticks(void) {
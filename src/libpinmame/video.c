@@ -382,15 +382,16 @@ void SetThrottleAdj(int adj)
 
 static void throttle_speed(void) {
 	static double ticks_per_sleep_msec = 0;
+	cycles_t start;
 	cycles_t target;
 	cycles_t curr;
 	cycles_t cps;
 
 	profiler_mark(PROFILER_IDLE);
 
-	curr = osd_cycles();
+	start = curr = osd_cycles();
 	cps = osd_cycles_per_second();
-	target = this_frame_base + (int)((double)frameskip_counter * (double)cps / video_fps);
+	target = this_frame_base + (cycles_t)((double)frameskip_counter * (double)cps / video_fps);
 
 	if (curr - target < 0) {
 		if (ticks_per_sleep_msec == 0) {
@@ -413,6 +414,7 @@ static void throttle_speed(void) {
 		}
 	}
 
+	perf_counters.throttle_time += curr - start;
 	profiler_mark(PROFILER_END);
 }
 
@@ -436,7 +438,7 @@ static void throttle_speed()
 void throttle_speed_part(int part, int totalparts)
 {
 	static double ticks_per_sleep_msec = 0;
-	cycles_t target, curr, cps;
+	cycles_t start, target, curr, cps;
 
 	//// if we're only syncing to the refresh, bail now
 	//if (win_sync_refresh)
@@ -446,10 +448,10 @@ void throttle_speed_part(int part, int totalparts)
 	profiler_mark(PROFILER_IDLE);
 
 	// get the current time and the target time
-	curr = osd_cycles();
+	start = curr = osd_cycles();
 	cps = osd_cycles_per_second();
 
-	target = this_frame_base + (int)((double)frameskip_counter * (double)cps / video_fps);
+	target = this_frame_base + (cycles_t)((double)frameskip_counter * (double)cps / video_fps);
 
 	// If we are throttling to a fractional vsync, adjust target to the partial target.
 	if (totalparts != 1)
@@ -457,7 +459,7 @@ void throttle_speed_part(int part, int totalparts)
 		// Meh.  The points in the code where frameskip counter gets updated is different from where the frame base is
 		// reset.  Makes this delay computation complicated.
 		if (frameskip_counter == 0)
-			target += (int)((double)(FRAMESKIP_LEVELS) * (double)cps / video_fps);
+			target += (cycles_t)((double)(FRAMESKIP_LEVELS) * (double)cps / video_fps);
 		// MAGIC: Experimentation with actual resuts show the most even distribution if I throttle to 1/7th increments at each 25% timestep.
 		target -= ((cycles_t)((double)cps / (video_fps * (totalparts + 3)))) * (totalparts - part + 3);
 	}
@@ -514,7 +516,7 @@ void throttle_speed_part(int part, int totalparts)
 			}
 		}
 	}
-	else if (curr - target >= (int)(cps / video_fps) && totalparts == 1)
+	else if (curr - target >= (cycles_t)(cps / video_fps) && totalparts == 1)
 	{
 		// We're behind schedule by a frame or more.  Something must
 		// have taken longer than it should have (e.g., a CPU emulator
@@ -540,6 +542,7 @@ void throttle_speed_part(int part, int totalparts)
 	}
 
 	// idle time done
+	perf_counters.throttle_time += curr - start;
 	profiler_mark(PROFILER_END);
 }
 
@@ -659,13 +662,13 @@ void osd_update_video_and_audio(struct mame_display *display)
 	// if this is the first time through, initialize the previous time value
 	if (warming_up)
 	{
-		last_skipcount0_time = osd_cycles() - (int)((double)FRAMESKIP_LEVELS * (double)cps / video_fps);
+		last_skipcount0_time = osd_cycles() - (cycles_t)((double)FRAMESKIP_LEVELS * (double)cps / video_fps);
 		warming_up = 0;
 	}
 
 	// if this is the first frame in a sequence, adjust the base time for this frame
 	if (frameskip_counter == 0)
-		this_frame_base = last_skipcount0_time + (int)((double)FRAMESKIP_LEVELS * (double)cps / video_fps);
+		this_frame_base = last_skipcount0_time + (cycles_t)((double)FRAMESKIP_LEVELS * (double)cps / video_fps);
 
 	// if we're not skipping this frame, draw it
 	if (display->changed_flags & GAME_BITMAP_CHANGED)
@@ -0,0 +1,139 @@
+// license:BSD-3-Clause
+
+// YM2151 rendering benchmark: feeds ymfm a synthetic register trace with
+// all 8 channels keyed on for a share of the time, renders it in stream
+// sized blocks and reports the time taken and a checksum of the output.
+// The checksum must not change when ymfm's rendering is optimized, so
+// run it against the old and the new ymfm sources to compare.
+//
+// pinmame_ym2151_bench [-n samples] [-d keyed on percent] [-b block size]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+// ymfm is built without the PinMAME glue, which needs the whole emulator
+#undef PINMAME
+#include "../../ext/ymfm/ymfm_opm.cpp"
+
+#define YM2151_CLOCK 3579545
+
+class BenchInterface : public ymfm::ymfm_interface
+{
+};
+
+static uint32_t s_seed = 0x2151;
+
+static uint8_t Random()
+{
+	s_seed = s_seed * 1103515245 + 12345;
+	return (uint8_t)(s_seed >> 16);
+}
+
+static void Write(ymfm::ym2151& chip, uint8_t reg, uint8_t data)
+{
+	chip.write(0, reg);
+	chip.write(1, data);
+}
+
+static void KeyOn(ymfm::ym2151& chip)
+{
+	for (int ch = 0; ch < 8; ch++) {
+		Write(chip, 0x20 + ch, 0xc0 | (Random() & 0x3f));
+		Write(chip, 0x28 + ch, Random() & 0x7f);
+		Write(chip, 0x30 + ch, Random() & 0xfc);
+
+		for (int op = 0; op < 4; op++) {
+			const int slot = ch + op * 8;
+			Write(chip, 0x40 + slot, Random() & 0x7f);
+			Write(chip, 0x60 + slot, Random() & 0x3f);
+			Write(chip, 0x80 + slot, 0x10 | (Random() & 0xcf));
+			Write(chip, 0xa0 + slot, Random() & 0x1f);
+			Write(chip, 0xc0 + slot, Random() & 0x1f);
+			Write(chip, 0xe0 + slot, (Random() & 0xf0) | 0x0f);
+		}
+
+		Write(chip, 0x08, 0x78 | ch);
+	}
+}
+
+static void KeyOff(ymfm::ym2151& chip)
+{
+	for (int ch = 0; ch < 8; ch++)
+		Write(chip, 0x08, ch);
+}
+
+int main(int argc, char* argv[])
+{
+	long samples = 5100000;
+	int dutyPercent = 30;
+	int blockSize = 256;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "-n") && i + 1 < argc)
+			samples = atol(argv[++i]);
+		else if (!strcmp(argv[i], "-d") && i + 1 < argc)
+			dutyPercent = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "-b") && i + 1 < argc)
+			blockSize = atoi(argv[++i]);
+		else {
+			fprintf(stderr, "usage: %s [-n samples] [-d keyed on percent] [-b block size]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (samples <= 0 || dutyPercent < 0 || dutyPercent > 100 || blockSize <= 0) {
+		fprintf(stderr, "invalid arguments\n");
+		return 1;
+	}
+
+	BenchInterface intf;
+	ymfm::ym2151 chip(intf);
+	chip.reset();
+
+	const uint32_t sampleRate = chip.sample_rate(YM2151_CLOCK);
+
+	// one note every half second, keyed on for dutyPercent of it
+	const long period = sampleRate / 2;
+	const long keyedOn = period * dutyPercent / 100;
+
+	ymfm::ym2151::output_data* const p_output = new ymfm::ym2151::output_data[blockSize];
+
+	uint32_t checksum = 2166136261u;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (long pos = 0; pos < samples; ) {
+		// register writes happen between blocks, as with the stream updates
+		const long phase = pos % period;
+		long end = pos + blockSize;
+		if (phase == 0 && keyedOn > 0)
+			KeyOn(chip);
+		if (phase < keyedOn && pos - phase + keyedOn < end)
+			end = pos - phase + keyedOn;
+		if (phase == keyedOn)
+			KeyOff(chip);
+		if (pos - phase + period < end)
+			end = pos - phase + period;
+		if (samples < end)
+			end = samples;
+
+		chip.generate(p_output, (uint32_t)(end - pos));
+
+		for (long i = 0; i < end - pos; i++)
+			for (int j = 0; j < (int)ymfm::ym2151::OUTPUTS; j++)
+				checksum = (checksum ^ (uint32_t)p_output[i].data[j]) * 16777619u;
+
+		pos = end;
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	delete[] p_output;
+
+	printf("%ld samples (%.1f emulated s) in %.3f s, %.0f samples/s, checksum %08x\n",
+		samples, (double)samples / sampleRate, seconds, samples / seconds, checksum);
+
+	return 0;
+}
@@ -25,6 +25,7 @@
  */
 
 #include "driver.h"
+#include "state.h"
 #include "6522via.h"
 
 //#define TRACE_VIA
@@ -74,10 +75,17 @@ struct via6522
 
 	mame_timer *t1;
 	double time1;
-	char t1_active;
+	double t1_expire;	/* when the running T1 count reaches zero */
+	double t1_armed;	/* expire time t1 is armed for, TIME_NEVER if idle */
+	UINT8 t1_active;
 	mame_timer *t2;
 	double time2;
-	char t2_active;
+	double t2_start;	/* when T2 was last loaded */
+	double t2_expire;
+	double t2_armed;
+	UINT8 t2_active;
+
+	struct via6522_stats stats;
 
 	double cycles_to_sec;
 	double sec_to_cycles;
@@ -155,9 +163,18 @@ struct via6522
 #define TIMER1_VALUE(v) (v->t1ll+(v->t1lh<<8))
 #define TIMER2_VALUE(v) (v->t2ll+(v->t2lh<<8))
 
+/* A timeout only needs a real timer when something outside the chip
+   sees it happen: PB7 toggling, the T2 callback or a fresh IRQ. Anything
+   else is caught up from t1_expire/t2_expire on the next access. */
+#define T1_NEEDS_TIMER(v)	(T1_SET_PB7(v->acr) || \
+							 (v->intf->irq_func && (v->ier & INT_T1) && !(v->ifr & INT_T1)))
+#define T2_NEEDS_TIMER(v)	(v->intf->t2_callback || \
+							 (v->intf->irq_func && (v->ier & INT_T2) && !(v->ifr & INT_T2)))
+
 /******************* static variables *******************/
 
 static struct via6522 via[MAX_VIA];
+static double via_save_time;	/* emulated time the state was saved at */
 
 /******************* configuration *******************/
 
@@ -226,25 +243,27 @@ LOG(("6522VIA chip %d: IFR = %02X.  PC: %08X\n", which, v->ifr, activecpu_get_pc
 }
 
 /******************* Timer timeouts *************************/
-static void via_t1_timeout (int which)
+
+/* T1 ran out 'periods' times since t1_expire was last set */
+static void via_t1_run_out (int which, int periods)
 {
 	struct via6522 *v = via + which;
 
 
 	if (T1_CONTINUOUS (v->acr))
     {
-		if (T1_SET_PB7(v->acr))
+		if (T1_SET_PB7(v->acr) && (periods & 1))
 			v->out_b ^= 0x80;
-		timer_adjust (v->t1, V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY), which, 0);
+		v->t1_expire += periods * V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY);
     }
 	else
     {
 		if (T1_SET_PB7(v->acr))
 			v->out_b |= 0x80;
 		v->t1_active = 0;
-		v->time1=timer_get_time();
+		v->time1 = v->t1_expire;
     }
-	if (v->ddr_b)
+	if (T1_SET_PB7(v->acr) && v->ddr_b)
 	{
 		UINT8 write_data = v->out_b & v->ddr_b;
 
@@ -258,22 +277,176 @@ static void via_t1_timeout (int which)
 		via_set_int (which, INT_T1);
 }
 
-static void via_t2_timeout (int which)
+static void via_t2_run_out (int which)
 {
 	struct via6522 *v = via + which;
 
 	if (v->intf->t2_callback)
-		v->intf->t2_callback(timer_timeelapsed(v->t2));
+		v->intf->t2_callback(v->t2_expire - v->t2_start);
 	else
 		LOG(("6522VIA chip %d: T2 timout occured but there is no callback.  PC: %08X\n", which, activecpu_get_pc()));
 
 	v->t2_active = 0;
-	v->time2=timer_get_time();
+	v->time2 = v->t2_expire;
 
 	if (!(v->ifr & INT_T2))
 		via_set_int (which, INT_T2);
 }
 
+/* bring the counters up to the current time before the CPU looks at them */
+static void via_sync (int which)
+{
+	struct via6522 *v = via + which;
+	/* same 1ns slack the timer system uses before it fires a timer */
+	double now = timer_get_time() + TIME_IN_NSEC(1);
+
+	if (v->t1_active && now > v->t1_expire)
+	{
+		int periods = 1;
+
+		if (T1_CONTINUOUS (v->acr))
+		{
+			double period = V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY);
+
+			periods += (int)((now - v->t1_expire) / period);
+			if (now > v->t1_expire + periods * period)
+				periods++;
+		}
+		v->stats.lazy_timeouts += periods;
+		via_t1_run_out (which, periods);
+	}
+	if (v->t2_active && now > v->t2_expire)
+	{
+		v->stats.lazy_timeouts++;
+		via_t2_run_out (which);
+	}
+}
+
+/* arm t1/t2 for the next timeout that has to be delivered on time */
+static void via_arm (int which, double now)
+{
+	struct via6522 *v = via + which;
+	double t1 = (v->t1_active && T1_NEEDS_TIMER(v)) ? v->t1_expire : TIME_NEVER;
+	double t2 = (v->t2_active && T2_NEEDS_TIMER(v)) ? v->t2_expire : TIME_NEVER;
+
+	if (t1 != v->t1_armed)
+	{
+		v->t1_armed = t1;
+		timer_adjust (v->t1, (t1 == TIME_NEVER) ? TIME_NEVER : t1 - now, which, 0);
+		v->stats.timer_inserts++;
+	}
+	if (t2 != v->t2_armed)
+	{
+		v->t2_armed = t2;
+		timer_adjust (v->t2, (t2 == TIME_NEVER) ? TIME_NEVER : t2 - now, which, 0);
+		v->stats.timer_inserts++;
+	}
+}
+
+static void via_schedule (int which)
+{
+	via_arm (which, timer_get_time());
+}
+
+static void via_t1_timeout (int which)
+{
+	struct via6522 *v = via + which;
+
+	v->t1_armed = TIME_NEVER;
+	v->stats.timer_timeouts++;
+	if (v->t1_active)
+		via_t1_run_out (which, 1);
+	via_schedule (which);
+}
+
+static void via_t2_timeout (int which)
+{
+	struct via6522 *v = via + which;
+
+	v->t2_armed = TIME_NEVER;
+	v->stats.timer_timeouts++;
+	if (v->t2_active)
+		via_t2_run_out (which);
+	via_schedule (which);
+}
+
+/******************* save state *******************/
+
+static void via_presave(void)
+{
+	via_save_time = timer_get_time();
+}
+
+/* The times are absolute and right once the emulated time is restored.
+   That may happen after this, so the timers are armed relative to the
+   saved time: they keep the time they have left when the time moves. */
+static void via_postload(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_VIA; i++)
+	{
+		struct via6522 *v = via + i;
+
+		if (!v->intf)
+			continue;
+		timer_adjust (v->t1, TIME_NEVER, i, 0);
+		timer_adjust (v->t2, TIME_NEVER, i, 0);
+		v->t1_armed = v->t2_armed = TIME_NEVER;
+		via_arm (i, via_save_time);
+	}
+}
+
+static void via_register_state(void)
+{
+	int i;
+
+	if (state_save_module_registered("6522via"))
+		return;
+
+	for (i = 0; i < MAX_VIA; i++)
+	{
+		struct via6522 *v = via + i;
+
+		if (!v->intf)
+			continue;
+		state_save_register_UINT8("6522via", i, "in_a",		&v->in_a, 1);
+		state_save_register_UINT8("6522via", i, "in_ca1",	&v->in_ca1, 1);
+		state_save_register_UINT8("6522via", i, "in_ca2",	&v->in_ca2, 1);
+		state_save_register_UINT8("6522via", i, "out_a",	&v->out_a, 1);
+		state_save_register_UINT8("6522via", i, "out_ca2",	&v->out_ca2, 1);
+		state_save_register_UINT8("6522via", i, "ddr_a",	&v->ddr_a, 1);
+		state_save_register_UINT8("6522via", i, "in_b",		&v->in_b, 1);
+		state_save_register_UINT8("6522via", i, "in_cb1",	&v->in_cb1, 1);
+		state_save_register_UINT8("6522via", i, "in_cb2",	&v->in_cb2, 1);
+		state_save_register_UINT8("6522via", i, "out_b",	&v->out_b, 1);
+		state_save_register_UINT8("6522via", i, "out_cb2",	&v->out_cb2, 1);
+		state_save_register_UINT8("6522via", i, "ddr_b",	&v->ddr_b, 1);
+		state_save_register_UINT8("6522via", i, "t1cl",		&v->t1cl, 1);
+		state_save_register_UINT8("6522via", i, "t1ch",		&v->t1ch, 1);
+		state_save_register_UINT8("6522via", i, "t1ll",		&v->t1ll, 1);
+		state_save_register_UINT8("6522via", i, "t1lh",		&v->t1lh, 1);
+		state_save_register_UINT8("6522via", i, "t2cl",		&v->t2cl, 1);
+		state_save_register_UINT8("6522via", i, "t2ch",		&v->t2ch, 1);
+		state_save_register_UINT8("6522via", i, "t2ll",		&v->t2ll, 1);
+		state_save_register_UINT8("6522via", i, "t2lh",		&v->t2lh, 1);
+		state_save_register_UINT8("6522via", i, "sr",		&v->sr, 1);
+		state_save_register_UINT8("6522via", i, "pcr",		&v->pcr, 1);
+		state_save_register_UINT8("6522via", i, "acr",		&v->acr, 1);
+		state_save_register_UINT8("6522via", i, "ier",		&v->ier, 1);
+		state_save_register_UINT8("6522via", i, "ifr",		&v->ifr, 1);
+		state_save_register_double("6522via", i, "time1",	&v->time1, 1);
+		state_save_register_double("6522via", i, "t1_expire",	&v->t1_expire, 1);
+		state_save_register_UINT8("6522via", i, "t1_active",	&v->t1_active, 1);
+		state_save_register_double("6522via", i, "time2",	&v->time2, 1);
+		state_save_register_double("6522via", i, "t2_start",	&v->t2_start, 1);
+		state_save_register_double("6522via", i, "t2_expire",	&v->t2_expire, 1);
+		state_save_register_UINT8("6522via", i, "t2_active",	&v->t2_active, 1);
+	}
+	state_save_register_func_presave(via_presave);
+	state_save_register_func_postload(via_postload);
+}
+
 /******************* reset *******************/
 
 void via_reset(void)
@@ -296,12 +469,17 @@ void via_reset(void)
 		v.cycles_to_sec = via[i].cycles_to_sec;
 
 		v.t1 = timer_alloc(via_t1_timeout);
+		v.t1_armed = TIME_NEVER;
 		v.t1_active = 0;
 		v.t2 = timer_alloc(via_t2_timeout);
+		v.t2_start = timer_get_time();
+		v.t2_armed = TIME_NEVER;
 		v.t2_active = 0;
 
 		via[i] = v;
     }
+
+	via_register_state();
 }
 
 /******************* CPU interface for VIA read *******************/
@@ -313,6 +491,8 @@ int via_read(int which, int offset)
 
 	offset &= 0xf;
 
+	via_sync (which);
+
 	switch (offset)
     {
     case VIA_PB:
@@ -393,7 +573,7 @@ int via_read(int which, int offset)
     case VIA_T1CL:
 		via_clear_int (which, INT_T1);
 		if (v->t1_active)
-			val = V_TIME_TO_CYCLES(timer_timeleft(v->t1)) & 0xff;
+			val = V_TIME_TO_CYCLES(v->t1_expire - timer_get_time()) & 0xff;
 		else
 		{
 			if ( T1_CONTINUOUS(v->acr) )
@@ -413,7 +593,7 @@ int via_read(int which, int offset)
 
     case VIA_T1CH:
 		if (v->t1_active)
-			val = V_TIME_TO_CYCLES(timer_timeleft(v->t1)) >> 8;
+			val = V_TIME_TO_CYCLES(v->t1_expire - timer_get_time()) >> 8;
 		else
 		{
 			if ( T1_CONTINUOUS(v->acr) )
@@ -442,7 +622,7 @@ int via_read(int which, int offset)
     case VIA_T2CL:
 		via_clear_int (which, INT_T2);
 		if (v->t2_active)
-			val = V_TIME_TO_CYCLES(timer_timeleft(v->t2)) & 0xff;
+			val = V_TIME_TO_CYCLES(v->t2_expire - timer_get_time()) & 0xff;
 		else
 		{
 			if (T2_COUNT_PB6(v->acr))
@@ -460,7 +640,7 @@ int via_read(int which, int offset)
 
     case VIA_T2CH:
 		if (v->t2_active)
-			val = V_TIME_TO_CYCLES(timer_timeleft(v->t2)) >> 8;
+			val = V_TIME_TO_CYCLES(v->t2_expire - timer_get_time()) >> 8;
 		else
 		{
 			if (T2_COUNT_PB6(v->acr))
@@ -496,6 +676,8 @@ int via_read(int which, int offset)
 		val = v->ifr;
 		break;
     }
+
+	via_schedule (which);
 	return val;
 }
 
@@ -508,6 +690,8 @@ void via_write(int which, int offset, int data)
 
 	offset &=0x0f;
 
+	via_sync (which);
+
 	switch (offset)
     {
     case VIA_PB:
@@ -677,7 +861,7 @@ void via_write(int which, int offset, int data)
 					LOG(("6522VIA chip %d: Port B is being written to but has no handler.  PC: %08X - %02X\n", which, activecpu_get_pc(), write_data));
 			}
 		}
-		timer_adjust (v->t1, V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY), which, 0);
+		v->t1_expire = timer_get_time() + V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY);
 		v->t1_active = 1;
 		break;
 
@@ -693,12 +877,15 @@ void via_write(int which, int offset, int data)
 
 		if (!T2_COUNT_PB6(v->acr))
 		{
+			double now = timer_get_time();
+
 			if (v->intf->t2_callback)
-				v->intf->t2_callback(timer_timeelapsed(v->t2));
+				v->intf->t2_callback(now - v->t2_start);
 			else
 				LOG(("6522VIA chip %d: T2 timout occured but there is no callback.  PC: %08X\n", which, activecpu_get_pc()));
 
-			timer_adjust (v->t2, V_CYCLES_TO_TIME(TIMER2_VALUE(v) + IFR_DELAY), which, 0);
+			v->t2_start = now;
+			v->t2_expire = now + V_CYCLES_TO_TIME(TIMER2_VALUE(v) + IFR_DELAY);
 			v->t2_active = 1;
 		}
 		else
@@ -776,7 +963,7 @@ LOG(("6522VIA chip %d: PCR = %02X.  PC: %08X\n", which, data, activecpu_get_pc()
 		}
 		if (T1_CONTINUOUS(data))
 		{
-			timer_adjust (v->t1, V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY), which, 0);
+			v->t1_expire = timer_get_time() + V_CYCLES_TO_TIME(TIMER1_VALUE(v) + IFR_DELAY);
 			v->t1_active = 1;
 		}
 		/* kludge for Mac Plus (and 128k, 512k, 512ke) : */
@@ -825,6 +1012,15 @@ LOG(("6522VIA chip %d: PCR = %02X.  PC: %08X\n", which, data, activecpu_get_pc()
 		via_clear_int (which, data);
 		break;
     }
+
+	via_schedule (which);
+}
+
+/******************* timer statistics *******************/
+
+void via_get_stats(int which, struct via6522_stats *stats)
+{
+	*stats = via[which].stats;
 }
 
 /******************* interface setting VIA port A input *******************/
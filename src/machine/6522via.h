@@ -59,6 +59,13 @@ struct via6522_interface
 	void (*si_ready_func)(void);		/* called when the shift-in is enabled (EXT sync mode) */
 };
 
+struct via6522_stats
+{
+	UINT32 timer_inserts;	/* times t1/t2 were (re)armed or disarmed */
+	UINT32 timer_timeouts;	/* timeouts delivered by the timer system */
+	UINT32 lazy_timeouts;	/* timeouts caught up on a register access instead */
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -76,6 +83,8 @@ void via_set_input_cb2(int which, int data);
 
 void via_set_input_si(int which, int data);
 
+void via_get_stats(int which, struct via6522_stats *stats);
+
 /******************* Standard 8-bit CPU interfaces, D0-D7 *******************/
 
 READ_HANDLER( via_0_r );
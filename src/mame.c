@@ -117,6 +117,8 @@
 #include "vidhrdw/vector.h"
 #include "palette.h"
 #include "harddisk.h"
+#include "nvsave.h"
+#include "unzip.h"
 #if defined(PINMAME) && defined(PROC_SUPPORT)
 #include "p-roc/p-roc.h"
 #endif /* PINMAME && PROC_SUPPORT */
@@ -583,17 +585,18 @@ void run_machine_core(void)
 				/* load the NVRAM now */
 				if (Machine->drv->nvram_handler)
 				{
-					mame_file *nvram_file = mame_fopen(Machine->gamedrv->name, 0, FILETYPE_NVRAM, 0);
+					mame_file *nvram_file = options.nvram ? options.nvram : mame_fopen(Machine->gamedrv->name, 0, FILETYPE_NVRAM, 0);
 					(*Machine->drv->nvram_handler)(nvram_file, 0);
-					if (nvram_file)
+					if (nvram_file && nvram_file != options.nvram)
 						mame_fclose(nvram_file);
 				}
+				nvram_autosave_start();
 
 				/* run the emulation! */
 				cpu_run();
 
-				/* save the NVRAM */
-				if (Machine->drv->nvram_handler)
+				/* save the NVRAM, unless the background saver just did */
+				if (Machine->drv->nvram_handler && !options.nvram && !nvram_autosave_stop())
 				{
 					mame_file *nvram_file = mame_fopen(Machine->gamedrv->name, 0, FILETYPE_NVRAM, 1);
 					if (nvram_file != NULL)
@@ -642,6 +645,9 @@ static void shutdown_machine(void)
 	/* close all hard drives */
 	hard_disk_close_all();
 
+	/* close the cached zips, so they can be replaced while no game runs */
+	unzip_cache_clear();
+
 	/* reset the CPU system */
 	cpu_exit();
 
@@ -1370,6 +1376,9 @@ int updatescreen(void)
 	/* blit to the screen */
 	update_video_and_audio();
 
+	/* save changed NVRAM now and then */
+	nvram_autosave_update();
+
 	/* call the end-of-frame callback */
 	if (Machine->drv->video_eof)
 	{
@@ -195,6 +195,7 @@ struct GameOptions
 {
 	mame_file *	record;			/* handle to file to record input to */
 	mame_file *	playback;		/* handle to file to playback input from */
+	mame_file *	nvram;			/* NVRAM to start from instead of the .nv file, which is then left untouched */
 	mame_file *	language_file;	/* handle to file for localization */
 
 	int		mame_debug;		/* 1 to enable debugging */
@@ -227,6 +228,13 @@ struct GameOptions
 
 	char	savegame;		/* character representing a savegame to load */
 	int     crc_only;       /* specify if only CRC should be used as checksum */
+	int     full_verify;    /* ignore the ROM verification cache and rehash every file */
+	int     nvram_autosave; /* ms between background NVRAM saves, 0 to save on exit only */
+	int     autointerleave; /* 1 to adapt the CPU interleave to cross-CPU traffic */
+	int     pcprofile;      /* cycles between PC samples, 0 for no profiling */
+	char *	pcprofile_file;	/* where the PC profile goes at exit */
+	char *	memtrace_file;	/* gzip'ed memory access trace, NULL for no tracing */
+	char *	memtrace_filter;	/* what to trace, see memtrace.h; NULL for everything */
 	char *	bios;			/* specify system bios (if used), 0 is default */
 
 	int		debug_width;	/* requested width of debugger bitmap */
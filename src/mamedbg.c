@@ -6082,4 +6082,61 @@ static void codelist_select( void )
 }
 #endif /* PINMAME */
 
-#endif
+#else /* MAME_DEBUG */
+
+#include "driver.h"
+#include "mamedbg.h"
+
+/**************************************************************************
+ * set_ea_info
+ * Without the debugger the disassemblers are only used by the PC
+ * profiler, so this just formats the operand like the version above.
+ **************************************************************************/
+const char *set_ea_info( int what, unsigned value, int size, int access )
+{
+	static char buffer[8][63+1];
+	static int which = 0;
+	const char *sign = "";
+	unsigned width, result = value;
+
+	which = (which+1) % 8;
+
+	switch( access )
+	{
+	case EA_VALUE:	/* Immediate value */
+		if( size == EA_INT8 || size == EA_UINT8 )
+			width = 2;
+		else
+		if( size == EA_INT16 || size == EA_UINT16 )
+			width = 4;
+		else
+			width = 8;
+		if( (size == EA_INT8 || size == EA_INT16 || size == EA_INT32) &&
+			(result & (1 << ((width * 4) - 1))) )
+		{
+			sign = "-";
+			result = (unsigned)-result;
+		}
+		if (width < 8)
+			result &= (1 << (width * 4)) - 1;
+		break;
+
+	case EA_ZPG_RD:
+	case EA_ZPG_WR:
+	case EA_ZPG_RDWR:
+		result &= 0xff;
+		width = (activecpu_address_bits() + 3) / 4;
+		break;
+
+	case EA_REL_PC: /* Relative program counter change */
+		result = value + size;
+		/* fall through */
+	default:
+		result &= activecpu_address_mask();
+		width = (activecpu_address_bits() + 3) / 4;
+	}
+	sprintf( buffer[which], "%s$%0*X", sign, width, result );
+	return buffer[which];
+}
+
+#endif /* MAME_DEBUG */
@@ -49,6 +49,8 @@ enum {
 #define COLOR_PC			(DBG_WHITE+DBG_BLUE*16) /* MB 980103 */
 #define COLOR_CURSOR		(DBG_WHITE+DBG_RED*16)	/* MB 980103 */
 
+#endif	/* MAME_DEBUG */
+
 /***************************************************************************
  *
  * The following functions are defined in mamedbg.c
@@ -96,9 +98,12 @@ enum {
  * an immediate value and at the same time returns a string that
  * contains a literal hex string for that address.
  * Later it could also return a symbol for that address and access.
+ * Without the debugger it only formats the operand.
  ***************************************************************************/
 extern const char *set_ea_info( int what, unsigned address, int size, int acc );
 
+#ifdef  MAME_DEBUG
+
 /* Startup and shutdown functions; called from cpu_run */
 extern void mame_debug_init(void);
 extern void mame_debug_exit(void);
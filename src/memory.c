@@ -19,12 +19,14 @@
 #include "driver.h"
 #include "osd_cpu.h"
 #include "state.h"
+#include "memtrace.h"
 
 #include <stdarg.h>
 
 
 //#define MEM_DUMP
 //#define CHECK_MASKS
+//#define MEM_BENCH
 
 
 
@@ -59,6 +61,19 @@
 #define MEMWRITESTART			profiler_mark(PROFILER_MEMWRITE);
 #define MEMWRITEEND(ret)		{ (ret); profiler_mark(PROFILER_END); return; }
 
+/* read trace for the direct page benchmark */
+#ifdef MEM_BENCH
+#define MEMBENCHREAD(f,s,a)		mem_bench_read((genf *)(f), (s), (a));
+#else
+#define MEMBENCHREAD(f,s,a)
+#endif
+
+/* access tracing on the lookup path, see memtrace.h; TRACE_ADDRESS undoes
+   the address -= offset of the 16/32-bit handlers */
+#define MEMREADTRACE(h,a,s,ret)		{ data32_t traced = (ret); if (UNEXPECTED(memtrace_active)) memory_trace(h, (s) << 4, entry, (a), traced); MEMREADEND(traced) }
+#define MEMWRITETRACE(h,a,s,ret)	{ if (UNEXPECTED(memtrace_active)) memory_trace(h, MEMTRACE_WRITE | ((s) << 4), entry, (a), data); MEMWRITEEND(ret) }
+#define TRACE_ADDRESS(h)			(address + (h)[entry].offset)
+
 #define DATABITS_TO_SHIFT(d)	(((d) == 32) ? 2 : ((d) == 16) ? 1 : 0)
 
 /* helper macros */
@@ -72,6 +87,21 @@
 #define HANDLER_TO_BANK(h)		((FPTR)(h))
 #define BANK_TO_HANDLER(b)		((genf *)(b))
 
+/* direct read pages: pages fully mapped to RAM/ROM or a bank are read
+   through a host pointer instead of walking the lookup table; a page
+   is never smaller than a 1st level lookup block */
+#define DIRECT_BITS_MIN			8						/* minimum number of address bits in a page */
+#define DIRECT_INDEX_BITS_MAX	16						/* maximum number of bits in the page index */
+#define DIRECT_NONE				0xff					/* directentry value for non-direct pages */
+
+#define DIRECT_PAGE_BITS(b)		(((b) - DIRECT_INDEX_BITS_MAX > DIRECT_BITS_MIN) ? (b) - DIRECT_INDEX_BITS_MAX : DIRECT_BITS_MIN)
+#define DIRECT_BITS(b,m)		((LEVEL2_BITS((b)-(m)) + (m) > DIRECT_PAGE_BITS(b)) ? LEVEL2_BITS((b)-(m)) + (m) : DIRECT_PAGE_BITS(b))
+#define DIRECT_INDEX(a,b,m)		((a) >> DIRECT_BITS(b,m))
+
+/* direct page lookups as used by the read handlers; ports have none */
+#define mem_direct(i)			(readmem_direct[i])
+#define port_direct(i)			((UINT8 *)NULL)
+
 
 /*-------------------------------------------------
 	TYPE DEFINITIONS
@@ -84,6 +114,9 @@ struct bank_data
 	offs_t 				base;				/* the base offset */
 	offs_t				readoffset;			/* original base offset for reads */
 	offs_t				writeoffset;		/* original base offset for writes */
+	UINT32				directcpus;			/* bit per CPU with direct pages in the bank */
+	offs_t				directfirst[MAX_CPU];	/* first direct page covered by the bank, per CPU */
+	offs_t				directlast[MAX_CPU];	/* last direct page covered by the bank, per CPU */
 };
 
 struct handler_data
@@ -126,6 +159,9 @@ struct cpu_data
 
 	struct memport_data	mem;				/* memory tables */
 	struct memport_data	port;				/* port tables */
+
+	UINT8 **			direct;				/* direct read pointers per page */
+	UINT8 *				directentry;		/* lookup entry behind each direct page */
 };
 
 struct memory_address_table
@@ -149,6 +185,7 @@ offs_t						OP_MEM_MAX;						/* opcode memory maximum */
 UINT8		 				opcode_entry;					/* opcode readmem entry */
 
 UINT8 *						readmem_lookup;					/* memory read lookup table */
+static UINT8 **				readmem_direct;					/* memory read direct page table */
 static UINT8 *				writemem_lookup;				/* memory write lookup table */
 static UINT8 *				readport_lookup;				/* port read lookup table */
 static UINT8 *				writeport_lookup;				/* port write lookup table */
@@ -206,6 +243,9 @@ static void set_static_handler(int idx,
 		read8_handler r8handler, read16_handler r16handler, read32_handler r32handler,
 		write8_handler w8handler, write16_handler w16handler, write32_handler w32handler);
 static int init_cpudata(void);
+static int init_direct(int cpunum);
+static void build_direct(int cpunum);
+static UINT8 *direct_base(const struct memport_data *memport, UINT8 entry);
 static int init_memport(int cpunum, struct memport_data *data, int abits, int dbits, int ismemory);
 static int verify_memory(void);
 static int verify_ports(void);
@@ -223,6 +263,12 @@ static void mem_dump(void);
 #ifdef CHECK_MASKS
 static void verify_masks(void);
 #endif
+#ifdef MEM_BENCH
+static void mem_bench_read(genf *handler, int size, offs_t address);
+static void mem_bench(void);
+#endif
+static void memory_trace(const struct handler_data *handlist, int flags, UINT8 entry, offs_t address, data32_t data);
+static void memory_trace_maps(void);
 
 
 
@@ -232,6 +278,8 @@ static void verify_masks(void);
 
 int memory_init(void)
 {
+	int cpunum;
+
 #ifdef CHECK_MASKS
 	verify_masks();
 #endif
@@ -266,6 +314,14 @@ int memory_init(void)
 
 	register_banks();
 
+	/* start tracing before the direct pages, which are off for full traces */
+	memtrace_start(memory_trace_maps);
+
+	/* build the direct read pages */
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		if (!init_direct(cpunum))
+			return 0;
+
 #ifdef MEM_DUMP
 	/* dump the final memory configuration */
 	mem_dump();
@@ -285,6 +341,13 @@ void memory_shutdown(void)
 	int ext_entry;
 	int cpunum;
 
+#ifdef MEM_BENCH
+	/* replay the recorded reads before the tables go away */
+	mem_bench();
+#endif
+
+	memtrace_stop();
+
 	/* free all the tables */
 	for (cpunum = 0; cpunum < MAX_CPU; cpunum++ )
 	{
@@ -296,7 +359,12 @@ void memory_shutdown(void)
 			free(cpudata[cpunum].port.read.table);
 		if (cpudata[cpunum].port.write.table)
 			free(cpudata[cpunum].port.write.table);
+		if (cpudata[cpunum].direct)
+			free(cpudata[cpunum].direct);
+		if (cpudata[cpunum].directentry)
+			free(cpudata[cpunum].directentry);
 	}
+	readmem_direct = NULL;
 	memset(&cpudata, 0, sizeof(cpudata));
 
 	/* free all the external memory */
@@ -365,6 +433,7 @@ void memory_set_context(int activecpu)
 	//opcode_entry = opcode_entry;
 
 	readmem_lookup = cpudata[activecpu].mem.read.table;
+	readmem_direct = cpudata[activecpu].direct;
 	writemem_lookup = cpudata[activecpu].mem.write.table;
 	readport_lookup = cpudata[activecpu].port.read.table;
 	writeport_lookup = cpudata[activecpu].port.write.table;
@@ -406,6 +475,35 @@ void memory_set_bankhandler_r(int bank, offs_t offset, mem_read_handler handler)
 	if (HANDLER_IS_STATIC(handler))
 		handler = rmemhandler8s[(FPTR)handler];
 	rmemhandler8[bank].handler = (genf *)handler;
+
+	/* the bank's direct pages only stay valid for the plain bank handler */
+	memory_update_direct(bank);
+}
+
+
+/*-------------------------------------------------
+	memory_update_direct - refresh the direct
+	read pages of a bank after its base or
+	handler changed
+-------------------------------------------------*/
+
+void memory_update_direct(int bank)
+{
+	struct bank_data *bdata = &bankdata[bank];
+	int cpunum;
+
+	/* every CPU mapping the bank has its own pages */
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+		if (bdata->directcpus & (1 << cpunum))
+		{
+			struct cpu_data *cpu = &cpudata[cpunum];
+			UINT8 *base = direct_base(&cpu->mem, bank);
+			offs_t page;
+
+			for (page = bdata->directfirst[cpunum]; page <= bdata->directlast[cpunum]; page++)
+				if (cpu->directentry[page] == bank)
+					cpu->direct[page] = base;
+		}
 }
 
 
@@ -1041,6 +1139,10 @@ void install_mem_handler(struct memport_data *memport, int iswrite, offs_t start
 		cpu_bankid[HANDLER_TO_BANK(handler)] = FAKE_BANKID;
 #endif /* PINMAME */
 	}
+
+	/* handlers installed after startup change the direct read pages */
+	if (!iswrite && cpudata[memport->cpunum].direct)
+		build_direct(memport->cpunum);
 }
 
 
@@ -1496,6 +1598,118 @@ static int populate_memory(void)
 }
 
 
+/*-------------------------------------------------
+	direct_base - host pointer that an address
+	inside a direct page is added to
+-------------------------------------------------*/
+
+static UINT8 *direct_base(const struct memport_data *memport, UINT8 entry)
+{
+	const struct handler_data *handler = &memport->read.handlers[entry];
+	UINT8 *base = (entry == STATIC_RAM) ? cpudata[memport->cpunum].rambase : cpu_bankbase[entry];
+
+	if (entry == DIRECT_NONE || base == NULL)
+		return NULL;
+
+	/* 8-bit RAM ignores the offset, 8-bit banks may be overridden by setbankhandler */
+	if (memport->dbits == 8)
+	{
+		if (entry == STATIC_RAM)
+			return base;
+		if (handler->handler != (genf *)rmemhandler8s[entry])
+			return NULL;
+	}
+
+	/* the byte swizzling of wider buses only survives aligned offsets */
+	if (handler->offset & ((1 << DATABITS_TO_SHIFT(memport->dbits)) - 1))
+		return NULL;
+	return base - handler->offset;
+}
+
+
+/*-------------------------------------------------
+	build_direct - rebuild the direct read pages
+	of a CPU from its read lookup table
+-------------------------------------------------*/
+
+static void build_direct(int cpunum)
+{
+	struct cpu_data *cpu = &cpudata[cpunum];
+	const struct memport_data *memport = &cpu->mem;
+	int minbits = DATABITS_TO_SHIFT(memport->dbits);
+	int pagebits = DIRECT_BITS(memport->abits, minbits);
+	int l1shift = LEVEL2_BITS(memport->ebits) + minbits;
+	offs_t pages, span, page, i;
+	int bank;
+
+	for (bank = STATIC_BANK1; bank <= STATIC_BANKMAX; bank++)
+		bankdata[bank].directcpus &= ~(1 << cpunum);
+
+	/* tiny address spaces just use the lookup table */
+	if (memport->abits <= pagebits)
+	{
+		cpu->directentry[0] = DIRECT_NONE;
+		cpu->direct[0] = NULL;
+		return;
+	}
+
+	/* each page covers one or more whole 1st level blocks */
+	pages = 1 << (memport->abits - pagebits);
+	span = 1 << (pagebits - l1shift);
+
+	for (page = 0; page < pages; page++)
+	{
+		/* a page is direct only if it maps to a single RAM/ROM/bank entry */
+		UINT8 entry = memport->read.table[page * span];
+		for (i = 1; i < span && entry != DIRECT_NONE; i++)
+			if (memport->read.table[page * span + i] != entry)
+				entry = DIRECT_NONE;
+		if (entry == STATIC_INVALID || entry > STATIC_RAM || memtrace_active == MEMTRACE_ALL)
+			entry = DIRECT_NONE;
+
+		cpu->directentry[page] = entry;
+		cpu->direct[page] = direct_base(memport, entry);
+
+		/* remember where the banks are for cpu_setbank */
+		if (entry >= STATIC_BANK1 && entry <= STATIC_BANKMAX)
+		{
+			if (!(bankdata[entry].directcpus & (1 << cpunum)))
+			{
+				bankdata[entry].directcpus |= 1 << cpunum;
+				bankdata[entry].directfirst[cpunum] = page;
+			}
+			bankdata[entry].directlast[cpunum] = page;
+		}
+	}
+}
+
+
+/*-------------------------------------------------
+	init_direct - allocate and build the direct
+	read pages of a CPU
+-------------------------------------------------*/
+
+static int init_direct(int cpunum)
+{
+	struct cpu_data *cpu = &cpudata[cpunum];
+	int pagebits = DIRECT_BITS(cpu->mem.abits, DATABITS_TO_SHIFT(cpu->mem.dbits));
+	size_t pages = (cpu->mem.abits > pagebits) ? (size_t)1 << (cpu->mem.abits - pagebits) : 1;
+	int bank;
+
+	if (cpunum == 0)
+		for (bank = 0; bank <= MAX_BANKS; bank++)
+			bankdata[bank].directcpus = 0;
+
+	cpu->direct = malloc(pages * sizeof(cpu->direct[0]));
+	cpu->directentry = malloc(pages);
+	if (!cpu->direct || !cpu->directentry)
+		return fatalerror("cpu #%d couldn't allocate direct read table\n", cpunum);
+
+	build_direct(cpunum);
+	return 1;
+}
+
+
 /*-------------------------------------------------
 	populate_ports - populate the port mapping
 	tables with entries
@@ -1819,14 +2033,22 @@ extern void bpr_memref(UINT32 adr, int length);
 #define bpr_memref(a,l)
 #endif
 
-#define READBYTE8(name,abits,lookup,handlist,mask)										\
+#define READBYTE8(name,abits,lookup,direct,handlist,mask)										\
 data8_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	MEMBENCHREAD(name,1,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,0));										\
+	if (base)																			\
+		MEMREADEND(base[address])														\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,0)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,0)];							\
@@ -1834,25 +2056,33 @@ data8_t name(offs_t address)															\
 	/* for compatibility with setbankhandler, 8-bit systems */							\
 	/* must call handlers for banks */													\
 	if (entry == STATIC_RAM)															\
-		MEMREADEND(cpu_bankbase[STATIC_RAM][address])									\
+		MEMREADTRACE(handlist,address,1,cpu_bankbase[STATIC_RAM][address])				\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		read8_handler handler = (read8_handler)handlist[entry].handler;					\
-		MEMREADEND((*handler)(address - handlist[entry].offset))						\
+		MEMREADTRACE(handlist,address,1,(*handler)(address - handlist[entry].offset))	\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READBYTE16BE(name,abits,lookup,handlist,mask)									\
+#define READBYTE16BE(name,abits,lookup,direct,handlist,mask)									\
 data8_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	MEMBENCHREAD(name,1,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,1));										\
+	if (base)																			\
+		MEMREADEND(base[BYTE_XOR_BE(address)])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -1860,26 +2090,34 @@ data8_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(cpu_bankbase[entry][BYTE_XOR_BE(address)])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE_XOR_BE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 1);													\
 		read16_handler handler = (read16_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 1, ~(0xff << shift)) >> shift)					\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 1, ~(0xff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READBYTE16LE(name,abits,lookup,handlist,mask)									\
+#define READBYTE16LE(name,abits,lookup,direct,handlist,mask)									\
 data8_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	MEMBENCHREAD(name,1,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,1));										\
+	if (base)																			\
+		MEMREADEND(base[BYTE_XOR_LE(address)])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -1887,26 +2125,34 @@ data8_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(cpu_bankbase[entry][BYTE_XOR_LE(address)])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE_XOR_LE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 1);													\
 		read16_handler handler = (read16_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 1, ~(0xff << shift)) >> shift)					\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 1, ~(0xff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READBYTE32BE(name,abits,lookup,handlist,mask)									\
+#define READBYTE32BE(name,abits,lookup,direct,handlist,mask)									\
 data8_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	MEMBENCHREAD(name,1,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,2));										\
+	if (base)																			\
+		MEMREADEND(base[BYTE4_XOR_BE(address)])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -1914,26 +2160,34 @@ data8_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(cpu_bankbase[entry][BYTE4_XOR_BE(address)])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE4_XOR_BE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 3);													\
 		read32_handler handler = (read32_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 2, ~(0xff << shift)) >> shift) 				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 2, ~(0xff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READBYTE32LE(name,abits,lookup,handlist,mask)									\
+#define READBYTE32LE(name,abits,lookup,direct,handlist,mask)									\
 data8_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask;bpr_memref(address,1);																	\
+	MEMBENCHREAD(name,1,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,2));										\
+	if (base)																			\
+		MEMREADEND(base[BYTE4_XOR_LE(address)])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -1941,14 +2195,14 @@ data8_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(cpu_bankbase[entry][BYTE4_XOR_LE(address)])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE4_XOR_LE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 3);													\
 		read32_handler handler = (read32_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 2, ~(0xff << shift)) >> shift) 				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 2, ~(0xff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
@@ -1959,14 +2213,22 @@ data8_t name(offs_t address)															\
 	(16-bit and 32-bit aligned only!)
 -------------------------------------------------*/
 
-#define READWORD16(name,abits,lookup,handlist,mask)										\
+#define READWORD16(name,abits,lookup,direct,handlist,mask)										\
 data16_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask & ~1;bpr_memref(address,2);																	\
+	MEMBENCHREAD(name,2,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,1));										\
+	if (base)																			\
+		MEMREADEND(*(data16_t *)&base[address])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,1)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,1)];							\
@@ -1974,25 +2236,33 @@ data16_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(*(data16_t *)&cpu_bankbase[entry][address])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][address])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		read16_handler handler = (read16_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 1,0))										 	\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 1,0))		\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READWORD32BE(name,abits,lookup,handlist,mask)									\
+#define READWORD32BE(name,abits,lookup,direct,handlist,mask)									\
 data16_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask & ~1;bpr_memref(address,2);																	\
+	MEMBENCHREAD(name,2,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,2));										\
+	if (base)																			\
+		MEMREADEND(*(data16_t *)&base[WORD_XOR_BE(address)])							\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2000,26 +2270,34 @@ data16_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(*(data16_t *)&cpu_bankbase[entry][WORD_XOR_BE(address)])				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][WORD_XOR_BE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 2);													\
 		read32_handler handler = (read32_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 2, ~(0xffff << shift)) >> shift)				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 2, ~(0xffff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
 
-#define READWORD32LE(name,abits,lookup,handlist,mask)									\
+#define READWORD32LE(name,abits,lookup,direct,handlist,mask)									\
 data16_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask & ~1;bpr_memref(address,2);																	\
+	MEMBENCHREAD(name,2,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,2));										\
+	if (base)																			\
+		MEMREADEND(*(data16_t *)&base[WORD_XOR_LE(address)])							\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2027,14 +2305,14 @@ data16_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(*(data16_t *)&cpu_bankbase[entry][WORD_XOR_LE(address)])				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][WORD_XOR_LE(address)])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 2);													\
 		read32_handler handler = (read32_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 2, ~(0xffff << shift)) >> shift)				\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 2, ~(0xffff << shift)) >> shift)	\
 	}																					\
 	return 0;																			\
 }																						\
@@ -2045,14 +2323,22 @@ data16_t name(offs_t address)															\
 	(32-bit aligned only!)
 -------------------------------------------------*/
 
-#define READLONG32(name,abits,lookup,handlist,mask)										\
+#define READLONG32(name,abits,lookup,direct,handlist,mask)										\
 data32_t name(offs_t address)															\
 {																						\
+	UINT8 *base;																		\
 	UINT8 entry;																		\
 	MEMREADSTART																		\
 																						\
 	/* perform lookup */																\
 	address &= mask & ~3;bpr_memref(address,4);																	\
+	MEMBENCHREAD(name,4,address)														\
+																						\
+	/* RAM/ROM pages are read straight from the host */									\
+	base = direct(DIRECT_INDEX(address,abits,2));										\
+	if (base)																			\
+		MEMREADEND(*(data32_t *)&base[address])											\
+																						\
 	entry = lookup[LEVEL1_INDEX(address,abits,2)];										\
 	if (entry >= SUBTABLE_BASE)															\
 		entry = lookup[LEVEL2_INDEX(entry,address,abits,2)];							\
@@ -2060,13 +2346,13 @@ data32_t name(offs_t address)															\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMREADEND(*(data32_t *)&cpu_bankbase[entry][address])							\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),4,*(data32_t *)&cpu_bankbase[entry][address])	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		read32_handler handler = (read32_handler)handlist[entry].handler;				\
-		MEMREADEND((*handler)(address >> 2,0))										 	\
+		MEMREADTRACE(handlist,TRACE_ADDRESS(handlist),4,(*handler)(address >> 2,0))		\
 	}																					\
 	return 0;																			\
 }																						\
@@ -2091,13 +2377,13 @@ void name(offs_t address, data8_t data)													\
 	/* for compatibility with setbankhandler, 8-bit systems */							\
 	/* must call handlers for banks */													\
 	if (entry == (FPTR)MRA_RAM)															\
-		MEMWRITEEND(cpu_bankbase[STATIC_RAM][address] = data)							\
+		MEMWRITETRACE(handlist,address,1,cpu_bankbase[STATIC_RAM][address] = data)		\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		write8_handler handler = (write8_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address - handlist[entry].offset, data))					\
+		MEMWRITETRACE(handlist,address,1,(*handler)(address - handlist[entry].offset, data))	\
 	}																					\
 }																						\
 
@@ -2116,14 +2402,14 @@ void name(offs_t address, data8_t data)													\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(cpu_bankbase[entry][BYTE_XOR_BE(address)] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE_XOR_BE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 1);													\
 		write16_handler handler = (write16_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 1, data << shift, ~(0xff << shift))) 			\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 1, data << shift, ~(0xff << shift)))	\
 	}																					\
 }																						\
 
@@ -2142,14 +2428,14 @@ void name(offs_t address, data8_t data)													\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(cpu_bankbase[entry][BYTE_XOR_LE(address)] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE_XOR_LE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 1);													\
 		write16_handler handler = (write16_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 1, data << shift, ~(0xff << shift)))			\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 1, data << shift, ~(0xff << shift)))	\
 	}																					\
 }																						\
 
@@ -2168,14 +2454,14 @@ void name(offs_t address, data8_t data)													\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(cpu_bankbase[entry][BYTE4_XOR_BE(address)] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE4_XOR_BE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 3);													\
 		write32_handler handler = (write32_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 2, data << shift, ~(0xff << shift))) 			\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 2, data << shift, ~(0xff << shift)))	\
 	}																					\
 }																						\
 
@@ -2194,14 +2480,14 @@ void name(offs_t address, data8_t data)													\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(cpu_bankbase[entry][BYTE4_XOR_LE(address)] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,cpu_bankbase[entry][BYTE4_XOR_LE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 3);													\
 		write32_handler handler = (write32_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 2, data << shift, ~(0xff << shift))) 			\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),1,(*handler)(address >> 2, data << shift, ~(0xff << shift)))	\
 	}																					\
 }																						\
 
@@ -2226,13 +2512,13 @@ void name(offs_t address, data16_t data)												\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(*(data16_t *)&cpu_bankbase[entry][address] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][address] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		write16_handler handler = (write16_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 1, data, 0))								 	\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 1, data, 0))	\
 	}																					\
 }																						\
 
@@ -2251,14 +2537,14 @@ void name(offs_t address, data16_t data)												\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(*(data16_t *)&cpu_bankbase[entry][WORD_XOR_BE(address)] = data)		\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][WORD_XOR_BE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (~address & 2);													\
 		write32_handler handler = (write32_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 2, data << shift, ~(0xffff << shift))) 		\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 2, data << shift, ~(0xffff << shift)))	\
 	}																					\
 }																						\
 
@@ -2277,14 +2563,14 @@ void name(offs_t address, data16_t data)												\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(*(data16_t *)&cpu_bankbase[entry][WORD_XOR_LE(address)] = data)		\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,*(data16_t *)&cpu_bankbase[entry][WORD_XOR_LE(address)] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		int shift = 8 * (address & 2);													\
 		write32_handler handler = (write32_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 2, data << shift, ~(0xffff << shift))) 		\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),2,(*handler)(address >> 2, data << shift, ~(0xffff << shift)))	\
 	}																					\
 }																						\
 
@@ -2309,13 +2595,13 @@ void name(offs_t address, data32_t data)												\
 	/* handle banks inline */															\
 	address -= handlist[entry].offset;													\
 	if (entry <= STATIC_RAM)															\
-		MEMWRITEEND(*(data32_t *)&cpu_bankbase[entry][address] = data)					\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),4,*(data32_t *)&cpu_bankbase[entry][address] = data)	\
 																						\
 	/* fall back to the handler */														\
 	else																				\
 	{																					\
 		write32_handler handler = (write32_handler)handlist[entry].handler;				\
-		MEMWRITEEND((*handler)(address >> 2, data, 0))								 	\
+		MEMWRITETRACE(handlist,TRACE_ADDRESS(handlist),4,(*handler)(address >> 2, data, 0))	\
 	}																					\
 }																						\
 
@@ -2378,33 +2664,33 @@ void name(offs_t pc)																	\
 -------------------------------------------------*/
 
 #define GENERATE_HANDLERS_8BIT(type, abits) \
-	    READBYTE8(cpu_read##type##abits,             abits, read##type##_lookup,  r##type##handler8,  type##_amask) \
+	    READBYTE8(cpu_read##type##abits,             abits, read##type##_lookup, type##_direct,  r##type##handler8,  type##_amask) \
 	   WRITEBYTE8(cpu_write##type##abits,            abits, write##type##_lookup, w##type##handler8,  type##_amask)
 
 #define GENERATE_HANDLERS_16BIT_BE(type, abits) \
-	 READBYTE16BE(cpu_read##type##abits##bew,        abits, read##type##_lookup,  r##type##handler16, type##_amask) \
-	   READWORD16(cpu_read##type##abits##bew_word,   abits, read##type##_lookup,  r##type##handler16, type##_amask) \
+	 READBYTE16BE(cpu_read##type##abits##bew,        abits, read##type##_lookup, type##_direct,  r##type##handler16, type##_amask) \
+	   READWORD16(cpu_read##type##abits##bew_word,   abits, read##type##_lookup, type##_direct,  r##type##handler16, type##_amask) \
 	WRITEBYTE16BE(cpu_write##type##abits##bew,       abits, write##type##_lookup, w##type##handler16, type##_amask) \
 	  WRITEWORD16(cpu_write##type##abits##bew_word,  abits, write##type##_lookup, w##type##handler16, type##_amask)
 
 #define GENERATE_HANDLERS_16BIT_LE(type, abits) \
-	 READBYTE16LE(cpu_read##type##abits##lew,        abits, read##type##_lookup,  r##type##handler16, type##_amask) \
-	   READWORD16(cpu_read##type##abits##lew_word,   abits, read##type##_lookup,  r##type##handler16, type##_amask) \
+	 READBYTE16LE(cpu_read##type##abits##lew,        abits, read##type##_lookup, type##_direct,  r##type##handler16, type##_amask) \
+	   READWORD16(cpu_read##type##abits##lew_word,   abits, read##type##_lookup, type##_direct,  r##type##handler16, type##_amask) \
 	WRITEBYTE16LE(cpu_write##type##abits##lew,       abits, write##type##_lookup, w##type##handler16, type##_amask) \
 	  WRITEWORD16(cpu_write##type##abits##lew_word,  abits, write##type##_lookup, w##type##handler16, type##_amask)
 
 #define GENERATE_HANDLERS_32BIT_BE(type, abits) \
-	 READBYTE32BE(cpu_read##type##abits##bedw,       abits, read##type##_lookup,  r##type##handler32, type##_amask) \
-	 READWORD32BE(cpu_read##type##abits##bedw_word,  abits, read##type##_lookup,  r##type##handler32, type##_amask) \
-	   READLONG32(cpu_read##type##abits##bedw_dword, abits, read##type##_lookup,  r##type##handler32, type##_amask) \
+	 READBYTE32BE(cpu_read##type##abits##bedw,       abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
+	 READWORD32BE(cpu_read##type##abits##bedw_word,  abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
+	   READLONG32(cpu_read##type##abits##bedw_dword, abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
 	WRITEBYTE32BE(cpu_write##type##abits##bedw,      abits, write##type##_lookup, w##type##handler32, type##_amask) \
 	WRITEWORD32BE(cpu_write##type##abits##bedw_word, abits, write##type##_lookup, w##type##handler32, type##_amask) \
 	  WRITELONG32(cpu_write##type##abits##bedw_dword,abits, write##type##_lookup, w##type##handler32, type##_amask)
 
 #define GENERATE_HANDLERS_32BIT_LE(type, abits) \
-	 READBYTE32LE(cpu_read##type##abits##ledw,       abits, read##type##_lookup,  r##type##handler32, type##_amask) \
-	 READWORD32LE(cpu_read##type##abits##ledw_word,  abits, read##type##_lookup,  r##type##handler32, type##_amask) \
-	   READLONG32(cpu_read##type##abits##ledw_dword, abits, read##type##_lookup,  r##type##handler32, type##_amask) \
+	 READBYTE32LE(cpu_read##type##abits##ledw,       abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
+	 READWORD32LE(cpu_read##type##abits##ledw_word,  abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
+	   READLONG32(cpu_read##type##abits##ledw_dword, abits, read##type##_lookup, type##_direct,  r##type##handler32, type##_amask) \
 	WRITEBYTE32LE(cpu_write##type##abits##ledw,      abits, write##type##_lookup, w##type##handler32, type##_amask) \
 	WRITEWORD32LE(cpu_write##type##abits##ledw_word, abits, write##type##_lookup, w##type##handler32, type##_amask) \
 	  WRITELONG32(cpu_write##type##abits##ledw_dword,abits, write##type##_lookup, w##type##handler32, type##_amask)
@@ -2815,6 +3101,118 @@ static int init_static(void)
 }
 
 
+/*-------------------------------------------------
+	memory_trace - pass an access of the lookup
+	path on to the tracer
+-------------------------------------------------*/
+
+static void memory_trace(const struct handler_data *handlist, int flags, UINT8 entry, offs_t address, data32_t data)
+{
+	if (handlist == rporthandler8 || handlist == rporthandler16 || handlist == rporthandler32 ||
+		handlist == wporthandler8 || handlist == wporthandler16 || handlist == wporthandler32)
+		flags |= MEMTRACE_PORT;
+	memtrace_access(flags, entry, address, data);
+}
+
+
+/*-------------------------------------------------
+	trace_run - describe a run of one entry in
+	the trace header
+-------------------------------------------------*/
+
+static void trace_run(int cpunum, int flags, const struct table_data *table, offs_t start, offs_t end, UINT8 entry)
+{
+	char what[64];
+
+	if (entry == STATIC_UNMAP)
+		return;
+
+	if (entry >= STATIC_BANK1 && entry <= STATIC_BANKMAX)
+		sprintf(what, "bank %d", entry);
+	else if (entry >= STATIC_COUNT)
+		sprintf(what, "handler %p", (void *)(FPTR)table->handlers[entry].handler);
+	else
+		strcpy(what, (entry == STATIC_RAM) ? "ram" : (entry == STATIC_ROM) ? "rom" : (entry == STATIC_RAMROM) ? "ramrom" : (entry == STATIC_NOP) ? "nop" : "static");
+
+	memtrace_map(cpunum, flags, start, end, entry, what);
+}
+
+
+/*-------------------------------------------------
+	trace_table - describe a lookup table as
+	runs of the same entry
+-------------------------------------------------*/
+
+static void trace_table(int cpunum, int flags, const struct memport_data *memport, const struct table_data *table)
+{
+	int minbits = DATABITS_TO_SHIFT(memport->dbits);
+	int l1bits = LEVEL1_BITS(memport->ebits);
+	int l2bits = LEVEL2_BITS(memport->ebits);
+	int l1count = 1 << l1bits;
+	int l2count = 1 << l2bits;
+	offs_t start = 0;
+	UINT8 run = table->table[0];
+	int i, j;
+
+	for (i = 0; i < l1count; i++)
+	{
+		UINT8 entry = table->table[i];
+
+		if (entry < SUBTABLE_BASE)
+		{
+			if (entry != run)
+			{
+				offs_t address = (offs_t)i << (l2bits + minbits);
+				trace_run(cpunum, flags, table, start, address - 1, run);
+				start = address;
+				run = entry;
+			}
+			continue;
+		}
+
+		for (j = 0; j < l2count; j++)
+		{
+			UINT8 entry2 = table->table[l1count + ((entry & SUBTABLE_MASK) << l2bits) + j];
+			if (entry2 != run)
+			{
+				offs_t address = ((offs_t)i << (l2bits + minbits)) | ((offs_t)j << minbits);
+				trace_run(cpunum, flags, table, start, address - 1, run);
+				start = address;
+				run = entry2;
+			}
+		}
+	}
+	trace_run(cpunum, flags, table, start, ((offs_t)l1count << (l2bits + minbits)) - 1, run);
+}
+
+
+/*-------------------------------------------------
+	memory_trace_maps - describe the lookup
+	tables of all CPUs in the trace header
+-------------------------------------------------*/
+
+static void memory_trace_maps(void)
+{
+	int cpunum;
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		struct cpu_data *cpu = &cpudata[cpunum];
+
+		if (cpu->mem.abits)
+		{
+			trace_table(cpunum, 0, &cpu->mem, &cpu->mem.read);
+			trace_table(cpunum, MEMTRACE_WRITE, &cpu->mem, &cpu->mem.write);
+		}
+		if (cpu->port.abits)
+		{
+			trace_table(cpunum, MEMTRACE_PORT, &cpu->port, &cpu->port.read);
+			trace_table(cpunum, MEMTRACE_PORT | MEMTRACE_WRITE, &cpu->port, &cpu->port.write);
+		}
+	}
+}
+
+
 /*-------------------------------------------------
 	debugging
 -------------------------------------------------*/
@@ -3085,3 +3483,117 @@ static void verify_masks(void)
 	printf("Busted entries that are static = %d\n", static_count);
 }
 #endif
+
+
+#ifdef MEM_BENCH
+/*-------------------------------------------------
+	mem_bench - replay the first reads of the
+	run through the direct pages and through the
+	lookup tables and compare the timings
+-------------------------------------------------*/
+
+#define MEM_BENCH_TRACE			(1 << 20)				/* number of reads recorded */
+#define MEM_BENCH_PASSES		16						/* replays of the trace per path */
+
+struct mem_bench_entry
+{
+	genf *				handler;			/* read function that was called */
+	offs_t				address;			/* masked address */
+	UINT8				cpunum;				/* CPU context */
+	UINT8				size;				/* bytes read */
+};
+
+static struct mem_bench_entry *bench_trace;
+static int bench_count;
+
+static void mem_bench_read(genf *handler, int size, offs_t address)
+{
+	struct mem_bench_entry *entry;
+
+	if (!bench_trace)
+		bench_trace = malloc(MEM_BENCH_TRACE * sizeof(bench_trace[0]));
+	if (!bench_trace || bench_count >= MEM_BENCH_TRACE || cur_context < 0)
+		return;
+
+	entry = &bench_trace[bench_count++];
+	entry->handler = handler;
+	entry->address = address;
+	entry->cpunum = cur_context;
+	entry->size = size;
+}
+
+static data32_t mem_bench_replay(int count, cycles_t *cycles)
+{
+	data32_t sum = 0;
+	int pass, i;
+
+	*cycles = osd_cycles();
+	for (pass = 0; pass < MEM_BENCH_PASSES; pass++)
+		for (i = 0; i < count; i++)
+		{
+			const struct mem_bench_entry *entry = &bench_trace[i];
+			if (entry->cpunum != cur_context)
+				memory_set_context(entry->cpunum);
+			switch (entry->size)
+			{
+				case 1:	sum += (*(data8_t (*)(offs_t))entry->handler)(entry->address);	break;
+				case 2:	sum += (*(data16_t (*)(offs_t))entry->handler)(entry->address);	break;
+				case 4:	sum += (*(data32_t (*)(offs_t))entry->handler)(entry->address);	break;
+			}
+		}
+	*cycles = osd_cycles() - *cycles;
+	return sum;
+}
+
+static void mem_bench(void)
+{
+	UINT8 **direct[MAX_CPU];
+	data32_t directsum, lookupsum;
+	cycles_t directcycles, lookupcycles;
+	double nsperread;
+	int cpunum, count = 0, total = bench_count, i;
+
+	if (!bench_trace || cur_context < 0)
+		return;
+
+	/* the replays must not extend the trace */
+	bench_count = MEM_BENCH_TRACE;
+
+	/* keep only the reads whose page is still direct; the rest may touch I/O */
+	for (i = 0; i < total; i++)
+	{
+		const struct mem_bench_entry *entry = &bench_trace[i];
+		const struct memport_data *memport = &cpudata[entry->cpunum].mem;
+		int pagebits = DIRECT_BITS(memport->abits, DATABITS_TO_SHIFT(memport->dbits));
+		if (cpudata[entry->cpunum].direct[entry->address >> pagebits])
+			bench_trace[count++] = *entry;
+	}
+
+	/* direct pages first, then the same reads with all pages disabled */
+	directsum = mem_bench_replay(count, &directcycles);
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		int pagebits = DIRECT_BITS(cpudata[cpunum].mem.abits, DATABITS_TO_SHIFT(cpudata[cpunum].mem.dbits));
+		size_t pages = (cpudata[cpunum].mem.abits > pagebits) ? (size_t)1 << (cpudata[cpunum].mem.abits - pagebits) : 1;
+		direct[cpunum] = cpudata[cpunum].direct;
+		cpudata[cpunum].direct = calloc(pages, sizeof(direct[cpunum][0]));
+	}
+	memory_set_context(cur_context);
+	lookupsum = mem_bench_replay(count, &lookupcycles);
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		free(cpudata[cpunum].direct);
+		cpudata[cpunum].direct = direct[cpunum];
+	}
+	memory_set_context(cur_context);
+
+	nsperread = count ? 1e9 / (double)osd_cycles_per_second() / ((double)count * MEM_BENCH_PASSES) : 0;
+	logerror("memory bench: %d of %d reads direct, direct %.2f ns/read, lookup %.2f ns/read, %s\n",
+			count, total, directcycles * nsperread, lookupcycles * nsperread,
+			(directsum == lookupsum) ? "results match" : "RESULTS DIFFER");
+
+	free(bench_trace);
+	bench_trace = NULL;
+	bench_count = 0;
+}
+#endif
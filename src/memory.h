@@ -819,6 +819,7 @@ void		memory_set_unmap_value(data32_t value);
 /* ----- dynamic bank handlers ----- */
 void		memory_set_bankhandler_r(int bank, offs_t offset, mem_read_handler handler);
 void		memory_set_bankhandler_w(int bank, offs_t offset, mem_write_handler handler);
+void		memory_update_direct(int bank);
 
 /* ----- opcode base control ---- */
 opbase_handler memory_set_opbase_handler(int cpunum, opbase_handler function);
@@ -949,6 +950,7 @@ do {																					\
 	if (bank >= STATIC_BANK1 && bank <= STATIC_BANKMAX)									\
 	{																					\
 		cpu_bankbase[bank] = (UINT8 *)(base);											\
+		memory_update_direct(bank);														\
 		if (opcode_entry == bank && cpu_getactivecpu() >= 0)							\
 		{																				\
 			opcode_entry = 0xff;														\
@@ -0,0 +1,374 @@
+/*********************************************************************
+
+	memtrace.c
+
+	Memory access tracing. memory.c reports the accesses of its lookup
+	path; they are filtered, stored in a ring per CPU and written to a
+	gzip'ed file by a worker thread. The rings are single producer,
+	single consumer: the emulation thread only moves the head, the
+	writer only the tail.
+
+*********************************************************************/
+
+#include "driver.h"
+#include "memtrace.h"
+#include <zlib.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <process.h>
+static HANDLE memtrace_thread;
+#define memtrace_barrier()	MemoryBarrier()
+#define memtrace_sleep()	Sleep(1)
+#else
+#include <pthread.h>
+#include <unistd.h>
+static pthread_t memtrace_thread;
+#define memtrace_barrier()	__sync_synchronize()
+#define memtrace_sleep()	usleep(1000)
+#endif
+
+#define MEMTRACE_RING_SIZE	(1 << 16)			/* records per CPU, a power of two */
+#define MEMTRACE_PUBLISH	256					/* records between head updates */
+#define MEMTRACE_FILTERS	16
+
+struct memtrace_ring
+{
+	struct memtrace_record *record;
+	UINT32 fill;								/* next record written, emulation thread only */
+	volatile UINT32 head;						/* records up to here are visible to the writer */
+	volatile UINT32 tail;						/* records up to here are written */
+};
+
+struct memtrace_filter
+{
+	int cpunum;									/* -1 for any CPU */
+	int entry;									/* handler table entry, -1 for an address range */
+	offs_t start, end;
+};
+
+int memtrace_active;
+
+static struct memtrace_ring ring[MAX_CPU];
+static struct memtrace_filter filter[MEMTRACE_FILTERS];
+static int filters;
+static int io_only;
+static UINT32 sequence;
+static UINT32 stalls;							/* times the emulation waited for the writer */
+
+/* shared with the writer */
+static gzFile file;
+static volatile int quit;
+static volatile int write_failed;
+
+
+/*-------------------------------------------------
+	memtrace_drain - write what the rings hold,
+	returns the number of records written
+-------------------------------------------------*/
+
+static UINT32 memtrace_drain(void)
+{
+	UINT32 drained = 0;
+	int cpunum;
+
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+	{
+		struct memtrace_ring *r = &ring[cpunum];
+		UINT32 head, tail;
+
+		if (!r->record)
+			continue;
+
+		head = r->head;
+		memtrace_barrier();
+		for (tail = r->tail; tail != head; )
+		{
+			UINT32 index = tail & (MEMTRACE_RING_SIZE - 1);
+			UINT32 count = head - tail;
+
+			if (count > MEMTRACE_RING_SIZE - index)
+				count = MEMTRACE_RING_SIZE - index;
+			if (!write_failed && gzwrite(file, &r->record[index], count * sizeof(r->record[0])) <= 0)
+				write_failed = 1;
+			tail += count;
+			drained += count;
+		}
+		memtrace_barrier();
+		r->tail = tail;
+	}
+
+	return drained;
+}
+
+
+/*-------------------------------------------------
+	memtrace_writer - worker thread, drains the
+	rings until asked to quit
+-------------------------------------------------*/
+
+static void memtrace_writer(void)
+{
+	while (!quit)
+		if (!memtrace_drain())
+			memtrace_sleep();
+
+	/* the emulation thread published everything before setting quit */
+	memtrace_drain();
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static unsigned __stdcall memtrace_thread_entry(void *param)
+{
+	memtrace_writer();
+	return 0;
+}
+#else
+static void *memtrace_thread_entry(void *param)
+{
+	memtrace_writer();
+	return NULL;
+}
+#endif
+
+
+/*-------------------------------------------------
+	memtrace_parse_filter - read the filter list
+-------------------------------------------------*/
+
+static void memtrace_parse_filter(const char *list)
+{
+	char buffer[256], *token;
+
+	filters = 0;
+	io_only = 0;
+	if (!list)
+		return;
+
+	strncpy(buffer, list, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = 0;
+
+	for (token = strtok(buffer, ", "); token; token = strtok(NULL, ", "))
+	{
+		struct memtrace_filter *f = &filter[filters];
+		char *colon = strchr(token, ':');
+		unsigned int start, end;
+
+		if (!strcmp(token, "io"))
+		{
+			io_only = 1;
+			continue;
+		}
+		if (filters == MEMTRACE_FILTERS)
+		{
+			logerror("memtrace: too many filters, %s ignored\n", token);
+			continue;
+		}
+
+		f->cpunum = -1;
+		if (colon)
+		{
+			f->cpunum = atoi(token);
+			token = colon + 1;
+		}
+
+		if (token[0] == 'h' && sscanf(token + 1, "%x", &start) == 1 && start < 0x100)
+		{
+			f->entry = start;
+			filters++;
+		}
+		else if (sscanf(token, "%x-%x", &start, &end) == 2 && start <= end)
+		{
+			f->entry = -1;
+			f->start = start;
+			f->end = end;
+			filters++;
+		}
+		else
+			logerror("memtrace: bad filter %s ignored\n", token);
+	}
+}
+
+
+/*-------------------------------------------------
+	memtrace_start - open the file, write the
+	header and start the writer
+-------------------------------------------------*/
+
+void memtrace_start(void (*describe_maps)(void))
+{
+	const UINT16 endian = 1;
+	int cpunum;
+
+	memtrace_active = MEMTRACE_OFF;
+	if (!options.memtrace_file || !*options.memtrace_file)
+		return;
+
+	memtrace_parse_filter(options.memtrace_filter);
+
+	/* fast compression, the writer has to keep up with the emulation */
+	file = gzopen(options.memtrace_file, "wb1");
+	if (!file)
+	{
+		logerror("memtrace: failed to open %s\n", options.memtrace_file);
+		return;
+	}
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		memset(&ring[cpunum], 0, sizeof(ring[cpunum]));
+		ring[cpunum].record = malloc(MEMTRACE_RING_SIZE * sizeof(ring[cpunum].record[0]));
+		if (!ring[cpunum].record)
+		{
+			logerror("memtrace: out of memory, tracing disabled\n");
+			memtrace_stop();
+			return;
+		}
+	}
+
+	gzprintf(file, "pinmame memtrace 1\n");
+	gzprintf(file, "game %s\n", Machine->gamedrv->name);
+	gzprintf(file, "anchor %p\n", (void *)(FPTR)memory_init);
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+		gzprintf(file, "cpu %d %s\n", cpunum, cpunum_name(cpunum));
+	(*describe_maps)();
+	gzprintf(file, "endian %s\n", *(const UINT8 *)&endian ? "little" : "big");
+	gzprintf(file, "records %d\n", (int)sizeof(struct memtrace_record));
+
+	sequence = stalls = 0;
+	quit = write_failed = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+	memtrace_thread = (HANDLE)_beginthreadex(NULL, 0, memtrace_thread_entry, NULL, 0, NULL);
+	if (!memtrace_thread)
+#else
+	if (pthread_create(&memtrace_thread, NULL, memtrace_thread_entry, NULL) != 0)
+#endif
+	{
+		logerror("memtrace: failed to start the writer, tracing disabled\n");
+		memtrace_stop();
+		return;
+	}
+
+	memtrace_active = io_only ? MEMTRACE_HANDLERS : MEMTRACE_ALL;
+}
+
+
+/*-------------------------------------------------
+	memtrace_stop - flush the rings, stop the
+	writer and close the file
+-------------------------------------------------*/
+
+void memtrace_stop(void)
+{
+	int cpunum;
+
+	if (memtrace_active)
+	{
+		memtrace_active = MEMTRACE_OFF;
+
+		for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+			ring[cpunum].head = ring[cpunum].fill;
+		memtrace_barrier();
+		quit = 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+		WaitForSingleObject(memtrace_thread, INFINITE);
+		CloseHandle(memtrace_thread);
+#else
+		pthread_join(memtrace_thread, NULL);
+#endif
+
+		logerror("memtrace: %u records, waited for the writer %u times%s\n",
+				sequence, stalls, write_failed ? ", WRITE FAILED" : "");
+	}
+
+	if (file)
+	{
+		gzclose(file);
+		file = NULL;
+	}
+
+	for (cpunum = 0; cpunum < MAX_CPU; cpunum++)
+	{
+		free(ring[cpunum].record);
+		ring[cpunum].record = NULL;
+	}
+}
+
+
+/*-------------------------------------------------
+	memtrace_map - write a map line
+-------------------------------------------------*/
+
+void memtrace_map(int cpunum, int flags, offs_t start, offs_t end, UINT8 entry, const char *what)
+{
+	gzprintf(file, "map %d %s %s %08X-%08X %02X %s\n", cpunum,
+			(flags & MEMTRACE_PORT) ? "port" : "mem", (flags & MEMTRACE_WRITE) ? "w" : "r",
+			start, end, entry, what);
+}
+
+
+/*-------------------------------------------------
+	memtrace_access - filter and record an
+	access of the active CPU
+-------------------------------------------------*/
+
+void memtrace_access(int flags, UINT8 entry, offs_t address, data32_t data)
+{
+	int cpunum = cpu_getactivecpu();
+	struct memtrace_ring *r;
+	struct memtrace_record *record;
+	int i;
+
+	/* accesses outside of a CPU timeslice have no PC to go with */
+	if (cpunum < 0)
+		return;
+
+	if (io_only && entry < STATIC_COUNT)
+		return;
+
+	if (filters)
+	{
+		for (i = 0; i < filters; i++)
+		{
+			const struct memtrace_filter *f = &filter[i];
+			if (f->cpunum >= 0 && f->cpunum != cpunum)
+				continue;
+			if ((f->entry >= 0) ? (f->entry == entry) : (address >= f->start && address <= f->end))
+				break;
+		}
+		if (i == filters)
+			return;
+	}
+
+	/* wait for the writer rather than losing records */
+	r = &ring[cpunum];
+	if (r->fill - r->tail >= MEMTRACE_RING_SIZE)
+	{
+		stalls++;
+		memtrace_barrier();
+		r->head = r->fill;
+		while (r->fill - r->tail >= MEMTRACE_RING_SIZE)
+			memtrace_sleep();
+	}
+
+	record = &r->record[r->fill & (MEMTRACE_RING_SIZE - 1)];
+	record->sequence = sequence++;
+	record->pc = activecpu_get_previouspc();
+	record->address = address;
+	record->data = data;
+	record->cpu = cpunum;
+	record->flags = flags;
+	record->entry = entry;
+	record->unused = 0;
+
+	if ((++r->fill & (MEMTRACE_PUBLISH - 1)) == 0)
+	{
+		memtrace_barrier();
+		r->head = r->fill;
+	}
+}
@@ -0,0 +1,85 @@
+#ifndef __MEMTRACE_H
+#define __MEMTRACE_H
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include "osd_cpu.h"
+#include "memory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************
+ * Memory access tracing
+ *
+ * With options.memtrace_file set, every access that takes the lookup path
+ * of memory.c is recorded with the CPU, PC, address, data and the handler
+ * table entry it went to. The records go to a ring per CPU and a worker
+ * thread writes them to the gzip'ed trace file, so the emulation only
+ * waits when the writer falls behind.
+ *
+ * options.memtrace_filter narrows the trace down, a list separated by
+ * commas or spaces of:
+ *   io              only accesses going to handler functions (no RAM,
+ *                   ROM or banks); the direct RAM/ROM pages stay on
+ *   [cpu:]start-end addresses (hex) of memory or ports
+ *   [cpu:]hNN       accesses to handler table entry NN (hex)
+ * An access is traced if it matches io (when given) and any of the
+ * others (when given). Without io the direct pages are off while tracing,
+ * so RAM and ROM reads are seen too.
+ *
+ * The file starts with text lines, the last one "records <size>":
+ *   pinmame memtrace 1
+ *   game <name>
+ *   anchor <address of memory_init>  (handler addresses minus this plus
+ *                                     the nm address of memory_init give
+ *                                     the symbol)
+ *   cpu <n> <name>
+ *   map <cpu> <mem|port> <r|w> <start>-<end> <entry> <what>
+ *   endian <little|big>
+ *   records 20
+ * followed by struct memtrace_record in host byte order. Records of one
+ * CPU are in order; sequence orders all of them.
+ ***************************************************************************/
+
+#define MEMTRACE_WRITE		0x01		/* flags: write access */
+#define MEMTRACE_PORT		0x02		/* flags: port space */
+#define MEMTRACE_SIZE(f)	((f) >> 4)	/* flags: bytes accessed */
+
+#define MEMTRACE_OFF		0
+#define MEMTRACE_HANDLERS	1			/* io filter, RAM/ROM pages stay direct */
+#define MEMTRACE_ALL		2
+
+struct memtrace_record
+{
+	UINT32 sequence;
+	UINT32 pc;							/* start of the accessing instruction */
+	UINT32 address;
+	UINT32 data;
+	UINT8 cpu;
+	UINT8 flags;
+	UINT8 entry;						/* handler table entry, see the map lines */
+	UINT8 unused;
+};
+
+/* MEMTRACE_OFF, _HANDLERS or _ALL */
+extern int memtrace_active;
+
+/* memory_init() starts the trace once the tables are built, describe_maps
+   writes the map lines through memtrace_map(); memory_shutdown() stops it */
+void memtrace_start(void (*describe_maps)(void));
+void memtrace_stop(void);
+
+/* describe a run of the lookup table in the header */
+void memtrace_map(int cpunum, int flags, offs_t start, offs_t end, UINT8 entry, const char *what);
+
+/* record an access, flags is MEMTRACE_WRITE/_PORT | bytes << 4 */
+void memtrace_access(int flags, UINT8 entry, offs_t address, data32_t data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,269 @@
+/*********************************************************************
+
+	nvsave.c
+
+	Background NVRAM saving. The image is captured on the emulation
+	thread by running the driver's nvram_handler into a RAM file,
+	compared against the last one, and handed to a worker thread
+	which writes it with mame_freplace().
+
+*********************************************************************/
+
+#include "driver.h"
+#include "nvsave.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <process.h>
+static CRITICAL_SECTION nvsave_lock;
+static CONDITION_VARIABLE nvsave_wake;
+static HANDLE nvsave_thread;
+#define nvsave_lock_acquire() EnterCriticalSection(&nvsave_lock)
+#define nvsave_lock_release() LeaveCriticalSection(&nvsave_lock)
+#define nvsave_wait() SleepConditionVariableCS(&nvsave_wake, &nvsave_lock, INFINITE)
+#define nvsave_signal() WakeConditionVariable(&nvsave_wake)
+#else
+#include <pthread.h>
+static pthread_mutex_t nvsave_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t nvsave_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t nvsave_thread;
+#define nvsave_lock_acquire() pthread_mutex_lock(&nvsave_lock)
+#define nvsave_lock_release() pthread_mutex_unlock(&nvsave_lock)
+#define nvsave_wait() pthread_cond_wait(&nvsave_wake, &nvsave_lock)
+#define nvsave_signal() pthread_cond_signal(&nvsave_wake)
+#endif
+
+#ifdef LIBPINMAME
+extern void libpinmame_nvram_changed(const void* p_data, int size);
+#endif
+
+/* emulation thread only */
+static int active;
+static cycles_t interval;
+static cycles_t next_capture;
+static UINT8 *last_image;			/* last image handed to the writer */
+static UINT32 last_length;
+
+/* shared with the writer, under nvsave_lock */
+static UINT8 *pending_image;		/* newest image not written yet */
+static UINT32 pending_length;
+static int write_failed;			/* last write didn't make it to disk */
+static int quit;
+static char filename[64];
+
+
+/*-------------------------------------------------
+	nvsave_writer - worker thread, writes the
+	pending image until asked to quit
+-------------------------------------------------*/
+
+static void nvsave_writer(void)
+{
+	nvsave_lock_acquire();
+	for (;;)
+	{
+		UINT8 *image;
+		UINT32 length;
+		int failed;
+
+		while (!pending_image && !quit)
+			nvsave_wait();
+		if (!pending_image)
+			break;
+
+		/* take the image, newer captures replace it as pending meanwhile */
+		image = pending_image;
+		length = pending_length;
+		pending_image = NULL;
+		nvsave_lock_release();
+
+		failed = mame_freplace(FILETYPE_NVRAM, filename, image, length);
+		free(image);
+
+		nvsave_lock_acquire();
+		write_failed = failed;
+	}
+	nvsave_lock_release();
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+static unsigned __stdcall nvsave_thread_entry(void *param)
+{
+	nvsave_writer();
+	return 0;
+}
+#else
+static void *nvsave_thread_entry(void *param)
+{
+	nvsave_writer();
+	return NULL;
+}
+#endif
+
+
+/*-------------------------------------------------
+	nvram_capture - run the nvram_handler into
+	memory; returns a malloc'ed image
+-------------------------------------------------*/
+
+static UINT8 *nvram_capture(UINT32 *length)
+{
+	mame_file *file = mame_fopen_ram();
+	UINT8 *image = NULL;
+
+	if (!file)
+		return NULL;
+
+	(*Machine->drv->nvram_handler)(file, 1);
+
+	*length = (UINT32)mame_fsize(file);
+	image = malloc(*length ? *length : 1);
+	if (image && *length)
+		memcpy(image, mame_fdata(file), *length);
+	mame_fclose(file);
+	return image;
+}
+
+
+/*-------------------------------------------------
+	nvram_queue - capture the image and pass it
+	on to the writer if it changed (or always,
+	with force)
+-------------------------------------------------*/
+
+static void nvram_queue(int force)
+{
+	UINT32 length;
+	UINT8 *image = nvram_capture(&length);
+	UINT8 *copy;
+	int changed;
+
+	if (!image)
+		return;
+
+	changed = !last_image || length != last_length || memcmp(image, last_image, length);
+	if (!changed && !force)
+	{
+		free(image);
+		return;
+	}
+
+#ifdef LIBPINMAME
+	if (changed)
+		libpinmame_nvram_changed(image, (int)length);
+#endif
+
+	/* the writer frees its copy, so keep our own for the next comparison */
+	copy = malloc(length ? length : 1);
+	if (!copy)
+	{
+		free(image);
+		return;
+	}
+	memcpy(copy, image, length);
+	free(last_image);
+	last_image = image;
+	last_length = length;
+
+	nvsave_lock_acquire();
+	free(pending_image);
+	pending_image = copy;
+	pending_length = length;
+	nvsave_signal();
+	nvsave_lock_release();
+}
+
+
+/*-------------------------------------------------
+	nvram_autosave_start
+-------------------------------------------------*/
+
+void nvram_autosave_start(void)
+{
+	if (active || options.nvram_autosave <= 0 || options.nvram || !Machine->drv->nvram_handler)
+		return;
+
+	strncpy(filename, Machine->gamedrv->name, sizeof(filename) - 1);
+	filename[sizeof(filename) - 1] = 0;
+	pending_image = NULL;
+	write_failed = quit = 0;
+
+#if defined(_WIN32) || defined(_WIN64)
+	InitializeCriticalSection(&nvsave_lock);
+	InitializeConditionVariable(&nvsave_wake);
+	nvsave_thread = (HANDLE)_beginthreadex(NULL, 0, nvsave_thread_entry, NULL, 0, NULL);
+	if (!nvsave_thread)
+	{
+		DeleteCriticalSection(&nvsave_lock);
+		return;
+	}
+#else
+	if (pthread_create(&nvsave_thread, NULL, nvsave_thread_entry, NULL) != 0)
+		return;
+#endif
+
+	/* what was just loaded is on disk already */
+	last_image = nvram_capture(&last_length);
+
+	interval = (cycles_t)((double)osd_cycles_per_second() * options.nvram_autosave / 1000.0);
+	next_capture = osd_cycles() + interval;
+	active = 1;
+}
+
+
+/*-------------------------------------------------
+	nvram_autosave_update
+-------------------------------------------------*/
+
+void nvram_autosave_update(void)
+{
+	cycles_t now;
+
+	if (!active)
+		return;
+
+	now = osd_cycles();
+	if (now < next_capture)
+		return;
+	next_capture = now + interval;
+
+	nvram_queue(0);
+}
+
+
+/*-------------------------------------------------
+	nvram_autosave_stop
+-------------------------------------------------*/
+
+int nvram_autosave_stop(void)
+{
+	int saved;
+
+	if (!active)
+		return 0;
+	active = 0;
+
+	/* the exit save is always written, like without autosave */
+	nvram_queue(1);
+
+	nvsave_lock_acquire();
+	quit = 1;
+	nvsave_signal();
+	nvsave_lock_release();
+
+#if defined(_WIN32) || defined(_WIN64)
+	WaitForSingleObject(nvsave_thread, INFINITE);
+	CloseHandle(nvsave_thread);
+	DeleteCriticalSection(&nvsave_lock);
+#else
+	pthread_join(nvsave_thread, NULL);
+#endif
+
+	saved = !write_failed;
+	free(last_image);
+	last_image = NULL;
+	return saved;
+}
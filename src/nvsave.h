@@ -0,0 +1,38 @@
+#ifndef __NVSAVE_H
+#define __NVSAVE_H
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include "osd_cpu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************
+ * Background NVRAM saving
+ *
+ * With options.nvram_autosave set, the NVRAM image (what the driver's
+ * nvram_handler writes) is captured every nvram_autosave milliseconds.
+ * Changed images are written by a worker thread, which replaces the .nv
+ * file atomically, so neither a slow disk stalls the emulation nor does a
+ * power loss leave a torn file. Only the newest unwritten image is kept.
+ ***************************************************************************/
+
+/* start after the NVRAM has been loaded */
+void nvram_autosave_start(void);
+
+/* called once per frame on the emulation thread, captures when due */
+void nvram_autosave_update(void);
+
+/* capture and write the final image and stop the worker; returns 0 if
+   autosave wasn't running or the write failed, so the caller saves the
+   usual way */
+int nvram_autosave_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -353,6 +353,20 @@ int osd_get_path_count(int pathtype);
 /* Get information on the existence of a file */
 int osd_get_path_info(int pathtype, int pathindex, const char *filename);
 
+/* Get the size and last modification time of a file, returns 0 on success */
+int osd_get_file_stamp(int pathtype, int pathindex, const char *filename, UINT64 *size, INT64 *mtime);
+
+/* Map a whole file read-only into memory, returns NULL if it can't be mapped */
+const void *osd_map_file(int pathtype, int pathindex, const char *filename, UINT64 *size);
+
+/* Release a mapping returned by osd_map_file */
+void osd_unmap_file(const void *base, UINT64 size);
+
+/* Write a whole file through a temporary next to it that is renamed over the
+   old one, so a crash leaves either the old or the new contents. Must not use
+   the open file table, it's called from a worker thread. Returns 0 on success */
+int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length);
+
 /* Attempt to open a file with the given name and mode using the specified path type */
 osd_file *osd_fopen(int pathtype, int pathindex, const char *filename, const char *mode);
 
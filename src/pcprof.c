@@ -0,0 +1,192 @@
+/*********************************************************************
+
+	pcprof.c
+
+	Sampling PC profiler. cpuexec.c feeds it the PC of each CPU every
+	pcprof_interval cycles; the samples land in one fixed size hash
+	table per CPU, and are symbolised with the CPU's disassembler when
+	the run ends.
+
+*********************************************************************/
+
+#include "driver.h"
+#include "pcprof.h"
+
+/* distinct PCs tracked per CPU, a power of two; the table is kept at
+   most 3/4 full, later PCs are only counted as a whole */
+#define PCPROF_SLOTS		0x10000
+#define PCPROF_MAX_USED		(PCPROF_SLOTS / 4 * 3)
+
+struct pcprof_slot
+{
+	UINT32 pc;
+	UINT32 count;			/* 0 for a free slot */
+};
+
+struct pcprof_cpu
+{
+	struct pcprof_slot *slot;
+	UINT32 used;
+	UINT32 other;			/* samples of PCs that didn't fit */
+	UINT32 total;
+};
+
+int pcprof_interval;
+
+static struct pcprof_cpu prof[MAX_CPU];
+
+
+/*-------------------------------------------------
+	pcprof_start - allocate the tables if the
+	profiler is enabled
+-------------------------------------------------*/
+
+void pcprof_start(void)
+{
+	int cpunum;
+
+	pcprof_interval = 0;
+	if (options.pcprofile <= 0)
+		return;
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		memset(&prof[cpunum], 0, sizeof(prof[cpunum]));
+		prof[cpunum].slot = calloc(PCPROF_SLOTS, sizeof(struct pcprof_slot));
+		if (!prof[cpunum].slot)
+		{
+			logerror("pcprof: out of memory, profiler disabled\n");
+			while (cpunum >= 0)
+			{
+				free(prof[cpunum].slot);
+				prof[cpunum--].slot = NULL;
+			}
+			return;
+		}
+	}
+
+	pcprof_interval = options.pcprofile;
+}
+
+
+/*-------------------------------------------------
+	pcprof_sample - count the current PC of a CPU
+-------------------------------------------------*/
+
+void pcprof_sample(int cpunum)
+{
+	struct pcprof_cpu *p = &prof[cpunum];
+	UINT32 pc = cpunum_get_pc(cpunum);
+	UINT32 i = (pc * 0x9e3779b1) >> 16;
+
+	p->total++;
+	for (;;)
+	{
+		struct pcprof_slot *s = &p->slot[i & (PCPROF_SLOTS - 1)];
+
+		if (s->count && s->pc == pc)
+		{
+			s->count++;
+			return;
+		}
+		if (!s->count)
+		{
+			if (p->used >= PCPROF_MAX_USED)
+				break;
+			s->pc = pc;
+			s->count = 1;
+			p->used++;
+			return;
+		}
+		i++;
+	}
+	p->other++;
+}
+
+
+/*-------------------------------------------------
+	pcprof_compare - qsort callback, by PC
+-------------------------------------------------*/
+
+static int pcprof_compare(const void *a, const void *b)
+{
+	UINT32 pa = ((const struct pcprof_slot *)a)->pc;
+	UINT32 pb = ((const struct pcprof_slot *)b)->pc;
+	return (pa < pb) ? -1 : (pa > pb);
+}
+
+
+/*-------------------------------------------------
+	pcprof_write - dump one CPU as folded stacks
+-------------------------------------------------*/
+
+static void pcprof_write(FILE *f, int cpunum)
+{
+	struct pcprof_cpu *p = &prof[cpunum];
+	int digits = (cpunum_address_bits(cpunum) + 3) / 4;
+	char cpuname[32], dasm[256];
+	UINT32 i, n;
+	char *c;
+
+	/* frame names can't hold the separators */
+	snprintf(cpuname, sizeof(cpuname), "cpu%d_%s", cpunum, cpunum_name(cpunum));
+	for (c = cpuname; *c; c++)
+		if (*c == ' ' || *c == ';')
+			*c = '_';
+
+	/* compact the used slots to the front and sort them */
+	for (i = n = 0; i < PCPROF_SLOTS; i++)
+		if (p->slot[i].count)
+			p->slot[n++] = p->slot[i];
+	qsort(p->slot, n, sizeof(p->slot[0]), pcprof_compare);
+
+	for (i = 0; i < n; i++)
+	{
+		/* the opcode base may still point at another bank or region */
+		dasm[0] = 0;
+		cpunum_set_op_base(cpunum, p->slot[i].pc);
+		cpunum_dasm(cpunum, dasm, p->slot[i].pc);
+		for (c = dasm; *c; c++)
+			if (*c == ';' || *c == '\t' || *c == '\n')
+				*c = (*c == ';') ? ',' : ' ';
+
+		fprintf(f, "%s;%0*X;%0*X %s %u\n", cpuname,
+				digits, p->slot[i].pc & ~0xff, digits, p->slot[i].pc, dasm, p->slot[i].count);
+	}
+	if (p->other)
+		fprintf(f, "%s;[other] %u\n", cpuname, p->other);
+
+	logerror("pcprof: CPU%d %u samples, %u PCs, %u untracked\n", cpunum, p->total, n, p->other);
+}
+
+
+/*-------------------------------------------------
+	pcprof_stop - write the profile and free the
+	tables
+-------------------------------------------------*/
+
+void pcprof_stop(void)
+{
+	const char *filename = options.pcprofile_file ? options.pcprofile_file : "pcprofile.txt";
+	FILE *f;
+	int cpunum;
+
+	if (!pcprof_interval)
+		return;
+	pcprof_interval = 0;
+
+	f = fopen(filename, "w");
+	if (!f)
+		logerror("pcprof: failed to open %s\n", filename);
+
+	for (cpunum = 0; cpunum < cpu_gettotalcpu(); cpunum++)
+	{
+		if (f)
+			pcprof_write(f, cpunum);
+		free(prof[cpunum].slot);
+		prof[cpunum].slot = NULL;
+	}
+
+	if (f)
+		fclose(f);
+}
@@ -0,0 +1,37 @@
+#ifndef __PCPROF_H
+#define __PCPROF_H
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include "osd_cpu.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************
+ * Sampling PC profiler
+ *
+ * With options.pcprofile set, the scheduler runs each CPU in chunks of
+ * that many cycles and samples its PC after every chunk, which works in
+ * release builds and with any CPU core. At the end of the run the
+ * histograms are written to options.pcprofile_file as folded stacks
+ * ("cpu;page;pc count" per line), ready for flamegraph.pl and friends.
+ ***************************************************************************/
+
+/* cycles between samples, 0 while the profiler is off */
+extern int pcprof_interval;
+
+/* called by cpu_run() around the emulation */
+void pcprof_start(void);
+void pcprof_stop(void);
+
+/* record the current PC of a CPU */
+void pcprof_sample(int cpunum);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
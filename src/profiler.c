@@ -202,3 +202,12 @@ void profiler_show(struct mame_bitmap *bitmap)
 
 	profiler_mark(PROFILER_END);
 }
+
+
+struct perf_counters perf_counters;
+
+void perf_counters_reset(void)
+{
+	memset(&perf_counters, 0, sizeof(perf_counters));
+	perf_counters.start = osd_cycles();
+}
@@ -68,4 +68,25 @@ void profiler_start(void);
 void profiler_stop(void);
 void profiler_show(struct mame_bitmap *bitmap);
 
+
+/*
+Unlike the marks above, these counters are kept in release builds too. They
+are cumulative since the emulation started; host times are in osd_cycles().
+The time spent in each CPU is kept by cpuexec.c, see cpunum_get_hosttime().
+*/
+struct perf_counters
+{
+	cycles_t	start;						/* osd_cycles() when the emulation started */
+	double		emulated_time;				/* seconds emulated */
+	UINT64		timer_callbacks;			/* timer callbacks fired */
+	cycles_t	mixer_time;					/* mixing and resampling the sound */
+	cycles_t	pwm_time;					/* integrating the PWM outputs */
+	cycles_t	display_time;				/* converting the displays */
+	cycles_t	throttle_time;				/* waiting in the throttle */
+};
+
+extern struct perf_counters perf_counters;
+
+void perf_counters_reset(void);
+
 #endif	/* PROFILER_H */
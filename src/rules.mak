@@ -389,7 +389,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_M6800=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: src/cpu/m6800/m6800.c src/cpu/m6800/m6800.h src/cpu/m6800/6800ops.c src/cpu/m6800/6800tbl.c
 else
 CPUDEFS += -DHAS_M6800=0
@@ -400,7 +400,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_M6801=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: m6800.c m6800.h 6800ops.c 6800tbl.c
 else
 CPUDEFS += -DHAS_M6801=0
@@ -411,7 +411,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_M6802=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: src/cpu/m6800/m6800.c src/cpu/m6800/m6800.h src/cpu/m6800/6800ops.c src/cpu/m6800/6800tbl.c
 else
 CPUDEFS += -DHAS_M6802=0
@@ -422,7 +422,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_M6803=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: src/cpu/m6800/m6800.c src/cpu/m6800/m6800.h src/cpu/m6800/6800ops.c src/cpu/m6800/6800tbl.c
 else
 CPUDEFS += -DHAS_M6803=0
@@ -433,7 +433,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_M6808=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: src/cpu/m6800/m6800.c src/cpu/m6800/m6800.h src/cpu/m6800/6800ops.c src/cpu/m6800/6800tbl.c
 else
 CPUDEFS += -DHAS_M6808=0
@@ -444,7 +444,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_HD63701=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: m6800.c m6800.h 6800ops.c 6800tbl.c
 else
 CPUDEFS += -DHAS_HD63701=0
@@ -455,7 +455,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6800
 CPUDEFS += -DHAS_NSC8105=1
 CPUOBJS += $(OBJ)/cpu/m6800/m6800.o
-DBGOBJS += $(OBJ)/cpu/m6800/6800dasm.o
+CPUOBJS += $(OBJ)/cpu/m6800/6800dasm.o
 $(OBJ)/cpu/m6800/m6800.o: m6800.c m6800.h 6800ops.c 6800tbl.c
 else
 CPUDEFS += -DHAS_NSC8105=0
@@ -510,7 +510,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/m6809
 CPUDEFS += -DHAS_M6809=1
 CPUOBJS += $(OBJ)/cpu/m6809/m6809.o
-DBGOBJS += $(OBJ)/cpu/m6809/6809dasm.o
+CPUOBJS += $(OBJ)/cpu/m6809/6809dasm.o
 $(OBJ)/cpu/m6809/m6809.o: src/cpu/m6809/m6809.c src/cpu/m6809/m6809.h src/cpu/m6809/6809ops.c src/cpu/m6809/6809tbl.c
 else
 CPUDEFS += -DHAS_M6809=0
@@ -819,7 +819,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/adsp2100
 CPUDEFS += -DHAS_ADSP2100=1
 CPUOBJS += $(OBJ)/cpu/adsp2100/adsp2100.o
-DBGOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
+CPUOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
 $(OBJ)/cpu/adsp2100/adsp2100.o: adsp2100.c adsp2100.h 2100ops.c
 else
 CPUDEFS += -DHAS_ADSP2100=0
@@ -830,7 +830,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/adsp2100
 CPUDEFS += -DHAS_ADSP2101=1
 CPUOBJS += $(OBJ)/cpu/adsp2100/adsp2100.o
-DBGOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
+CPUOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
 $(OBJ)/cpu/adsp2100/adsp2100.o: src/cpu/adsp2100/adsp2100.c src/cpu/adsp2100/adsp2100.h src/cpu/adsp2100/2100ops.c
 else
 CPUDEFS += -DHAS_ADSP2101=0
@@ -841,7 +841,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/adsp2100
 CPUDEFS += -DHAS_ADSP2105=1
 CPUOBJS += $(OBJ)/cpu/adsp2100/adsp2100.o
-DBGOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
+CPUOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
 $(OBJ)/cpu/adsp2100/adsp2100.o: src/cpu/adsp2100/adsp2100.c src/cpu/adsp2100/adsp2100.h src/cpu/adsp2100/2100ops.c
 else
 CPUDEFS += -DHAS_ADSP2105=0
@@ -852,7 +852,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/adsp2100
 CPUDEFS += -DHAS_ADSP2115=1
 CPUOBJS += $(OBJ)/cpu/adsp2100/adsp2100.o
-DBGOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
+CPUOBJS += $(OBJ)/cpu/adsp2100/2100dasm.o
 $(OBJ)/cpu/adsp2100/adsp2100.o: adsp2100.c adsp2100.h 2100ops.c
 else
 CPUDEFS += -DHAS_ADSP2115=0
@@ -1633,7 +1633,7 @@ ifneq ($(CPU),)
 OBJDIRS += $(OBJ)/cpu/arm7
 CPUDEFS += -DHAS_ARM7=1
 CPUOBJS += $(OBJ)/cpu/arm7/arm7.o
-DBGOBJS += $(OBJ)/cpu/arm7/arm7dasm.o
+CPUOBJS += $(OBJ)/cpu/arm7/arm7dasm.o
 $(OBJ)/cpu/arm7/arm7.o: src/cpu/arm7/arm7.c src/cpu/arm7/arm7.h src/cpu/arm7/arm7core.c src/cpu/arm7/arm7core.h src/cpu/arm7/arm7jit.c src/cpu/arm7/arm7jit.h
 else
 CPUDEFS += -DHAS_ARM7=0
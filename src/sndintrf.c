@@ -1,4 +1,5 @@
 #include "driver.h"
+#include "state.h"
 
 
 /***************************************************************************
@@ -1298,6 +1299,11 @@ int sound_start(void)
 
 	cleared_value = 0x00;
 
+	state_save_register_int("soundlatch", 0, "latch", &latch);
+	state_save_register_int("soundlatch", 0, "latch2", &latch2);
+	state_save_register_int("soundlatch", 0, "latch3", &latch3);
+	state_save_register_int("soundlatch", 0, "latch4", &latch4);
+
 	/* Verify the order of entries in the sndintf[] array */
 	for (i = 0;i < SOUND_COUNT;i++)
 	{
@@ -7,6 +7,7 @@
 ***************************************************************************/
 
 #include "driver.h"
+#include "state.h"
 //#include "fm.h"
 
 #if (HAS_YM2151_ALT)
@@ -34,9 +35,16 @@
 
  void ymfm_ym2151_write(void* obj, uint32_t offset, uint8_t data);
 
- void ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples);
+ int ymfm_ym2151_generate(void* obj, int16_t** output, uint32_t numsamples);
+
+ int ymfm_ym2151_save_state(void* obj, uint8_t* data, int size);
+ void ymfm_ym2151_load_state(void* obj, const uint8_t* data, int size);
 
  static void* chip[MAX_2151];
+ static UINT8* state_buf[MAX_2151];
+ static int state_size[MAX_2151];
+ static UINT64 rendered_samples[MAX_2151];
+ static UINT64 idle_samples[MAX_2151];
  static unsigned short vgm_idx[MAX_2151];
  static unsigned char lastreg[MAX_2151];
 #endif
@@ -110,7 +118,24 @@ static void update_timer_func(int timer_num)
 #if (HAS_YM2151_YMFM)
 static void YM2151UpdateYMFM(int num, INT16 **buffers, int length)
 {
-	ymfm_ym2151_generate/*_buffered*/(chip[num], buffers, length);
+	// blocks where all operators are released come back as silence without running the FM pipeline
+	if (ymfm_ym2151_generate/*_buffered*/(chip[num], buffers, length))
+		idle_samples[num] += length;
+	rendered_samples[num] += length;
+}
+
+static void ymfm_presave(void)
+{
+	int i;
+	for (i = 0; i < intf->num; i++)
+		ymfm_ym2151_save_state(chip[i], state_buf[i], state_size[i]);
+}
+
+static void ymfm_postload(void)
+{
+	int i;
+	for (i = 0; i < intf->num; i++)
+		ymfm_ym2151_load_state(chip[i], state_buf[i], state_size[i]);
 }
 
 static void timercallback(int timer_num)
@@ -262,10 +287,21 @@ static int my_YM2151_sh_start(const struct MachineSound *msound,const int mode)
 			// DE & WMS needs irqhandler
 			// DE needs portwritehandler
 			chip[i] = ymfm_ym2151_create(intf->irqhandler[i], intf->portwritehandler[i], intf->baseclock, timercallback);
+			rendered_samples[i] = idle_samples[i] = 0;
 			vgm_idx[i] = vgm_open(VGMC_YM2151, intf->baseclock);
 
+			/* the chip state is serialized into a buffer of fixed size */
+			state_size[i] = ymfm_ym2151_save_state(chip[i], NULL, 0);
+			state_buf[i] = auto_malloc(state_size[i]);
+			if (!state_buf[i])
+				return 1;
+			state_save_register_UINT8("ym2151", i, "ymfm", state_buf[i], state_size[i]);
+			state_save_register_UINT8("ym2151", i, "lastreg", &lastreg[i], 1);
+
 			has_handler |= (intf->irqhandler[i] != 0) | (intf->portwritehandler[i] != 0);
 		}
+		state_save_register_func_presave(ymfm_presave);
+		state_save_register_func_postload(ymfm_postload);
 
 		return 0;
 	}
@@ -333,8 +369,12 @@ void YM2151_sh_stop(void)
 		{
 		int i;
 		for (i = 0; i < intf->num; i++)
+		{
+			if (rendered_samples[i])
+				logerror("YM2151 #%d: %.0f of %.0f samples idle (%d%%)\n", i, (double)idle_samples[i], (double)rendered_samples[i], (int)(idle_samples[i] * 100 / rendered_samples[i]));
 			ymfm_ym2151_destroy(chip[i]);
 		}
+		}
 		break;
 #endif
 	}
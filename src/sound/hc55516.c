@@ -378,6 +378,11 @@ static FILE *dynrange_log_fp;
 //
 #define DEFAULT_GAIN    (DYN_RANGE_MAX/V_HIGH)
 
+// Decoder block size.  Buffered input bits are decoded in blocks of up to
+// this many bits at a time, and each block is passed to the resampler in a
+// single call.
+#define HC55516_DECODE_BLOCK 256
+
 
 //
 // HC55536 chip state
@@ -405,6 +410,24 @@ struct hc55516_data
 			int charge_shift;
 			int charge_add;
 			int decay_shift;
+
+			// Precomputed register transfer tables.  The chip's registers
+			// are narrow enough (12 and 10 bits) that every arithmetic step
+			// in the bit pipeline can be tabulated once at startup, which
+			// turns the per-bit work into a handful of table lookups.  The
+			// tables reproduce the bit operations exactly, so the output is
+			// identical to evaluating the register logic directly.
+			//
+			//   syl_next[c][syl]   - syllabic register after the charge
+			//                        update; c = 1 if the charge_add term
+			//                        applies (shift register not all ones)
+			//   charge[syl]        - integrator step size for the syllabic level
+			//   decay[i+512]       - integrator after the decay update
+			//   sample[i+512]      - PCM sample for the integrator value, -1..1
+			UINT16 syl_next[2][4096];
+			UINT8  charge[4096];
+			INT16  decay[1024];
+			float  sample[1024];
 		} intg;
 
 		// Floating-point arithmetic, used in original MAME implementation
@@ -420,8 +443,10 @@ struct hc55516_data
 		} dbl;
 	} filter;
 
-	// Bit processor function
-	void (*process_bit)(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio);
+	// Block decoder function.  Decodes 'n' bits from the input ring buffer,
+	// starting at ring index 'read', into raw PCM samples at the CVSD clock
+	// rate.
+	void (*decode_bits)(struct hc55516_data *chip, int read, int n, float *out);
 
 	// Loudness compression function
 	float (*compress_loudness)(struct hc55516_data *chip, double sample);
@@ -590,59 +615,74 @@ static void init_output_filter(struct hc55516_data *chip)
 
 // ---------------------------------------------------------------------------
 //
-// Add a decoded output sample.  This takes a raw sample from the CVSD 
-// decoder, resamples it using the PCM sample rate of the MAME output stream,
-// and adds it to our output buffer to eventually pass to the MAME stream.
+// Add a block of decoded output samples.  This takes raw samples from the
+// CVSD decoder, resamples them using the PCM sample rate of the MAME output
+// stream, and adds them to our output buffer to eventually pass to the MAME
+// stream.
+//
+// The whole block is handed to libsamplerate in as few calls as possible.
+// The sinc converter keeps its full history between calls, so feeding it a
+// block at a time produces exactly the same output as feeding it one sample
+// at a time, at a small fraction of the per-call overhead.
 //
-static void add_sample_out(struct hc55516_data *chip, const double sample, const double output_rate_ratio)
+static void add_samples_out(struct hc55516_data *chip, const float *samples, int n, const double output_rate_ratio)
 {
-	float fOut[128];
+	float fOut[HC55516_DECODE_BLOCK * 4];
 	SRC_DATA sd;
 	long i;
 
-	// resample at the MAME stream rate
-	const float fIn = (float)sample;
-	sd.data_in = &fIn;
-	sd.input_frames = 1;
-	sd.input_frames_used = 0;
-	sd.data_out = fOut;
-	sd.output_frames = _countof(fOut);
-	sd.output_frames_gen = 0;
-	sd.end_of_input = 0;
-	sd.src_ratio = output_rate_ratio;
-
 	// When using the src_process or src_callback_process APIs and updating the src_ratio field of the SRC_STATE struct,
 	// the library will try to smoothly transition between the conversion ratio of the last call and the conversion ratio of the current call.
 	// BUT we can disable this via:
-	src_set_ratio(chip->resample_state, sd.src_ratio);
+	src_set_ratio(chip->resample_state, output_rate_ratio);
 
-	if (src_process(chip->resample_state, &sd) != SRC_ERR_NO_ERROR)
+	while (n > 0)
 	{
-		// error processing the sample - not much we can do, so just discard
-		// the sample
-		return;
-	}
+		// resample at the MAME stream rate
+		sd.data_in = samples;
+		sd.input_frames = n;
+		sd.input_frames_used = 0;
+		sd.data_out = fOut;
+		sd.output_frames = _countof(fOut);
+		sd.output_frames_gen = 0;
+		sd.end_of_input = 0;
+		sd.src_ratio = output_rate_ratio;
 
-	// Add the resampled output(s) to the PCM sample buffer.  Note that the HC55516
-	// clock rates are in the 20kHz range (the exact rate varies by game and even
-	// clip), whereas the MAME stream will be at the PC sound card hardware rate,
-	// typically 44.1 kHz or 48 kHz.  Each HC55516 sample therefore turns into 
-	// approximately two MAME samples.  That's the main reason we need this extra
-	// buffering step - MAME might not be ready to accept all the PCM samples that
-	// convert from the current single HC55516 sample, so we need to be prepared
-	// to stash extras for the next MAME buffer refill.
-	for (i = 0; i < sd.output_frames_gen; ++i)
-	{
-		/* add the sample at the write pointer */
-		chip->pcm_out.pcm[chip->pcm_out.write++] = fOut[i];
-		if (chip->pcm_out.write >= _countof(chip->pcm_out.pcm))
-			chip->pcm_out.write = 0;
-
-		/* if the write pointer bumped into the read pointer, drop the oldest sample */
-		if (chip->pcm_out.write == chip->pcm_out.read) {
-			if (++chip->pcm_out.read >= _countof(chip->pcm_out.pcm))
-				chip->pcm_out.read = 0;
+		if (src_process(chip->resample_state, &sd) != SRC_ERR_NO_ERROR)
+		{
+			// error processing the samples - not much we can do, so just
+			// discard the rest of the block
+			return;
 		}
+
+		// Add the resampled outputs to the PCM sample buffer.  Note that the HC55516
+		// clock rates are in the 20kHz range (the exact rate varies by game and even
+		// clip), whereas the MAME stream will be at the PC sound card hardware rate,
+		// typically 44.1 kHz or 48 kHz.  Each HC55516 sample therefore turns into 
+		// approximately two MAME samples.  That's the main reason we need this extra
+		// buffering step - MAME might not be ready to accept all the PCM samples that
+		// convert from the current HC55516 samples, so we need to be prepared to
+		// stash extras for the next MAME buffer refill.
+		for (i = 0; i < sd.output_frames_gen; ++i)
+		{
+			/* add the sample at the write pointer */
+			chip->pcm_out.pcm[chip->pcm_out.write++] = fOut[i];
+			if (chip->pcm_out.write >= _countof(chip->pcm_out.pcm))
+				chip->pcm_out.write = 0;
+
+			/* if the write pointer bumped into the read pointer, drop the oldest sample */
+			if (chip->pcm_out.write == chip->pcm_out.read) {
+				if (++chip->pcm_out.read >= _countof(chip->pcm_out.pcm))
+					chip->pcm_out.read = 0;
+			}
+		}
+
+		// stop if the converter made no progress, to avoid spinning
+		if (sd.input_frames_used == 0 && sd.output_frames_gen == 0)
+			return;
+
+		samples += sd.input_frames_used;
+		n -= sd.input_frames_used;
 	}
 }
 
@@ -744,65 +784,92 @@ INLINE int signext10bits(int v)
 	return (v & 0x200) != 0 ? v | ~0x3FF : v;
 }
 
-// bit processor
-static void process_bit_HC555XX(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio)
+// Build the register transfer tables for the chip logic decoder.  Each
+// entry is computed with the same bit operations the chip performs, so the
+// table-driven decoder below is bit-exact with the register logic.
+static void init_tables_HC555XX(struct hc55516_data *chip)
 {
-	// shift the bit into the shift register
-	chip->shiftreg = ((chip->shiftreg << 1) | bit) & SHIFTMASK;
+	int v;
+
+	for (v = 0; v < 4096; ++v)
+	{
+		// Syllabic filter charge update (in floating-point terms, this is
+		// calculating syl *= 31/32 or syl *= 63/64, depending upon the
+		// charge_mask/charge_shift parameters).  The charge_add term applies
+		// whenever the shift register isn't all ones.  The result is masked
+		// to 12 bits, per the HC555XX hardware.
+		const int charged = v + ((~v & chip->filter.intg.charge_mask) >> chip->filter.intg.charge_shift);
+		chip->filter.intg.syl_next[0][v] = (UINT16)(charged & 0xFFF);
+		chip->filter.intg.syl_next[1][v] = (UINT16)((charged + chip->filter.intg.charge_add) & 0xFFF);
+
+		// integrator charge step for this syllabic filter level
+		chip->filter.intg.charge[v] = (UINT8)((v >> 6) < 2 ? 2 : (v >> 6));
+	}
+
+	for (v = -512; v < 512; ++v)
+	{
+		// Integrator filter decay update (in floating-point terms, this is
+		// calculating integrator *= 15/16 or 31/32, depending upon the
+		// decay_shift parameter)
+		const int sum = signext10bits(((~v >> chip->filter.intg.decay_shift) + 1) & 0x3FF);
+		chip->filter.intg.decay[v + 512] = (INT16)clip10bits(v + sum);
+
+		// scale the sample from 10-bit signed (-512..511) to 16-bit signed
+		// (-32768..32767), and then to the -1..1 range of the float stream
+		chip->filter.intg.sample[v + 512] = (float)(((v << 6) | (((v & 0x3FF) ^ 0x200) >> 4)) / 32768.0);
+	}
+}
 
-	// apply the syllabic filter charge update (in floating-point terms,
-	// this is calculating syl *= 31/32 or syl *= 63/64, depending upon
-	// the charge_mask/charge_shift parameters)
-	chip->filter.intg.syl_reg += (~chip->filter.intg.syl_reg & chip->filter.intg.charge_mask) >> chip->filter.intg.charge_shift;
-	if ((chip->shiftreg ^ SHIFTMASK) != 0)
-		chip->filter.intg.syl_reg += chip->filter.intg.charge_add;
+// block decoder
+static void decode_bits_HC555XX(struct hc55516_data *chip, int read, int n, float *out)
+{
+	// work in locals, so that the compiler can keep the registers in
+	// registers for the duration of the block
+	UINT8 shiftreg = chip->shiftreg;
+	int syl_reg = chip->filter.intg.syl_reg;
+	int integrator = chip->filter.intg.integrator;
 
-	// mask the syllabic filter register to 12 bits, per the HC555XX hardware
-	chip->filter.intg.syl_reg &= 0xFFF;
+	for (; n > 0; --n)
+	{
+		// shift the bit into the shift register
+		shiftreg = ((shiftreg << 1) | chip->bits_in.bits[read].bit) & SHIFTMASK;
+		if (++read >= _countof(chip->bits_in.bits))
+			read = 0;
 
-	// apply the integrator filter decay update (in floating-point terms,
-	// this is calculating integrator *= 15/16 or 31/32, depending upon
-	// the INTSHIFT parameter)
-	int sum = signext10bits(((~chip->filter.intg.integrator >> chip->filter.intg.decay_shift) + 1) & 0x3FF);
-	chip->filter.intg.integrator = clip10bits(chip->filter.intg.integrator + sum);
+		// apply the syllabic filter charge update
+		syl_reg = chip->filter.intg.syl_next[(shiftreg ^ SHIFTMASK) != 0][syl_reg];
 
-	// scale the sample from 10-bit signed (-512..511) to 16-bit signed (-32768..32767)
-	int sample = (chip->filter.intg.integrator << 6) | (((chip->filter.intg.integrator & 0x3FF) ^ 0x200) >> 4);
+		// apply the integrator filter decay update
+		integrator = chip->filter.intg.decay[integrator + 512];
 
-	// buffer the sample
-	add_sample_out(chip, sample / 32768.0, output_rate_ratio);
+		// output the sample
+		*out++ = chip->filter.intg.sample[integrator + 512];
 
-	// Charge the integrator from the syllabic filter according to the 
-	// current data bit.
-	//
-	// Note: the MAME version of this code, which is a doggedly literal
-	// translation of the HC55516 gate logic (from a decap analysis) into
-	// C, expresses the negation of 'sum' as a somewhat obtuse bit-
-	// twiddling operation.  We C programmers have the luxury of a more
-	// abstract mathematical expression of our intent, so let's take
-	// advantage of that and not resort to unreadable bit twiddling.
-	// MAME expresses the negation like this:
-	// 
-	//    sum = (~sum) + 1;
-	//    sum = signext10bits(sum & 0x3FF);
-	// 
-	// That bit-twiddling formula is the canonical bit-logic decomposition
-	// of the 2's complement negation operation - you invert all the bits
-	// and add 1.  The physical HC chip does it that way because that's
-	// the way you do it in logic gates.  For a C program, it will work
-	// on 2's-complement platforms to do the same decomposition, but it's
-	// actually not 100% portable to do so, because there do exist machines
-	// with other integer representations (although none that anyone would
-	// use today, admittedly).  The math operation that we're trying to
-	// achieve is a negation, so it's more strictly correct to write it
-	// that way and let the compiler translate it into the appropriate
-	// machine operation for us.
-	sum = chip->filter.intg.syl_reg >> 6;
-	if (sum < 2)
-		sum = 2;
-	if ((chip->shiftreg & 1) != 0)
-		sum = -sum;
-	chip->filter.intg.integrator = clip10bits(chip->filter.intg.integrator + sum);
+		// Charge the integrator from the syllabic filter according to the 
+		// current data bit.
+		//
+		// Note: the MAME version of this code, which is a doggedly literal
+		// translation of the HC55516 gate logic (from a decap analysis) into
+		// C, expresses the negation of the charge step as a somewhat obtuse
+		// bit-twiddling operation:
+		// 
+		//    sum = (~sum) + 1;
+		//    sum = signext10bits(sum & 0x3FF);
+		// 
+		// That bit-twiddling formula is the canonical bit-logic decomposition
+		// of the 2's complement negation operation - you invert all the bits
+		// and add 1.  The physical HC chip does it that way because that's
+		// the way you do it in logic gates.  The math operation that we're
+		// trying to achieve is a negation, so we write it that way and let
+		// the compiler translate it into the appropriate machine operation.
+		integrator = (shiftreg & 1) != 0 ?
+			clip10bits(integrator - chip->filter.intg.charge[syl_reg]) :
+			clip10bits(integrator + chip->filter.intg.charge[syl_reg]);
+	}
+
+	chip->shiftreg = shiftreg;
+	chip->filter.intg.syl_reg = syl_reg;
+	chip->filter.intg.integrator = integrator;
 }
 
 // We don't need any loudness compression for the integer math implementation,
@@ -841,27 +908,47 @@ static float flat_loudness(struct hc55516_data *chip, double sample)
 // be more detrimental to the sound quality than the precision and range
 // upgrades are positives.
 //
-static void process_bit_dbl(struct hc55516_data *chip, const UINT8 bit, const double output_rate_ratio)
+static void decode_bits_dbl(struct hc55516_data *chip, int read, int n, float *out)
 {
-	// add/subtract the syllabic filter output to/from the integrator
-	const double di = (1.0 - DECAY) * chip->filter.dbl.syl_level;
-	if (bit != 0)
-		chip->filter.dbl.integrator += di;
-	else
-		chip->filter.dbl.integrator -= di;
+	// filter coefficients for the per-bit updates
+	static const double integrator_step = 1.0 - DECAY;
+	static const double syl_charge_high = (1.0 - CHARGE) * V_HIGH;
+	static const double syl_charge_low = (1.0 - CHARGE) * V_LOW;
+
+	UINT8 shiftreg = chip->shiftreg;
+	double syl_level = chip->filter.dbl.syl_level;
+	double integrator = chip->filter.dbl.integrator;
+
+	for (; n > 0; --n)
+	{
+		const UINT8 bit = chip->bits_in.bits[read].bit;
+		if (++read >= _countof(chip->bits_in.bits))
+			read = 0;
+
+		// add/subtract the syllabic filter output to/from the integrator
+		const double di = integrator_step * syl_level;
+		if (bit != 0)
+			integrator += di;
+		else
+			integrator -= di;
+
+		// simulate leakage
+		integrator *= DECAY;
 
-	// simulate leakage
-	chip->filter.dbl.integrator *= DECAY;
+		// shift the new data bit into the syllabic filter's shift register
+		shiftreg = ((shiftreg << 1) | bit) & SHIFTMASK;
 
-	// shift the new data bit into the syllabic filter's shift register
-	chip->shiftreg = ((chip->shiftreg << 1) | bit) & SHIFTMASK;
+		// figure the new syllabic filter output level
+		syl_level *= CHARGE;
+		syl_level += (shiftreg == 0 || shiftreg == SHIFTMASK) ? syl_charge_high : syl_charge_low;
 
-	// figure the new syllabic filter output level
-	chip->filter.dbl.syl_level *= CHARGE;
-	chip->filter.dbl.syl_level += (1.0 - CHARGE) * ((chip->shiftreg == 0 || chip->shiftreg == SHIFTMASK) ? V_HIGH : V_LOW);
+		// output the sample
+		*out++ = (float)integrator;
+	}
 
-	// buffer the sample
-	add_sample_out(chip, chip->filter.dbl.integrator, output_rate_ratio);
+	chip->shiftreg = shiftreg;
+	chip->filter.dbl.syl_level = syl_level;
+	chip->filter.dbl.integrator = integrator;
 }
 
 // Loudness compression function.  This takes a sample in linear space form
@@ -886,47 +973,61 @@ static float compress_clip(struct hc55516_data *chip, double sample)
 
 // ---------------------------------------------------------------------------
 //
-// Apply the final output filter
+// Apply the final output filter to a block of samples, in place
 //
-static float apply_filter(struct hc55516_data *chip, const float sample)
+static void apply_filter(struct hc55516_data *chip, float *buffer, int length)
 {
-	// run the sample through the two-stage filter
-	const double filtered = filter2_step_with(&chip->output_filter.f2, filter2_step_with(&chip->output_filter.f1, sample));
+	// Run the two filter stages on local copies of the filter state, so
+	// that the cascade stays in registers across the whole block instead
+	// of round-tripping through the chip struct for every sample.  The
+	// arithmetic is the same as stepping each stage per sample.
+	filter2_context f1 = chip->output_filter.f1;
+	filter2_context f2 = chip->output_filter.f2;
+	const int flat = (chip->compress_loudness == flat_loudness);
+	int i;
+
+	for (i = 0; i < length; ++i)
+	{
+		const float sample = buffer[i];
 
-	// apply the gain and apply loudness compression
-	const float scaled = (*chip->compress_loudness)(chip, filtered);
+		// run the sample through the two-stage filter
+		const double filtered = filter2_step_with(&f2, filter2_step_with(&f1, sample));
+
+		// apply the gain and apply loudness compression
+		buffer[i] = flat ? (float)filtered : (*chip->compress_loudness)(chip, filtered);
 
 #ifdef LOG_DYN_RANGE
-	// update the min/max range 
-	if (sample < chip->dynrange.vmin)
-		chip->dynrange.vmin = sample;
-	if (sample > chip->dynrange.vmax)
-		chip->dynrange.vmax = sample;
-
-	// update the log file periodically
-	if (++chip->dynrange.nsamples > 100000 && dynrange_log_fp != NULL)
-	{
-		// figure the maximum gain that won't clip for the current range
-		const double maxgain1 = -DYN_RANGE_MAX / chip->dynrange.vmin;
-		const double maxgain2 = DYN_RANGE_MAX / chip->dynrange.vmax;
-		const double maxgain = maxgain1 < maxgain2 ? maxgain1 : maxgain2;
-
-		// log the data
-		fprintf(dynrange_log_fp, "HC55516 #%d range [%lf..+%lf] -> max gain w/o clipping %d\n",
-			(int)(chip - hc55516), chip->dynrange.vmin, chip->dynrange.vmax, (int)maxgain);
-
-		// make sure the new hits the file immediately, in case the program
-		// exits before the next update (as we won't have a chance to close
-		// the file properly on exit)
-		fflush(dynrange_log_fp);
-
-		// reset the log sample counter
-		chip->dynrange.nsamples = 0;
-	}
+		// update the min/max range 
+		if (sample < chip->dynrange.vmin)
+			chip->dynrange.vmin = sample;
+		if (sample > chip->dynrange.vmax)
+			chip->dynrange.vmax = sample;
+
+		// update the log file periodically
+		if (++chip->dynrange.nsamples > 100000 && dynrange_log_fp != NULL)
+		{
+			// figure the maximum gain that won't clip for the current range
+			const double maxgain1 = -DYN_RANGE_MAX / chip->dynrange.vmin;
+			const double maxgain2 = DYN_RANGE_MAX / chip->dynrange.vmax;
+			const double maxgain = maxgain1 < maxgain2 ? maxgain1 : maxgain2;
+
+			// log the data
+			fprintf(dynrange_log_fp, "HC55516 #%d range [%lf..+%lf] -> max gain w/o clipping %d\n",
+				(int)(chip - hc55516), chip->dynrange.vmin, chip->dynrange.vmax, (int)maxgain);
+
+			// make sure the new hits the file immediately, in case the program
+			// exits before the next update (as we won't have a chance to close
+			// the file properly on exit)
+			fflush(dynrange_log_fp);
+
+			// reset the log sample counter
+			chip->dynrange.nsamples = 0;
+		}
 #endif // LOG_LOUDNESS
+	}
 
-	// return the scaled result
-	return scaled;
+	chip->output_filter.f1 = f1;
+	chip->output_filter.f2 = f2;
 }
 
 //
@@ -943,6 +1044,8 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 	const double now = timer_get_time();
 	double t = chip->stream_update_time;
 	float * __restrict buffer = (float*)buffer_ptr;
+	float * const buffer_start = buffer;
+	float decoded[HC55516_DECODE_BLOCK];
 
 	// Start a tiny bit early, so that we (hopefully) end a little early,
 	// leaving a little CVSD input to carry over to next time.  This helps
@@ -959,7 +1062,7 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 		// transfer any buffered PCM samples
 		for (; chip->pcm_out.read != chip->pcm_out.write && length != 0; --length, t += chip->output_dt)
 		{
-			*buffer++ = apply_filter(chip, chip->pcm_out.pcm[chip->pcm_out.read++]);
+			*buffer++ = chip->pcm_out.pcm[chip->pcm_out.read++];
 			if (chip->pcm_out.read >= _countof(chip->pcm_out.pcm))
 				chip->pcm_out.read = 0;
 		}
@@ -974,7 +1077,7 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 		{
 			// add silence
 			for (; length != 0; --length, t += chip->output_dt)
-				*buffer++ = apply_filter(chip, 0.0f);
+				*buffer++ = 0.0f;
 
 			// done
 			break;
@@ -982,7 +1085,7 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 
 		// fill any gap to the next input bit with silence
 		for (; length != 0 && t < chip->bits_in.bits[chip->bits_in.read].t - max_gap; --length, t += chip->output_dt)
-			*buffer++ = apply_filter(chip, 0.0f);
+			*buffer++ = 0.0f;
 
 		// stop if we're out of space
 		if (length == 0)
@@ -1055,19 +1158,29 @@ static void hc55516_update(int num, INT16 *buffer_ptr, int length)
 		if (ratio < 0.5)
 			ratio = 1.0;
 
-		// generate these samples
-		for (i = chip->bits_in.read; n > 0; --n)
+		// generate these samples, a block at a time
+		for (i = chip->bits_in.read; n > 0; )
 		{
-			// process this bit
-			(*chip->process_bit)(chip, chip->bits_in.bits[i++].bit, ratio);
+			const int nblock = n < HC55516_DECODE_BLOCK ? n : HC55516_DECODE_BLOCK;
+
+			// decode the block and pass it through the resampler
+			(*chip->decode_bits)(chip, i, nblock, decoded);
+			add_samples_out(chip, decoded, nblock, ratio);
+
+			// advance past the block
+			n -= nblock;
+			i += nblock;
 			if (i >= _countof(chip->bits_in.bits))
-				i = 0;
+				i -= _countof(chip->bits_in.bits);
 		}
 
 		// update the read pointer
 		chip->bits_in.read = i;
 	}
 
+	// run everything we generated through the output filter in one pass
+	apply_filter(chip, buffer_start, (int)(buffer - buffer_start));
+
 	// set the new stream update time
 	chip->stream_update_time = now;
 }
@@ -1149,8 +1262,11 @@ void hc55516_clock_w(int num, int state)
 			chip->bits_in.write = 0;
 
 		// if we bumped into the read pointer, drop the last sample
-		if (chip->bits_in.write == chip->bits_in.read && ++chip->bits_in.read >= _countof(chip->bits_in.bits))
-			chip->bits_in.read = 0;
+		if (chip->bits_in.write == chip->bits_in.read)
+		{
+			if (++chip->bits_in.read >= _countof(chip->bits_in.bits))
+				chip->bits_in.read = 0;
+		}
 	}
 }
 
@@ -1275,7 +1391,7 @@ int hc55516_sh_start(const struct MachineSound *msound)
 			// low-cost decoder-only version of the 55532) though, earlier ones the 55516.
 
 			// use the chip logic simulation, with a flat loudness curve
-			chip->process_bit = process_bit_HC555XX;
+			chip->decode_bits = decode_bits_HC555XX;
 			chip->compress_loudness = flat_loudness;
 
 			// Populate the filter parameters according to the chip type
@@ -1319,6 +1435,9 @@ int hc55516_sh_start(const struct MachineSound *msound)
 				// invalid chip selection
 				return 1;
 			}
+
+			// precompute the register transfer tables for these parameters
+			init_tables_HC555XX(chip);
 		}
 		else
 		{
@@ -1332,7 +1451,7 @@ int hc55516_sh_start(const struct MachineSound *msound)
 			// to the original HC55516 logic would be to clip the sample to the 16-bit
 			// range.  That might also require some scaling (i.e., multiply the samples
 			// by X, where X > 1.0) to raise the floor level.
-			chip->process_bit = process_bit_dbl;
+			chip->decode_bits = decode_bits_dbl;
 			chip->compress_loudness = compress_loudness;
 
 			// set the default parameters for this version of the filter
@@ -178,7 +178,8 @@ static uint4 xorshift_init(const uint2 *const seed) // input simple 32/64bit see
 #endif
 
 // 4 states, as we need 2(TPDF)*2(stereo) when dithering, init'ed with plain randomness
-static uint4 xorshift_state[4] = { {1260868664u, 251862568u, 674858257u, 1214218489u}, {1131520192u, 4290450112u, 432448198u, 2826638483u}, {192412538u, 3450217573u, 3001734286u, 580418667u}, {200079512u, 80235087u, 3037801790u, 716526505u} };
+static const uint4 xorshift_seed[4] = { {1260868664u, 251862568u, 674858257u, 1214218489u}, {1131520192u, 4290450112u, 432448198u, 2826638483u}, {192412538u, 3450217573u, 3001734286u, 580418667u}, {200079512u, 80235087u, 3037801790u, 716526505u} };
+static uint4 xorshift_state[4];
 
 INLINE unsigned int xorshiftu(uint4 *const __restrict state)
 {
@@ -759,6 +760,9 @@ int mixer_sh_start()
 	memset(left_accum, 0, sizeof(left_accum));
 	memset(right_accum, 0, sizeof(right_accum));
 
+	/* restart the dither, so every run produces the same samples */
+	memcpy(xorshift_state, xorshift_seed, sizeof(xorshift_state));
+
 	r = osd_start_audio_stream(is_stereo);
 	if (r < 0)
 		return -1;
@@ -826,6 +830,7 @@ void mixer_sh_update()
 {
 	struct mixer_channel_data* channel;
 	unsigned int accum_pos = accum_base;
+	cycles_t start = osd_cycles();
 	int i;
 
 	profiler_mark(PROFILER_MIXER);
@@ -932,6 +937,9 @@ void mixer_sh_update()
     pm_wave_record(mix_buffer, samples_this_frame);
     }
 
+	/* handing the samples to the host isn't mixing */
+	perf_counters.mixer_time += osd_cycles() - start;
+
 	samples_this_frame = osd_update_audio_stream(mix_buffer);
 
 	accum_base = accum_pos;
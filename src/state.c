@@ -5,6 +5,7 @@
 #include <ctype.h>
 #include <stdarg.h>
 #include "driver.h"
+#include "state.h"
 #include <zlib.h>
 
 /* Save state file format:
@@ -58,6 +59,16 @@ static void (*ss_conv[])(unsigned char *, unsigned) = {
 	0, 0, ss_c2, ss_c2, ss_c4, ss_c4, 0, ss_c8, ss_c4
 };
 
+/* The image stores ints as 32 bit little endian whatever the host is, so on
+   little endian hosts with 32 bit ints they are plain copies.  They keep
+   their SS_INT tag though: the byte swapping of images from the other
+   endianness must leave them alone */
+#if defined(LSB_FIRST)
+#define SS_INT_PLAIN	(sizeof(int) == 4)
+#else
+#define SS_INT_PLAIN	0
+#endif
+
 
 typedef struct ss_entry {
 	struct ss_entry *next;
@@ -66,7 +77,6 @@ typedef struct ss_entry {
 	void *data;
 	unsigned size;
 	int tag;
-	unsigned offset;
 } ss_entry;
 
 typedef struct ss_module {
@@ -86,11 +96,62 @@ typedef struct ss_func {
 static ss_func *ss_prefunc_reg;
 static ss_func *ss_postfunc_reg;
 static int ss_current_tag;
+static int ss_machine;			/* 1 complete, -1 some part can't be saved */
 
 static unsigned char *ss_dump_array;
 static mame_file *ss_dump_file;
 static size_t ss_dump_size;
+static int ss_dump_in_arena;
 
+/* Flattened save plan: the registry as one array of copies sorted by tag,
+   with copies that continue each other merged.  Rebuilt only when the
+   registry changes, so saving and loading are plain array walks */
+typedef struct ss_copy {
+	void *data;
+	unsigned offset;
+	unsigned count;
+	int type;
+} ss_copy;
+
+static ss_copy *ss_plan;
+static int *ss_plan_tag;		/* first copy of each tag, ss_plan_tags+1 entries */
+static int ss_plan_tags;
+static size_t ss_plan_size;
+static UINT32 ss_plan_signature;
+static int ss_plan_valid;
+
+/* Reusable image buffer for file saves, loads and snapshots */
+static unsigned char *ss_arena;
+static size_t ss_arena_size;
+
+/* Snapshot ring: a snapshot is a table of reference counted pages of the
+   state image.  Pages equal to the previous snapshot's are shared, so
+   successive snapshots only store the pages that changed */
+#define SS_PAGE_SHIFT	12
+#define SS_PAGE_SIZE	(1 << SS_PAGE_SHIFT)
+
+typedef struct ss_page {
+	struct ss_page *next_free;
+	unsigned refs;
+	unsigned char data[SS_PAGE_SIZE];
+} ss_page;
+
+typedef struct ss_snapshot {
+	ss_page **pages;
+	unsigned page_count;
+	size_t size;			/* 0 if the slot is empty */
+	UINT32 signature;
+} ss_snapshot;
+
+static ss_snapshot *ss_ring;
+static int ss_ring_count, ss_ring_used, ss_ring_head;
+static ss_page **ss_ring_spare;
+static unsigned ss_ring_spare_count;
+static ss_page *ss_free_pages;
+static size_t ss_ring_pages;
+
+
+static int ss_load_check(void);
 
 static UINT32 ss_get_signature(void)
 {
@@ -180,9 +241,24 @@ void state_save_reset(void)
 	ss_postfunc_reg = 0;
 
 	ss_current_tag = 0;
+	ss_machine = 0;
 	ss_dump_array = 0;
 	ss_dump_file = 0;
 	ss_dump_size = 0;
+	ss_dump_in_arena = 0;
+
+	free(ss_plan);
+	free(ss_plan_tag);
+	ss_plan = 0;
+	ss_plan_tag = 0;
+	ss_plan_tags = 0;
+	ss_plan_valid = 0;
+
+	free(ss_arena);
+	ss_arena = 0;
+	ss_arena_size = 0;
+
+	state_save_ring_exit();
 }
 
 static ss_module *ss_get_module(const char *name)
@@ -233,8 +309,8 @@ static ss_entry *ss_register_entry(const char *module, int instance, const char
 	(*ep)->type   = type;
 	(*ep)->data   = data;
 	(*ep)->size   = size;
-	(*ep)->offset = 0;
 	(*ep)->tag	  = ss_current_tag;
+	ss_plan_valid = 0;
 	return *ep;
 }
 
@@ -318,6 +394,46 @@ static void ss_register_func(ss_func **root, void (*func)(void))
 	(*root)->tag  = ss_current_tag;
 }
 
+int state_save_module_registered(const char *module)
+{
+	ss_module *m;
+	for(m = ss_registry; m; m=m->next)
+		if(!strcmp(m->name, module))
+			return 1;
+	return 0;
+}
+
+int state_save_tag_registered(int tag)
+{
+	ss_module *m;
+	for(m = ss_registry; m; m=m->next) {
+		int i;
+		for(i=0; i<MAX_INSTANCES; i++) {
+			ss_entry *e;
+			for(e = m->instances[i]; e; e=e->next)
+				if(e->tag == tag)
+					return 1;
+		}
+	}
+	return 0;
+}
+
+void state_save_machine_complete(void)
+{
+	if (ss_machine == 0)
+		ss_machine = 1;
+}
+
+void state_save_machine_incomplete(void)
+{
+	ss_machine = -1;
+}
+
+int state_save_is_machine_complete(void)
+{
+	return ss_machine > 0;
+}
+
 void state_save_register_func_presave(void (*func)(void))
 {
 	ss_register_func(&ss_prefunc_reg, func);
@@ -382,36 +498,145 @@ static void ss_c8(unsigned char *data, unsigned size)
 }
 
 
-void state_save_save_begin(mame_file *file)
+static int ss_can_merge(const ss_copy *a, const ss_copy *b)
+{
+	unsigned bytes = ss_size[a->type]*a->count;
+	return a->type == b->type && (a->type != SS_INT || SS_INT_PLAIN)
+		&& (UINT8 *)a->data + bytes == (UINT8 *)b->data
+		&& a->offset + bytes == b->offset;
+}
+
+static int ss_build_plan(void)
 {
 	ss_module *m;
-	TRACE(logerror("Beginning save\n"));
-	ss_dump_size = 0x18;
-	ss_dump_file = file;
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
+	ss_entry *e;
+	int i, n = 0, tag, *next;
+	size_t offset = 0x18;
+
+	if (ss_plan_valid)
+		return 0;
+
+	free(ss_plan);
+	free(ss_plan_tag);
+	ss_plan_tags = 0;
+	for(m = ss_registry; m; m=m->next)
+		for(i=0; i<MAX_INSTANCES; i++)
+			for(e = m->instances[i]; e; e=e->next) {
+				n++;
+				if(e->tag >= ss_plan_tags)
+					ss_plan_tags = e->tag + 1;
+			}
+
+	ss_plan = malloc((n ? n : 1) * sizeof(ss_copy));
+	ss_plan_tag = calloc(ss_plan_tags + 1, sizeof(int));
+	next = malloc((ss_plan_tags ? ss_plan_tags : 1) * sizeof(int));
+	if (ss_plan == NULL || ss_plan_tag == NULL || next == NULL)
+	{
+		logerror ("malloc failed in ss_build_plan\n");
+		free(next);
+		return 1;
+	}
+
+	/* count the copies of each tag */
+	for(m = ss_registry; m; m=m->next)
+		for(i=0; i<MAX_INSTANCES; i++)
+			for(e = m->instances[i]; e; e=e->next)
+				ss_plan_tag[e->tag + 1]++;
+	for(tag=0; tag<ss_plan_tags; tag++)
+		ss_plan_tag[tag + 1] += ss_plan_tag[tag];
+
+	/* place them in registry order within their tag */
+	memcpy(next, ss_plan_tag, ss_plan_tags * sizeof(int));
+	for(m = ss_registry; m; m=m->next)
+		for(i=0; i<MAX_INSTANCES; i++)
 			for(e = m->instances[i]; e; e=e->next) {
-				e->offset = ss_dump_size;
-				ss_dump_size += ss_size[e->type]*e->size;
+				ss_copy *c = &ss_plan[next[e->tag]++];
+				c->data   = e->data;
+				c->offset = offset;
+				c->count  = e->size;
+				c->type   = e->type;
+				offset += ss_size[e->type]*e->size;
 			}
+	free(next);
+
+	/* merge the copies */
+	n = 0;
+	for(tag=0; tag<ss_plan_tags; tag++) {
+		int first = ss_plan_tag[tag], last = ss_plan_tag[tag + 1];
+		ss_plan_tag[tag] = n;
+		for(i=first; i<last; i++) {
+			if(n > ss_plan_tag[tag] && ss_can_merge(&ss_plan[n-1], &ss_plan[i]))
+				ss_plan[n-1].count += ss_plan[i].count;
+			else
+				ss_plan[n++] = ss_plan[i];
 		}
 	}
+	ss_plan_tag[ss_plan_tags] = n;
+
+	ss_plan_size = offset;
+	ss_plan_signature = ss_get_signature();
+	ss_plan_valid = 1;
+	TRACE(logerror("Save plan: %d copies, %u bytes\n", n, ss_plan_size));
+	return 0;
+}
+
+static unsigned char *ss_get_arena(size_t size)
+{
+	if (size > ss_arena_size)
+	{
+		unsigned char *arena = realloc(ss_arena, size);
+		if (arena == NULL)
+		{
+			logerror ("malloc failed in ss_get_arena\n");
+			return NULL;
+		}
+		ss_arena = arena;
+		ss_arena_size = size;
+	}
+	return ss_arena;
+}
+
+/* releases the image once a save or load is done */
+static void ss_dump_done(void)
+{
+	if (!ss_dump_in_arena)
+		free(ss_dump_array);
+	ss_dump_array = 0;
+	ss_dump_size = 0;
+	ss_dump_file = 0;
+	ss_dump_in_arena = 0;
+}
+
+static void ss_save_begin(mame_file *file, int in_arena)
+{
+	TRACE(logerror("Beginning save\n"));
+	ss_dump_file = file;
+	ss_dump_in_arena = in_arena;
+	if (ss_build_plan())
+	{
+		ss_dump_array = 0;
+		ss_dump_size = 0;
+		return;
+	}
+	ss_dump_size = ss_plan_size;
 
 	TRACE(logerror("   total size %u\n", ss_dump_size));
-	ss_dump_array = malloc(ss_dump_size);
+	ss_dump_array = in_arena ? ss_get_arena(ss_dump_size) : malloc(ss_dump_size);
 	if (ss_dump_array == NULL)
 	{
 		logerror ("malloc failed in state_save_save_begin\n");
 	}
 }
 
+void state_save_save_begin(mame_file *file)
+{
+	ss_save_begin(file, 1);
+}
+
 void state_save_save_continue(void)
 {
-	ss_module *m;
 	ss_func * f;
-	int count = 0;
+	int count = 0, i;
 	TRACE(logerror("Saving tag %d\n", ss_current_tag));
 	TRACE(logerror("  calling pre-save functions\n"));
 	f = ss_prefunc_reg;
@@ -423,37 +648,27 @@ void state_save_save_continue(void)
 		f = f->next;
 	}
 	TRACE(logerror("    %d functions called\n", count));
+	if (ss_dump_array == NULL || ss_current_tag >= ss_plan_tags)
+		return;
 	TRACE(logerror("  copying data\n"));
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next)
-				if(e->tag == ss_current_tag) {
-					if(e->type == SS_INT) {
-						int v = *(int *)(e->data);
-						ss_dump_array[e->offset]   = v ;
-						ss_dump_array[e->offset+1] = v >> 8;
-						ss_dump_array[e->offset+2] = v >> 16;
-						ss_dump_array[e->offset+3] = v >> 24;
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+3));
-					} else {
-						memcpy(ss_dump_array + e->offset, e->data, ss_size[e->type]*e->size);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+ss_size[e->type]*e->size-1));
-					}
-				}
-		}
+	for(i = ss_plan_tag[ss_current_tag]; i < ss_plan_tag[ss_current_tag + 1]; i++) {
+		const ss_copy *c = &ss_plan[i];
+		if(c->type == SS_INT && !SS_INT_PLAIN) {
+			int v = *(int *)(c->data);
+			ss_dump_array[c->offset]   = v ;
+			ss_dump_array[c->offset+1] = v >> 8;
+			ss_dump_array[c->offset+2] = v >> 16;
+			ss_dump_array[c->offset+3] = v >> 24;
+		} else
+			memcpy(ss_dump_array + c->offset, c->data, ss_size[c->type]*c->count);
+		TRACE(logerror("    %x..%x\n", c->offset, c->offset+ss_size[c->type]*c->count-1));
 	}
 }
 
-void state_save_save_finish(void)
+static void ss_write_header(void)
 {
-	UINT32 signature;
 	unsigned char flags = 0;
 
-	TRACE(logerror("Finishing save\n"));
-
-	signature = ss_get_signature();
 	if(Machine->sample_rate == 0.)
 		flags |= SS_NO_SOUND;
 
@@ -467,34 +682,86 @@ void state_save_save_finish(void)
 	memset(ss_dump_array+0xa, 0, 10);
 	strcpy((char *)ss_dump_array+0xa, Machine->gamedrv->name);
 
-	ss_dump_array[0x14] = signature;
-	ss_dump_array[0x15] = signature >> 8;
-	ss_dump_array[0x16] = signature >> 16;
-	ss_dump_array[0x17] = signature >> 24;
+	ss_dump_array[0x14] = ss_plan_signature;
+	ss_dump_array[0x15] = ss_plan_signature >> 8;
+	ss_dump_array[0x16] = ss_plan_signature >> 16;
+	ss_dump_array[0x17] = ss_plan_signature >> 24;
+}
+
+void state_save_save_finish(void)
+{
+	TRACE(logerror("Finishing save\n"));
+
+	if (ss_dump_array)
+	{
+		ss_write_header();
+		mame_fwrite(ss_dump_file, ss_dump_array, ss_dump_size);
+	}
+	ss_dump_done();
+}
+
+void state_save_save_begin_memory(void)
+{
+	ss_save_begin(NULL, 0);
+}
+
+void *state_save_save_finish_memory(size_t *size)
+{
+	unsigned char *data = ss_dump_array;
+
+	TRACE(logerror("Finishing save to memory\n"));
+
+	*size = 0;
+	if (data == NULL)
+		return NULL;
+
+	ss_write_header();
 
-	mame_fwrite(ss_dump_file, ss_dump_array, ss_dump_size);
-	free(ss_dump_array);
+	/* the caller takes over the image */
+	*size = ss_dump_size;
 	ss_dump_array = 0;
-	ss_dump_size = 0;
-	ss_dump_file = 0;
+	ss_dump_done();
+	return data;
 }
 
 int state_save_load_begin(mame_file *file)
 {
-	ss_module *m;
-	unsigned int offset;
-	UINT32 signature, file_sig;
-
 	TRACE(logerror("Beginning load\n"));
 
-	signature = ss_get_signature();
-
 	ss_dump_size = mame_fsize(file);
-	ss_dump_array = malloc(ss_dump_size);
+	ss_dump_array = ss_get_arena(ss_dump_size);
+	ss_dump_in_arena = 1;
 	ss_dump_file = file;
+	if (ss_dump_array == NULL)
+		return 1;
 	mame_fread(ss_dump_file, ss_dump_array, ss_dump_size);
 
-	if(memcmp(ss_dump_array, "MAMESAVE", 8)) {
+	return ss_load_check();
+}
+
+int state_save_load_begin_memory(const void *data, size_t size)
+{
+	TRACE(logerror("Beginning load from memory\n"));
+
+	ss_dump_size = size;
+	ss_dump_array = ss_get_arena(ss_dump_size);
+	ss_dump_in_arena = 1;
+	ss_dump_file = 0;
+	if (ss_dump_array == NULL)
+		return 1;
+	memcpy(ss_dump_array, data, ss_dump_size);
+
+	return ss_load_check();
+}
+
+static int ss_load_check(void)
+{
+	UINT32 file_sig;
+
+	if(ss_build_plan())
+		goto bad;
+
+	if(ss_dump_size < 0x18 || memcmp(ss_dump_array, "MAMESAVE", 8)) {
 		usrintf_showmessage("Error: This is not a mame save file");
 		goto bad;
 	}
@@ -510,9 +777,9 @@ int state_save_load_begin(mame_file *file)
 		| (ss_dump_array[0x16] << 16)
 		| (ss_dump_array[0x17] << 24);
 
-	if(file_sig != signature) {
+	if(file_sig != ss_plan_signature) {
 		usrintf_showmessage("Error: Incompatible save file (signature %08x, expected %08x)",
-							file_sig, signature);
+							file_sig, ss_plan_signature);
 		goto bad;
 	}
 
@@ -527,29 +794,21 @@ int state_save_load_begin(mame_file *file)
 			usrintf_showmessage("Warning: Game was saved with sound on, but sound is off.  Result may be interesting.");
 	}
 
-	offset = 0x18;
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next) {
-				e->offset = offset;
-				offset += ss_size[e->type]*e->size;
-			}
-		}
+	if(ss_plan_size > ss_dump_size) {
+		usrintf_showmessage("Error: Truncated save file");
+		goto bad;
 	}
 	return 0;
 
  bad:
-	free(ss_dump_array);
+	ss_dump_done();
 	return 1;
 }
 
 void state_save_load_continue(void)
 {
-	ss_module *m;
 	ss_func * f;
-	int count = 0;
+	int count = 0, i;
 	int need_convert;
 
 #ifdef LSB_FIRST
@@ -560,29 +819,23 @@ void state_save_load_continue(void)
 
 	TRACE(logerror("Loading tag %d\n", ss_current_tag));
 	TRACE(logerror("  copying data\n"));
-	for(m = ss_registry; m; m=m->next) {
-		int i;
-		for(i=0; i<MAX_INSTANCES; i++) {
-			ss_entry *e;
-			for(e = m->instances[i]; e; e=e->next)
-				if(e->tag == ss_current_tag) {
-					if(e->type == SS_INT) {
-						int v;
-						v = ss_dump_array[e->offset]
-							| (ss_dump_array[e->offset+1] << 8)
-							| (ss_dump_array[e->offset+2] << 16)
-							| (ss_dump_array[e->offset+3] << 24);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+3));
-						*(int *)(e->data) = v;
-					} else {
-						memcpy(e->data, ss_dump_array + e->offset, ss_size[e->type]*e->size);
-						if (need_convert && ss_conv[e->type])
-							ss_conv[e->type](e->data, e->size);
-						TRACE(logerror("    %s.%d.%s: %x..%x\n", m->name, i, e->name, e->offset, e->offset+ss_size[e->type]*e->size-1));
-					}
-				}
+	if (ss_current_tag < ss_plan_tags)
+		for(i = ss_plan_tag[ss_current_tag]; i < ss_plan_tag[ss_current_tag + 1]; i++) {
+			const ss_copy *c = &ss_plan[i];
+			if(c->type == SS_INT && !SS_INT_PLAIN) {
+				int v;
+				v = ss_dump_array[c->offset]
+					| (ss_dump_array[c->offset+1] << 8)
+					| (ss_dump_array[c->offset+2] << 16)
+					| (ss_dump_array[c->offset+3] << 24);
+				*(int *)(c->data) = v;
+			} else {
+				memcpy(c->data, ss_dump_array + c->offset, ss_size[c->type]*c->count);
+				if (need_convert && ss_conv[c->type])
+					ss_conv[c->type](c->data, c->count);
+			}
+			TRACE(logerror("    %x..%x\n", c->offset, c->offset+ss_size[c->type]*c->count-1));
 		}
-	}
 	TRACE(logerror("  calling post-load functions\n"));
 	f = ss_postfunc_reg;
 	while(f) {
@@ -598,10 +851,206 @@ void state_save_load_continue(void)
 void state_save_load_finish(void)
 {
 	TRACE(logerror("Finishing load\n"));
-	free(ss_dump_array);
-	ss_dump_array = 0;
-	ss_dump_size = 0;
+	ss_dump_done();
+}
+
+static ss_page *ss_page_alloc(void)
+{
+	ss_page *p = ss_free_pages;
+	if (p)
+		ss_free_pages = p->next_free;
+	else
+	{
+		p = malloc(sizeof(ss_page));
+		if (p == NULL)
+		{
+			logerror ("malloc failed in ss_page_alloc\n");
+			return NULL;
+		}
+		ss_ring_pages++;
+	}
+	p->refs = 1;
+	return p;
+}
+
+static void ss_page_release(ss_page *p)
+{
+	if (--p->refs == 0)
+	{
+		p->next_free = ss_free_pages;
+		ss_free_pages = p;
+	}
+}
+
+static void ss_snapshot_release(ss_snapshot *s)
+{
+	unsigned i, n = (unsigned)((s->size + SS_PAGE_SIZE - 1) >> SS_PAGE_SHIFT);
+	for (i = 0; i < n; i++)
+		ss_page_release(s->pages[i]);
+	s->size = 0;
+}
+
+int state_save_ring_init(int count)
+{
+	state_save_ring_exit();
+	if (count <= 0)
+		return 0;
+	ss_ring = calloc(count, sizeof(ss_snapshot));
+	if (ss_ring == NULL)
+		return 1;
+	ss_ring_count = count;
+	return 0;
+}
+
+void state_save_ring_exit(void)
+{
+	int i;
+	for (i = 0; i < ss_ring_count; i++)
+	{
+		if (ss_ring[i].size)
+			ss_snapshot_release(&ss_ring[i]);
+		free(ss_ring[i].pages);
+	}
+	free(ss_ring);
+	free(ss_ring_spare);
+	ss_ring = 0;
+	ss_ring_spare = 0;
+	ss_ring_spare_count = 0;
+	ss_ring_count = ss_ring_used = ss_ring_head = 0;
+
+	while (ss_free_pages)
+	{
+		ss_page *next = ss_free_pages->next_free;
+		free(ss_free_pages);
+		ss_free_pages = next;
+	}
+	ss_ring_pages = 0;
+}
+
+void state_save_ring_info(int *snapshots, size_t *memory)
+{
+	if (snapshots)
+		*snapshots = ss_ring_used;
+	if (memory)
+		*memory = ss_ring_pages * SS_PAGE_SIZE;
+}
+
+void state_save_snapshot_begin(void)
+{
+	ss_save_begin(NULL, 1);
+}
+
+int state_save_snapshot_finish(void)
+{
+	ss_snapshot *prev, *s;
+	ss_page **pages;
+	unsigned i, n, count;
+
+	if (ss_ring_count == 0 || ss_dump_array == NULL)
+	{
+		ss_dump_done();
+		return 1;
+	}
+
+	ss_write_header();
+
+	/* only an image with the same layout can share pages */
+	prev = ss_ring_used ? &ss_ring[(ss_ring_head + ss_ring_count - 1) % ss_ring_count] : NULL;
+	if (prev && (prev->size != ss_dump_size || prev->signature != ss_plan_signature))
+		prev = NULL;
+
+	/* build the new page table in the spare one, the slot may be prev itself */
+	n = (unsigned)((ss_dump_size + SS_PAGE_SIZE - 1) >> SS_PAGE_SHIFT);
+	if (n > ss_ring_spare_count)
+	{
+		pages = realloc(ss_ring_spare, n * sizeof(ss_page *));
+		if (pages == NULL)
+		{
+			ss_dump_done();
+			return 1;
+		}
+		ss_ring_spare = pages;
+		ss_ring_spare_count = n;
+	}
+	for (i = 0; i < n; i++)
+	{
+		const unsigned char *src = ss_dump_array + ((size_t)i << SS_PAGE_SHIFT);
+		size_t len = ss_dump_size - ((size_t)i << SS_PAGE_SHIFT);
+		if (len > SS_PAGE_SIZE)
+			len = SS_PAGE_SIZE;
+
+		if (prev && !memcmp(prev->pages[i]->data, src, len))
+		{
+			ss_ring_spare[i] = prev->pages[i];
+			ss_ring_spare[i]->refs++;
+		}
+		else if ((ss_ring_spare[i] = ss_page_alloc()) != NULL)
+			memcpy(ss_ring_spare[i]->data, src, len);
+		else
+		{
+			while (i--)
+				ss_page_release(ss_ring_spare[i]);
+			ss_dump_done();
+			return 1;
+		}
+	}
+
+	s = &ss_ring[ss_ring_head];
+	if (s->size)
+		ss_snapshot_release(s);
+	pages = s->pages;
+	count = s->page_count;
+	s->pages = ss_ring_spare;
+	s->page_count = ss_ring_spare_count;
+	s->size = ss_dump_size;
+	s->signature = ss_plan_signature;
+	ss_ring_spare = pages;
+	ss_ring_spare_count = count;
+
+	ss_ring_head = (ss_ring_head + 1) % ss_ring_count;
+	if (ss_ring_used < ss_ring_count)
+		ss_ring_used++;
+
+	ss_dump_done();
+	return 0;
+}
+
+int state_save_snapshot_load_begin(int back)
+{
+	const ss_snapshot *s;
+	unsigned i, n;
+
+	TRACE(logerror("Beginning load from snapshot %d\n", back));
+
+	if (back < 0 || back >= ss_ring_used)
+		return 1;
+
+	s = &ss_ring[(ss_ring_head + ss_ring_count - 1 - back) % ss_ring_count];
+	ss_dump_size = s->size;
+	ss_dump_array = ss_get_arena(ss_dump_size);
+	ss_dump_in_arena = 1;
 	ss_dump_file = 0;
+	if (ss_dump_array == NULL)
+		return 1;
+
+	n = (unsigned)((s->size + SS_PAGE_SIZE - 1) >> SS_PAGE_SHIFT);
+	for (i = 0; i < n; i++)
+	{
+		size_t len = s->size - ((size_t)i << SS_PAGE_SHIFT);
+		memcpy(ss_dump_array + ((size_t)i << SS_PAGE_SHIFT), s->pages[i]->data, len > SS_PAGE_SIZE ? SS_PAGE_SIZE : len);
+	}
+
+	if (ss_load_check())
+		return 1;
+
+	/* the snapshots taken after this one are dropped */
+	while (back--)
+	{
+		ss_ring_head = (ss_ring_head + ss_ring_count - 1) % ss_ring_count;
+		ss_snapshot_release(&ss_ring[ss_ring_head]);
+		ss_ring_used--;
+	}
+	return 0;
 }
 
 void state_save_dump_registry(void)
@@ -30,6 +30,26 @@ void state_save_register_float (const char *module, int instance,
 void state_save_register_int   (const char *module, int instance,
 								const char *name, int *val);
 
+/* Registers a pointer-free variable, array or struct as raw bytes.
+   Raw items are stored in host byte order */
+#define state_save_register_item(module, instance, item) \
+	state_save_register_UINT8(module, instance, #item, (UINT8 *)&(item), sizeof(item))
+
+/* Returns non-zero if anything was registered for the module yet, so
+   drivers initialised again on a soft reset can skip their registration */
+int state_save_module_registered(const char *module);
+
+/* Returns non-zero if any data was registered with the given tag */
+int state_save_tag_registered(int tag);
+
+/* A driver marks the machine complete once its own state and that of its
+   boards is registered; a part that can't be saved marks it incomplete
+   for good.  Only complete machines can have their state saved and
+   restored, both marks are cleared by state_save_reset() */
+void state_save_machine_complete(void);
+void state_save_machine_incomplete(void);
+int state_save_is_machine_complete(void);
+
 
 void state_save_register_func_presave(void (*func)(void));
 void state_save_register_func_postload(void (*func)(void));
@@ -46,6 +66,25 @@ void state_save_load_continue(void);
 void state_save_save_finish(void);
 void state_save_load_finish(void);
 
+/* In-memory variants: the state image is the same as the file contents.
+   state_save_save_finish_memory() returns a malloc'ed buffer owned by the
+   caller, state_save_load_begin_memory() copies the supplied image */
+void state_save_save_begin_memory(void);
+void *state_save_save_finish_memory(size_t *size);
+int  state_save_load_begin_memory(const void *data, size_t size);
+
+/* Snapshot ring for rewind and replay.  Snapshots are images in the
+   same format, kept in memory; pages of the image that did not change
+   since the previous snapshot are shared with it.  Loading a snapshot
+   drops the ones taken after it.  The ring is freed by state_save_reset() */
+int  state_save_ring_init(int count);
+void state_save_ring_exit(void);
+void state_save_ring_info(int *snapshots, size_t *memory);
+
+void state_save_snapshot_begin(void);
+int  state_save_snapshot_finish(void);
+int  state_save_snapshot_load_begin(int back);
+
 /* Display function */
 void state_save_dump_registry(void);
 
@@ -315,6 +315,7 @@ void timer_adjust_global_time(double delta)
 			profiler_mark(PROFILER_TIMER_CALLBACK);
 			(*timer->callback)(timer->callback_param);
 			profiler_mark(PROFILER_END);
+			perf_counters.timer_callbacks++;
 		}
 
 		/* clear the callback timer global */
@@ -342,6 +343,20 @@ void timer_adjust_global_time(double delta)
 
 
 
+/*-------------------------------------------------
+	timer_set_global_time - move the current time
+	to an absolute value; pending timers keep the
+	time they have left. Used when a save state
+	is loaded
+-------------------------------------------------*/
+
+void timer_set_global_time(double time)
+{
+	global_offset = time - get_relative_time();
+}
+
+
+
 /*-------------------------------------------------
 	timer_alloc - allocate a permament timer that
 	isn't primed yet
@@ -59,6 +59,7 @@ void timer_init(void);
 void timer_free(void);
 double timer_time_until_next_timer(void);
 void timer_adjust_global_time(double delta);
+void timer_set_global_time(double time);
 mame_timer *timer_alloc(void (*callback)(int));
 void timer_adjust(mame_timer *which, double duration, int param, double period);
 void timer_pulse(double period, int param, void (*callback)(int));
@@ -5,6 +5,8 @@
 /*============================================================ */
 
 #include <stdarg.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include "xmame.h"
 #include "osdutils.h"
 #include "unzip.h"
@@ -449,6 +451,119 @@ int osd_get_path_info(int pathtype, int pathindex, const char *filename)
 
 
 
+/*============================================================ */
+/*	osd_get_file_stamp */
+/*============================================================ */
+
+int osd_get_file_stamp(int pathtype, int pathindex, const char *filename, UINT64 *size, INT64 *mtime)
+{
+	struct stat buf;
+	char fullpath[1024];
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+	if (stat(fullpath, &buf) || S_ISDIR(buf.st_mode))
+		return -1;
+
+	*size = buf.st_size;
+	*mtime = buf.st_mtime;
+	return 0;
+}
+
+
+
+/*============================================================ */
+/*	osd_map_file */
+/*============================================================ */
+
+const void *osd_map_file(int pathtype, int pathindex, const char *filename, UINT64 *size)
+{
+	struct stat buf;
+	char fullpath[1024];
+	const void *base = NULL;
+	int fd;
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+	fd = open(fullpath, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+
+	/* empty files can't be mapped; the mapping stays valid once the descriptor is closed */
+	if (!fstat(fd, &buf) && S_ISREG(buf.st_mode) && buf.st_size > 0)
+	{
+		base = mmap(NULL, buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED)
+			base = NULL;
+	}
+	close(fd);
+
+	if (base)
+		*size = buf.st_size;
+	return base;
+}
+
+
+
+/*============================================================ */
+/*	osd_unmap_file */
+/*============================================================ */
+
+void osd_unmap_file(const void *base, UINT64 size)
+{
+	munmap((void *)base, size);
+}
+
+
+
+/*============================================================ */
+/*	osd_replace_file */
+/*============================================================ */
+
+int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length)
+{
+	char fullpath[1024], temppath[1024 + 4];
+	UINT32 done = 0;
+	int fd, ok;
+
+	/* compose the full path, and the temporary next to it */
+	compose_path(fullpath, pathtype, pathindex, filename);
+	strcpy(temppath, fullpath);
+	strcat(temppath, ".tmp");
+
+	fd = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (fd == -1 && errno == ENOENT)
+	{
+		create_path(temppath, 1);
+		fd = open(temppath, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	}
+	if (fd == -1)
+		return 1;
+
+	while (done < length)
+	{
+		ssize_t result = write(fd, (const UINT8 *)data + done, length - done);
+		if (result <= 0)
+			break;
+		done += result;
+	}
+	ok = (done == length && fsync(fd) == 0);
+	if (close(fd) != 0)
+		ok = 0;
+
+	/* only replace the old file once the new one is complete on disk */
+	if (!ok || rename(temppath, fullpath) != 0)
+	{
+		unlink(temppath);
+		return 1;
+	}
+	return 0;
+}
+
+
+
 /*============================================================ */
 /*	osd_fopen */
 /*============================================================ */
@@ -192,6 +192,29 @@ static int ecd_read(ZIP* zip) {
 #define ZIPXTRALN	0x1c
 #define ZIPNAME		0x1e
 
+/* Decode a central directory entry, except for its name */
+static void read_zipent(struct zipent* ent, char* buf) {
+	ent->cent_file_header_sig = read_dword (buf+ZIPCENSIG);
+	ent->version_made_by = *(buf+ZIPCVER);
+	ent->host_os = *(buf+ZIPCOS);
+	ent->version_needed_to_extract = *(buf+ZIPCVXT);
+	ent->os_needed_to_extract = *(buf+ZIPCEXOS);
+	ent->general_purpose_bit_flag = read_word (buf+ZIPCFLG);
+	ent->compression_method = read_word (buf+ZIPCMTHD);
+	ent->last_mod_file_time = read_word (buf+ZIPCTIM);
+	ent->last_mod_file_date = read_word (buf+ZIPCDAT);
+	ent->crc32 = read_dword (buf+ZIPCCRC);
+	ent->compressed_size = read_dword (buf+ZIPCSIZ);
+	ent->uncompressed_size = read_dword (buf+ZIPCUNC);
+	ent->filename_length = read_word (buf+ZIPCFNL);
+	ent->extra_field_length = read_word (buf+ZIPCXTL);
+	ent->file_comment_length = read_word (buf+ZIPCCML);
+	ent->disk_number_start = read_word (buf+ZIPDSK);
+	ent->internal_file_attrib = read_word (buf+ZIPINT);
+	ent->external_file_attrib = read_dword (buf+ZIPEXT);
+	ent->offset_lcl_hdr_frm_frst_disk = read_dword (buf+ZIPOFST);
+}
+
 /* Opens a zip stream for reading
    return:
      !=0 success, zip stream
@@ -327,25 +350,7 @@ struct zipent* readzip(ZIP* zip) {
 		return 0;
 
 	/* compile zipent info */
-	zip->ent.cent_file_header_sig = read_dword (zip->cd+zip->cd_pos+ZIPCENSIG);
-	zip->ent.version_made_by = *(zip->cd+zip->cd_pos+ZIPCVER);
-	zip->ent.host_os = *(zip->cd+zip->cd_pos+ZIPCOS);
-	zip->ent.version_needed_to_extract = *(zip->cd+zip->cd_pos+ZIPCVXT);
-	zip->ent.os_needed_to_extract = *(zip->cd+zip->cd_pos+ZIPCEXOS);
-	zip->ent.general_purpose_bit_flag = read_word (zip->cd+zip->cd_pos+ZIPCFLG);
-	zip->ent.compression_method = read_word (zip->cd+zip->cd_pos+ZIPCMTHD);
-	zip->ent.last_mod_file_time = read_word (zip->cd+zip->cd_pos+ZIPCTIM);
-	zip->ent.last_mod_file_date = read_word (zip->cd+zip->cd_pos+ZIPCDAT);
-	zip->ent.crc32 = read_dword (zip->cd+zip->cd_pos+ZIPCCRC);
-	zip->ent.compressed_size = read_dword (zip->cd+zip->cd_pos+ZIPCSIZ);
-	zip->ent.uncompressed_size = read_dword (zip->cd+zip->cd_pos+ZIPCUNC);
-	zip->ent.filename_length = read_word (zip->cd+zip->cd_pos+ZIPCFNL);
-	zip->ent.extra_field_length = read_word (zip->cd+zip->cd_pos+ZIPCXTL);
-	zip->ent.file_comment_length = read_word (zip->cd+zip->cd_pos+ZIPCCML);
-	zip->ent.disk_number_start = read_word (zip->cd+zip->cd_pos+ZIPDSK);
-	zip->ent.internal_file_attrib = read_word (zip->cd+zip->cd_pos+ZIPINT);
-	zip->ent.external_file_attrib = read_dword (zip->cd+zip->cd_pos+ZIPEXT);
-	zip->ent.offset_lcl_hdr_frm_frst_disk = read_dword (zip->cd+zip->cd_pos+ZIPOFST);
+	read_zipent(&zip->ent, zip->cd+zip->cd_pos);
 
     /* check to see if filename length is illegally long (past the size of this directory
        entry) */
@@ -624,6 +629,420 @@ int readuncompresszip(ZIP* zip, struct zipent* ent, char* data) {
 	}
 }
 
+/* -------------------------------------------------------------------------
+   Mapped zip support
+ ------------------------------------------------------------------------- */
+
+/* Unused maps kept for the next open, unzip_cache_clear() (run when a
+   game stops) unmaps them */
+#define ZIPMAP_CACHE_MAX 16
+
+struct _ZIPMAP {
+	ZIPMAP* next; /* cache list, most recently used first */
+	char* zip; /* zip name */
+	int pathtype,pathindex; /* additional path info */
+	UINT64 size; /* size and timestamp of the mapped file */
+	INT64 mtime;
+	int refcount; /* zipmap_open calls not yet closed */
+	int cached; /* still in the cache list */
+
+	const UINT8* base; /* mapped zip file */
+	UINT64 length;
+
+	UINT16 number_of_this_disk;
+	unsigned entries;
+	struct zipent* ent; /* cent_dir entries, names point into 'names' */
+	const UINT8** data; /* member data inside the mapping, 0 if out of bounds */
+	char* names;
+	unsigned* hash; /* entry index + 1 by member name, 0 if empty */
+	unsigned hash_mask;
+};
+
+static ZIPMAP* zipmap_cache;
+
+#if defined(_WIN32) || defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+static SRWLOCK zipmap_lock = SRWLOCK_INIT;
+#define zipmap_lock_acquire() AcquireSRWLockExclusive(&zipmap_lock)
+#define zipmap_lock_release() ReleaseSRWLockExclusive(&zipmap_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t zipmap_lock = PTHREAD_MUTEX_INITIALIZER;
+#define zipmap_lock_acquire() pthread_mutex_lock(&zipmap_lock)
+#define zipmap_lock_release() pthread_mutex_unlock(&zipmap_lock)
+#endif
+
+static int equal_filename(const char* zipfile, const char* file);
+
+/* Hash of a member name, same rules as equal_filename() */
+static unsigned zipmap_hash_name(const char* name) {
+	unsigned hash = 2166136261u;
+	while (*name)
+		hash = (hash ^ (unsigned)toupper((unsigned char)*name++)) * 16777619u;
+	return hash;
+}
+
+static void zipmap_free(ZIPMAP* map) {
+	if (map->base)
+		osd_unmap_file(map->base, map->length);
+	free(map->hash);
+	free(map->names);
+	free(map->data);
+	free(map->ent);
+	free(map->zip);
+	free(map);
+}
+
+/* Parse the central directory of a mapped zip
+   return:
+	==0 success
+	<0 error
+*/
+static int zipmap_parse(ZIPMAP* map) {
+	char* ecd = 0;
+	char* cd;
+	UINT32 size_of_cent_dir, offset_to_start_of_cent_dir;
+	unsigned pos, i, names_length = 0, hash_size;
+	char* name;
+	INT64 scan, stop;
+
+	/* end of central directory, followed by at most 64k of comment */
+	stop = map->length > 22 + 0xffff ? (INT64)map->length - 22 - 0xffff : 0;
+	for (scan = (INT64)map->length - 22; scan >= stop; scan--) {
+		if (memcmp(map->base+scan, "PK\x05\x06", 4) == 0) {
+			ecd = (char*)map->base+scan;
+			break;
+		}
+	}
+	if (!ecd) {
+		errormsg ("Reading ECD (end of central directory)", ERROR_CORRUPT, map->zip);
+		return -1;
+	}
+
+	/* verify that we can work with this zipfile (no disk spanning allowed) */
+	map->number_of_this_disk = read_word (ecd+ZIPEDSK);
+	if ((map->number_of_this_disk != read_word (ecd+ZIPECEN)) ||
+		(read_word (ecd+ZIPENUM) != read_word (ecd+ZIPECENN)) ||
+		(read_word (ecd+ZIPECENN) < 1)) {
+		errormsg("Cannot span disks", ERROR_UNSUPPORTED, map->zip);
+		return -1;
+	}
+
+	size_of_cent_dir = read_dword (ecd+ZIPECSZ);
+	offset_to_start_of_cent_dir = read_dword (ecd+ZIPEOFST);
+	if ((UINT64)offset_to_start_of_cent_dir + size_of_cent_dir > (UINT64)scan) {
+		errormsg ("Reading central directory", ERROR_CORRUPT, map->zip);
+		return -1;
+	}
+	cd = (char*)map->base + offset_to_start_of_cent_dir;
+
+	/* count the entries and the space for their names */
+	for (pos = 0; pos + ZIPCFN <= size_of_cent_dir; ) {
+		UINT16 filename_length = read_word (cd+pos+ZIPCFNL);
+		if (pos + ZIPCFN + filename_length > size_of_cent_dir) {
+			errormsg("Invalid filename length in directory", ERROR_CORRUPT, map->zip);
+			return -1;
+		}
+		names_length += filename_length + 1;
+		map->entries++;
+		pos += ZIPCFN + filename_length + read_word (cd+pos+ZIPCXTL) + read_word (cd+pos+ZIPCCML);
+	}
+
+	/* hash table at most half full */
+	for (hash_size = 16; hash_size < 2 * map->entries; hash_size *= 2)
+		;
+	map->hash_mask = hash_size - 1;
+
+	map->ent = (struct zipent*)malloc(map->entries * sizeof(struct zipent) + 1);
+	map->data = (const UINT8**)malloc(map->entries * sizeof(UINT8*) + 1);
+	map->names = (char*)malloc(names_length + 1);
+	map->hash = (unsigned*)calloc(hash_size, sizeof(unsigned));
+	if (!map->ent || !map->data || !map->names || !map->hash)
+		return -1;
+
+	name = map->names;
+	for (pos = 0, i = 0; i < map->entries; i++) {
+		struct zipent* ent = &map->ent[i];
+		UINT64 local = 0;
+		unsigned slot;
+
+		read_zipent(ent, cd+pos);
+
+		/* copy filename */
+		ent->name = name;
+		memcpy(name, cd+pos+ZIPCFN, ent->filename_length);
+		name[ent->filename_length] = 0;
+		name += ent->filename_length + 1;
+
+		/* skip the local header, the data must lie inside the file */
+		map->data[i] = 0;
+		if ((UINT64)ent->offset_lcl_hdr_frm_frst_disk + ZIPNAME <= map->length) {
+			char* header = (char*)map->base + ent->offset_lcl_hdr_frm_frst_disk;
+			local = (UINT64)ent->offset_lcl_hdr_frm_frst_disk + ZIPNAME + read_word (header+ZIPFNLN) + read_word (header+ZIPXTRALN);
+			if (local + ent->compressed_size <= map->length)
+				map->data[i] = map->base + local;
+		}
+
+		/* index by name, the first of several equal names wins like a readzip() scan */
+		{
+			const char* base_name = strrchr(ent->name, '/');
+			slot = zipmap_hash_name(base_name ? base_name + 1 : ent->name) & map->hash_mask;
+		}
+		while (map->hash[slot])
+			slot = (slot + 1) & map->hash_mask;
+		map->hash[slot] = i + 1;
+
+		/* skip to next entry in central dir */
+		pos += ZIPCFN + ent->filename_length + ent->extra_field_length + ent->file_comment_length;
+	}
+
+	return 0;
+}
+
+/* Free unused maps beyond ZIPMAP_CACHE_MAX, lock held */
+static void zipmap_trim(void) {
+	ZIPMAP** link = &zipmap_cache;
+	unsigned unused = 0;
+
+	while (*link) {
+		ZIPMAP* map = *link;
+		if (!map->refcount && ++unused > ZIPMAP_CACHE_MAX) {
+			*link = map->next;
+			zipmap_free(map);
+		}
+		else
+			link = &map->next;
+	}
+}
+
+/* Maps a zip, or returns the cached map of it
+   return:
+     !=0 success, release with zipmap_close
+     ==0 error, or the file can't be mapped
+*/
+ZIPMAP* zipmap_open(int pathtype, int pathindex, const char* zipfile) {
+	ZIPMAP* map;
+	ZIPMAP** link;
+	UINT64 size;
+	INT64 mtime;
+
+	if (osd_get_file_stamp(pathtype, pathindex, zipfile, &size, &mtime) != 0)
+		return 0;
+
+	/* search in the cache */
+	zipmap_lock_acquire();
+	for (link = &zipmap_cache; (map = *link) != 0; link = &map->next) {
+		if (map->pathtype == pathtype && map->pathindex == pathindex && strcmp(map->zip, zipfile) == 0) {
+			*link = map->next;
+
+			if (map->size == size && map->mtime == mtime) {
+				/* found, move it to the front */
+				map->next = zipmap_cache;
+				zipmap_cache = map;
+				map->refcount++;
+				zipmap_lock_release();
+				return map;
+			}
+
+			/* the zip changed on disk, drop the map once it's unused */
+			map->cached = 0;
+			if (!map->refcount)
+				zipmap_free(map);
+			break;
+		}
+	}
+	zipmap_lock_release();
+
+	/* not found, map and parse it outside of the lock */
+	map = (ZIPMAP*)calloc(1, sizeof(ZIPMAP));
+	if (!map)
+		return 0;
+
+	map->zip = (char*)malloc(strlen(zipfile)+1);
+	if (!map->zip) {
+		free(map);
+		return 0;
+	}
+	strcpy(map->zip, zipfile);
+	map->pathtype = pathtype;
+	map->pathindex = pathindex;
+	map->size = size;
+	map->mtime = mtime;
+
+	map->base = (const UINT8*)osd_map_file(pathtype, pathindex, zipfile, &map->length);
+	if (!map->base || zipmap_parse(map) != 0) {
+		zipmap_free(map);
+		return 0;
+	}
+
+	/* if another thread mapped the same zip meanwhile, its map just ages out */
+	zipmap_lock_acquire();
+	map->refcount = 1;
+	map->cached = 1;
+	map->next = zipmap_cache;
+	zipmap_cache = map;
+	zipmap_trim();
+	zipmap_lock_release();
+
+	return map;
+}
+
+/* Releases a map returned by zipmap_open */
+void zipmap_close(ZIPMAP* map) {
+	int unused;
+
+	zipmap_lock_acquire();
+	unused = --map->refcount == 0 && !map->cached;
+	if (map->cached)
+		zipmap_trim();
+	zipmap_lock_release();
+
+	if (unused)
+		zipmap_free(map);
+}
+
+/* Drop all maps, the ones still in use are freed by their last zipmap_close */
+static void zipmap_cache_clear(void) {
+	ZIPMAP* map;
+
+	zipmap_lock_acquire();
+	while ((map = zipmap_cache) != 0) {
+		zipmap_cache = map->next;
+		map->cached = 0;
+		if (!map->refcount)
+			zipmap_free(map);
+	}
+	zipmap_lock_release();
+}
+
+/* Finds a member by name, the directory in the zip and case are ignored */
+const struct zipent* zipmap_find(ZIPMAP* map, const char* filename) {
+	unsigned slot = zipmap_hash_name(filename) & map->hash_mask;
+
+	while (map->hash[slot]) {
+		const struct zipent* ent = &map->ent[map->hash[slot] - 1];
+		if (equal_filename(ent->name, filename))
+			return ent;
+		slot = (slot + 1) & map->hash_mask;
+	}
+	return 0;
+}
+
+/* Finds a member by CRC */
+const struct zipent* zipmap_find_crc(ZIPMAP* map, UINT32 crc) {
+	unsigned i;
+
+	if (crc)
+		for (i = 0; i < map->entries; i++)
+			if (map->ent[i].crc32 == crc)
+				return &map->ent[i];
+	return 0;
+}
+
+/* Returns the data of a stored member inside the mapping, NULL if the
+   member is compressed or can't be read */
+const UINT8* zipmap_stored(ZIPMAP* map, const struct zipent* ent) {
+	if (ent->compression_method != 0x0000 || ent->compressed_size != ent->uncompressed_size)
+		return 0;
+	return map->data[ent - map->ent];
+}
+
+/* Inflate a member from memory
+   return:
+	==0 ok
+*/
+static int inflate_memory(const UINT8* in_data, unsigned in_size, unsigned char* out_data, unsigned out_size)
+{
+	int err;
+	z_stream d_stream; /* decompression stream */
+
+	memset(&d_stream, 0, sizeof(d_stream));
+	d_stream.next_in = (Bytef*)in_data;
+	d_stream.avail_in = in_size;
+	d_stream.next_out = out_data;
+	d_stream.avail_out = out_size;
+
+	err = inflateInit2(&d_stream, -MAX_WBITS);
+	if (err != Z_OK)
+	{
+		logerror("inflateInit error: %d\n", err);
+		return -1;
+	}
+
+	/* all of the input is available, so one call inflates the whole member */
+	err = inflate(&d_stream, Z_FINISH);
+	inflateEnd(&d_stream);
+	if (err != Z_STREAM_END)
+	{
+		logerror("inflate error: %d\n", err);
+		return -1;
+	}
+
+	if (d_stream.avail_out > 0)
+	{
+		logerror("zip size mismatch. %i\n", d_stream.avail_out);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* Read decompressed data of a member
+   return:
+	==0 success
+	<0 error
+*/
+int zipmap_read(ZIPMAP* map, const struct zipent* ent, UINT8* data) {
+	const UINT8* in_data = map->data[ent - map->ent];
+
+	if (!in_data) {
+		errormsg ("Reading header", ERROR_CORRUPT, map->zip);
+		return -1;
+	}
+
+	if (ent->compression_method == 0x0000) {
+		/* file is not compressed, simply stored */
+
+		/* check if size are equal */
+		if (ent->compressed_size != ent->uncompressed_size) {
+			errormsg("Wrong uncompressed size in store compression", ERROR_CORRUPT, map->zip);
+			return -3;
+		}
+
+		memcpy(data, in_data, ent->uncompressed_size);
+		return 0;
+	} else if (ent->compression_method == 0x0008) {
+		/* file is compressed using "Deflate" method */
+		if (ent->version_needed_to_extract > 0x14) {
+			errormsg("Version too new", ERROR_UNSUPPORTED, map->zip);
+			return -2;
+		}
+
+		if (ent->os_needed_to_extract != 0x00) {
+			errormsg("OS not supported", ERROR_UNSUPPORTED, map->zip);
+			return -2;
+		}
+
+		if (ent->disk_number_start != map->number_of_this_disk) {
+			errormsg("Cannot span disks", ERROR_UNSUPPORTED, map->zip);
+			return -2;
+		}
+
+		if (inflate_memory(in_data, ent->compressed_size, data, ent->uncompressed_size)) {
+			errormsg("Inflating compressed data", ERROR_CORRUPT, map->zip);
+			return -3;
+		}
+
+		return 0;
+	} else {
+		errormsg("Compression method unsupported", ERROR_UNSUPPORTED, map->zip);
+		return -2;
+	}
+}
+
 /* -------------------------------------------------------------------------
    Zip cache support
  ------------------------------------------------------------------------- */
@@ -728,6 +1147,8 @@ void unzip_cache_clear()
 {
 	unsigned i;
 
+	zipmap_cache_clear();
+
 	/* search in the cache buffer for any zip info and clear it */
 	for(i=0;i<ZIP_CACHE_MAX;++i) {
 		if (zip_cache_map[i] != NULL) {
@@ -750,7 +1171,7 @@ void unzip_cache_clear()
 #define cache_closezip(a) closezip(a)
 #define cache_suspendzip(a) closezip(a)
 
-#define unzip_cache_clear()
+#define unzip_cache_clear() zipmap_cache_clear()
 
 #endif
 
@@ -782,8 +1203,42 @@ static int equal_filename(const char* zipfile, const char* file) {
    length will be set to the length of the uncompressed data. */
 int /* error */ load_zipped_file (int pathtype, int pathindex, const char* zipfile, const char* filename, unsigned char** buf, unsigned int* length) {
 	ZIP* zip;
+	ZIPMAP* map;
 	struct zipent* ent;
 
+	/* a mapped zip is searched by hash and read straight from the mapping */
+	map = zipmap_open(pathtype, pathindex, zipfile);
+	if (map) {
+		const struct zipent* mapent = zipmap_find(map, filename);
+
+		/* NS981003: support for "load by CRC" */
+		if (!mapent && strlen(filename) == 8 && strspn(filename, "0123456789abcdef") == 8)
+			mapent = zipmap_find_crc(map, (UINT32)strtoul(filename, NULL, 16));
+
+		if (!mapent) {
+			zipmap_close(map);
+			return -1;
+		}
+
+		*length = mapent->uncompressed_size;
+		*buf = (unsigned char*)malloc( *length );
+		if (!*buf) {
+			if (!gUnzipQuiet)
+				printf("load_zipped_file(): Unable to allocate %d bytes of RAM\n",*length);
+			zipmap_close(map);
+			return -1;
+		}
+
+		if (zipmap_read(map, mapent, *buf)!=0) {
+			free(*buf);
+			zipmap_close(map);
+			return -1;
+		}
+
+		zipmap_close(map);
+		return 0;
+	}
+
 	zip = cache_openzip(pathtype, pathindex, zipfile);
 	if (!zip)
 		return -1;
@@ -827,8 +1282,26 @@ int /* error */ load_zipped_file (int pathtype, int pathindex, const char* zipfi
 /*  The caller can preset sum to the expected checksum to enable "load by CRC" */
 int /* error */ checksum_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename, unsigned int *length, unsigned int *sum) {
 	ZIP* zip;
+	ZIPMAP* map;
 	struct zipent* ent;
 
+	map = zipmap_open(pathtype, pathindex, zipfile);
+	if (map) {
+		const struct zipent* mapent = zipmap_find(map, filename);
+
+		/* NS981003: support for "load by CRC" */
+		if (!mapent && *sum)
+			mapent = zipmap_find_crc(map, *sum);
+
+		if (mapent) {
+			*length = mapent->uncompressed_size;
+			*sum = mapent->crc32;
+		}
+
+		zipmap_close(map);
+		return mapent ? 0 : -1;
+	}
+
 	zip = cache_openzip(pathtype, pathindex, zipfile);
 	if (!zip)
 		return -1;
@@ -102,6 +102,16 @@ void suspendzip(ZIP* zip);
 */
 void rewindzip(ZIP* zip);
 
+/* Seek to the compressed data of an entry, reopening a suspended zip
+   in:
+     zip zip stream open or suspended
+     ent entry to seek to
+   return:
+     ==0 success
+     <0 error
+*/
+int seekcompresszip(ZIP* zip, struct zipent* ent);
+
 /* Read compressed data from a zip entry
    in:
      zip opened zip
@@ -126,6 +136,50 @@ int readcompresszip(ZIP* zip, struct zipent* ent, char* data);
 */
 int readuncompresszip(ZIP* zip, struct zipent* ent, char* data);
 
+/***************************************************************************
+ * Zipfiles mapped into memory
+ *
+ * The central directory is parsed once into a hash of member names, and
+ * members are read straight from the mapping. Mapped zips are cached and
+ * reference counted; lookups and reads don't modify the map, so any number
+ * of threads can share one.
+ ***************************************************************************/
+
+typedef struct _ZIPMAP ZIPMAP;
+
+/* Maps a zip, or returns the cached map of it
+   return:
+     !=0 success, release with zipmap_close
+     ==0 error, or the file can't be mapped
+*/
+ZIPMAP* zipmap_open(int pathtype, int pathindex, const char* zipfile);
+
+/* Releases a map returned by zipmap_open */
+void zipmap_close(ZIPMAP* map);
+
+/* Finds a member by name, the directory in the zip and case are ignored
+   return:
+     !=0 entry, valid until zipmap_close
+     ==0 not found
+*/
+const struct zipent* zipmap_find(ZIPMAP* map, const char* filename);
+
+/* Finds a member by CRC */
+const struct zipent* zipmap_find_crc(ZIPMAP* map, UINT32 crc);
+
+/* Returns the data of a stored member inside the mapping, NULL if the
+   member is compressed or can't be read */
+const UINT8* zipmap_stored(ZIPMAP* map, const struct zipent* ent);
+
+/* Read decompressed data of a member
+   out:
+     data buffer for data, ent.uncompressed_size UINT8s allocated by the caller
+   return:
+     ==0 success
+     <0 error
+*/
+int zipmap_read(ZIPMAP* map, const struct zipent* ent, UINT8* data);
+
 /* public functions */
 int /* error */ load_zipped_file (int pathtype, int pathindex, const char *zipfile, const char *filename,
 	unsigned char **buf, unsigned int *length);
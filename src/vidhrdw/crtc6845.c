@@ -15,6 +15,7 @@
 
 **********************************************************************/
 #include "driver.h"
+#include "state.h"
 #include "crtc6845.h"
 
 #ifdef VERBOSE
@@ -48,6 +49,12 @@ static CRTC6845 crtc6845[MAX_6845];
 void crtc6845_init(int chipnum)
 {
 	memset(&crtc6845[chipnum],0,sizeof(CRTC6845));
+	if (!state_save_module_registered("crtc6845"))
+	{
+		int i;
+		for (i = 0; i < MAX_6845; i++)
+			state_save_register_item("crtc6845", i, crtc6845[i]);
+	}
 }
 
 READ_HANDLER( crtc6845_register_r )
@@ -276,6 +276,13 @@ struct rc_option core_opts[] = {
         { "skip_disclaimer", NULL, rc_bool, &options.skip_disclaimer, "0", 0, 0, NULL, "skip displaying the disclaimer screen" },
         { "skip_gameinfo", NULL, rc_bool, &options.skip_gameinfo, "0", 0, 0, NULL, "skip displaying the game info screen" },
         { "crconly", NULL, rc_bool, &options.crc_only, "0", 0, 0, NULL, "use only CRC for all integrity checks" },
+        { "fullverify", NULL, rc_bool, &options.full_verify, "0", 0, 0, NULL, "ignore the ROM verification cache and rehash every file" },
+        { "nvramautosave", NULL, rc_int, &options.nvram_autosave, "0", 0, 3600000, NULL, "save changed NVRAM in the background every n ms (0 = on exit only)" },
+        { "autointerleave", NULL, rc_bool, &options.autointerleave, "0", 0, 0, NULL, "adapt the CPU interleave to the measured cross-CPU traffic" },
+        { "pcprofile", NULL, rc_int, &options.pcprofile, "0", 0, 100000000, NULL, "sample the CPU PCs every n cycles (0 = off)" },
+        { "pcprofile_file", NULL, rc_string, &options.pcprofile_file, "pcprofile.txt", 0, 0, NULL, "folded stacks file the PC profile is written to" },
+        { "memtrace", NULL, rc_string, &options.memtrace_file, NULL, 0, 0, NULL, "write a gzip'ed trace of the memory accesses to this file" },
+        { "memtrace_filter", NULL, rc_string, &options.memtrace_filter, NULL, 0, 0, NULL, "accesses to trace: io, [cpu:]start-end, [cpu:]hNN (hex)" },
         { "bios", NULL, rc_string, &options.bios, "default", 0, 14, NULL, "change system bios" },
         { "at91jit", NULL, rc_int, &options.at91jit, "1", 0, 33554432, NULL, "at91 CPU JIT compiler enabled" },
 
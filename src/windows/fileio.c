@@ -450,6 +450,115 @@ int osd_get_path_info(int pathtype, int pathindex, const char *filename)
 
 
 
+//============================================================
+//	osd_get_file_stamp
+//============================================================
+
+int osd_get_file_stamp(int pathtype, int pathindex, const char *filename, UINT64 *size, INT64 *mtime)
+{
+	TCHAR fullpath[1024];
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+	if (!GetFileAttributesEx(fullpath, GetFileExInfoStandard, &data) || (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		return -1;
+
+	*size = ((UINT64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	*mtime = (INT64)(((UINT64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime);
+	return 0;
+}
+
+
+
+//============================================================
+//	osd_map_file
+//============================================================
+
+const void *osd_map_file(int pathtype, int pathindex, const char *filename, UINT64 *size)
+{
+	TCHAR fullpath[1024];
+	HANDLE handle, mapping;
+	LARGE_INTEGER length;
+	const void *base = NULL;
+
+	/* compose the full path */
+	compose_path(fullpath, pathtype, pathindex, filename);
+
+	handle = CreateFile(fullpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	/* empty files can't be mapped; the view keeps the mapping alive once the handles are closed */
+	if (GetFileSizeEx(handle, &length) && length.QuadPart > 0)
+	{
+		mapping = CreateFileMapping(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping)
+		{
+			base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(handle);
+
+	if (base)
+		*size = length.QuadPart;
+	return base;
+}
+
+
+
+//============================================================
+//	osd_unmap_file
+//============================================================
+
+void osd_unmap_file(const void *base, UINT64 size)
+{
+	UnmapViewOfFile(base);
+}
+
+
+
+//============================================================
+//	osd_replace_file
+//============================================================
+
+int osd_replace_file(int pathtype, int pathindex, const char *filename, const void *data, UINT32 length)
+{
+	TCHAR fullpath[1024], temppath[1024 + 4];
+	HANDLE handle;
+	DWORD written = 0;
+	BOOL ok;
+
+	/* compose the full path, and the temporary next to it */
+	compose_path(fullpath, pathtype, pathindex, filename);
+	_tcscpy(temppath, fullpath);
+	_tcscat(temppath, TEXT(".tmp"));
+
+	handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE && GetLastError() == ERROR_PATH_NOT_FOUND)
+	{
+		create_path(temppath, 1);
+		handle = CreateFile(temppath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	}
+	if (handle == INVALID_HANDLE_VALUE)
+		return 1;
+
+	ok = WriteFile(handle, data, length, &written, NULL) && written == length && FlushFileBuffers(handle);
+	CloseHandle(handle);
+
+	/* only replace the old file once the new one is complete on disk */
+	if (!ok || !MoveFileEx(temppath, fullpath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		DeleteFile(temppath);
+		return 1;
+	}
+	return 0;
+}
+
+
+
 //============================================================
 //	osd_fopen
 //============================================================
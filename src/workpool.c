@@ -0,0 +1,137 @@
+/*********************************************************************
+
+	workpool.c
+
+	Minimal worker pool for splitting startup work (ROM loading and
+	the like) across the available cores.
+
+*********************************************************************/
+
+#include "workpool.h"
+#include <stdlib.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct workpool_batch
+{
+	workpool_job job;
+	void *param;
+	int count;
+#if defined(_WIN32) || defined(_WIN64)
+	volatile LONG next;			/* next job index to hand out */
+#else
+	volatile int next;
+#endif
+};
+
+
+static int workpool_cpu_count(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	return (int)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+	return 1;
+#endif
+}
+
+
+static int workpool_next(struct workpool_batch *batch)
+{
+#if defined(_WIN32) || defined(_WIN64)
+	return (int)InterlockedIncrement(&batch->next) - 1;
+#else
+	return __sync_fetch_and_add(&batch->next, 1);
+#endif
+}
+
+
+static void workpool_drain(struct workpool_batch *batch)
+{
+	int index;
+	while ((index = workpool_next(batch)) < batch->count)
+		batch->job(batch->param, index);
+}
+
+
+#if defined(_WIN32) || defined(_WIN64)
+static unsigned __stdcall workpool_thread(void *param)
+{
+	workpool_drain((struct workpool_batch *)param);
+	return 0;
+}
+#else
+static void *workpool_thread(void *param)
+{
+	workpool_drain((struct workpool_batch *)param);
+	return NULL;
+}
+#endif
+
+
+int workpool_threads(int count)
+{
+	int threads = workpool_cpu_count();
+	if (threads > WORKPOOL_MAX_THREADS)
+		threads = WORKPOOL_MAX_THREADS;
+	if (threads > count)
+		threads = count;
+	return (threads < 1) ? 1 : threads;
+}
+
+
+void workpool_run(int count, workpool_job job, void *param)
+{
+	struct workpool_batch batch;
+	int threads = workpool_threads(count);
+	int started = 0;
+	int i;
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE handles[WORKPOOL_MAX_THREADS - 1];
+#else
+	pthread_t handles[WORKPOOL_MAX_THREADS - 1];
+#endif
+
+	batch.job = job;
+	batch.param = param;
+	batch.count = count;
+	batch.next = 0;
+
+	/* the calling thread is one of the workers; if a thread can't be
+	   started the others simply pick up its share */
+	for (i = 0; i < threads - 1; i++)
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		handles[started] = (HANDLE)_beginthreadex(NULL, 0, workpool_thread, &batch, 0, NULL);
+		if (handles[started])
+			started++;
+#else
+		if (pthread_create(&handles[started], NULL, workpool_thread, &batch) == 0)
+			started++;
+#endif
+	}
+
+	workpool_drain(&batch);
+
+	for (i = 0; i < started; i++)
+	{
+#if defined(_WIN32) || defined(_WIN64)
+		WaitForSingleObject(handles[i], INFINITE);
+		CloseHandle(handles[i]);
+#else
+		pthread_join(handles[i], NULL);
+#endif
+	}
+}
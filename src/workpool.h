@@ -0,0 +1,32 @@
+#ifndef __WORKPOOL_H
+#define __WORKPOOL_H
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************************************************************
+ * Runs a batch of independent jobs on short-lived worker threads
+ ***************************************************************************/
+
+#define WORKPOOL_MAX_THREADS	8
+
+typedef void (*workpool_job)(void *param, int index);
+
+/* number of threads workpool_run() would use for count jobs (1 = inline) */
+int workpool_threads(int count);
+
+/* call job(param, index) for every index in [0, count) and return once all
+   of them are done. Jobs are handed out in index order to whichever thread
+   is free, so put the most expensive ones first. Jobs must not touch state
+   shared with each other or with the emulation */
+void workpool_run(int count, workpool_job job, void *param);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
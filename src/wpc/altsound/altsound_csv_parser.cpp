@@ -46,160 +46,199 @@ bool AltsoundCsvParser::parse(std::vector<AltsoundSampleInfo>& samples_out)
 	// skip header row
 	std::getline(file, line);
 
+	std::vector<std::string> lines;
+	while (std::getline(file, line)) {
+		lines.push_back(std::move(line));
+	}
+
+	// Rows are independent, so parse them on the worker pool and report the
+	// results in file order afterwards
+	std::vector<ParsedRow> rows(lines.size());
+	parallel_for(lines.size(), 256, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			parseRow(std::move(lines[i]), rows[i]);
+		}
+	});
+
 	bool success = true;
+	samples_out.reserve(samples_out.size() + rows.size());
 
-	try {
-		while (std::getline(file, line)) {
-			if (line.empty()) {
-				// ignore blank lines
-				continue;
-			}
+	for (const ParsedRow& row : rows) {
+		if (row.blank) {
+			continue;
+		}
 
-			// Some Altsounds use quotes around fields.  These need to be removed.
-			line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+		if (!row.warning.empty()) {
+			ALT_WARNING(1, "%s", row.warning.c_str());
+		}
 
-			std::stringstream ss(line);
-			std::string field;
-			AltsoundSampleInfo entry;
+		if (row.failed) {
+			success = false;
+		}
 
-			// Assume the fields are in the following order:
-			// ID, CHANNEL, DUCK, GAIN, LOOP, STOP, NAME, FNAME
+		if (!row.error.empty()) {
+			ALT_ERROR(0, "%s", row.error.c_str());
+			break;
+		}
 
-			// ID
-			if (std::getline(ss, field, ',')) {
-				entry.id = std::stoul(trim(field), nullptr, 16);
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample ID value");
-				success = false;
-				entry.id = 0;  // assign some default value
-				break;
-			}
+		const AltsoundSampleInfo& entry = row.entry;
+		samples_out.emplace_back(entry);
 
-			// CHANNEL
-			if (std::getline(ss, field, ',')) {
-				std::string trimmed = trim(field);
+		std::ostringstream debug_stream;
+		debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << entry.id << std::dec
+					 << ", CHANNEL = " << entry.channel
+					 << ", DUCKING = " << std::fixed << std::setprecision(2) << entry.ducking
+					 << ", GAIN = " << std::fixed << std::setprecision(2) << entry.gain
+					 << ", LOOP = " << entry.loop
+					 << ", NAME = " << entry.name
+					 << ", FNAME = " << entry.fname;
 
-				if (trimmed.empty()) {
-					entry.channel = -1;
-				}
-				else {
-					int val = std::stoi(trimmed);
-					if (val == 0 || val == 1 || val == -1) {
-						entry.channel = val;
-					}
-					else {
-						ALT_WARNING(1, "Invalid sample CHANNEL value: %d", val);
-						entry.channel = -1;  // assign some default value
-					}
-				}
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample CHANNEL value");
-				success = false;
-				entry.channel = -1;  // assign some default value
-				break;
-			}
+		ALT_DEBUG(0, debug_stream.str().c_str());
+	}
 
-			// DUCK
-			if (std::getline(ss, field, ',')) {
-				float val = std::stof(trim(field));
-				entry.ducking = entry.channel == 0 ? 100.0f : val < 0.0f ? -1.0f : val > 100.0f ? 1.0f : val / 100.0f;
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample DUCK value");
-				success = false;
-				entry.ducking = 0.0f;  // assign some default value
-				break;
-			}
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundCsvParser::parse()");
+	return success;
+}
 
-			// GAIN
-			if (std::getline(ss, field, ',')) {
-				float val = std::stof(trim(field));
-				entry.gain = val < 0.0f ? 0.0f : val > 100.0f ? 1.0f : val / 100.0f;
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample GAIN value");
-				success = false;
-				entry.gain = 0.0f;  // assign some default value
-				break;
-			}
+// ----------------------------------------------------------------------------
 
-			// LOOP
-			if (std::getline(ss, field, ',')) {
-				entry.loop = std::stoul(trim(field)) == 100;
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample LOOP value");
-				success = false;
-				entry.loop = false;  // assign some default value
-				break;
-			}
+void AltsoundCsvParser::parseRow(std::string line, ParsedRow& row_out) const
+{
+	if (line.empty()) {
+		// ignore blank lines
+		row_out.blank = true;
+		return;
+	}
 
-			// STOP
-			if (std::getline(ss, field, ',')) {
-				entry.stop = std::stoul(trim(field)) == 1;
-			}
-			else {
-				ALT_ERROR(0, "Failed to parse sample STOP value");
-				success = false;
-				entry.stop = false;  // assign some default value
-				break;
-			}
+	// Some Altsounds use quotes around fields.  These need to be removed.
+	line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+
+	std::stringstream ss(line);
+	std::string field;
+	AltsoundSampleInfo& entry = row_out.entry;
+
+	try {
+		// Assume the fields are in the following order:
+		// ID, CHANNEL, DUCK, GAIN, LOOP, STOP, NAME, FNAME
+
+		// ID
+		if (std::getline(ss, field, ',')) {
+			entry.id = std::stoul(trim(field), nullptr, 16);
+		}
+		else {
+			row_out.error = "Failed to parse sample ID value";
+			row_out.failed = true;
+			entry.id = 0;  // assign some default value
+			return;
+		}
+
+		// CHANNEL
+		if (std::getline(ss, field, ',')) {
+			std::string trimmed = trim(field);
 
-			// NAME
-			if (std::getline(ss, field, ',')) {
-				entry.name = toLowerCase(trim(field));
+			if (trimmed.empty()) {
+				entry.channel = -1;
 			}
 			else {
-				success = false;
-				entry.name.clear();  // assign some default value
+				int val = std::stoi(trimmed);
+				if (val == 0 || val == 1 || val == -1) {
+					entry.channel = val;
+				}
+				else {
+					row_out.warning = "Invalid sample CHANNEL value: " + std::to_string(val);
+					entry.channel = -1;  // assign some default value
+				}
 			}
+		}
+		else {
+			row_out.error = "Failed to parse sample CHANNEL value";
+			row_out.failed = true;
+			entry.channel = -1;  // assign some default value
+			return;
+		}
 
-			// FNAME
-			if (std::getline(ss, field, ',')) {
-				field = trim(field);
+		// DUCK
+		if (std::getline(ss, field, ',')) {
+			float val = std::stof(trim(field));
+			entry.ducking = entry.channel == 0 ? 100.0f : val < 0.0f ? -1.0f : val > 100.0f ? 1.0f : val / 100.0f;
+		}
+		else {
+			row_out.error = "Failed to parse sample DUCK value";
+			row_out.failed = true;
+			entry.ducking = 0.0f;  // assign some default value
+			return;
+		}
 
-				if (field.empty()) {
-					ALT_ERROR(1, "Sample filename is blank");
-					success = false;
-					entry.fname.clear();  // assign some default value
-					break;
-				}
+		// GAIN
+		if (std::getline(ss, field, ',')) {
+			float val = std::stof(trim(field));
+			entry.gain = val < 0.0f ? 0.0f : val > 100.0f ? 1.0f : val / 100.0f;
+		}
+		else {
+			row_out.error = "Failed to parse sample GAIN value";
+			row_out.failed = true;
+			entry.gain = 0.0f;  // assign some default value
+			return;
+		}
 
-				std::string full_path = altsound_path + '/' + field;
+		// LOOP
+		if (std::getline(ss, field, ',')) {
+			entry.loop = std::stoul(trim(field)) == 100;
+		}
+		else {
+			row_out.error = "Failed to parse sample LOOP value";
+			row_out.failed = true;
+			entry.loop = false;  // assign some default value
+			return;
+		}
 
-				// Normalize to forward slashes
-				std::replace(full_path.begin(), full_path.end(), '\\', '/');
-				entry.fname = full_path;
-			}
-			else {
-				ALT_ERROR(1, "Failed to parse FNAME");
-				success = false;
+		// STOP
+		if (std::getline(ss, field, ',')) {
+			entry.stop = std::stoul(trim(field)) == 1;
+		}
+		else {
+			row_out.error = "Failed to parse sample STOP value";
+			row_out.failed = true;
+			entry.stop = false;  // assign some default value
+			return;
+		}
+
+		// NAME
+		if (std::getline(ss, field, ',')) {
+			entry.name = toLowerCase(trim(field));
+		}
+		else {
+			row_out.failed = true;
+			entry.name.clear();  // assign some default value
+		}
+
+		// FNAME
+		if (std::getline(ss, field, ',')) {
+			field = trim(field);
+
+			if (field.empty()) {
+				row_out.error = "Sample filename is blank";
+				row_out.failed = true;
 				entry.fname.clear();  // assign some default value
-				break;
+				return;
 			}
 
-			samples_out.emplace_back(entry);
+			std::string full_path = altsound_path + '/' + field;
 
-			std::ostringstream debug_stream;
-			debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << entry.id << std::dec
-						 << ", CHANNEL = " << entry.channel
-						 << ", DUCKING = " << std::fixed << std::setprecision(2) << entry.ducking
-						 << ", GAIN = " << std::fixed << std::setprecision(2) << entry.gain
-						 << ", LOOP = " << entry.loop
-						 << ", NAME = " << entry.name
-						 << ", FNAME = " << entry.fname;
-
-			ALT_DEBUG(0, debug_stream.str().c_str());
+			// Normalize to forward slashes
+			std::replace(full_path.begin(), full_path.end(), '\\', '/');
+			entry.fname = full_path;
+		}
+		else {
+			row_out.error = "Failed to parse FNAME";
+			row_out.failed = true;
+			entry.fname.clear();  // assign some default value
+			return;
 		}
 	}
 	catch (std::exception& e) { // catch by reference
-		ALT_ERROR(0, "AltsoundCsvParser::parse(): %s", e.what());
-		success = false;
+		row_out.error = std::string("AltsoundCsvParser::parse(): ") + e.what();
+		row_out.failed = true;
 	}
-
-	OUTDENT;
-	ALT_DEBUG(0, "END AltsoundCsvParser::parse()");
-	return success;
 }
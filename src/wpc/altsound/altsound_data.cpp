@@ -15,10 +15,12 @@
 #include <cctype>
 #include <map>
 #include <algorithm>
+#include <sys/stat.h>
 
 // Local includes
 #include "../../ext/bass/bass.h"
 #include "altsound_logger.hpp"
+#include "workpool.h"
 
 // namespace resolution
 using std::string;
@@ -232,3 +234,32 @@ std::string toLowerCase(const std::string& str)
 	std::transform(str.begin(), str.end(), std::back_inserter(lowerCaseStr), ::tolower);
 	return lowerCaseStr;
 }
+
+// ----------------------------------------------------------------------------
+// Helper function to spread independent work items over a pool of threads
+// ----------------------------------------------------------------------------
+
+struct ParallelForBatches
+{
+	size_t count;
+	size_t batch;
+	const std::function<void(size_t, size_t)>* fn;
+};
+
+static void parallel_for_job(void* param, int index)
+{
+	const ParallelForBatches& batches = *static_cast<const ParallelForBatches*>(param);
+	const size_t begin = (size_t)index * batches.batch;
+	(*batches.fn)(begin, std::min(batches.count, begin + batches.batch));
+}
+
+void parallel_for(size_t count, size_t batch, const std::function<void(size_t, size_t)>& fn)
+{
+	if (batch == 0)
+		batch = 1;
+
+	// the core's worker pool hands the batches out on demand, so slow items
+	// (cold files) don't leave the other workers idle
+	ParallelForBatches batches = { count, batch, &fn };
+	workpool_run((int)((count + batch - 1) / batch), parallel_for_job, &batches);
+}
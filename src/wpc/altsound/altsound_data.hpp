@@ -24,7 +24,9 @@
 // Std Library includes
 #include <array>
 #include <bitset>
+#include <functional>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -35,6 +37,16 @@
 // Global Data Structures
 // ----------------------------------------------------------------------------
 
+enum AltsoundSampleType {
+	UNDEFINED = 0,
+	MUSIC,
+	JINGLE,
+	SFX,
+	CALLOUT,
+	SOLO,
+	OVERLAY
+};
+
 struct _stream_info;  // forward declaration for clarity
 typedef _stream_info AltsoundStreamInfo;
 typedef std::array<AltsoundStreamInfo*, ALT_MAX_CHANNELS> StreamArray;
@@ -53,16 +65,6 @@ struct _stream_info {
 	float gain = 1.0f;
 };
 
-enum AltsoundSampleType {
-	UNDEFINED = 0,
-	MUSIC,
-	JINGLE,
-	SFX,
-	CALLOUT,
-	SOLO,
-	OVERLAY
-};
-
 // Structure for storing G-Sound ducking profiles
 typedef struct _ducking_profile {
 	float music_duck_vol = 1.0f;
@@ -144,4 +146,8 @@ std::string trim(const std::string& str);
 // convert string to lowercase
 std::string toLowerCase(const std::string& str);
 
+// run fn(begin, end) over [0, count) in batches of 'batch' items on a pool of
+// worker threads.  fn must not log: AltsoundLogger is not thread-safe
+void parallel_for(size_t count, size_t batch, const std::function<void(size_t, size_t)>& fn);
+
 #endif // ALTSOUND_DATA_H
@@ -11,6 +11,7 @@
 
 // Standard Library includes
 #include <iomanip>
+#include <stdexcept>
 
 // local includes
 #include <dirent.h>
@@ -18,6 +19,59 @@
 
 extern AltsoundLogger alog;
 
+// ---------------------------------------------------------------------------
+// Helper functions
+// ---------------------------------------------------------------------------
+
+// List the entries of a directory.  The Windows dirent shim keeps static state
+// and changes the working directory, so it can't be used from worker threads
+static bool list_directory(const std::string& path, std::vector<std::string>& names_out)
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAA find_data;
+	const HANDLE handle = FindFirstFileA((path + "/*").c_str(), &find_data);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	do {
+		names_out.push_back(find_data.cFileName);
+	} while (FindNextFileA(handle, &find_data));
+	FindClose(handle);
+#else
+	DIR* const dir = opendir(path.c_str());
+	if (!dir)
+		return false;
+
+	while (const struct dirent* const entry = readdir(dir))
+		names_out.push_back(entry->d_name);
+	closedir(dir);
+#endif
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// PinSound packs hold system and settings files next to the sample folders
+static bool is_sample_entry(const std::string& name)
+{
+	return !name.empty() && name[0] != '.'
+		&& name.find(".txt") == std::string::npos
+		&& name.find(".ini") == std::string::npos;
+}
+
+// ---------------------------------------------------------------------------
+
+// One <instruction>-name folder, scanned on a worker thread
+struct InstructionDir {
+	int type;               // index into the sample type folders
+	std::string path;
+	float gain;
+	float ducking;
+	bool opened = false;
+	std::string error;
+	std::vector<AltsoundSampleInfo> samples;
+};
+
 // ---------------------------------------------------------------------------
 // CTOR/DTOR
 // ---------------------------------------------------------------------------
@@ -74,15 +128,17 @@ bool AltsoundFileParser::parse(std::vector<AltsoundSampleInfo>& samples_out)
 	const std::string path_sfx = "sfx/";
 	const std::string path_single = "single/";
 	const std::string path_voice = "voice/";
+	const std::string* const subpaths[5] = { &path_jingle, &path_music, &path_sfx, &path_single, &path_voice };
+
+	// Collect the instruction folders of every sample type.  This only reads
+	// the five type folders, the bulk of the work is done by the worker pool
+	std::vector<InstructionDir> dirs;
 
 	for (int i = 0; i < 5; ++i) {
 		float default_gain = .1f;
 		float default_ducking = 1.f; //!! default depends on type??
 
-		const std::string subpath = (i == 0) ? path_jingle :
-			((i == 1) ? path_music :
-			((i == 2) ? path_sfx :
-			((i == 3) ? path_single : path_voice)));
+		const std::string& subpath = *subpaths[i];
 
 		// Set default ducking values.  Can be overridden by ducking.txt file
 		if (subpath == path_jingle || subpath == path_single) {
@@ -95,9 +151,6 @@ bool AltsoundFileParser::parse(std::vector<AltsoundSampleInfo>& samples_out)
 			default_ducking = .65f;
 		}
 
-		DIR *dir;
-		struct dirent *entry;
-
 		std::string PATH = altsound_path + '/' + subpath;
 		ALT_INFO(0, "Current_path1: %s", PATH.c_str());
 
@@ -117,120 +170,135 @@ bool AltsoundFileParser::parse(std::vector<AltsoundSampleInfo>& samples_out)
 		}
 		}
 
-		dir = opendir(PATH.c_str());
-		if (!dir)
+		std::vector<std::string> names;
+		if (!list_directory(PATH, names))
 		{
 			// Path not found.. try the others
 			ALT_INFO(0, "Path not found: %s", PATH.c_str());
 			continue;
 		}
 
-		// parse individual sound file data
-		entry = readdir(dir);
-		while (entry != nullptr) {
-			if (entry->d_name[0] != '.'
-				&& strstr(entry->d_name, ".txt") == nullptr
-				&& strstr(entry->d_name, ".ini") == nullptr)
-			{
-				// Not a system file or txt file.  Assume it's a directory
-				// (per PinSound format requirements).  Backup the current
-				// directory stream and entry
-				const DIR backup_dir = *dir;
-				struct dirent backup_entry = *entry;
-
-				float gain = default_gain;
-				float ducking = default_ducking;
-
-				DIR *dir2;
-				struct dirent *entry2;
-
-				std::string PATH2 = PATH + entry->d_name;
-
-				// Check for overriding gain value
-				std::string PATHG = PATH2 + '/' + "gain.txt";
-				float parsedGain = parseFileValue(PATHG);
-				if (parsedGain != -1.0f) {
-					gain = parsedGain;
-				}
+		for (const std::string& name : names) {
+			// Not a system file or txt file.  Assume it's a directory
+			// (per PinSound format requirements)
+			if (is_sample_entry(name)) {
+				InstructionDir dir;
+				dir.type = i;
+				dir.path = PATH + name;
+				dir.gain = default_gain;
+				dir.ducking = default_ducking;
+				dirs.push_back(std::move(dir));
+			}
+		}
+	}
 
-				// check for overriding ducking value
-				PATHG = PATH2 + '/' + "ducking.txt";
-				float parsedDucking = parseFileValue(PATHG);
-				if (parsedDucking != -1.0f) {
-					ducking = parsedDucking;
-				}
+	// Scan the instruction folders in parallel.  Nothing is logged here, the
+	// results are reported below in directory order
+	parallel_for(dirs.size(), 4, [&](size_t begin, size_t end) {
+		for (size_t d = begin; d < end; ++d) {
+			InstructionDir& dir = dirs[d];
+			const std::string& subpath = *subpaths[dir.type];
+			const std::string& PATH2 = dir.path;
+
+			// Check for overriding gain value
+			std::string PATHG = PATH2 + '/' + "gain.txt";
+			float parsedGain = parseFileValue(PATHG);
+			if (parsedGain != -1.0f) {
+				dir.gain = parsedGain;
+			}
+
+			// check for overriding ducking value
+			PATHG = PATH2 + '/' + "ducking.txt";
+			float parsedDucking = parseFileValue(PATHG);
+			if (parsedDucking != -1.0f) {
+				dir.ducking = parsedDucking;
+			}
+
+			std::vector<std::string> names;
+			dir.opened = list_directory(PATH2, names);
 
-				dir2 = opendir(PATH2.c_str());
-				ALT_INFO(1, "opendir(%s)", PATH2.c_str());
-
-				entry2 = readdir(dir2);
-				while (entry2 != nullptr) {
-					if (entry2->d_name[0] != '.'
-						&& strstr(entry2->d_name, ".txt") == nullptr
-						&& strstr(entry2->d_name, ".ini") == nullptr)
-					{
-						//LOG(("CURRENT_ENTRY2: %s\n", entry->d_name));
-						const char* ptr = strrchr(PATH2.c_str(), '/');
-						char id[7] = { 0, 0, 0, 0, 0, 0, 0 };
-
-						AltsoundSampleInfo sample;
-
-						sample.fname = PATH2 + '/' + entry2->d_name;
-
-						memcpy(id, ptr + 1, 6);
-						sample.id = std::stoul(trim(id), nullptr);
-
-						// DAR@20230828
-						// Original code divided the gain by 20 before storing.
-						// That equates to multiplying the fractional gain below
-						// by 5.  This often results in gain values greater than
-						// 1.0f which indicates an amplified sound.  If the gain
-						// being read in is 100% (1.0f) then this value will end up
-						// being 5.0f which seems awfully high.  However, to
-						// replicate original behavior, it is being preserved below
-						sample.gain = gain * 5.0f;
-						sample.ducking = ducking;
-
-						if (subpath == path_music) {
-							sample.channel = 0;
-							sample.loop = true;
-							sample.stop = false;
-						}
-
-						if (subpath == path_jingle || subpath == path_single) {
-							sample.channel = 1;
-							sample.loop = false;
-							sample.stop = (subpath == path_single) ? true : false;
-						}
-
-						if (subpath == path_sfx || subpath == path_voice) {
-							sample.channel = -1;
-							sample.loop = false;
-							sample.stop = false;
-						}
-
-						samples_out.push_back(sample);
-
-						std::ostringstream debug_stream;
-						debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << sample.id << std::dec
-							<< ", CHANNEL = " << sample.channel
-							<< ", DUCKING = " << std::fixed << std::setprecision(2) << sample.ducking
-							<< ", GAIN = " << std::fixed << std::setprecision(2) << sample.gain
-							<< ", LOOP = " << sample.loop
-							<< ", FNAME = " << sample.fname;
-
-						ALT_DEBUG(0, debug_stream.str().c_str());
+			try {
+				for (const std::string& name : names) {
+					if (!is_sample_entry(name)) {
+						continue;
 					}
-					entry2 = readdir(dir2);
-				}
-				closedir(dir2);
 
-				*dir = backup_dir;
-				*entry = backup_entry;
+					const char* ptr = strrchr(PATH2.c_str(), '/');
+					char id[7] = { 0, 0, 0, 0, 0, 0, 0 };
+
+					AltsoundSampleInfo sample;
+
+					sample.fname = PATH2 + '/' + name;
+
+					memcpy(id, ptr + 1, 6);
+					sample.id = std::stoul(trim(id), nullptr);
+
+					// DAR@20230828
+					// Original code divided the gain by 20 before storing.
+					// That equates to multiplying the fractional gain below
+					// by 5.  This often results in gain values greater than
+					// 1.0f which indicates an amplified sound.  If the gain
+					// being read in is 100% (1.0f) then this value will end up
+					// being 5.0f which seems awfully high.  However, to
+					// replicate original behavior, it is being preserved below
+					sample.gain = dir.gain * 5.0f;
+					sample.ducking = dir.ducking;
+
+					if (subpath == path_music) {
+						sample.channel = 0;
+						sample.loop = true;
+						sample.stop = false;
+					}
+
+					if (subpath == path_jingle || subpath == path_single) {
+						sample.channel = 1;
+						sample.loop = false;
+						sample.stop = (subpath == path_single) ? true : false;
+					}
+
+					if (subpath == path_sfx || subpath == path_voice) {
+						sample.channel = -1;
+						sample.loop = false;
+						sample.stop = false;
+					}
+
+					dir.samples.push_back(sample);
+				}
 			}
-			entry = readdir(dir);
+			catch (const std::exception& e) {
+				// folder name does not start with the instruction number
+				dir.error = e.what();
+				dir.samples.clear();
+			}
+		}
+	});
+
+	for (const InstructionDir& dir : dirs) {
+		ALT_INFO(1, "opendir(%s)", dir.path.c_str());
+
+		if (!dir.opened) {
+			ALT_WARNING(1, "Unable to open sample folder: %s", dir.path.c_str());
+			continue;
+		}
+
+		if (!dir.error.empty()) {
+			ALT_ERROR(1, "Invalid sample folder name: %s (%s)", dir.path.c_str(), dir.error.c_str());
+			continue;
+		}
+
+		for (const AltsoundSampleInfo& sample : dir.samples) {
+			samples_out.push_back(sample);
+
+			std::ostringstream debug_stream;
+			debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << sample.id << std::dec
+				<< ", CHANNEL = " << sample.channel
+				<< ", DUCKING = " << std::fixed << std::setprecision(2) << sample.ducking
+				<< ", GAIN = " << std::fixed << std::setprecision(2) << sample.gain
+				<< ", LOOP = " << sample.loop
+				<< ", FNAME = " << sample.fname;
+
+			ALT_DEBUG(0, debug_stream.str().c_str());
 		}
-		closedir(dir);
 	}
 	ALT_INFO(0, "Found %d samples", samples_out.size());
 
@@ -110,6 +110,20 @@ bool AltsoundIniProcessor::parse_altsound_ini(const string& path_in)
 		return false;
 	}
 
+	// get sample bank settings
+	string sample_bank_str;
+	if (inipp::get_value(ini.sections["system"], "sample_bank", sample_bank_str)) {
+		sample_bank = (sample_bank_str == "1");
+	}
+	ALT_INFO(0, "Parsed \"sample_bank\": %s", sample_bank ? "true" : "false");
+
+	if (!parseUnsignedValue(ini.sections["system"], "bank_max_sample_kb", bank_max_sample_kb)
+	 || !parseUnsignedValue(ini.sections["system"], "cache_budget_mb", cache_budget_mb)) {
+		return false;
+	}
+	ALT_INFO(0, "Parsed \"bank_max_sample_kb\": %u", bank_max_sample_kb);
+	ALT_INFO(0, "Parsed \"cache_budget_mb\": %u", cache_budget_mb);
+
 	// get AltSound format type
 	inipp::get_value(ini.sections["format"], "format", altsound_format);
 	altsound_format = normalizeString(altsound_format);
@@ -351,6 +365,33 @@ bool AltsoundIniProcessor::parseBehaviorValue(const IniSection& section,
 	return true;
 }
 
+// ---------------------------------------------------------------------------
+// Helper function to parse unsigned values
+// ---------------------------------------------------------------------------
+
+bool AltsoundIniProcessor::parseUnsignedValue(const IniSection& section, const std::string& key, unsigned int& value)
+{
+	std::string parsed_value;
+	if (!inipp::get_value(section, key, parsed_value)) {
+		return true;
+	}
+
+	try {
+		const int val = std::stoi(parsed_value);
+		value = (unsigned int)(val < 0 ? 0 : val);
+	}
+	catch (const std::invalid_argument& e) {
+		ALT_ERROR(0, "Invalid number format while parsing %s value: %s\n", key.c_str(), parsed_value.c_str());
+		return false;
+	}
+	catch (const std::out_of_range& e) {
+		ALT_ERROR(0, "Number out of range while parsing %s value: %s\n", key.c_str(), parsed_value.c_str());
+		return false;
+	}
+
+	return true;
+}
+
 // ---------------------------------------------------------------------------
 // Helper function to parse G-Sound behavior volume values
 // ---------------------------------------------------------------------------
@@ -601,12 +642,23 @@ bool AltsoundIniProcessor::create_altsound_ini(const std::string& path_in)
 		";                     specify how many initial commands to ignore at startup.\n"
 		";                     NOTE:  If the record_sound_cmds flag is set, the skipped\n"
 		";                     commands will be included in the recording file.\n"
+		";\n"
+		"; sample_bank       : packs all samples up to bank_max_sample_kb into a single\n"
+		";                     \"altsound.bank\" file in this folder the first time the\n"
+		";                     package is used, so playback doesn't wait on the disk.\n"
+		";                     The bank is rebuilt automatically when samples change.\n"
+		";                     Larger samples (except music, which is streamed) are\n"
+		";                     kept in memory up to cache_budget_mb. Set to 0 to read\n"
+		";                     every sample from disk when played\n"
 		"; ----------------------------------------------------------------------------\n"
 		"\n"
 		"[system]\n"
 		"record_sound_cmds = 0\n"
 		"rom_volume_ctrl = 1\n"
 		"cmd_skip_count = 0\n"
+		"sample_bank = 1\n"
+		"bank_max_sample_kb = 512\n"
+		"cache_budget_mb = 64\n"
 		"\n"
 		"; ----------------------------------------------------------------------------\n"
 		"; There are three supported AltSound formats:\n"
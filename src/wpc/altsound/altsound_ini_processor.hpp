@@ -60,6 +60,11 @@ public:
 	// Return parsed skip count value
 	const unsigned int getSkipCount() const;
 
+	// Return parsed sample bank settings
+	const bool useSampleBank() const;
+	const unsigned int getBankMaxSampleKb() const;
+	const unsigned int getCacheBudgetMb() const;
+
 private: // functions
 
 	// helper function to parse behavior variable values
@@ -68,6 +73,9 @@ private: // functions
 	// helper function to parse behavior volume values
 	bool parseVolumeValue(const IniSection& section, const std::string& key, float& volume);
 
+	// helper function to parse an unsigned [system] value, keeping the default if absent
+	bool parseUnsignedValue(const IniSection& section, const std::string& key, unsigned int& value);
+
 	// helper function to parse ducking profiles
 	bool parseDuckingProfile(const IniSection& ducking_section, ProfileMap& profiles);
 
@@ -94,6 +102,9 @@ private: // data
 	bool rom_volume_control = true;
 	std::string altsound_format;
 	unsigned int skip_count = 0;
+	bool sample_bank = true;
+	unsigned int bank_max_sample_kb = 512;
+	unsigned int cache_budget_mb = 64;
 };
 
 // ----------------------------------------------------------------------------
@@ -123,4 +134,22 @@ inline const unsigned int AltsoundIniProcessor::getSkipCount() const {
 	return skip_count;
 }
 
+// ----------------------------------------------------------------------------
+
+inline const bool AltsoundIniProcessor::useSampleBank() const {
+	return sample_bank;
+}
+
+// ----------------------------------------------------------------------------
+
+inline const unsigned int AltsoundIniProcessor::getBankMaxSampleKb() const {
+	return bank_max_sample_kb;
+}
+
+// ----------------------------------------------------------------------------
+
+inline const unsigned int AltsoundIniProcessor::getCacheBudgetMb() const {
+	return cache_budget_mb;
+}
+
 #endif // ALTSOUND_INI_PROCESSOR_H
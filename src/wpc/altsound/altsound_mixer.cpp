@@ -0,0 +1,874 @@
+// ---------------------------------------------------------------------------
+// altsound_mixer.cpp
+//
+// Built-in replacement for the subset of the BASS API used by AltSound.
+// Sample files are decoded here and every playing stream is resampled and
+// mixed into a stereo PinMAME sound stream, removing the dependency on BASS
+// and on a second audio device
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#include "altsound_mixer.hpp"
+
+// Std Library includes
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#ifdef ALTSOUND_USE_VORBISFILE
+#include <vorbis/vorbisfile.h>
+#endif
+
+#ifdef __cplusplus
+  extern "C" {
+#endif
+  #include "driver.h"
+#ifdef __cplusplus
+  }
+#endif
+
+// ---------------------------------------------------------------------------
+// Constants
+// ---------------------------------------------------------------------------
+
+// number of source frames decoded per refill of a voice buffer
+#define ALT_MIXER_DECODE_FRAMES 1024
+
+// stdio buffer for samples streamed from disk, so long music tracks are read
+// ahead in large chunks instead of one small read per decode block
+#define ALT_MIXER_READ_AHEAD (256 * 1024)
+
+// sync types understood by BASS_ChannelSetSync()
+#define ALT_MIXER_SYNC_TYPE_MASK 0x00ffffff
+
+// ---------------------------------------------------------------------------
+// Sample file readers
+// ---------------------------------------------------------------------------
+
+class AltsoundReader {
+public:
+	virtual ~AltsoundReader() {}
+
+	// read up to 'bytes' bytes, returns the number of bytes read
+	virtual size_t read(void* dst, size_t bytes) = 0;
+
+	// seek to an absolute position, returns false if out of range
+	virtual bool seek(size_t pos) = 0;
+
+	virtual size_t tell() const = 0;
+	virtual size_t size() const = 0;
+};
+
+// ---------------------------------------------------------------------------
+
+class AltsoundFileReader : public AltsoundReader {
+public:
+	explicit AltsoundFileReader(FILE* f) : file(f), file_size(0), read_ahead(ALT_MIXER_READ_AHEAD) {
+		setvbuf(file, &read_ahead[0], _IOFBF, read_ahead.size());
+		fseek(file, 0, SEEK_END);
+		file_size = (size_t)ftell(file);
+		fseek(file, 0, SEEK_SET);
+	}
+	~AltsoundFileReader() { fclose(file); }
+
+	size_t read(void* dst, size_t bytes) { return fread(dst, 1, bytes, file); }
+	bool seek(size_t pos) { return pos <= file_size && fseek(file, (long)pos, SEEK_SET) == 0; }
+	size_t tell() const { return (size_t)ftell(file); }
+	size_t size() const { return file_size; }
+
+private:
+	FILE* file;
+	size_t file_size;
+	std::vector<char> read_ahead;
+};
+
+// ---------------------------------------------------------------------------
+
+class AltsoundMemoryReader : public AltsoundReader {
+public:
+	AltsoundMemoryReader(const UINT8* data_in, size_t length_in)
+	: data(data_in), length(length_in), pos(0) {}
+
+	size_t read(void* dst, size_t bytes) {
+		if (bytes > length - pos)
+			bytes = length - pos;
+		memcpy(dst, data + pos, bytes);
+		pos += bytes;
+		return bytes;
+	}
+	bool seek(size_t pos_in) {
+		if (pos_in > length)
+			return false;
+		pos = pos_in;
+		return true;
+	}
+	size_t tell() const { return pos; }
+	size_t size() const { return length; }
+
+private:
+	const UINT8* data;
+	size_t length;
+	size_t pos;
+};
+
+// ---------------------------------------------------------------------------
+// Decoders
+//
+// A decoder converts its source to interleaved stereo float frames in the
+// -1..1 range.  Mono sources are duplicated to both sides, sources with more
+// than two channels contribute their first two
+// ---------------------------------------------------------------------------
+
+class AltsoundDecoder {
+public:
+	AltsoundDecoder() : sample_rate(0) {}
+	virtual ~AltsoundDecoder() {}
+
+	// decode up to 'frames' stereo frames, returns 0 at the end of the data
+	virtual size_t decode(float* dst, size_t frames) = 0;
+
+	// restart decoding from the first frame
+	virtual bool rewind() = 0;
+
+	unsigned int sample_rate;
+};
+
+// ---------------------------------------------------------------------------
+
+class AltsoundWavDecoder : public AltsoundDecoder {
+public:
+	explicit AltsoundWavDecoder(AltsoundReader* reader_in)
+	: reader(reader_in), channels(0), bits(0), is_float(false), block_align(0),
+	  data_start(0), data_frames(0), frames_left(0) {}
+
+	// parse the RIFF header, returns a BASS_ERROR_* code
+	int open();
+
+	size_t decode(float* dst, size_t frames);
+	bool rewind();
+
+private:
+	std::unique_ptr<AltsoundReader> reader;
+	std::vector<UINT8> raw;
+	unsigned int channels;
+	unsigned int bits;
+	bool is_float;
+	unsigned int block_align;
+	size_t data_start;
+	size_t data_frames;
+	size_t frames_left;
+};
+
+// ---------------------------------------------------------------------------
+
+static UINT16 get_le16(const UINT8* p) { return (UINT16)(p[0] | (p[1] << 8)); }
+static UINT32 get_le32(const UINT8* p) { return (UINT32)p[0] | ((UINT32)p[1] << 8) | ((UINT32)p[2] << 16) | ((UINT32)p[3] << 24); }
+
+int AltsoundWavDecoder::open()
+{
+	UINT8 hdr[12];
+	if (reader->read(hdr, 12) != 12 || memcmp(hdr, "RIFF", 4) != 0 || memcmp(hdr + 8, "WAVE", 4) != 0)
+		return BASS_ERROR_FILEFORM;
+
+	bool have_fmt = false;
+	UINT16 format_tag = 0;
+	size_t data_len = 0;
+
+	for (;;) {
+		UINT8 chunk[8];
+		if (reader->read(chunk, 8) != 8)
+			return have_fmt ? BASS_ERROR_NOTAUDIO : BASS_ERROR_FILEFORM;
+
+		const UINT32 chunk_len = get_le32(chunk + 4);
+		const size_t chunk_start = reader->tell();
+
+		if (memcmp(chunk, "fmt ", 4) == 0) {
+			UINT8 fmt[40];
+			const size_t fmt_len = chunk_len < sizeof(fmt) ? chunk_len : sizeof(fmt);
+			if (fmt_len < 16 || reader->read(fmt, fmt_len) != fmt_len)
+				return BASS_ERROR_FILEFORM;
+
+			format_tag = get_le16(fmt);
+			channels = get_le16(fmt + 2);
+			sample_rate = get_le32(fmt + 4);
+			block_align = get_le16(fmt + 12);
+			bits = get_le16(fmt + 14);
+
+			// WAVE_FORMAT_EXTENSIBLE: the real format is the start of the subformat GUID
+			if (format_tag == 0xFFFE && fmt_len >= 26)
+				format_tag = get_le16(fmt + 24);
+
+			have_fmt = true;
+		}
+		else if (memcmp(chunk, "data", 4) == 0) {
+			if (!have_fmt)
+				return BASS_ERROR_FILEFORM;
+
+			data_start = chunk_start;
+			data_len = chunk_len;
+			if (data_len > reader->size() - data_start)
+				data_len = reader->size() - data_start; // truncated file
+			break;
+		}
+
+		// chunks are word aligned
+		if (!reader->seek(chunk_start + chunk_len + (chunk_len & 1)))
+			return BASS_ERROR_FILEFORM;
+	}
+
+	if (format_tag == 1)
+		is_float = false;
+	else if (format_tag == 3)
+		is_float = true;
+	else
+		return BASS_ERROR_CODEC;
+
+	if (channels == 0 || sample_rate == 0 || block_align != channels * (bits / 8))
+		return BASS_ERROR_FILEFORM;
+	if (is_float ? (bits != 32 && bits != 64) : (bits != 8 && bits != 16 && bits != 24 && bits != 32))
+		return BASS_ERROR_CODEC;
+
+	data_frames = data_len / block_align;
+	if (data_frames == 0)
+		return BASS_ERROR_EMPTY;
+
+	frames_left = data_frames;
+	raw.resize((size_t)ALT_MIXER_DECODE_FRAMES * block_align);
+	return reader->seek(data_start) ? BASS_OK : BASS_ERROR_FILEFORM;
+}
+
+// ---------------------------------------------------------------------------
+
+size_t AltsoundWavDecoder::decode(float* dst, size_t frames)
+{
+	if (frames > frames_left)
+		frames = frames_left;
+	if (frames > ALT_MIXER_DECODE_FRAMES)
+		frames = ALT_MIXER_DECODE_FRAMES;
+
+	frames = reader->read(&raw[0], frames * block_align) / block_align;
+	frames_left -= frames;
+
+	const unsigned int bytes = bits / 8;
+	const unsigned int right = channels > 1 ? bytes : 0;
+
+	for (size_t i = 0; i < frames; ++i) {
+		const UINT8* p = &raw[i * block_align];
+		for (unsigned int c = 0; c < 2; ++c) {
+			const UINT8* s = p + (c ? right : 0);
+			float v;
+			if (is_float)
+			{
+				if (bits == 32) {
+					UINT32 u = get_le32(s);
+					float f;
+					memcpy(&f, &u, sizeof(f));
+					v = f;
+				}
+				else {
+					UINT64 u = (UINT64)get_le32(s) | ((UINT64)get_le32(s + 4) << 32);
+					double d;
+					memcpy(&d, &u, sizeof(d));
+					v = (float)d;
+				}
+			}
+			else switch (bits)
+			{
+				case 8:  v = (float)((int)s[0] - 128) * (float)(1.0 / 128.0); break;
+				case 16: v = (float)(INT16)get_le16(s) * (float)(1.0 / 32768.0); break;
+				case 24: v = (float)((INT32)(((UINT32)s[0] << 8) | ((UINT32)s[1] << 16) | ((UINT32)s[2] << 24)) >> 8) * (float)(1.0 / 8388608.0); break;
+				default: v = (float)(INT32)get_le32(s) * (float)(1.0 / 2147483648.0); break;
+			}
+			dst[i * 2 + c] = v;
+		}
+	}
+
+	return frames;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundWavDecoder::rewind()
+{
+	frames_left = data_frames;
+	return reader->seek(data_start);
+}
+
+// ---------------------------------------------------------------------------
+
+#ifdef ALTSOUND_USE_VORBISFILE
+
+class AltsoundOggDecoder : public AltsoundDecoder {
+public:
+	explicit AltsoundOggDecoder(AltsoundReader* reader_in)
+	: reader(reader_in), channels(0), is_open(false) {}
+	~AltsoundOggDecoder() { if (is_open) ov_clear(&vf); }
+
+	// open the Ogg Vorbis stream, returns a BASS_ERROR_* code
+	int open();
+
+	size_t decode(float* dst, size_t frames);
+	bool rewind() { return ov_raw_seek(&vf, 0) == 0; }
+
+private:
+	static size_t read_cb(void* ptr, size_t size, size_t nmemb, void* src) {
+		return size ? static_cast<AltsoundReader*>(src)->read(ptr, size * nmemb) / size : 0;
+	}
+	static int seek_cb(void* src, ogg_int64_t offset, int whence) {
+		AltsoundReader* const r = static_cast<AltsoundReader*>(src);
+		const ogg_int64_t base = whence == SEEK_SET ? 0 : whence == SEEK_CUR ? (ogg_int64_t)r->tell() : (ogg_int64_t)r->size();
+		return (base + offset >= 0 && r->seek((size_t)(base + offset))) ? 0 : -1;
+	}
+	static long tell_cb(void* src) { return (long)static_cast<AltsoundReader*>(src)->tell(); }
+
+	std::unique_ptr<AltsoundReader> reader;
+	OggVorbis_File vf;
+	int channels;
+	bool is_open;
+};
+
+// ---------------------------------------------------------------------------
+
+int AltsoundOggDecoder::open()
+{
+	const ov_callbacks callbacks = { read_cb, seek_cb, NULL, tell_cb };
+	if (ov_open_callbacks(reader.get(), &vf, NULL, 0, callbacks) != 0)
+		return BASS_ERROR_FILEFORM;
+	is_open = true;
+
+	const vorbis_info* const info = ov_info(&vf, -1);
+	if (!info || info->channels < 1)
+		return BASS_ERROR_FILEFORM;
+
+	channels = info->channels;
+	sample_rate = (unsigned int)info->rate;
+	return BASS_OK;
+}
+
+// ---------------------------------------------------------------------------
+
+size_t AltsoundOggDecoder::decode(float* dst, size_t frames)
+{
+	size_t done = 0;
+	while (done < frames) {
+		float** pcm;
+		int section;
+		const long n = ov_read_float(&vf, &pcm, (int)(frames - done), &section);
+		if (n <= 0)
+			break;
+
+		const float* const l = pcm[0];
+		const float* const r = pcm[channels > 1 ? 1 : 0];
+		for (long i = 0; i < n; ++i) {
+			dst[(done + i) * 2] = l[i];
+			dst[(done + i) * 2 + 1] = r[i];
+		}
+		done += n;
+	}
+	return done;
+}
+
+#endif // ALTSOUND_USE_VORBISFILE
+
+// ---------------------------------------------------------------------------
+
+// Pick a decoder by sniffing the container.  Takes ownership of the reader,
+// returns a BASS_ERROR_* code and the decoder (to be deleted by the caller)
+static int alt_mixer_open_decoder(AltsoundReader* reader, AltsoundDecoder*& decoder_out)
+{
+	char magic[4] = { 0 };
+	reader->read(magic, 4);
+	reader->seek(0);
+
+	int err = BASS_ERROR_FILEFORM;
+	decoder_out = nullptr;
+
+	if (memcmp(magic, "RIFF", 4) == 0) {
+		AltsoundWavDecoder* const wav = new AltsoundWavDecoder(reader);
+		decoder_out = wav;
+		err = wav->open();
+	}
+#ifdef ALTSOUND_USE_VORBISFILE
+	else if (memcmp(magic, "OggS", 4) == 0) {
+		AltsoundOggDecoder* const ogg = new AltsoundOggDecoder(reader);
+		decoder_out = ogg;
+		err = ogg->open();
+	}
+#endif
+	else
+		delete reader;
+
+	return err;
+}
+
+// ---------------------------------------------------------------------------
+// Mixer state
+// ---------------------------------------------------------------------------
+
+struct AltsoundSync {
+	HSYNC handle;
+	DWORD type;
+	SYNCPROC* proc;
+	void* user;
+};
+
+struct AltsoundVoice {
+	std::unique_ptr<AltsoundDecoder> decoder;
+	std::vector<float> buffer; // decoded stereo frames
+	size_t buffer_pos;         // next frame to consume from buffer
+	size_t buffer_len;         // valid frames in buffer
+	float prev[2];             // interpolation endpoints
+	float next[2];
+	double frac;               // position between prev and next
+	double step;               // source frames per output sample
+	float volume;              // target volume set by the caller
+	float gain;                // volume applied at the end of the last update
+	bool loop;
+	DWORD state;               // BASS_ACTIVE_STOPPED/PLAYING/PAUSED
+	std::vector<AltsoundSync> syncs;
+};
+
+struct AltsoundPendingSync {
+	SYNCPROC* proc;
+	HSYNC handle;
+	DWORD channel;
+	void* user;
+};
+
+static struct {
+	std::mutex mutex;
+	std::unordered_map<DWORD, AltsoundVoice> voices;
+	std::vector<float> mix[2];
+	std::vector<AltsoundPendingSync> pending;
+	DWORD next_handle;
+	int stream;       // first of the two PinMAME mixer channels, -1 if none
+	bool initialized;
+	int error;
+} alt_mixer = { {}, {}, {}, {}, 1, -1, false, BASS_OK };
+
+// ---------------------------------------------------------------------------
+
+static BOOL alt_mixer_error(const int code)
+{
+	alt_mixer.error = code;
+	return code == BASS_OK;
+}
+
+// ---------------------------------------------------------------------------
+
+static AltsoundVoice* alt_mixer_find(const DWORD handle)
+{
+	const auto it = alt_mixer.voices.find(handle);
+	return it == alt_mixer.voices.end() ? nullptr : &it->second;
+}
+
+// ---------------------------------------------------------------------------
+
+// Fetch the next source frame, refilling the voice buffer as needed
+static bool alt_mixer_fetch(AltsoundVoice& voice, float* frame)
+{
+	if (voice.buffer_pos == voice.buffer_len) {
+		voice.buffer_len = voice.decoder->decode(&voice.buffer[0], ALT_MIXER_DECODE_FRAMES);
+		voice.buffer_pos = 0;
+		if (voice.buffer_len == 0)
+			return false;
+	}
+	frame[0] = voice.buffer[voice.buffer_pos * 2];
+	frame[1] = voice.buffer[voice.buffer_pos * 2 + 1];
+	voice.buffer_pos++;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// Position a voice on its first frame
+static bool alt_mixer_prime(AltsoundVoice& voice)
+{
+	voice.buffer_pos = voice.buffer_len = 0;
+	voice.frac = 1.0;
+	if (!alt_mixer_fetch(voice, voice.next))
+		return false;
+	voice.prev[0] = voice.next[0];
+	voice.prev[1] = voice.next[1];
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// Queue the END syncs of a voice, dropping the one-time ones
+static void alt_mixer_queue_end_syncs(const DWORD handle, AltsoundVoice& voice)
+{
+	for (size_t i = 0; i < voice.syncs.size();) {
+		const AltsoundSync& sync = voice.syncs[i];
+		const AltsoundPendingSync pending = { sync.proc, sync.handle, handle, sync.user };
+		alt_mixer.pending.push_back(pending);
+
+		if (sync.type & BASS_SYNC_ONETIME)
+			voice.syncs.erase(voice.syncs.begin() + i);
+		else
+			++i;
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+// Add 'length' samples of a voice to the mix buffers
+static void alt_mixer_render(const DWORD handle, AltsoundVoice& voice, float* left, float* right, const int length)
+{
+	const float gain_step = (voice.volume - voice.gain) / (float)length;
+	float gain = voice.gain;
+
+	for (int i = 0; i < length; ++i) {
+		while (voice.frac >= 1.0) {
+			voice.frac -= 1.0;
+			voice.prev[0] = voice.next[0];
+			voice.prev[1] = voice.next[1];
+
+			if (!alt_mixer_fetch(voice, voice.next)) {
+				alt_mixer_queue_end_syncs(handle, voice);
+				if (!voice.loop || !voice.decoder->rewind() || !alt_mixer_fetch(voice, voice.next)) {
+					voice.state = BASS_ACTIVE_STOPPED;
+					voice.gain = voice.volume;
+					return;
+				}
+			}
+		}
+
+		const float f = (float)voice.frac;
+		gain += gain_step;
+		left[i] += (voice.prev[0] + (voice.next[0] - voice.prev[0]) * f) * gain;
+		right[i] += (voice.prev[1] + (voice.next[1] - voice.prev[1]) * f) * gain;
+		voice.frac += voice.step;
+	}
+
+	voice.gain = voice.volume;
+}
+
+// ---------------------------------------------------------------------------
+
+static void alt_mixer_update(int param, INT16** buffer, int length)
+{
+	float* const left = (float*)buffer[0];
+	float* const right = (float*)buffer[1];
+
+	std::unique_lock<std::mutex> lock(alt_mixer.mutex);
+
+	memset(left, 0, length * sizeof(float));
+	memset(right, 0, length * sizeof(float));
+
+	if (alt_mixer.initialized)
+		for (auto& it : alt_mixer.voices)
+			if (it.second.state == BASS_ACTIVE_PLAYING)
+				alt_mixer_render(it.first, it.second, left, right, length);
+
+	if (alt_mixer.pending.empty())
+		return;
+
+	// Sync callbacks re-enter the API (usually to free the stream), and take
+	// the AltSound io_mutex, so they must run without the mixer lock held
+	std::vector<AltsoundPendingSync> pending;
+	pending.swap(alt_mixer.pending);
+	lock.unlock();
+
+	for (const AltsoundPendingSync& sync : pending)
+		sync.proc(sync.handle, sync.channel, 0, sync.user);
+}
+
+// ---------------------------------------------------------------------------
+
+void altsound_mixer_mute_emulation()
+{
+	for (int ch = 0; ch < MIXER_MAX_CHANNELS; ch++) {
+		if (ch == alt_mixer.stream || ch == alt_mixer.stream + 1)
+			continue;
+		if (mixer_get_name(ch) != NULL)
+			mixer_set_volume(ch, 0);
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+bool altsound_mixer_decode_to_wav(const char* path, std::vector<unsigned char>& wav_out)
+{
+	FILE* const f = fopen(path, "rb");
+	if (!f)
+		return false;
+
+	AltsoundDecoder* decoder;
+	const int err = alt_mixer_open_decoder(new AltsoundFileReader(f), decoder);
+	std::unique_ptr<AltsoundDecoder> owner(decoder);
+	if (err != BASS_OK)
+		return false;
+
+	static const unsigned char header[44] = {
+		'R','I','F','F', 0,0,0,0, 'W','A','V','E',
+		'f','m','t',' ', 16,0,0,0, 1,0, 2,0, 0,0,0,0, 0,0,0,0, 4,0, 16,0,
+		'd','a','t','a', 0,0,0,0
+	};
+	wav_out.assign(header, header + sizeof(header));
+
+	std::vector<float> block(ALT_MIXER_DECODE_FRAMES * 2);
+	size_t frames;
+	while ((frames = decoder->decode(&block[0], ALT_MIXER_DECODE_FRAMES)) != 0) {
+		for (size_t i = 0; i < frames * 2; ++i) {
+			const float v = block[i] * 32768.0f;
+			const INT16 s = v >= 32767.0f ? 32767 : v <= -32768.0f ? -32768 : (INT16)v;
+			wav_out.push_back((unsigned char)(s & 0xff));
+			wav_out.push_back((unsigned char)((UINT16)s >> 8));
+		}
+	}
+
+	const UINT32 data_len = (UINT32)(wav_out.size() - sizeof(header));
+	const UINT32 fields[4][2] = {
+		{ 4, data_len + 36 },                       // RIFF size
+		{ 24, decoder->sample_rate },               // sample rate
+		{ 28, decoder->sample_rate * 4 },           // byte rate
+		{ 40, data_len }                            // data size
+	};
+	for (const auto& field : fields)
+		for (int b = 0; b < 4; ++b)
+			wav_out[field[0] + b] = (unsigned char)(field[1] >> (b * 8));
+
+	return data_len != 0;
+}
+
+// ---------------------------------------------------------------------------
+// BASS API subset
+// ---------------------------------------------------------------------------
+
+extern "C" {
+
+int BASS_ErrorGetCode(void)
+{
+	return alt_mixer.error;
+}
+
+// ---------------------------------------------------------------------------
+
+// The device, rate and window are ignored: output always goes to a PinMAME
+// stream running at the machine sample rate
+BOOL BASS_Init(int device, DWORD freq, DWORD flags, void* win, const void* dsguid)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	if (alt_mixer.initialized)
+		return alt_mixer_error(BASS_ERROR_ALREADY);
+	if (Machine->sample_rate == 0)
+		return alt_mixer_error(BASS_ERROR_NOPLAY);
+
+	if (alt_mixer.stream < 0) {
+		static const char* names[2] = { "AltSound Left", "AltSound Right" };
+		static const int levels[2] = { MIXER(100, MIXER_PAN_LEFT), MIXER(100, MIXER_PAN_RIGHT) };
+		alt_mixer.stream = stream_init_multi_float(2, names, levels, Machine->sample_rate, 0, alt_mixer_update, 1);
+		if (alt_mixer.stream < 0)
+			return alt_mixer_error(BASS_ERROR_NOCHAN);
+	}
+
+	alt_mixer.initialized = true;
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+// The PinMAME stream itself stays allocated (and silent) until the mixer is
+// torn down with the machine, since channels cannot be released earlier.
+// AltSound is only shut down with the machine, so the next BASS_Init()
+// belongs to a new machine and allocates a fresh stream
+BOOL BASS_Free(void)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	if (!alt_mixer.initialized)
+		return alt_mixer_error(BASS_ERROR_INIT);
+
+	alt_mixer.voices.clear();
+	alt_mixer.pending.clear();
+	alt_mixer.initialized = false;
+	alt_mixer.stream = -1;
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+HSTREAM BASS_StreamCreateFile(BOOL mem, const void* file, QWORD offset, QWORD length, DWORD flags)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	if (!alt_mixer.initialized) {
+		alt_mixer_error(BASS_ERROR_INIT);
+		return 0;
+	}
+	if (!file || (flags & BASS_UNICODE)) {
+		alt_mixer_error(BASS_ERROR_ILLPARAM);
+		return 0;
+	}
+
+	AltsoundReader* reader;
+	if (mem) {
+		reader = new AltsoundMemoryReader((const UINT8*)file + offset, (size_t)length);
+	}
+	else {
+		FILE* const f = fopen((const char*)file, "rb");
+		if (!f) {
+			alt_mixer_error(BASS_ERROR_FILEOPEN);
+			return 0;
+		}
+		reader = new AltsoundFileReader(f);
+	}
+
+	AltsoundDecoder* decoder;
+	const int err = alt_mixer_open_decoder(reader, decoder);
+
+	AltsoundVoice voice;
+	voice.decoder.reset(decoder);
+	if (err != BASS_OK) {
+		alt_mixer_error(err);
+		return 0;
+	}
+
+	voice.buffer.resize(ALT_MIXER_DECODE_FRAMES * 2);
+	voice.step = (double)decoder->sample_rate / (double)Machine->sample_rate;
+	voice.volume = voice.gain = 1.0f;
+	voice.loop = (flags & BASS_SAMPLE_LOOP) != 0;
+	voice.state = BASS_ACTIVE_STOPPED;
+
+	if (!alt_mixer_prime(voice)) {
+		alt_mixer_error(BASS_ERROR_EMPTY);
+		return 0;
+	}
+
+	const HSTREAM handle = alt_mixer.next_handle++;
+	if (alt_mixer.next_handle == 0)
+		alt_mixer.next_handle = 1;
+	alt_mixer.voices.emplace(handle, std::move(voice));
+
+	alt_mixer_error(BASS_OK);
+	return handle;
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASS_StreamFree(HSTREAM handle)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	if (alt_mixer.voices.erase(handle) == 0)
+		return alt_mixer_error(BASS_ERROR_HANDLE);
+
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASS_ChannelPlay(DWORD handle, BOOL restart)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice)
+		return alt_mixer_error(BASS_ERROR_HANDLE);
+
+	if (restart && (!voice->decoder->rewind() || !alt_mixer_prime(*voice)))
+		return alt_mixer_error(BASS_ERROR_FILEFORM);
+
+	voice->state = BASS_ACTIVE_PLAYING;
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASS_ChannelPause(DWORD handle)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice)
+		return alt_mixer_error(BASS_ERROR_HANDLE);
+	if (voice->state != BASS_ACTIVE_PLAYING)
+		return alt_mixer_error(BASS_ERROR_NOPLAY);
+
+	voice->state = BASS_ACTIVE_PAUSED;
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASS_ChannelStop(DWORD handle)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice)
+		return alt_mixer_error(BASS_ERROR_HANDLE);
+
+	voice->state = BASS_ACTIVE_STOPPED;
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+DWORD BASS_ChannelIsActive(DWORD handle)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	const AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice) {
+		alt_mixer_error(BASS_ERROR_HANDLE);
+		return BASS_ACTIVE_STOPPED;
+	}
+
+	alt_mixer_error(BASS_OK);
+	return voice->state;
+}
+
+// ---------------------------------------------------------------------------
+
+BOOL BASS_ChannelSetAttribute(DWORD handle, DWORD attrib, float value)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice)
+		return alt_mixer_error(BASS_ERROR_HANDLE);
+	if (attrib != BASS_ATTRIB_VOL)
+		return alt_mixer_error(BASS_ERROR_ILLTYPE);
+
+	voice->volume = value < 0.0f ? 0.0f : value;
+
+	// a stream that is not playing yet starts at its new volume
+	if (voice->state != BASS_ACTIVE_PLAYING)
+		voice->gain = voice->volume;
+
+	return alt_mixer_error(BASS_OK);
+}
+
+// ---------------------------------------------------------------------------
+
+HSYNC BASS_ChannelSetSync(DWORD handle, DWORD type, QWORD param, SYNCPROC* proc, void* user)
+{
+	std::lock_guard<std::mutex> lock(alt_mixer.mutex);
+
+	AltsoundVoice* const voice = alt_mixer_find(handle);
+	if (!voice) {
+		alt_mixer_error(BASS_ERROR_HANDLE);
+		return 0;
+	}
+	if ((type & ALT_MIXER_SYNC_TYPE_MASK) != BASS_SYNC_END || !proc) {
+		alt_mixer_error(BASS_ERROR_ILLTYPE);
+		return 0;
+	}
+
+	const AltsoundSync sync = { alt_mixer.next_handle++, type, proc, user };
+	if (alt_mixer.next_handle == 0)
+		alt_mixer.next_handle = 1;
+	voice->syncs.push_back(sync);
+
+	alt_mixer_error(BASS_OK);
+	return sync.handle;
+}
+
+} // extern "C"
@@ -0,0 +1,34 @@
+// ---------------------------------------------------------------------------
+// altsound_mixer.hpp
+//
+// Built-in replacement for the subset of the BASS API used by AltSound.
+// Compiled when ALTSOUND_INTERNAL_MIXER is defined, in which case the
+// BASS_* entry points declared in bass.h are provided by altsound_mixer.cpp
+// instead of the BASS library.  All AltSound streams are mixed into a stereo
+// PinMAME sound stream, so the output travels through the regular mixer and
+// osd_update_audio_stream() like any emulated sound chip
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#ifndef ALTSOUND_MIXER_HPP
+#define ALTSOUND_MIXER_HPP
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+// Std Library includes
+#include <vector>
+
+// Local includes
+#include "../../ext/bass/bass.h"
+
+// Mute every emulated PinMAME mixer channel, leaving only the AltSound mix
+// audible.  Must be called after BASS_Init()
+void altsound_mixer_mute_emulation();
+
+// Decode a sample file to a 16-bit stereo PCM WAV image at its native rate.
+// Used to pre-decode compressed samples into the sample bank
+bool altsound_mixer_decode_to_wav(const char* path, std::vector<unsigned char>& wav_out);
+
+#endif // ALTSOUND_MIXER_HPP
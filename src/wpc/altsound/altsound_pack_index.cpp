@@ -0,0 +1,519 @@
+// ---------------------------------------------------------------------------
+// altsound_pack_index.cpp
+//
+// Persistent index of AltSound/G-Sound packs, with parallel validation of
+// the sample files
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#include "altsound_pack_index.hpp"
+
+// Std Library includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+// Local includes
+#include "altsound_logger.hpp"
+
+extern AltsoundLogger alog;
+
+// ---------------------------------------------------------------------------
+// Index file layout (native byte order, the file is a local cache).  Strings
+// are stored as UINT32 length followed by the characters:
+//
+//   header     : "ALTIDX01", pack format string
+//   signature  : UINT32 count, per entry key, UINT64 size, INT64 mtime
+//   files      : UINT32 count, per entry key, UINT8 exists, UINT8 format,
+//                UINT64 size, INT64 mtime
+//   samples    : UINT8 present, UINT32 count, per entry UINT32 id,
+//                INT32 channel, FLOAT gain, FLOAT ducking, UINT8 loop,
+//                UINT8 stop, name, fname key
+// ---------------------------------------------------------------------------
+
+#define ALT_INDEX_MAGIC "ALTIDX01"
+#define ALT_INDEX_MISSING ((uint64_t)-1)
+
+// files probed per worker batch
+#define ALT_INDEX_PROBE_BATCH 16
+
+// ---------------------------------------------------------------------------
+// Helper functions
+// ---------------------------------------------------------------------------
+
+static bool stat_path(const std::string& path, uint64_t& size_out, int64_t& mtime_out, bool& is_dir_out)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return false;
+
+	size_out = (uint64_t)info.st_size;
+	mtime_out = (int64_t)info.st_mtime;
+	is_dir_out = (info.st_mode & S_IFDIR) != 0;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+// stat a sample file and identify its format from the first bytes
+static AltsoundPackIndex::FileInfo probe_file(const std::string& path)
+{
+	AltsoundPackIndex::FileInfo info;
+
+	bool is_dir = false;
+	if (!stat_path(path, info.size, info.mtime, is_dir) || is_dir)
+		return info;
+	info.exists = true;
+
+	FILE* const f = fopen(path.c_str(), "rb");
+	if (!f)
+		return info;
+
+	unsigned char header[12] = { 0 };
+	const size_t read = fread(header, 1, sizeof(header), f);
+	fclose(f);
+
+	if (read >= 12 && memcmp(header, "RIFF", 4) == 0 && memcmp(header + 8, "WAVE", 4) == 0)
+		info.format = AltsoundPackIndex::FORMAT_WAV;
+	else if (read >= 4 && memcmp(header, "OggS", 4) == 0)
+		info.format = AltsoundPackIndex::FORMAT_OGG;
+	else if ((read >= 3 && memcmp(header, "ID3", 3) == 0) || (read >= 2 && header[0] == 0xFF && (header[1] & 0xE0) == 0xE0))
+		info.format = AltsoundPackIndex::FORMAT_MP3;
+
+	return info;
+}
+
+// ---------------------------------------------------------------------------
+
+static void put_bytes(std::vector<unsigned char>& out, const void* data, const size_t size)
+{
+	out.insert(out.end(), (const unsigned char*)data, (const unsigned char*)data + size);
+}
+
+template <typename T>
+static void put(std::vector<unsigned char>& out, const T value)
+{
+	put_bytes(out, &value, sizeof(value));
+}
+
+static void put_string(std::vector<unsigned char>& out, const std::string& str)
+{
+	put(out, (uint32_t)str.size());
+	put_bytes(out, str.data(), str.size());
+}
+
+// ---------------------------------------------------------------------------
+
+// bounds-checked reader over the loaded index file
+class IndexReader {
+public:
+	IndexReader(const std::vector<unsigned char>& data_in) : data(data_in) {}
+
+	template <typename T>
+	bool get(T& value_out) {
+		if (data.size() - pos < sizeof(T))
+			return false;
+		memcpy(&value_out, &data[pos], sizeof(T));
+		pos += sizeof(T);
+		return true;
+	}
+
+	bool getString(std::string& str_out) {
+		uint32_t len;
+		if (!get(len) || data.size() - pos < len)
+			return false;
+		str_out.assign((const char*)&data[pos], len);
+		pos += len;
+		return true;
+	}
+
+	bool done() const { return pos == data.size(); }
+
+private:
+	const std::vector<unsigned char>& data;
+	size_t pos = 0;
+};
+
+// ---------------------------------------------------------------------------
+// AltsoundPackIndex implementation
+// ---------------------------------------------------------------------------
+
+AltsoundPackIndex::AltsoundPackIndex(const std::string& altsound_path, const std::string& format)
+: base_path(altsound_path),
+  pack_format(format),
+  index_path(altsound_path + "/altsound.idx")
+{
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundPackIndex::load()
+{
+	ALT_DEBUG(0, "BEGIN AltsoundPackIndex::load()");
+	INDENT;
+
+	files.clear();
+	samples.clear();
+	has_samples = false;
+	loaded = false;
+	dirty = true;
+
+	std::vector<unsigned char> data;
+	FILE* const f = fopen(index_path.c_str(), "rb");
+	if (f) {
+		fseek(f, 0, SEEK_END);
+		const long size = ftell(f);
+		fseek(f, 0, SEEK_SET);
+
+		data.resize(size > 0 ? (size_t)size : 0);
+		if (data.empty() || fread(&data[0], 1, data.size(), f) != data.size())
+			data.clear();
+		fclose(f);
+	}
+
+	if (data.empty()) {
+		ALT_INFO(1, "No pack index: %s", index_path.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundPackIndex::load()");
+		return false;
+	}
+
+	IndexReader reader(data);
+	bool valid = data.size() >= 8 && memcmp(&data[0], ALT_INDEX_MAGIC, 8) == 0;
+	if (valid) {
+		char magic[8];
+		reader.get(magic);
+	}
+
+	// the pack format and signature decide whether the rest can be trusted
+	std::string format;
+	valid = valid && reader.getString(format) && format == pack_format;
+
+	uint32_t count = 0;
+	valid = valid && reader.get(count);
+	for (uint32_t i = 0; valid && i < count; ++i) {
+		Signature sig;
+		valid = reader.getString(sig.key) && reader.get(sig.size) && reader.get(sig.mtime);
+		if (valid) {
+			const Signature current = makeSignature(sig.key);
+			valid = current.size == sig.size && current.mtime == sig.mtime;
+			if (!valid)
+				ALT_INFO(1, "Pack changed: %s", sig.key.c_str());
+		}
+	}
+
+	valid = valid && reader.get(count);
+	for (uint32_t i = 0; valid && i < count; ++i) {
+		std::string key;
+		uint8_t exists, format_id;
+		FileInfo info;
+		valid = reader.getString(key) && reader.get(exists) && reader.get(format_id)
+		     && reader.get(info.size) && reader.get(info.mtime);
+		if (valid) {
+			info.exists = exists != 0;
+			info.format = (Format)format_id;
+			files[filePath(key)] = info;
+		}
+	}
+
+	uint8_t present = 0;
+	valid = valid && reader.get(present) && reader.get(count);
+	for (uint32_t i = 0; valid && i < count; ++i) {
+		AltsoundSampleInfo sample;
+		int32_t channel;
+		uint8_t loop, stop;
+		std::string key;
+		valid = reader.get(sample.id) && reader.get(channel) && reader.get(sample.gain)
+		     && reader.get(sample.ducking) && reader.get(loop) && reader.get(stop)
+		     && reader.getString(sample.name) && reader.getString(key);
+		if (valid) {
+			sample.channel = channel;
+			sample.loop = loop != 0;
+			sample.stop = stop != 0;
+			sample.fname = filePath(key);
+			samples.push_back(sample);
+		}
+	}
+	valid = valid && reader.done();
+
+	if (!valid) {
+		files.clear();
+		samples.clear();
+		ALT_INFO(1, "Pack index out of date: %s", index_path.c_str());
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundPackIndex::load()");
+		return false;
+	}
+
+	has_samples = present != 0;
+	loaded = true;
+	dirty = false;
+	ALT_INFO(1, "Loaded pack index: %d files, %d samples", (int)files.size(), (int)samples.size());
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundPackIndex::load()");
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundPackIndex::save()
+{
+	if (!dirty)
+		return true;
+
+	ALT_DEBUG(0, "BEGIN AltsoundPackIndex::save()");
+	INDENT;
+
+	std::vector<unsigned char> data;
+	put_bytes(data, ALT_INDEX_MAGIC, 8);
+	put_string(data, pack_format);
+
+	const std::vector<std::string> keys = signatureKeys();
+	put(data, (uint32_t)keys.size());
+	for (const std::string& key : keys) {
+		const Signature sig = makeSignature(key);
+		put_string(data, sig.key);
+		put(data, sig.size);
+		put(data, sig.mtime);
+	}
+
+	put(data, (uint32_t)files.size());
+	for (const auto& file : files) {
+		put_string(data, fileKey(file.first));
+		put(data, (uint8_t)file.second.exists);
+		put(data, (uint8_t)file.second.format);
+		put(data, file.second.size);
+		put(data, file.second.mtime);
+	}
+
+	put(data, (uint8_t)has_samples);
+	put(data, (uint32_t)samples.size());
+	for (const AltsoundSampleInfo& sample : samples) {
+		put(data, (uint32_t)sample.id);
+		put(data, (int32_t)sample.channel);
+		put(data, sample.gain);
+		put(data, sample.ducking);
+		put(data, (uint8_t)sample.loop);
+		put(data, (uint8_t)sample.stop);
+		put_string(data, sample.name);
+		put_string(data, fileKey(sample.fname));
+	}
+
+	// write to a temporary file first, so an interrupted write never leaves
+	// a truncated index behind
+	const std::string tmp_path = index_path + ".tmp";
+	bool success = false;
+	FILE* const f = fopen(tmp_path.c_str(), "wb");
+	if (f) {
+		success = fwrite(&data[0], 1, data.size(), f) == data.size();
+		success = (fclose(f) == 0) && success;
+		if (success) {
+			remove(index_path.c_str());
+			success = rename(tmp_path.c_str(), index_path.c_str()) == 0;
+		}
+		if (!success)
+			remove(tmp_path.c_str());
+	}
+
+	if (success) {
+		dirty = false;
+		ALT_INFO(1, "Saved pack index: %s", index_path.c_str());
+	}
+	else {
+		ALT_WARNING(1, "Cannot write pack index: %s", index_path.c_str());
+	}
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundPackIndex::save()");
+	return success;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundPackIndex::getSamples(std::vector<AltsoundSampleInfo>& samples_out) const
+{
+	if (!loaded || !has_samples)
+		return false;
+
+	samples_out.insert(samples_out.end(), samples.begin(), samples.end());
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void AltsoundPackIndex::setSamples(const std::vector<AltsoundSampleInfo>& samples_in)
+{
+	samples = samples_in;
+	has_samples = true;
+	dirty = true;
+}
+
+// ---------------------------------------------------------------------------
+
+size_t AltsoundPackIndex::validate(const std::vector<std::string>& sample_paths)
+{
+	ALT_DEBUG(0, "BEGIN AltsoundPackIndex::validate()");
+	INDENT;
+
+	// several commands can share a sample file
+	std::vector<std::string> unique_paths(sample_paths);
+	std::sort(unique_paths.begin(), unique_paths.end());
+	unique_paths.erase(std::unique(unique_paths.begin(), unique_paths.end()), unique_paths.end());
+
+	// files that the loaded index does not cover are probed on the worker pool
+	std::vector<std::string> pending;
+	for (const std::string& path : unique_paths) {
+		if (!path.empty() && files.find(path) == files.end())
+			pending.push_back(path);
+	}
+
+	if (!pending.empty()) {
+		std::vector<FileInfo> probed(pending.size());
+		parallel_for(pending.size(), ALT_INDEX_PROBE_BATCH, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				probed[i] = probe_file(pending[i]);
+		});
+
+		for (size_t i = 0; i < pending.size(); ++i)
+			files[pending[i]] = probed[i];
+		dirty = true;
+
+		ALT_INFO(1, "Probed %d sample files", (int)pending.size());
+	}
+
+	size_t usable = 0;
+	for (const std::string& path : unique_paths) {
+		const FileInfo* const info = find(path);
+		if (!info || !info->exists) {
+			ALT_WARNING(1, "Missing sample file: %s", path.c_str());
+		}
+		else if (!isPlayable(info->format)) {
+			ALT_WARNING(1, "Unsupported sample format: %s", path.c_str());
+		}
+		else {
+			++usable;
+		}
+	}
+	ALT_INFO(1, "%d of %d sample files usable", (int)usable, (int)unique_paths.size());
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundPackIndex::validate()");
+	return usable;
+}
+
+// ---------------------------------------------------------------------------
+
+const AltsoundPackIndex::FileInfo* AltsoundPackIndex::find(const std::string& sample_path) const
+{
+	const auto it = files.find(sample_path);
+	return it != files.end() ? &it->second : nullptr;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundPackIndex::isPlayable(const Format format)
+{
+	switch (format) {
+	case FORMAT_WAV:
+		return true;
+
+#ifdef ALTSOUND_INTERNAL_MIXER
+ #ifdef ALTSOUND_USE_VORBISFILE
+	case FORMAT_OGG:
+		return true;
+ #endif
+#else
+	case FORMAT_OGG:
+	case FORMAT_MP3:
+		return true;
+#endif
+
+	default:
+		return false;
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+std::vector<std::string> AltsoundPackIndex::signatureKeys() const
+{
+	static const char* const type_dirs[] = { "jingle", "music", "sfx", "single", "voice" };
+	const bool legacy = pack_format == "legacy";
+
+	std::vector<std::string> keys = { "altsound.csv", "g-sound.csv" };
+	for (const char* const dir : type_dirs) {
+		keys.push_back(dir);
+		if (legacy) {
+			keys.push_back(std::string(dir) + "/gain.txt");
+			keys.push_back(std::string(dir) + "/ducking.txt");
+		}
+	}
+
+	// the folders holding samples change timestamp when files are added,
+	// removed or renamed
+	std::vector<std::string> dirs;
+	for (const auto& file : files) {
+		const std::string key = fileKey(file.first);
+		const size_t slash = key.rfind('/');
+		if (slash != std::string::npos)
+			dirs.push_back(key.substr(0, slash));
+	}
+	std::sort(dirs.begin(), dirs.end());
+	dirs.erase(std::unique(dirs.begin(), dirs.end()), dirs.end());
+
+	for (const std::string& dir : dirs) {
+		if (std::find(keys.begin(), keys.end(), dir) != keys.end())
+			continue;
+		keys.push_back(dir);
+		if (legacy) {
+			keys.push_back(dir + "/gain.txt");
+			keys.push_back(dir + "/ducking.txt");
+		}
+	}
+
+	return keys;
+}
+
+// ---------------------------------------------------------------------------
+
+AltsoundPackIndex::Signature AltsoundPackIndex::makeSignature(const std::string& key) const
+{
+	Signature sig;
+	sig.key = key;
+
+	bool is_dir;
+	if (!stat_path(base_path + '/' + key, sig.size, sig.mtime, is_dir)) {
+		sig.size = ALT_INDEX_MISSING;
+		sig.mtime = 0;
+	}
+	else if (is_dir) {
+		// directory sizes are not meaningful on every file system
+		sig.size = 0;
+	}
+	return sig;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string AltsoundPackIndex::fileKey(const std::string& sample_path) const
+{
+	if (sample_path.size() > base_path.size() && sample_path.compare(0, base_path.size(), base_path) == 0
+	 && sample_path[base_path.size()] == '/')
+		return sample_path.substr(base_path.size() + 1);
+	return sample_path;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string AltsoundPackIndex::filePath(const std::string& key) const
+{
+	// keys of files outside the pack folder are stored as full paths
+	if (key.empty() || key[0] == '/' || key.find(':') != std::string::npos)
+		return key;
+	return base_path + '/' + key;
+}
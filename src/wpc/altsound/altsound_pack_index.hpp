@@ -0,0 +1,122 @@
+// ---------------------------------------------------------------------------
+// altsound_pack_index.hpp
+//
+// Persistent index of an AltSound/G-Sound pack.  Stores the size, timestamp
+// and probed format of every sample file, plus the parsed sample list of
+// legacy (PinSound directory) packs, in an "altsound.idx" file next to the
+// pack.  The index is keyed by the size and timestamp of the pack's CSV files
+// and sample folders, so later starts skip the directory walk and the file
+// probing entirely.
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#ifndef ALTSOUND_PACK_INDEX_HPP
+#define ALTSOUND_PACK_INDEX_HPP
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#if _MSC_VER >= 1700
+ #ifdef inline
+  #undef inline
+ #endif
+#endif
+
+// Std Library includes
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Local includes
+#include "altsound_data.hpp"
+
+// ---------------------------------------------------------------------------
+// AltsoundPackIndex class definition
+// ---------------------------------------------------------------------------
+
+class AltsoundPackIndex {
+public:
+
+	// Sample file format, detected from the file header
+	enum Format : uint8_t {
+		FORMAT_UNKNOWN = 0,
+		FORMAT_WAV,
+		FORMAT_OGG,
+		FORMAT_MP3
+	};
+
+	// Information gathered about a sample file
+	struct FileInfo {
+		bool exists = false;
+		Format format = FORMAT_UNKNOWN;
+		uint64_t size = 0;
+		int64_t mtime = 0;
+	};
+
+	// Standard constructor. 'format' is the pack format ("altsound",
+	// "legacy" or "g-sound"), switching formats invalidates the index
+	AltsoundPackIndex(const std::string& altsound_path, const std::string& format);
+
+	// Copy constructor - NOT USED
+	AltsoundPackIndex(AltsoundPackIndex&) = delete;
+
+	// Load the index file.  Returns false if it is missing, unreadable or
+	// the pack changed since it was written
+	bool load();
+
+	// Write the index file if anything changed since load()
+	bool save();
+
+	// Parsed sample list of legacy packs.  getSamples() returns false when
+	// the loaded index holds none
+	bool getSamples(std::vector<AltsoundSampleInfo>& samples_out) const;
+	void setSamples(const std::vector<AltsoundSampleInfo>& samples_in);
+
+	// Check that the sample files exist and hold a playable format.  Files not
+	// covered by a loaded index are stat'ed and probed on the worker pool.
+	// Returns the number of usable files
+	size_t validate(const std::vector<std::string>& sample_paths);
+
+	// Information about a sample file, nullptr if validate() did not see it
+	const FileInfo* find(const std::string& sample_path) const;
+
+	// true if samples in this format can be decoded by the active backend
+	static bool isPlayable(const Format format);
+
+private: // functions
+
+	struct Signature {
+		std::string key;
+		uint64_t size;
+		int64_t mtime;
+	};
+
+	// the CSV files and sample folders whose timestamps key the index
+	std::vector<std::string> signatureKeys() const;
+
+	// stat a path relative to the pack folder
+	Signature makeSignature(const std::string& key) const;
+
+	// key used in the index file: path relative to the pack folder
+	std::string fileKey(const std::string& sample_path) const;
+
+	// inverse of fileKey()
+	std::string filePath(const std::string& key) const;
+
+private: // data
+
+	std::string base_path;
+	std::string pack_format;
+	std::string index_path;
+
+	std::unordered_map<std::string, FileInfo> files;
+	std::vector<AltsoundSampleInfo> samples;
+	bool has_samples = false;
+
+	bool loaded = false;
+	bool dirty = false;
+};
+
+#endif // ALTSOUND_PACK_INDEX_HPP
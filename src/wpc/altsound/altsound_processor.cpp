@@ -21,6 +21,7 @@
 #include "altsound_csv_parser.hpp"
 #include "altsound_file_parser.hpp"
 #include "altsound_logger.hpp"
+#include "altsound_pack_index.hpp"
 
 using std::string;
 
@@ -284,6 +285,11 @@ bool AltsoundProcessor::loadSamples()
 		altsound_path += game_name;
 	}
 
+	// A valid pack index replaces the directory walk of legacy packs and the
+	// sample file probing
+	AltsoundPackIndex pack_index(altsound_path, format);
+	const bool have_index = pack_index.load();
+
 	if (format == "altsound") {
 		AltsoundCsvParser csv_parser(altsound_path);
 
@@ -297,17 +303,34 @@ bool AltsoundProcessor::loadSamples()
 		ALT_INFO(0, "SUCCESS AltsoundCsvParser::parse()");
 	}
 	else if (format == "legacy") {
-		AltsoundFileParser file_parser(altsound_path);
-		if (!file_parser.parse(samples)) {
-			ALT_ERROR(0, "FAILED AltsoundFileParser::parse()");
-			
-			OUTDENT;
-			ALT_DEBUG(0, "END AltsoundProcessor::loadSamples");
-			return false;
+		if (have_index && pack_index.getSamples(samples)) {
+			ALT_INFO(0, "Loaded %d samples from pack index", (int)samples.size());
+		}
+		else {
+			AltsoundFileParser file_parser(altsound_path);
+			if (!file_parser.parse(samples)) {
+				ALT_ERROR(0, "FAILED AltsoundFileParser::parse()");
+
+				OUTDENT;
+				ALT_DEBUG(0, "END AltsoundProcessor::loadSamples");
+				return false;
+			}
+			ALT_INFO(0, "SUCCESS AltsoundFileParser::parse()");
+			pack_index.setSamples(samples);
 		}
-		ALT_INFO(0, "SUCCESS AltsoundFileParser::parse()");
 	}
 
+	std::vector<string> sample_paths;
+	sample_paths.reserve(samples.size());
+	for (const AltsoundSampleInfo& sample : samples)
+		sample_paths.push_back(sample.fname);
+
+	pack_index.validate(sample_paths);
+	pack_index.save();
+
+	// pack short samples into memory so commands don't hit the disk
+	sample_bank.open(altsound_path, sample_paths);
+
 	OUTDENT;
 	ALT_DEBUG(0, "END AltsoundProcessor::loadSamples");
 	return true;
@@ -27,7 +27,7 @@
 // Local includes
 #include "altsound_processor_base.hpp"
 #include "snd_alt.h"
-#include "..\ext\bass\bass.h"
+#include "../../ext/bass/bass.h"
 
 // ---------------------------------------------------------------------------
 // AltsoundProcessor class definition
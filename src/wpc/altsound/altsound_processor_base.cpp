@@ -9,6 +9,7 @@
 // ---------------------------------------------------------------------------
 #include "altsound_processor_base.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 
@@ -20,6 +21,7 @@ extern StreamArray channel_stream;
 // initialize static data members
 float AltsoundProcessorBase::global_vol = 1.0f;
 float AltsoundProcessorBase::master_vol = 1.0f;
+AltsoundSampleBank AltsoundProcessorBase::sample_bank;
 
 // reference to sound command recording status
 extern bool rec_snd_cmds;
@@ -56,6 +58,10 @@ AltsoundProcessorBase::~AltsoundProcessorBase()
 	}
 #endif
 
+	// streams may play from sample bank memory, so release them before the bank
+	stopAllStreams();
+	sample_bank.close();
+
 	// clean up stored steam objects
 	for (auto& stream : channel_stream) {
 		delete stream;
@@ -199,7 +205,7 @@ bool AltsoundProcessorBase::setStreamVolume(HSTREAM stream_in, const float vol_i
 
 // ----------------------------------------------------------------------------
 
-bool AltsoundProcessorBase::createStream(void* syncproc_in, AltsoundStreamInfo* stream_out)
+bool AltsoundProcessorBase::createStream(SYNCPROC* syncproc_in, AltsoundStreamInfo* stream_out)
 {
 	ALT_DEBUG(0, "BEGIN AltsoundProcessorBase::createStream()");
 	INDENT;
@@ -219,7 +225,8 @@ bool AltsoundProcessorBase::createStream(void* syncproc_in, AltsoundStreamInfo*
 	const bool loop = stream_out->loop;
 
     // Create playback stream
-	HSTREAM hstream = BASS_StreamCreateFile(FALSE, stream_out->sample_path.c_str(), 0, 0, loop ? BASS_SAMPLE_LOOP : 0);
+	HSTREAM hstream = sample_bank.createStream(stream_out->sample_path, stream_out->stream_type == MUSIC,
+	                                           loop ? BASS_SAMPLE_LOOP : 0);
 
 	if (hstream == BASS_NO_STREAM) {
 		// Failed to create stream
@@ -231,7 +238,7 @@ bool AltsoundProcessorBase::createStream(void* syncproc_in, AltsoundStreamInfo*
 	}
 
 	// Set callback to execute when sample playback ends
-	SYNCPROC* callback = static_cast<SYNCPROC*>(syncproc_in);
+	SYNCPROC* callback = syncproc_in;
 	HSYNC hsync = 0;
 
 	if (callback) {
@@ -266,6 +273,7 @@ bool AltsoundProcessorBase::freeStream(const HSTREAM hstream_in)
 	INDENT;
 
 	const bool success = BASS_StreamFree(hstream_in) != 0;
+	sample_bank.releaseStream(hstream_in);
 	if (!success) {
 		ALT_ERROR(1, "FAILED BASS_StreamFree(%u)", hstream_in);
 	}
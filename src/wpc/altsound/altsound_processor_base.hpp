@@ -25,6 +25,7 @@
 
 // Local includes
 #include "altsound_data.hpp"
+#include "altsound_sample_bank.hpp"
 #include "../../ext/bass/bass.h"
 
 // ---------------------------------------------------------------------------
@@ -73,6 +74,9 @@ public:
 	// command skip count accessor/mutator
 	void setSkipCount(const unsigned int skip_count_in);
 	const unsigned int getSkipCount() const;
+
+	// sample bank configuration, see AltsoundSampleBank::configure()
+	void configureSampleBank(const bool enable, const size_t bank_max_bytes, const size_t cache_budget_bytes);
 	
 public: // data
 	
@@ -85,7 +89,7 @@ protected: // functions
 	virtual unsigned int getSample(const unsigned int cmd_combined_in) = 0;
 
 	// Create stream for BASS playback
-	bool createStream(void* syncproc_in, AltsoundStreamInfo* stream_out);
+	bool createStream(SYNCPROC* syncproc_in, AltsoundStreamInfo* stream_out);
 
 	// get short path of current game <gamename>/subpath/filename
 	std::string getShortPath(const std::string& path_in);
@@ -119,6 +123,10 @@ protected: // data
 	std::string game_name;
 	std::string vpm_path;
 
+	// in-memory sample storage, shared like channel_stream since streams are
+	// released through the static freeStream()
+	static AltsoundSampleBank sample_bank;
+
 private: // functions
 
 private: // data
@@ -198,4 +206,11 @@ inline void AltsoundProcessorBase::setSkipCount(const unsigned int skip_count_in
 	skip_count = skip_count_in;
 }
 
+// ----------------------------------------------------------------------------
+
+inline void AltsoundProcessorBase::configureSampleBank(const bool enable, const size_t bank_max_bytes,
+	                                                   const size_t cache_budget_bytes) {
+	sample_bank.configure(enable, bank_max_bytes, cache_budget_bytes);
+}
+
 #endif // ALTSOUND_PROCESSOR_BASE_HPP
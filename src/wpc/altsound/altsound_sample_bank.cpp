@@ -0,0 +1,463 @@
+// ---------------------------------------------------------------------------
+// altsound_sample_bank.cpp
+//
+// In-memory sample storage for AltSound: memory-mapped bank file for short
+// samples and an LRU cache for the rest
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#include "altsound_sample_bank.hpp"
+
+// Std Library includes
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+// Local includes
+#include "altsound_logger.hpp"
+#ifdef ALTSOUND_INTERNAL_MIXER
+#include "altsound_mixer.hpp"
+#endif
+
+extern AltsoundLogger alog;
+
+// ---------------------------------------------------------------------------
+// Bank file layout (native byte order, the file is a local cache):
+//
+//   header : "ALTBANK1", UINT32 count, UINT32 reserved, UINT64 index offset
+//   data   : sample images, each aligned to ALT_BANK_ALIGN
+//   index  : per sample UINT32 key length, key, UINT64 source size,
+//            INT64 source mtime, UINT64 offset, UINT64 size
+// ---------------------------------------------------------------------------
+
+#define ALT_BANK_MAGIC "ALTBANK1"
+#define ALT_BANK_HEADER_SIZE 24
+#define ALT_BANK_ALIGN 16
+
+// samples larger than this fraction of the budget bypass the LRU cache
+#define ALT_CACHE_MAX_FRACTION 4
+
+// ---------------------------------------------------------------------------
+
+static bool stat_file(const std::string& path, uint64_t& size_out, int64_t& mtime_out)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0 || (info.st_mode & S_IFREG) == 0)
+		return false;
+
+	size_out = (uint64_t)info.st_size;
+	mtime_out = (int64_t)info.st_mtime;
+	return true;
+}
+
+// ---------------------------------------------------------------------------
+
+static bool read_file(const std::string& path, std::vector<unsigned char>& data_out)
+{
+	FILE* const f = fopen(path.c_str(), "rb");
+	if (!f)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	data_out.resize(size > 0 ? (size_t)size : 0);
+	const bool success = size > 0 && fread(&data_out[0], 1, data_out.size(), f) == data_out.size();
+	fclose(f);
+	return success;
+}
+
+// ---------------------------------------------------------------------------
+// CTOR/DTOR
+// ---------------------------------------------------------------------------
+
+AltsoundSampleBank::~AltsoundSampleBank()
+{
+	unmapBank();
+}
+
+// ---------------------------------------------------------------------------
+
+void AltsoundSampleBank::configure(const bool enable, const size_t bank_max_bytes,
+	                               const size_t cache_budget_bytes)
+{
+	enabled = enable;
+	bank_max = bank_max_bytes;
+	cache_budget = cache_budget_bytes;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundSampleBank::open(const std::string& altsound_path,
+	                          const std::vector<std::string>& sample_paths)
+{
+	ALT_DEBUG(0, "BEGIN AltsoundSampleBank::open()");
+	INDENT;
+
+	close();
+	stats = Stats();
+	base_path = altsound_path;
+
+	if (!enabled) {
+		ALT_INFO(1, "Sample bank disabled");
+
+		OUTDENT;
+		ALT_DEBUG(0, "END AltsoundSampleBank::open()");
+		return false;
+	}
+
+	// several commands can share a sample file
+	std::vector<std::string> unique_paths(sample_paths);
+	std::sort(unique_paths.begin(), unique_paths.end());
+	unique_paths.erase(std::unique(unique_paths.begin(), unique_paths.end()), unique_paths.end());
+
+	std::vector<SampleFile> short_samples;
+	for (const std::string& path : unique_paths) {
+		SampleFile file;
+		if (!path.empty() && stat_file(path, file.size, file.mtime) && file.size <= bank_max) {
+			file.path = path;
+			short_samples.push_back(file);
+		}
+	}
+
+	const std::string bank_path = altsound_path + "/altsound.bank";
+	bool success = mapBank(bank_path, short_samples);
+
+	if (!success) {
+		ALT_INFO(1, "Building sample bank: %s (%d samples)", bank_path.c_str(), (int)short_samples.size());
+		success = writeBank(bank_path, short_samples) && mapBank(bank_path, short_samples);
+		if (!success) {
+			ALT_WARNING(1, "Sample bank unavailable, samples will be cached on demand");
+		}
+	}
+
+	if (success) {
+		stats.bank_bytes = bank_size;
+		ALT_INFO(1, "Sample bank ready: %d samples, %u KB", (int)bank_index.size(), (unsigned int)(bank_size / 1024));
+	}
+
+	OUTDENT;
+	ALT_DEBUG(0, "END AltsoundSampleBank::open()");
+	return success;
+}
+
+// ---------------------------------------------------------------------------
+
+void AltsoundSampleBank::close()
+{
+	const uint64_t memory_lookups = stats.bank_hits + stats.cache_hits + stats.cache_misses;
+	if (memory_lookups + stats.streamed > 0) {
+		const double hit_rate = memory_lookups ? 100.0 * (double)(stats.bank_hits + stats.cache_hits) / (double)memory_lookups : 0.0;
+		ALT_INFO(0, "Sample bank: %.1f%% hit rate (bank %llu, cache %llu, miss %llu, streamed %llu, evicted %llu)",
+			     hit_rate, (unsigned long long)stats.bank_hits, (unsigned long long)stats.cache_hits,
+			     (unsigned long long)stats.cache_misses, (unsigned long long)stats.streamed,
+			     (unsigned long long)stats.evictions);
+	}
+
+	pinned.clear();
+	lru.clear();
+	lru_index.clear();
+	stats.cache_bytes = 0;
+	unmapBank();
+}
+
+// ---------------------------------------------------------------------------
+
+HSTREAM AltsoundSampleBank::createStream(const std::string& sample_path, const bool music,
+	                                     const DWORD flags)
+{
+	if (enabled && !music) {
+		const auto it = bank_index.find(bankKey(sample_path));
+		if (bank_data && it != bank_index.end()) {
+			stats.bank_hits++;
+			return BASS_StreamCreateFile(TRUE, bank_data + it->second.offset, 0, it->second.size, flags);
+		}
+
+		const Buffer buffer = fetchCached(sample_path);
+		if (buffer) {
+			const HSTREAM hstream = BASS_StreamCreateFile(TRUE, &(*buffer)[0], 0, buffer->size(), flags);
+			if (hstream != 0)
+				pinned[hstream] = buffer;
+			return hstream;
+		}
+	}
+
+	stats.streamed++;
+	return BASS_StreamCreateFile(FALSE, sample_path.c_str(), 0, 0, flags);
+}
+
+// ---------------------------------------------------------------------------
+
+void AltsoundSampleBank::releaseStream(const HSTREAM hstream)
+{
+	pinned.erase(hstream);
+}
+
+// ---------------------------------------------------------------------------
+
+AltsoundSampleBank::Buffer AltsoundSampleBank::fetchCached(const std::string& sample_path)
+{
+	const auto it = lru_index.find(sample_path);
+	if (it != lru_index.end()) {
+		stats.cache_hits++;
+		lru.splice(lru.begin(), lru, it->second);
+		return it->second->second;
+	}
+
+	uint64_t size;
+	int64_t mtime;
+	if (!stat_file(sample_path, size, mtime) || size > cache_budget / ALT_CACHE_MAX_FRACTION)
+		return Buffer();
+
+	Buffer buffer = std::make_shared<std::vector<unsigned char>>();
+	if (!read_file(sample_path, *buffer))
+		return Buffer();
+
+	stats.cache_misses++;
+	lru.emplace_front(sample_path, buffer);
+	lru_index[sample_path] = lru.begin();
+	stats.cache_bytes += buffer->size();
+
+	// streams still playing an evicted buffer keep it alive through 'pinned'
+	while (stats.cache_bytes > cache_budget && lru.size() > 1) {
+		stats.cache_bytes -= lru.back().second->size();
+		lru_index.erase(lru.back().first);
+		lru.pop_back();
+		stats.evictions++;
+	}
+
+	return buffer;
+}
+
+// ---------------------------------------------------------------------------
+
+std::string AltsoundSampleBank::bankKey(const std::string& sample_path) const
+{
+	if (sample_path.size() > base_path.size() && sample_path.compare(0, base_path.size(), base_path) == 0
+	 && sample_path[base_path.size()] == '/')
+		return sample_path.substr(base_path.size() + 1);
+	return sample_path;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundSampleBank::mapBank(const std::string& bank_path,
+	                             const std::vector<SampleFile>& short_samples)
+{
+	unmapBank();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(bank_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	HANDLE mapping = NULL;
+	const void* view = NULL;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart >= ALT_BANK_HEADER_SIZE
+	 && (mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL)) != NULL)
+		view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (!view) {
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	bank_file = file;
+	bank_mapping = mapping;
+	bank_data = (const unsigned char*)view;
+	bank_size = (size_t)file_size.QuadPart;
+#else
+	const int fd = ::open(bank_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < ALT_BANK_HEADER_SIZE) {
+		::close(fd);
+		return false;
+	}
+
+	bank_size = (size_t)info.st_size;
+	void* const view = mmap(NULL, bank_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (view != MAP_FAILED) {
+		bank_data = (const unsigned char*)view;
+	}
+	else {
+		// fall back to reading the bank into memory
+		bank_copy.resize(bank_size);
+		if (pread(fd, &bank_copy[0], bank_size, 0) != (ssize_t)bank_size) {
+			::close(fd);
+			unmapBank();
+			return false;
+		}
+		bank_data = &bank_copy[0];
+	}
+	::close(fd);
+#endif
+
+	// parse header
+	uint32_t count;
+	uint64_t index_offset;
+	memcpy(&count, bank_data + 8, sizeof(count));
+	memcpy(&index_offset, bank_data + 16, sizeof(index_offset));
+
+	bool valid = memcmp(bank_data, ALT_BANK_MAGIC, 8) == 0 && count == short_samples.size()
+	          && index_offset <= bank_size;
+
+	// parse index
+	size_t pos = (size_t)index_offset;
+	for (uint32_t i = 0; valid && i < count; ++i) {
+		uint32_t key_len;
+		if (pos + sizeof(key_len) > bank_size) {
+			valid = false;
+			break;
+		}
+		memcpy(&key_len, bank_data + pos, sizeof(key_len));
+		pos += sizeof(key_len);
+
+		BankEntry entry;
+		if (pos + key_len + sizeof(entry) > bank_size) {
+			valid = false;
+			break;
+		}
+		const std::string key((const char*)bank_data + pos, key_len);
+		pos += key_len;
+		memcpy(&entry, bank_data + pos, sizeof(entry));
+		pos += sizeof(entry);
+
+		if (entry.offset + entry.size > index_offset)
+			valid = false;
+		else
+			bank_index[key] = entry;
+	}
+
+	// every current short sample must be present and unchanged
+	for (size_t i = 0; valid && i < short_samples.size(); ++i) {
+		const auto it = bank_index.find(bankKey(short_samples[i].path));
+		valid = it != bank_index.end() && it->second.src_size == short_samples[i].size
+		     && it->second.src_mtime == short_samples[i].mtime;
+	}
+
+	if (!valid) {
+		ALT_INFO(1, "Sample bank out of date: %s", bank_path.c_str());
+		unmapBank();
+	}
+	return valid;
+}
+
+// ---------------------------------------------------------------------------
+
+bool AltsoundSampleBank::writeBank(const std::string& bank_path,
+	                               const std::vector<SampleFile>& short_samples)
+{
+	const std::string tmp_path = bank_path + ".tmp";
+	FILE* const f = fopen(tmp_path.c_str(), "wb");
+	if (!f) {
+		ALT_WARNING(1, "Cannot create sample bank: %s", tmp_path.c_str());
+		return false;
+	}
+
+	unsigned char header[ALT_BANK_HEADER_SIZE] = { 0 };
+	memcpy(header, ALT_BANK_MAGIC, 8);
+	bool success = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+
+	std::vector<std::pair<std::string, BankEntry>> index;
+	std::vector<unsigned char> image;
+	uint64_t offset = ALT_BANK_HEADER_SIZE;
+	static const unsigned char padding[ALT_BANK_ALIGN] = { 0 };
+
+	for (size_t i = 0; success && i < short_samples.size(); ++i) {
+		const SampleFile& sample = short_samples[i];
+		if (!read_file(sample.path, image))
+			continue;
+
+#ifdef ALTSOUND_INTERNAL_MIXER
+		// pre-decode compressed samples so triggering them costs no decoding
+		if (image.size() < 4 || memcmp(&image[0], "RIFF", 4) != 0) {
+			std::vector<unsigned char> wav;
+			if (altsound_mixer_decode_to_wav(sample.path.c_str(), wav))
+				image.swap(wav);
+		}
+#endif
+
+		const size_t pad = (size_t)((ALT_BANK_ALIGN - offset % ALT_BANK_ALIGN) % ALT_BANK_ALIGN);
+		success = fwrite(padding, 1, pad, f) == pad && fwrite(&image[0], 1, image.size(), f) == image.size();
+		offset += pad;
+
+		const BankEntry entry = { sample.size, sample.mtime, offset, (uint64_t)image.size() };
+		index.emplace_back(bankKey(sample.path), entry);
+		offset += image.size();
+	}
+
+	// unreadable samples are left out, which would invalidate the bank on the
+	// next run, so give up instead of rebuilding it every time
+	success = success && index.size() == short_samples.size();
+
+	const uint32_t count = (uint32_t)index.size();
+	const uint64_t index_offset = offset;
+	for (size_t i = 0; success && i < index.size(); ++i) {
+		const uint32_t key_len = (uint32_t)index[i].first.size();
+		success = fwrite(&key_len, sizeof(key_len), 1, f) == 1
+		       && fwrite(index[i].first.data(), 1, key_len, f) == key_len
+		       && fwrite(&index[i].second, sizeof(BankEntry), 1, f) == 1;
+	}
+
+	if (success) {
+		memcpy(header + 8, &count, sizeof(count));
+		memcpy(header + 16, &index_offset, sizeof(index_offset));
+		success = fseek(f, 0, SEEK_SET) == 0 && fwrite(header, 1, sizeof(header), f) == sizeof(header);
+	}
+
+	success = (fclose(f) == 0) && success;
+
+	if (success) {
+		remove(bank_path.c_str());
+		success = rename(tmp_path.c_str(), bank_path.c_str()) == 0;
+	}
+	if (!success) {
+		ALT_WARNING(1, "Failed writing sample bank: %s", bank_path.c_str());
+		remove(tmp_path.c_str());
+	}
+	return success;
+}
+
+// ---------------------------------------------------------------------------
+
+void AltsoundSampleBank::unmapBank()
+{
+	bank_index.clear();
+
+	if (!bank_data)
+		return;
+
+	if (!bank_copy.empty()) {
+		std::vector<unsigned char>().swap(bank_copy);
+	}
+	else {
+#ifdef _WIN32
+		UnmapViewOfFile(bank_data);
+		CloseHandle((HANDLE)bank_mapping);
+		CloseHandle((HANDLE)bank_file);
+		bank_mapping = bank_file = nullptr;
+#else
+		munmap((void*)bank_data, bank_size);
+#endif
+	}
+
+	bank_data = nullptr;
+	bank_size = 0;
+}
@@ -0,0 +1,153 @@
+// ---------------------------------------------------------------------------
+// altsound_sample_bank.hpp
+//
+// Keeps AltSound samples in memory so sound commands do not open and read
+// files at trigger time.  Short samples are packed (pre-decoded where the
+// built-in mixer can do so) into a single "altsound.bank" file next to the
+// pack, which is memory-mapped on later runs.  Longer non-music samples are
+// held in an LRU cache bounded by a memory budget, and music is streamed from
+// disk.
+// ---------------------------------------------------------------------------
+// license:BSD-3-Clause
+// ---------------------------------------------------------------------------
+
+#ifndef ALTSOUND_SAMPLE_BANK_HPP
+#define ALTSOUND_SAMPLE_BANK_HPP
+#if !defined(__GNUC__) || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || (__GNUC__ >= 4)	// GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#if _MSC_VER >= 1700
+ #ifdef inline
+  #undef inline
+ #endif
+#endif
+
+// Std Library includes
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Local includes
+#include "../../ext/bass/bass.h"
+
+// ---------------------------------------------------------------------------
+// AltsoundSampleBank class definition
+// ---------------------------------------------------------------------------
+
+class AltsoundSampleBank {
+public:
+
+	// Sample lookup statistics
+	struct Stats {
+		uint64_t bank_hits = 0;     // served from the mapped bank file
+		uint64_t cache_hits = 0;    // served from the LRU cache
+		uint64_t cache_misses = 0;  // read from disk into the LRU cache
+		uint64_t streamed = 0;      // streamed from disk (music, oversized)
+		uint64_t evictions = 0;     // LRU entries dropped to honor the budget
+		size_t bank_bytes = 0;      // size of the mapped bank file
+		size_t cache_bytes = 0;     // bytes currently held by the LRU cache
+	};
+
+	// Default constructor
+	AltsoundSampleBank() = default;
+
+	// Copy constructor - NOT USED
+	AltsoundSampleBank(AltsoundSampleBank&) = delete;
+
+	// Destructor
+	~AltsoundSampleBank();
+
+	// Configure the bank.  Samples up to 'bank_max_bytes' on disk are packed
+	// into the bank file, the LRU cache holds at most 'cache_budget_bytes'
+	void configure(const bool enable, const size_t bank_max_bytes, const size_t cache_budget_bytes);
+
+	// Open the bank for the supplied samples, (re)building the bank file in
+	// 'altsound_path' when it is missing or out of date
+	bool open(const std::string& altsound_path, const std::vector<std::string>& sample_paths);
+
+	// Release the bank file and cache, logging the hit rates
+	void close();
+
+	// Create a BASS stream for the sample.  Music is always streamed from
+	// disk, other samples are played from memory when possible
+	HSTREAM createStream(const std::string& sample_path, const bool music, const DWORD flags);
+
+	// Release the memory pinned by a stream created with createStream()
+	void releaseStream(const HSTREAM hstream);
+
+	// Lookup statistics accessor
+	const Stats& getStats() const;
+
+private: // functions
+
+	struct BankEntry {
+		uint64_t src_size;
+		int64_t src_mtime;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	struct SampleFile {
+		std::string path;
+		uint64_t size;
+		int64_t mtime;
+	};
+
+	typedef std::shared_ptr<std::vector<unsigned char>> Buffer;
+
+	// map the bank file and validate its index, returns false if it must be rebuilt
+	bool mapBank(const std::string& bank_path, const std::vector<SampleFile>& short_samples);
+
+	// write a new bank file for the supplied samples
+	bool writeBank(const std::string& bank_path, const std::vector<SampleFile>& short_samples);
+
+	// unmap the bank file
+	void unmapBank();
+
+	// fetch a sample from the LRU cache, loading it from disk on a miss
+	Buffer fetchCached(const std::string& sample_path);
+
+	// key used in the bank index: path relative to the AltSound folder
+	std::string bankKey(const std::string& sample_path) const;
+
+private: // data
+
+	bool enabled = true;
+	size_t bank_max = 512 * 1024;
+	size_t cache_budget = 64 * 1024 * 1024;
+
+	std::string base_path;
+
+	// mapped bank file
+	const unsigned char* bank_data = nullptr;
+	size_t bank_size = 0;
+	std::vector<unsigned char> bank_copy; // used when mapping is unavailable
+#ifdef _WIN32
+	void* bank_file = nullptr;
+	void* bank_mapping = nullptr;
+#endif
+	std::unordered_map<std::string, BankEntry> bank_index;
+
+	// LRU cache, most recently used first
+	std::list<std::pair<std::string, Buffer>> lru;
+	std::unordered_map<std::string, std::list<std::pair<std::string, Buffer>>::iterator> lru_index;
+
+	// buffers kept alive while a stream plays from them
+	std::unordered_map<HSTREAM, Buffer> pinned;
+
+	Stats stats;
+};
+
+// ----------------------------------------------------------------------------
+// Inline functions
+// ----------------------------------------------------------------------------
+
+inline const AltsoundSampleBank::Stats& AltsoundSampleBank::getStats() const {
+	return stats;
+}
+
+#endif // ALTSOUND_SAMPLE_BANK_HPP
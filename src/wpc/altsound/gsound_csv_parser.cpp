@@ -52,138 +52,174 @@ bool GSoundCsvParser::parse(std::vector<GSoundSampleInfo>& samples_out)
 	// skip header row
 	std::getline(file, line);
 
-	std::unordered_set<std::string> allowed_types = {
+	std::vector<std::string> lines;
+	while (std::getline(file, line)) {
+		lines.push_back(std::move(line));
+	}
+
+	file.close();
+
+	// Rows are independent, so parse them on the worker pool and report the
+	// results in file order afterwards
+	std::vector<ParsedRow> rows(lines.size());
+	parallel_for(lines.size(), 256, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			parseRow(std::move(lines[i]), rows[i]);
+		}
+	});
+
+	bool success = true;
+	samples_out.reserve(samples_out.size() + rows.size());
+
+	for (const ParsedRow& row : rows) {
+		if (row.blank) {
+			continue;
+		}
+
+		if (row.failed) {
+			success = false;
+		}
+
+		if (!row.error.empty()) {
+			ALT_ERROR(1, "%s", row.error.c_str());
+			break;
+		}
+
+		const GSoundSampleInfo& entry = row.entry;
+		samples_out.push_back(entry);
+
+		std::ostringstream debug_stream;
+		debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << entry.id << std::dec
+			<< ", TYPE = " << entry.type
+			<< ", GAIN = " << std::fixed << std::setprecision(2) << entry.gain
+			<< ", DUCK_PRF = " << entry.ducking_profile
+			<< ", FNAME = " << entry.fname;
+
+		ALT_DEBUG(0, debug_stream.str().c_str());
+	}
+
+	OUTDENT;
+	ALT_DEBUG(0, "END GSoundCsvParser::parse()");
+	return success;
+}
+
+// ----------------------------------------------------------------------------
+
+void GSoundCsvParser::parseRow(std::string line, ParsedRow& row_out) const
+{
+	static const std::unordered_set<std::string> allowed_types = {
 		"music",
 		"callout",
 		"solo",
 		"sfx",
 		"overlay" 
 	};
-	
-	bool success = true;
 
-	try {
-		while (std::getline(file, line)) {
-			if (line.empty()) {
-				// ignore blank lines
-				continue;
-			}
+	if (line.empty()) {
+		// ignore blank lines
+		row_out.blank = true;
+		return;
+	}
 
-			// Some Altsounds use quotes around fields.  These need to be removed.
-			line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+	// Some Altsounds use quotes around fields.  These need to be removed.
+	line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
 
-			std::stringstream ss(line);
-			std::string field;
-			GSoundSampleInfo entry;
+	std::stringstream ss(line);
+	std::string field;
+	GSoundSampleInfo& entry = row_out.entry;
 
-			// Read ID field (unsigned hexadecimal)
-			if (std::getline(ss, field, ',')) {
-				field = trim(field);
-				entry.id = std::stoul(field, nullptr, 16);
-			}
-			else {
-				ALT_ERROR(1, "Failed to parse ID field");
-				success = false;
-				break;
-			}
+	try {
+		// Read ID field (unsigned hexadecimal)
+		if (std::getline(ss, field, ',')) {
+			field = trim(field);
+			entry.id = std::stoul(field, nullptr, 16);
+		}
+		else {
+			row_out.error = "Failed to parse ID field";
+			row_out.failed = true;
+			return;
+		}
 
-			// Read TYPE field
-			if (std::getline(ss, field, ',')) {
-				field = trim(field);
-				std::transform(field.begin(), field.end(), field.begin(), ::tolower);
-				entry.type = field;
-
-				if (allowed_types.find(field) == allowed_types.end()) {
-					ALT_ERROR(1, "%s is not a known sample type");
-					success = false;
-					break;
-				}
-
-				if (field == "music") {
-					entry.loop = true;
-				}
-			}
-			else {
-				ALT_ERROR(1, "Failed to parse TYPE field");
-				entry.type.clear();
-				success = false;
-				break;
-			}
+		// Read TYPE field
+		if (std::getline(ss, field, ',')) {
+			field = trim(field);
+			std::transform(field.begin(), field.end(), field.begin(), ::tolower);
+			entry.type = field;
 
-			// Read GAIN field (float)
-			if (std::getline(ss, field, ',')) {
-				field = trim(field);
-				float val = std::stof(field);
-				entry.gain = val < 0.0f ? 0.0f : val > 100.0f ? 1.0f : val / 100.0f;
+			if (allowed_types.find(field) == allowed_types.end()) {
+				row_out.error = field + " is not a known sample type";
+				row_out.failed = true;
+				return;
 			}
-			else {
-				ALT_ERROR(1, "Failed to parse GAIN field");
-				entry.gain = 1.0f;
-				success = false;
-				break;
+
+			if (field == "music") {
+				entry.loop = true;
 			}
+		}
+		else {
+			row_out.error = "Failed to parse TYPE field";
+			row_out.failed = true;
+			entry.type.clear();
+			return;
+		}
 
-			// Read DUCKING_PROFILE field (uint)
-			if (std::getline(ss, field, ','))
-			{
-				if (field.empty()) {
-					field = "0"; // default value
-				}
+		// Read GAIN field (float)
+		if (std::getline(ss, field, ',')) {
+			field = trim(field);
+			float val = std::stof(field);
+			entry.gain = val < 0.0f ? 0.0f : val > 100.0f ? 1.0f : val / 100.0f;
+		}
+		else {
+			row_out.error = "Failed to parse GAIN field";
+			row_out.failed = true;
+			entry.gain = 1.0f;
+			return;
+		}
 
-				field = trim(field);
-				unsigned int val = std::stoul(field);
-				entry.ducking_profile = val;
-			}
-			else {
-				ALT_ERROR(1, "Failed to parse DUCKING_PROFILE field");
-				entry.ducking_profile = 0;
-				success = false;
-				break;
+		// Read DUCKING_PROFILE field (uint)
+		if (std::getline(ss, field, ','))
+		{
+			if (field.empty()) {
+				field = "0"; // default value
 			}
 
-			// Read FNAME field
-			if (std::getline(ss, field, ','))
-			{
-				field = trim(field);
-				if (field.empty()) {
-					ALT_ERROR(1, "Sample filename is blank");
-					success = false;
-					entry.fname.clear();  // assign some default value
-					break;
-				}
-
-				std::string sample_path = altsound_path + '/' + field;
-
-				// Normalize to forward slashes
-				std::replace(sample_path.begin(), sample_path.end(), '\\', '/');
-				entry.fname = sample_path;
-			}
-			else {
-				ALT_ERROR(1, "Failed to parse FNAME");
-				success = false;
+			field = trim(field);
+			unsigned int val = std::stoul(field);
+			entry.ducking_profile = val;
+		}
+		else {
+			row_out.error = "Failed to parse DUCKING_PROFILE field";
+			row_out.failed = true;
+			entry.ducking_profile = 0;
+			return;
+		}
+
+		// Read FNAME field
+		if (std::getline(ss, field, ','))
+		{
+			field = trim(field);
+			if (field.empty()) {
+				row_out.error = "Sample filename is blank";
+				row_out.failed = true;
 				entry.fname.clear();  // assign some default value
-				break;
+				return;
 			}
 
-			samples_out.push_back(entry);
-
-			std::ostringstream debug_stream;
-			debug_stream << "ID = 0x" << std::setfill('0') << std::setw(4) << std::hex << entry.id << std::dec
-				<< ", TYPE = " << entry.type
-				<< ", GAIN = " << std::fixed << std::setprecision(2) << entry.gain
-				<< ", DUCK_PRF = " << entry.ducking_profile
-				<< ", FNAME = " << entry.fname;
+			std::string sample_path = altsound_path + '/' + field;
 
-			ALT_DEBUG(0, debug_stream.str().c_str());
+			// Normalize to forward slashes
+			std::replace(sample_path.begin(), sample_path.end(), '\\', '/');
+			entry.fname = sample_path;
+		}
+		else {
+			row_out.error = "Failed to parse FNAME";
+			row_out.failed = true;
+			entry.fname.clear();  // assign some default value
+			return;
 		}
 	}
 	catch (const std::exception& e) {
-		ALT_ERROR(0, "GSoundCsvParser::parse(): %s", e.what());
+		// like before, a malformed value ends parsing without failing it
+		row_out.error = std::string("GSoundCsvParser::parse(): ") + e.what();
 	}
-
-	file.close();
-
-	OUTDENT;
-	ALT_DEBUG(0, "END GSoundCsvParser::parse()");
-	return success;
 }
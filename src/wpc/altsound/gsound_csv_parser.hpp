@@ -51,6 +51,18 @@ protected:
 
 private: // functions
 
+	// result of parsing a single CSV row
+	struct ParsedRow {
+		GSoundSampleInfo entry;
+		std::string error;    // logged, parsing stops at this row
+		bool blank = false;   // row is ignored
+		bool failed = false;  // parse() reports failure
+	};
+
+	// parse a single CSV row.  Rows are parsed on worker threads, so this
+	// must not log
+	void parseRow(std::string line, ParsedRow& row_out) const;
+
 private: // data
 
 	std::string altsound_path;
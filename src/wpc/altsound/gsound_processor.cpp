@@ -25,6 +25,7 @@
 
 // Local includes
 #include "gsound_csv_parser.hpp"
+#include "altsound_pack_index.hpp"
 
 using std::string;
 using std::vector;
@@ -423,6 +424,20 @@ bool GSoundProcessor::loadSamples()
 	}
 	ALT_INFO(1, "SUCCESS GSoundCsvParser::parse()");
 
+	std::vector<string> sample_paths;
+	sample_paths.reserve(samples.size());
+	for (const GSoundSampleInfo& sample : samples)
+		sample_paths.push_back(sample.fname);
+
+	// check the sample files, reusing the pack index when it is current
+	AltsoundPackIndex pack_index(altsound_path, "g-sound");
+	pack_index.load();
+	pack_index.validate(sample_paths);
+	pack_index.save();
+
+	// pack short samples into memory so commands don't hit the disk
+	sample_bank.open(altsound_path, sample_paths);
+
 	OUTDENT;
 	ALT_DEBUG(0, "END GSoundProcessor::init()");
 	return true;
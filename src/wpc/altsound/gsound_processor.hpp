@@ -28,7 +28,7 @@
 
 // Local includes
 #include "altsound_processor_base.hpp"
-#include "..\ext\bass\bass.h"
+#include "../../ext/bass/bass.h"
 #include "altsound_logger.hpp"
 
 constexpr int NUM_STREAM_TYPES = 5;
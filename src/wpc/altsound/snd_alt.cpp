@@ -32,6 +32,9 @@
 #include "inipp.h"
 #include "altsound_data.hpp"
 #include "altsound_logger.hpp"
+#ifdef ALTSOUND_INTERNAL_MIXER
+#include "altsound_mixer.hpp"
+#endif
 
 // namespace scope resolution
 using std::string;
@@ -64,6 +67,9 @@ StreamArray channel_stream;
 // ---------------------------------------------------------------------------
 
 extern "C" char g_szGameName[256];
+#ifdef LIBPINMAME
+extern "C" const char* libpinmame_get_vpm_path();
+#endif
 
 // ---------------------------------------------------------------------------
 // Globals
@@ -259,6 +265,8 @@ BOOL alt_sound_init(CmdData* cmds_out)
 	processor->romControlsVol(ini_proc.usingRomVolumeControl());
 	processor->recordSoundCmds(ini_proc.recordSoundCmds());
 	processor->setSkipCount(ini_proc.getSkipCount());
+	processor->configureSampleBank(ini_proc.useSampleBank(), ini_proc.getBankMaxSampleKb() * 1024u,
+	                               (size_t)ini_proc.getCacheBudgetMb() * 1024u * 1024u);
 
 	// perform processor initialization (load samples, etc)
 	processor->init();
@@ -279,8 +287,13 @@ BOOL alt_sound_init(CmdData* cmds_out)
 		//sprintf_s(bla, "BASS music/sound library initialization error %d", BASS_ErrorGetCode());
 	}
 
+#ifdef ALTSOUND_INTERNAL_MIXER
+	// altsound is mixed by PinMAME itself, so only mute the emulated channels
+	altsound_mixer_mute_emulation();
+#else
 	// disable the global mixer to mute ROM sounds in favor of altsound
 	mixer_sound_enable_global_w(0);
+#endif
 
 	//DAR@20230520
 	// This code does not appear to be necessary. The call above which sets the
@@ -634,6 +647,27 @@ std::string get_vpinmame_path()
 	ALT_DEBUG(0, "BEGIN get_vpinmame_path");
 	INDENT;
 
+#ifdef LIBPINMAME
+	// libpinmame clients pass the VPinMAME folder in their configuration
+	const char* const cvpmd = libpinmame_get_vpm_path();
+	if (cvpmd && *cvpmd)
+	{
+		std::string vpm_path = cvpmd;
+
+		// Normalize slashes and drop the trailing one
+		std::replace(vpm_path.begin(), vpm_path.end(), '\\', '/');
+		while (vpm_path.size() > 1 && vpm_path.back() == '/')
+			vpm_path.pop_back();
+
+		OUTDENT;
+		ALT_DEBUG(0, "END get_vpinmame_path()");
+		return vpm_path;
+	}
+	else
+	{
+		ALT_ERROR(0, "VPinMAME path not set in libpinmame configuration");
+	}
+#else
 	HMODULE hModule = nullptr;
 
 #ifdef _WIN64
@@ -659,6 +693,7 @@ std::string get_vpinmame_path()
 	{
 		ALT_ERROR(0, "Module not found: VPinMAME.dll or VPinMAME64.dll");
 	}
+#endif
 
 	OUTDENT;
 	ALT_DEBUG(0, "END get_vpinmame_path()");
@@ -4,6 +4,7 @@
 #include <stdarg.h>
 #include <math.h>
 #include "driver.h"
+#include "state.h"
 #include "sim.h"
 #include "snd_cmd.h"
 #include "mech.h"
@@ -91,6 +92,8 @@ INLINE UINT8 saturatedByte(float v) { return (UINT8)(255.0f * (v < 0.0f ? 0.0f :
 
 static void drawChar(struct mame_bitmap *bitmap, int row, int col, UINT32 bits, int type, UINT8 dimming[16]);
 static UINT32 core_initDisplaySize(const struct core_dispLayout *layout);
+static void nvram_feedExit(void);
+static void nvram_feedMarkAll(void);
 static VIDEO_UPDATE(core_status);
 
 /*---------------------------
@@ -695,6 +698,12 @@ static struct {
   int       pwmUpdateRequested; // Flag set to request an update of all physic outputs
 } locals;
 
+/*-- physic output states without the integrator pointer, for save states --*/
+static struct {
+  float value;
+  UINT8 state[sizeof(((core_tPhysicOutput *)0)->state)];
+} physicOutputSave[CORE_MODOUT_MAX];
+
 void core_update_pwm_outputs(int forceUpdate);
 
 /*-------------------------------
@@ -1366,6 +1375,7 @@ static void updateDisplay(struct mame_bitmap *bitmap, const struct rectangle *cl
 
 VIDEO_UPDATE(core_gen) {
   int count = 0;
+  cycles_t start;
 
   /*-- Update all physic output at least once per frame --*/
   core_update_pwm_outputs(TRUE);
@@ -1385,8 +1395,10 @@ VIDEO_UPDATE(core_gen) {
   g_display_index = 0;
 #endif
 
+  start = osd_cycles();
   updateDisplay(bitmap, cliprect, core_gameData->lcdLayout, &count);
   memcpy(locals.lastSeg, coreGlobals.segments, sizeof(locals.lastSeg));
+  perf_counters.display_time += osd_cycles() - start;
 #ifdef PROC_SUPPORT
   }
   if (coreGlobals.p_rocEn) {
@@ -2113,6 +2125,62 @@ static void drawChar(struct mame_bitmap *bitmap, int row, int col, UINT32 bits,
 /*----------------------
 /  Initialize PinMAME
 /-----------------------*/
+/*---------------------------------------------
+/  Save state registration.
+/  The integrators are set up by the drivers on
+/  init, only the integration state is saved
+/----------------------------------------------*/
+static void core_state_presave(void) {
+  int ii;
+  for (ii = 0; ii < CORE_MODOUT_MAX; ii++) {
+    physicOutputSave[ii].value = coreGlobals.physicOutputState[ii].value;
+    memcpy(physicOutputSave[ii].state, &coreGlobals.physicOutputState[ii].state, sizeof(physicOutputSave[ii].state));
+  }
+}
+
+static void core_state_postload(void) {
+  int ii;
+  for (ii = 0; ii < CORE_MODOUT_MAX; ii++) {
+    coreGlobals.physicOutputState[ii].value = physicOutputSave[ii].value;
+    memcpy(&coreGlobals.physicOutputState[ii].state, physicOutputSave[ii].state, sizeof(physicOutputSave[ii].state));
+  }
+  nvram_feedMarkAll();
+  schedule_full_refresh();
+}
+
+static void core_register_state(void) {
+  if (state_save_module_registered("core"))
+    return; // soft reset, already registered
+  state_save_register_item("core", 0, coreGlobals.swMatrix);
+  state_save_register_item("core", 0, coreGlobals.invSw);
+  state_save_register_item("core", 0, coreGlobals.lampMatrix);
+  state_save_register_item("core", 0, coreGlobals.tmpLampMatrix);
+  state_save_register_item("core", 0, coreGlobals.segments);
+  state_save_register_item("core", 0, coreGlobals.drawSeg);
+  state_save_register_item("core", 0, coreGlobals.segDim);
+  state_save_register_item("core", 0, coreGlobals.dotCol);
+  state_save_register_item("core", 0, coreGlobals.pulsedSolState);
+  state_save_register_item("core", 0, coreGlobals.solenoids);
+  state_save_register_item("core", 0, coreGlobals.solenoids2);
+  state_save_register_item("core", 0, coreGlobals.gi);
+  state_save_register_item("core", 0, coreGlobals.lastACZeroCrossTimeStamp);
+  state_save_register_item("core", 0, coreGlobals.binaryOutputState);
+  state_save_register_item("core", 0, coreGlobals.lastPhysicOutputReportedValue);
+  state_save_register_item("core", 0, coreGlobals.diagnosticLed);
+  state_save_register_item("core", 0, physicOutputSave);
+  state_save_register_item("core", 0, locals.lastSeg);
+  state_save_register_item("core", 0, locals.lastSegDim);
+  state_save_register_item("core", 0, locals.flipTimer);
+  state_save_register_item("core", 0, locals.solLog);
+  state_save_register_item("core", 0, locals.solLogCount);
+  state_save_register_item("core", 0, locals.lastPhysicsOutput);
+  state_save_register_item("core", 0, locals.lastLampMatrix);
+  state_save_register_item("core", 0, locals.lastGI);
+  state_save_register_item("core", 0, locals.lastSol);
+  state_save_register_func_presave(core_state_presave);
+  state_save_register_func_postload(core_state_postload);
+}
+
 static MACHINE_INIT(core) {
 #ifdef PROC_SUPPORT
   char * yaml_filename = pmoptions.p_roc;
@@ -2231,6 +2299,8 @@ static MACHINE_INIT(core) {
 
     /*-- init sound commander --*/
     snd_cmd_init();
+
+    core_register_state();
   }
   /*-- now reset everything --*/
   if (coreData->reset) coreData->reset();
@@ -2271,6 +2341,8 @@ static MACHINE_STOP(core) {
   g_needs_DMD_update = 1;
 #endif
 
+  /* before the driver frees its memory, the client may still be polling */
+  nvram_feedExit();
   mech_emuExit();
   if (coreData->stop) coreData->stop();
   snd_cmd_exit();
@@ -2332,10 +2404,175 @@ static UINT32 core_initDisplaySize(const struct core_dispLayout *layout) {
   return (maxX<<16) | maxY;
 }
 
+/*---------------------------------------
+/  NVRAM change feed
+/----------------------------------------*/
+#define NVRAM_BLOCKSIZE (1 << CORE_NVRAM_BLOCKSHIFT)
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define nvram_takeBits(p)      ((UINT32)_InterlockedExchange((volatile long *)(p), 0))
+#define nvram_putBits(p, bits) _InterlockedOr((volatile long *)(p), (long)(bits))
+#else
+#define nvram_takeBits(p)      __sync_lock_test_and_set((p), 0)
+#define nvram_putBits(p, bits) __sync_fetch_and_or((p), (bits))
+#endif
+
+/* the getters run on the client thread, the feed is set up and torn down on the emulation thread */
+#if defined(_WIN32) || defined(_WIN64)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+static SRWLOCK nvramFeedLock = SRWLOCK_INIT;
+#define nvram_feedLock()   AcquireSRWLockExclusive(&nvramFeedLock)
+#define nvram_feedUnlock() ReleaseSRWLockExclusive(&nvramFeedLock)
+#else
+#include <pthread.h>
+static pthread_mutex_t nvramFeedLock = PTHREAD_MUTEX_INITIALIZER;
+#define nvram_feedLock()   pthread_mutex_lock(&nvramFeedLock)
+#define nvram_feedUnlock() pthread_mutex_unlock(&nvramFeedLock)
+#endif
+
+UINT32 *core_nvramDirty;          /* one bit per block written since the last check */
+size_t core_nvramDirtyLength;     /* 0 while there is nothing to track */
+
+static struct {
+  UINT8 *mem;                     /* NVRAM as passed to core_nvram() */
+  size_t length;
+  UINT8 *shadow;                  /* contents as last reported */
+  int    tracked;                 /* driver calls core_nvramWritten() */
+} nvramFeed;
+
+/*-- with nvramFeedLock held --*/
+static void nvram_feedFree(void) {
+  core_nvramDirtyLength = 0;
+  free(nvramFeed.shadow);
+  free(core_nvramDirty);
+  memset(&nvramFeed, 0, sizeof(nvramFeed));
+  core_nvramDirty = NULL;
+}
+
+static void nvram_feedExit(void) {
+  nvram_feedLock();
+  nvram_feedFree();
+  nvram_feedUnlock();
+}
+
+/*-- called once the NVRAM is loaded, changes are reported from here on --*/
+static void nvram_feedInit(void *mem, size_t length) {
+  const size_t words = ((length + NVRAM_BLOCKSIZE - 1) / NVRAM_BLOCKSIZE + 31) / 32;
+
+  nvram_feedLock();
+  nvram_feedFree();
+  nvramFeed.shadow = malloc(length);
+  core_nvramDirty = calloc(words ? words : 1, sizeof(UINT32));
+  if (!nvramFeed.shadow || !core_nvramDirty)
+    nvram_feedFree();
+  else {
+    memcpy(nvramFeed.shadow, mem, length);
+    nvramFeed.mem = mem;
+    nvramFeed.length = length;
+    core_nvramDirtyLength = length;
+  }
+  nvram_feedUnlock();
+}
+
+/*-- NVRAM changed behind the handlers' back (init, state load) --*/
+static void nvram_feedMarkAll(void) {
+  size_t ii;
+  for (ii = 0; ii < core_nvramDirtyLength; ii += NVRAM_BLOCKSIZE)
+    core_nvramWritten(ii);
+}
+
+void core_nvramTrackWrites(void) {
+  nvram_feedLock();
+  nvramFeed.tracked = 1;
+  nvram_feedUnlock();
+  /* the driver may just have cleared parts of the RAM directly */
+  nvram_feedMarkAll();
+}
+
+int core_getNvram(UINT8 *nvram) {
+  int length;
+
+  nvram_feedLock();
+  length = (int)nvramFeed.length;
+  if (nvramFeed.shadow && nvram)
+    memcpy(nvram, nvramFeed.mem, nvramFeed.length);
+  nvram_feedUnlock();
+  return length;
+}
+
+static int nvram_getChanged(UINT8 *nvram, core_tNvramRange *ranges, int maxRanges) {
+  const size_t blocks = (nvramFeed.length + NVRAM_BLOCKSIZE - 1) / NVRAM_BLOCKSIZE;
+  const UINT8 * const mem = nvramFeed.mem;
+  UINT8 * const shadow = nvramFeed.shadow;
+  size_t word;
+  int count = 0;
+
+  if (!shadow)
+    return -1;
+
+  for (word = 0; word * 32 < blocks; word++) {
+    UINT32 bits;
+    int bit;
+
+    if (nvramFeed.tracked) {
+      if (!core_nvramDirty[word]) continue;
+      bits = nvram_takeBits(&core_nvramDirty[word]);
+    }
+    else
+      bits = (blocks - word * 32 >= 32) ? 0xffffffff : ((1u << (blocks - word * 32)) - 1);
+
+    for (bit = 0; bit < 32 && (bits >> bit); bit++) {
+      size_t ii = (word * 32 + bit) * NVRAM_BLOCKSIZE;
+      const size_t end = (ii + NVRAM_BLOCKSIZE < nvramFeed.length) ? ii + NVRAM_BLOCKSIZE : nvramFeed.length;
+
+      if ((~bits & (1u << bit)) || memcmp(mem + ii, shadow + ii, end - ii) == 0)
+        continue;
+
+      while (ii < end) {
+        size_t jj;
+        if (mem[ii] == shadow[ii]) { ii++; continue; }
+        for (jj = ii + 1; jj < end && mem[jj] != shadow[jj]; jj++) ;
+
+        /* runs continuing into the next block are merged */
+        if (count > 0 && ranges[count-1].offset + ranges[count-1].length == (int)ii)
+          ranges[count-1].length += (int)(jj - ii);
+        else if (count < maxRanges) {
+          ranges[count].offset = (int)ii;
+          ranges[count].length = (int)(jj - ii);
+          count++;
+        }
+        else { /* out of ranges, the rest is reported next time */
+          if (nvramFeed.tracked)
+            nvram_putBits(&core_nvramDirty[word], bits & (0xffffffff << bit));
+          return count;
+        }
+        memcpy(shadow + ii, mem + ii, jj - ii);
+        memcpy(nvram + ii, shadow + ii, jj - ii);
+        ii = jj;
+      }
+    }
+  }
+  return count;
+}
+
+int core_getChangedNvram(UINT8 *nvram, core_tNvramRange *ranges, int maxRanges) {
+  int count;
+
+  nvram_feedLock();
+  count = nvram_getChanged(nvram, ranges, maxRanges);
+  nvram_feedUnlock();
+  return count;
+}
+
 void core_nvram(void *file, int write, void *mem, size_t length, UINT8 init) {
   if (write)     mame_fwrite(file, mem, length); /* save */
   else if (file) mame_fread(file,  mem, length); /* load */
   else           memset(mem, init, length);      /* first time */
+  if (!write) nvram_feedInit(mem, length);
   mech_nv(file, write); /* save mech positions */
   { /*-- Load/Save DIP settings --*/
     UINT8 dips[6];
@@ -2567,6 +2804,7 @@ void core_request_pwm_output_update()
 void core_update_pwm_outputs(int forceUpdate)
 {
    if (locals.pwmUpdateRequested || forceUpdate) {
+	   cycles_t start = osd_cycles();
 	   locals.pwmUpdateRequested = FALSE;
 	   float now = (float) timer_get_time();
 	   for (int i = 0; i < coreGlobals.nLamps; i++)
@@ -2577,6 +2815,7 @@ void core_update_pwm_outputs(int forceUpdate)
 		  coreGlobals.physicOutputState[CORE_MODOUT_SOL0 + i].integrator(now, CORE_MODOUT_SOL0 + i, FALSE);
 	   for (int i = 0; i < coreGlobals.nAlphaSegs; i++)
 		  coreGlobals.physicOutputState[CORE_MODOUT_SEG0 + i].integrator(now, CORE_MODOUT_SEG0 + i, FALSE);
+	   perf_counters.pwm_time += osd_cycles() - start;
    }
 }
 
@@ -585,6 +585,25 @@ extern void core_sound_throttle_adj(int sIn, int *sOut, int buffersize, double s
 /*-- nvram handling --*/
 extern void core_nvram(void *file, int write, void *mem, size_t length, UINT8 init);
 
+/*-- NVRAM change feed --
+ *   Changes are found by comparing 64 byte blocks of NVRAM against a shadow copy.
+ *   Drivers writing all of their NVRAM through a handler call core_nvramTrackWrites()
+ *   at machine init and core_nvramWritten() on each write, so only written blocks
+ *   are compared. --*/
+#define CORE_NVRAM_BLOCKSHIFT 6
+typedef struct { int offset, length; } core_tNvramRange;
+extern UINT32 *core_nvramDirty;
+extern size_t core_nvramDirtyLength;
+extern void core_nvramTrackWrites(void);
+INLINE void core_nvramWritten(size_t offset) {
+  if (offset < core_nvramDirtyLength)
+    core_nvramDirty[offset >> (CORE_NVRAM_BLOCKSHIFT + 5)] |= 1u << ((offset >> CORE_NVRAM_BLOCKSHIFT) & 31);
+}
+//  Copy the NVRAM into nvram (if not NULL), returns its size
+extern int core_getNvram(UINT8 *nvram);
+//  Copy bytes changed since the last call into nvram, returns number of ranges (-1 if no NVRAM)
+extern int core_getChangedNvram(UINT8 *nvram, core_tNvramRange *ranges, int maxRanges);
+
 /* makes it easier to swap bits */
 extern const UINT8 core_swapNyb[16];
 INLINE UINT8 core_revbyte(UINT8 x) { return (core_swapNyb[x & 0xf]<<4)|(core_swapNyb[x>>4]); }
@@ -3,6 +3,7 @@
 #include "cpu/m6809/m6809.h"
 #include "cpu/m68000/m68000.h"
 #include "core.h"
+#include "state.h"
 #include "sndbrd.h"
 #include "dedmd.h"
 #ifdef PROC_SUPPORT
@@ -24,6 +25,33 @@ static struct {
 static UINT16 *dmd64RAM;
 static UINT8  *dmd32RAM;
 
+/*-- save state support, the ROM bank is re-applied by the board specific postload --*/
+static void dmd_register_state(void (*postload)(void)) {
+  if (state_save_module_registered("dedmd"))
+    return;
+  state_save_register_int("dedmd", 0, "cmd", &dmdlocals.cmd);
+  state_save_register_int("dedmd", 0, "ncmd", &dmdlocals.ncmd);
+  state_save_register_int("dedmd", 0, "busy", &dmdlocals.busy);
+  state_save_register_int("dedmd", 0, "status", &dmdlocals.status);
+  state_save_register_int("dedmd", 0, "ctrl", &dmdlocals.ctrl);
+  state_save_register_int("dedmd", 0, "bank", &dmdlocals.bank);
+  state_save_register_UINT32("dedmd", 0, "hv5408", &dmdlocals.hv5408, 1);
+  state_save_register_UINT32("dedmd", 0, "hv5408s", &dmdlocals.hv5408s, 1);
+  state_save_register_UINT32("dedmd", 0, "hv5308", &dmdlocals.hv5308, 1);
+  state_save_register_UINT32("dedmd", 0, "hv5308s", &dmdlocals.hv5308s, 1);
+  state_save_register_UINT32("dedmd", 0, "hv5222", &dmdlocals.hv5222, 1);
+  state_save_register_UINT32("dedmd", 0, "lasthv5222", &dmdlocals.lasthv5222, 1);
+  state_save_register_int("dedmd", 0, "blnk", &dmdlocals.blnk);
+  state_save_register_int("dedmd", 0, "rowdata", &dmdlocals.rowdata);
+  state_save_register_int("dedmd", 0, "rowclk", &dmdlocals.rowclk);
+  state_save_register_int("dedmd", 0, "frame", &dmdlocals.frame);
+  state_save_register_int("dedmd", 0, "laststat", &dmdlocals.laststat);
+  if (dmdlocals.framedata)
+    state_save_register_UINT32("dedmd", 0, "framedata", dmdlocals.framedata, memory_region_length(DE_DMD16DMDREGION)/4);
+  if (postload)
+    state_save_register_func_postload(postload);
+}
+
 static WRITE_HANDLER(dmd_data_w)  { dmdlocals.ncmd = data; }
 static READ_HANDLER(dmd_status_r) { return dmdlocals.status; }
 static READ_HANDLER(dmd_busy_r)   { return dmdlocals.busy; }
@@ -41,7 +69,7 @@ static void dmd32_init(struct sndbrdData *brdData);
 
 const struct sndbrdIntf dedmd32Intf = {
   NULL, dmd32_init, NULL, NULL,NULL,
-  dmd_data_w, dmd_busy_r, dmd32_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND
+  dmd_data_w, dmd_busy_r, dmd32_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND | SNDBRD_STATESAVE
 };
 
 static WRITE_HANDLER(dmd32_bank_w);
@@ -92,6 +120,10 @@ MACHINE_DRIVER_START(se_dmd32)
   MDRV_INTERLEAVE(50)
 MACHINE_DRIVER_END
 
+static void dmd32_state_postload(void) {
+  cpu_setbank(DMD32_BANK0, dmdlocals.brdData.romRegion + (dmdlocals.bank & 0x1f)*0x4000);
+}
+
 static void dmd32_init(struct sndbrdData *brdData) {
   memset(&dmdlocals, 0, sizeof(dmdlocals));
   dmdlocals.brdData = *brdData;
@@ -101,6 +133,7 @@ static void dmd32_init(struct sndbrdData *brdData) {
          memory_region(DE_DMD32ROMREGION) + memory_region_length(DE_DMD32ROMREGION)-0x8000,0x8000);
   //Init 6845
   crtc6845_init(0);
+  dmd_register_state(dmd32_state_postload);
 }
 
 static WRITE_HANDLER(dmd32_ctrl_w) {
@@ -114,6 +147,7 @@ static WRITE_HANDLER(dmd32_ctrl_w) {
   else if (~data & dmdlocals.ctrl & 0x02) {
     cpu_set_reset_line(dmdlocals.brdData.cpuNo, PULSE_LINE);
     cpu_setbank(DMD32_BANK0, dmdlocals.brdData.romRegion);
+    dmdlocals.bank = 0;
   }
   dmdlocals.ctrl = data;
 }
@@ -123,6 +157,7 @@ static WRITE_HANDLER(dmd32_status_w) {
 }
 
 static WRITE_HANDLER(dmd32_bank_w) {
+  dmdlocals.bank = data;
   cpu_setbank(DMD32_BANK0, dmdlocals.brdData.romRegion + (data & 0x1f)*0x4000);
 }
 
@@ -199,7 +234,7 @@ static void dmd64_init(struct sndbrdData *brdData);
 
 const struct sndbrdIntf dedmd64Intf = {
   NULL, dmd64_init, NULL, NULL,NULL,
-  dmd_data_w, dmd_busy_r, dmd64_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND
+  dmd_data_w, dmd_busy_r, dmd64_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND | SNDBRD_STATESAVE
 };
 
 static WRITE16_HANDLER(crtc6845_msb_address_w);
@@ -234,6 +269,7 @@ MACHINE_DRIVER_END
 static void dmd64_init(struct sndbrdData *brdData) {
   memset(&dmdlocals, 0, sizeof(dmdlocals));
   dmdlocals.brdData = *brdData;
+  dmd_register_state(NULL);
 }
 
 static WRITE_HANDLER(dmd64_ctrl_w) {
@@ -320,7 +356,7 @@ static INTERRUPT_GEN(dmd16_nmi);
 
 const struct sndbrdIntf dedmd16Intf = {
   NULL, dmd16_init, NULL, NULL,NULL,
-  dmd_data_w, dmd_busy_r, dmd16_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND
+  dmd_data_w, dmd_busy_r, dmd16_ctrl_w, dmd_status_r, SNDBRD_NOTSOUND | SNDBRD_STATESAVE
 };
 
 static READ_HANDLER(dmd16_port_r);
@@ -356,6 +392,7 @@ MACHINE_DRIVER_END
 
 static void dmd16_setbusy(int bit, int value);
 static void dmd16_setbank(int bit, int value);
+static void dmd16_state_postload(void);
 
 static void dmd16_init(struct sndbrdData *brdData) {
   memset(&dmdlocals, 0, sizeof(dmdlocals));
@@ -365,6 +402,7 @@ static void dmd16_init(struct sndbrdData *brdData) {
   dmdlocals.framedata = (UINT32 *)memory_region(DE_DMD16DMDREGION);
   dmd16_setbank(0x07, 0x07);
   dmd16_setbusy(BUSY_SET|BUSY_CLR,0);
+  dmd_register_state(dmd16_state_postload);
 }
 
 /*--- Port decoding ----
@@ -501,6 +539,9 @@ static void dmd16_setbank(int bit, int value) {
   dmdlocals.bank = (dmdlocals.bank & ~bit) | (value ? bit : 0);
   cpu_setbank(DMD16_BANK0, dmdlocals.brdData.romRegion + (dmdlocals.bank & 0x07)*0x4000);
 }
+static void dmd16_state_postload(void) {
+  cpu_setbank(DMD16_BANK0, dmdlocals.brdData.romRegion + (dmdlocals.bank & 0x07)*0x4000);
+}
 static INTERRUPT_GEN(dmd16_nmi) { cpu_set_nmi_line(dmdlocals.brdData.cpuNo, PULSE_LINE); }
 
 /*-- update display --*/
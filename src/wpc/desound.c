@@ -6,6 +6,7 @@
 */
 #include "driver.h"
 #include "core.h"
+#include "state.h"
 #include "cpu/m6809/m6809.h"
 #include "cpu/at91/at91.h"
 #include "sound/2151intf.h"
@@ -40,7 +41,7 @@ static WRITE_HANDLER(de1s_4052_w);
 static WRITE_HANDLER(de1s_MSM5025_w);
 
 const struct sndbrdIntf de1sIntf = {
-  "DE", de1s_init, NULL, NULL, de1s_manCmd_w, de1s_data_w, NULL, de1s_ctrl_w, NULL
+  "DE", de1s_init, NULL, NULL, de1s_manCmd_w, de1s_data_w, NULL, de1s_ctrl_w, NULL, SNDBRD_STATESAVE
 };
 
 static struct MSM5205interface de1s_msm5205Int = {
@@ -75,10 +76,14 @@ MEMORY_END
 
 static struct {
   struct sndbrdData brdData;
-  int    msmread, nmiEn, cmd;
+  int    msmread, nmiEn, cmd, bankAddr;
   UINT8  msmdata;
 } de1slocals;
 
+static void de1s_state_postload(void) {
+  cpu_setbank(DE1S_BANK0, de1slocals.brdData.romRegion+de1slocals.bankAddr);
+}
+
 MACHINE_DRIVER_START(de1s)
   MDRV_CPU_ADD(M6809, 2000000) // XTAL(8'000'000) / 4 // MC68B09E
   MDRV_CPU_FLAGS(CPU_AUDIO_CPU)
@@ -95,6 +100,14 @@ static void de1s_init(struct sndbrdData *brdData) {
   cpu_setbank(DE1S_BANK0, de1slocals.brdData.romRegion);
   watchdog_reset_w(0,0);
   MSM5205_playmode_w(0,MSM5205_S96_4B); /* Start off MSM5205 at 4khz sampling */
+  if (!state_save_module_registered("de1s")) {
+    state_save_register_int("de1s", 0, "msmread", &de1slocals.msmread);
+    state_save_register_int("de1s", 0, "nmiEn", &de1slocals.nmiEn);
+    state_save_register_int("de1s", 0, "cmd", &de1slocals.cmd);
+    state_save_register_int("de1s", 0, "bankAddr", &de1slocals.bankAddr);
+    state_save_register_UINT8("de1s", 0, "msmdata", &de1slocals.msmdata, 1);
+    state_save_register_func_postload(de1s_state_postload);
+  }
 }
 
 static WRITE_HANDLER(de1s_data_w) {
@@ -140,6 +153,7 @@ static WRITE_HANDLER(de1s_chipsel_w) {
 	     (((data>>3)&0x01)*0x10000) +
 	     (((data>>2)&0x01)*0x20000);
 
+  de1slocals.bankAddr = addr;
   cpu_setbank(DE1S_BANK0, de1slocals.brdData.romRegion+addr);
   MSM5205_playmode_w(0, prescaler[(data & 0x30)>>4]); /* bit 4&5 */
   MSM5205_reset_w(0,   (data & 0x40)); /* bit 6 */
@@ -213,7 +227,7 @@ static WRITE_HANDLER(de2s_bsmtcmdLo_w);
 static INTERRUPT_GEN(de2s_firq);
 
 const struct sndbrdIntf de2sIntf = {
-  "BSMT", de2s_init, NULL, NULL, soundlatch_w, soundlatch_w, NULL, NULL, NULL, SNDBRD_NODATASYNC
+  "BSMT", de2s_init, NULL, NULL, soundlatch_w, soundlatch_w, NULL, NULL, NULL, SNDBRD_NODATASYNC | SNDBRD_STATESAVE
 };
 
 /* ---------------------------------------------------------------------------------------------------------------*/
@@ -294,6 +308,8 @@ static struct {
 static void de2s_init(struct sndbrdData *brdData) {
   memset(&de2slocals, 0, sizeof(de2slocals));
   de2slocals.brdData = *brdData;
+  if (!state_save_module_registered("de2s"))
+    state_save_register_int("de2s", 0, "bsmtData", &de2slocals.bsmtData);
 }
 
 #if 0
@@ -820,6 +820,12 @@ static MACHINE_INIT(gts3dmd2) {
 }
 
 static MACHINE_STOP(gts3) {
+  int ii;
+  for (ii = 0; ii < 2; ii++) {
+    struct via6522_stats stats;
+    via_get_stats(ii, &stats);
+    logerror("VIA %d: %u timer inserts, %u timeouts, %u caught up lazily\n", ii, stats.timer_inserts, stats.timer_timeouts, stats.lazy_timeouts);
+  }
   sndbrd_0_exit();
 }
 
@@ -7,6 +7,7 @@
 #include "cpu/m6800/m6800.h"
 #include "machine/6821pia.h"
 #include "core.h"
+#include "state.h"
 #include "sndbrd.h"
 #include "snd_cmd.h"
 #include "wmssnd.h"
@@ -1177,6 +1178,10 @@ static MACHINE_INIT(s11) {
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 11 - 1, 1, CORE_MODOUT_BULB_44_6_3V_AC_REV); // GI output
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 25 - 1, 7, CORE_MODOUT_BULB_89_32V_DC_S11); // 8 muxed flasher outputs (K1 relay is solenoid #10)
   }
+  if (!state_save_module_registered("s11")) {
+    state_save_register_item("s11", 0, locals);
+    state_save_machine_complete();
+  }
 }
 static MACHINE_RESET(s11) {
   pia_reset();
@@ -1100,6 +1100,12 @@ static WRITE32_HANDLER(sambank_w)
 	nvram[offset] = (nvram[offset] & mem_mask) | (data & ~mem_mask);
 }*/
 
+static WRITE32_HANDLER(sam_nvram_w)
+{
+	COMBINE_DATA(&nvram[offset]);
+	core_nvramWritten(offset << 2);
+}
+
 static MEMORY_WRITE32_START(sam_writemem)
 	{ 0x00000000, 0x000FFFFF, MWA32_RAM, &sam_page0_ram},  //Boot RAM
 	{ 0x00300000, 0x003FFFFF, MWA32_RAM, &sam_reset_ram},  //Swapped RAM
@@ -1107,7 +1113,7 @@ static MEMORY_WRITE32_START(sam_writemem)
 	{ 0x01080000, 0x0109EFFF, MWA32_RAM },				   //U13 RAM - DMD Data for output
 	{ 0x0109F000, 0x010FFFFF, samxilinx_w },			   //U13 RAM - Sound Data for output
 	{ 0x01100000, 0x01FFFFFF, samdmdram_w },			   //Various Output Signals
-	{ 0x02100000, 0x0211FFFF, MWA32_RAM, &nvram },		   //U11 NVRAM (128K) 0x02100000,0x0211ffff
+	{ 0x02100000, 0x0211FFFF, sam_nvram_w, &nvram },	   //U11 NVRAM (128K) 0x02100000,0x0211ffff
 	{ 0x02200000, 0x022fffff, sam_io2_w },				   //LE versions: more I/O stuff (mostly LED lamps)
 	{ 0x02400000, 0x02FFFFFF, sambank_w },				   //I/O Related
 	{ 0x03000000, 0x030000FF, MWA32_RAM },				   //USB Related
@@ -1197,6 +1203,7 @@ PORT_END
 
 static MACHINE_INIT(sam) {
 	at91_set_ram_pointers(sam_reset_ram, sam_page0_ram);
+	core_nvramTrackWrites();
 	at91_set_transmit_serial(sam_transmit_serial);
 	at91_set_serial_receive_ready(sam_LED_hack);
 #ifdef SAM_USE_JIT
@@ -1524,6 +1531,10 @@ void sam_init(void)
 		samlocals.fastflipaddr = 0x01070912;
 	//else if (strncasecmp(gn, "scarn200", 8) == 0)
 	//	samlocals.fastflipaddr = ;
+
+	// The AT91 core has no save state support yet, so a SAM state is never complete
+	if (!state_save_module_registered("sam"))
+		state_save_register_item("sam", 0, samlocals);
 }
 
 
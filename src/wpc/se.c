@@ -28,6 +28,7 @@ DMD Timing is still wrong.. FIRQ rate is variable, and it's not fully understood
 #include "driver.h"
 #include "cpu/m6809/m6809.h"
 #include "core.h"
+#include "state.h"
 #include "sndbrd.h"
 #include "dedmd.h"
 #include "se.h"
@@ -247,6 +248,39 @@ static SWITCH_UPDATE(se) {
 #endif
 }
 
+static void se_state_postload(void) {
+  cpu_setbank(SE_ROMBANK0, memory_region(SE_ROMREGION) + (selocals.curBank & 0x1f)* 0x4000);
+}
+
+static void se_register_state(void) {
+  if (state_save_module_registered("se"))
+    return;
+  state_save_register_item("se", 0, selocals.vblankCount);
+  state_save_register_item("se", 0, selocals.solenoids);
+  state_save_register_item("se", 0, selocals.lampRow);
+  state_save_register_item("se", 0, selocals.lampColumn);
+  state_save_register_item("se", 0, selocals.diagnosticLed);
+  state_save_register_item("se", 0, selocals.swCol);
+  state_save_register_item("se", 0, selocals.flipsol);
+  state_save_register_item("se", 0, selocals.flipsolPulse);
+  state_save_register_item("se", 0, selocals.sst0);
+  state_save_register_item("se", 0, selocals.plin);
+  state_save_register_item("se", 0, selocals.auxdata);
+  state_save_register_item("se", 0, selocals.lastgiaux);
+  state_save_register_item("se", 0, selocals.miniidx);
+  state_save_register_item("se", 0, selocals.miniframe);
+  state_save_register_item("se", 0, selocals.minidata);
+  state_save_register_item("se", 0, selocals.minidmd);
+  state_save_register_item("se", 0, selocals.curBank);
+  state_save_register_item("se", 0, selocals.lampstate);
+  /* 0x0000-0x1fff goes through handlers, so the memory system does not save it */
+  state_save_register_UINT8("se", 0, "ram", memory_region(SE_CPUREGION), 0x2000);
+  if (selocals.ram8000)
+    state_save_register_UINT8("se", 0, "ram8000", selocals.ram8000, 0x200);
+  state_save_register_func_postload(se_state_postload);
+  state_save_machine_complete();
+}
+
 static MACHINE_INIT(se3) {
 	memset(&selocals, 0, sizeof(selocals));
 	//const char * const gn = Machine->gamedrv->name;
@@ -334,6 +368,7 @@ static MACHINE_INIT(se3) {
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 26 - 1, 4, CORE_MODOUT_BULB_89_20V_DC_WPC);
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 31 - 1, 2, CORE_MODOUT_BULB_89_20V_DC_WPC);
    }
+   se_register_state();
 }
 
 static MACHINE_INIT(se) {
@@ -527,6 +562,7 @@ static MACHINE_INIT(se) {
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 22 - 1, 2, CORE_MODOUT_BULB_89_20V_DC_WPC);
      core_set_pwm_output_type(CORE_MODOUT_SOL0 + 25 - 1, 8, CORE_MODOUT_BULB_89_20V_DC_WPC);
   }
+  se_register_state();
 }
 
 static MACHINE_STOP(se) {
@@ -1,6 +1,7 @@
 #ifndef SNDBRD_RECURSIVE
 #  define SNDBRD_RECURSIVE
 #  include "driver.h"
+#  include "state.h"
 #  include "core.h"
 #  include "snd_cmd.h"
 #  include "sndbrd.h"
@@ -47,6 +48,8 @@ void sndbrd_init(int brdNo, int brdType, int cpuNo, UINT8 *romRegion,
     i->manCmdBuf = -1;
     if (b && (coreGlobals.soundEn || b->flags & SNDBRD_NOTSOUND) && b->init)
       b->init(&brdData);
+    if (b && !(b->flags & SNDBRD_STATESAVE))
+      state_save_machine_incomplete();
   }
 
   reinit_pinSound();
@@ -86,7 +89,7 @@ void sndbrd_data_w(int board, int data) {
 		snd_cmd_log(board, data);
 #endif
     if (b->flags & SNDBRD_NODATASYNC)
-      b->data_w(board, data);
+      { cpu_note_communication(); b->data_w(board, data); }
     else
     {
       sndbrd_sync_w(b->data_w, board, data);
@@ -97,14 +100,14 @@ void sndbrd_data_w(int board, int data) {
 int sndbrd_data_r(int board) {
   const struct sndbrdIntf *b = intf[board].brdIntf;
   if (b && (coreGlobals.soundEn || (b->flags & SNDBRD_NOTSOUND)) && b->data_r)
-    return b->data_r(board);
+    { cpu_note_communication(); return b->data_r(board); }
   return 0;
 }
 void sndbrd_ctrl_w(int board, int data) {
   const struct sndbrdIntf *b = intf[board].brdIntf;
   if (b && (coreGlobals.soundEn || (b->flags & SNDBRD_NOTSOUND)) && b->ctrl_w) {
     if (b->flags & SNDBRD_NOCTRLSYNC)
-      b->ctrl_w(board, data);
+      { cpu_note_communication(); b->ctrl_w(board, data); }
     else
       sndbrd_sync_w(b->ctrl_w, board, data);
   }
@@ -112,13 +115,13 @@ void sndbrd_ctrl_w(int board, int data) {
 int sndbrd_ctrl_r(int board) {
   const struct sndbrdIntf *b = intf[board].brdIntf;
   if (b && (coreGlobals.soundEn || (b->flags & SNDBRD_NOTSOUND)) && b->ctrl_r)
-    return b->ctrl_r(board);
+    { cpu_note_communication(); return b->ctrl_r(board); }
   return 0;
 }
 void sndbrd_ctrl_cb(int board, int data) {
   if (intf[board].ctrl_cb) {
     if (intf[board].brdIntf && (intf[board].brdIntf->flags & SNDBRD_NOCBSYNC))
-      intf[board].ctrl_cb(board, data);
+      { cpu_note_communication(); intf[board].ctrl_cb(board, data); }
     else
       sndbrd_sync_w(intf[board].ctrl_cb, board, data);
   }
@@ -126,7 +129,7 @@ void sndbrd_ctrl_cb(int board, int data) {
 void sndbrd_data_cb(int board, int data) {
   if (intf[board].data_cb) {
     if (intf[board].brdIntf && (intf[board].brdIntf->flags & SNDBRD_NOCBSYNC))
-      intf[board].data_cb(board, data);
+      { cpu_note_communication(); intf[board].data_cb(board, data); }
     else
       sndbrd_sync_w(intf[board].data_cb, board, data);
   }
@@ -183,6 +186,7 @@ void sndbrd_sync_w(WRITE_HANDLER((*handler)),int offset, int data) {
   int ii;
 
   if (!handler) return;
+  cpu_note_communication();
   for (ii = 0; ii < MAX_SYNCS; ii++)
     if (!syncData[ii].used) {
       syncData[ii].used = TRUE;
@@ -60,6 +60,7 @@ struct sndbrdIntf {
 #define SNDBRD_NOCBSYNC   0x0004 // Don't use cpu sync'ed callbacks
 #define SNDBRD_DOUBLECMD  0x0010 // Requires 2 bytes for each manual sound command
 #define SNDBRD_NOTSOUND   0x0100 // Board is available even if sound is disabled
+#define SNDBRD_STATESAVE  0x0200 // Board registers its whole state for save states
 #define SNDBRD_TYPE(main,sub) (((main)<<8)|(sub))
 
 #define SNDBRD_NONE    SNDBRD_TYPE( 0,0)
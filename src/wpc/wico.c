@@ -118,6 +118,7 @@ static WRITE_HANDLER(io_w) {
   switch (offset) {
     case 0: // fire NMI? marked MUXLD, enables write to 0x1fe1 on cpu #1
       cpu_set_nmi_line(COMMAND, PULSE_LINE);
+      cpu_note_communication();
       break;
     case 1: // STORE, enables NVRAM
       break;
@@ -178,6 +179,7 @@ static READ_HANDLER(shared_ram_r) {
 }
 static WRITE_HANDLER(shared_ram_w) {
   shared_ram[offset] = data;
+  cpu_note_communication();
 
   if (offset > 0x45 && offset < 0x56) {
   	coreGlobals.tmpLampMatrix[offset - 0x46] = data;
@@ -226,6 +228,7 @@ static MACHINE_INIT(WICO) {
   memset(shared_ram, 0x12, 0x800);  
   cpunum_set_reset_line(HOUSEKEEPING, ASSERT_LINE);
   cpu_set_irq_line(HOUSEKEEPING, M6809_IRQ_LINE, CLEAR_LINE);
+  cpu_communication_instrumented(); // shared RAM and the NMI are the only links
 }
 
 static MACHINE_RESET(WICO) {
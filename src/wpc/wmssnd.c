@@ -1,5 +1,6 @@
 #include <assert.h>
 #include "driver.h"
+#include "state.h"
 #include "cpu/m6800/m6800.h"
 #include "cpu/m6809/m6809.h"
 #include "cpu/adsp2100/adsp2100.h"
@@ -910,7 +911,7 @@ static WRITE_HANDLER(wpcs_data_w);
 static WRITE_HANDLER(wpcs_manCmd_w);
 static READ_HANDLER(wpcs_ctrl_r);
 static WRITE_HANDLER(wpcs_ctrl_w);
-const struct sndbrdIntf wpcsIntf = { "WPCS", wpcs_init, NULL, NULL, wpcs_manCmd_w, wpcs_data_w, wpcs_data_r, wpcs_ctrl_w, wpcs_ctrl_r, SNDBRD_DOUBLECMD };
+const struct sndbrdIntf wpcsIntf = { "WPCS", wpcs_init, NULL, NULL, wpcs_manCmd_w, wpcs_data_w, wpcs_data_r, wpcs_ctrl_w, wpcs_ctrl_r, SNDBRD_DOUBLECMD | SNDBRD_STATESAVE };
 
 /*-- other memory handlers --*/
 static WRITE_HANDLER(wpcs_rombank_w);
@@ -922,6 +923,7 @@ static struct {
   struct sndbrdData brdData;
   int replyAvail;
   int volume;
+  int romBank;   /* last value written to the bank register */
 #if HAS_YM2151_YMFM
   data8_t ym_reg_addr;
 #endif
@@ -933,6 +935,7 @@ static WRITE_HANDLER(wpcs_rombank_w) {
   /* this would be much easier if the region was filled in opposite order */
   /* but I don't want to change it now */
   int bankBase = data & 0x0f;
+  locals.romBank = data;
 #ifdef MAME_DEBUG
   /* this register can no be read but this makes debugging easier */
   *(memory_region(REGION_CPU1+locals.brdData.cpuNo) + 0x2000) = data;
@@ -951,6 +954,14 @@ static WRITE_HANDLER(wpcs_rombank_w) {
   cpu_setbank(WPCS_BANK0, locals.brdData.romRegion + (bankBase<<15));
 }
 
+static void wpcs_set_volume(void) {
+  int ch;
+  for (ch = 0; ch < MIXER_MAX_CHANNELS; ch++) {
+    if (mixer_get_name(ch) != NULL)
+      mixer_set_volume(ch, locals.volume * 100 / 127);
+  }
+}
+
 static WRITE_HANDLER(wpcs_volume_w) {
   if (data & 0x01) {
     if ((locals.volume > 0) && (data & 0x02))
@@ -958,22 +969,18 @@ static WRITE_HANDLER(wpcs_volume_w) {
     else if ((locals.volume < 0xff) && ((data & 0x02) == 0))
       locals.volume += 1;
     /* DBGLOG(("Volume set to %d\n",locals.volume)); */
-    {
-      int ch;
-      for (ch = 0; ch < MIXER_MAX_CHANNELS; ch++) {
-        if (mixer_get_name(ch) != NULL)
-          mixer_set_volume(ch, locals.volume * 100 / 127);
-      }
-    }
+    wpcs_set_volume();
   }
 }
 
 static WRITE_HANDLER(wpcs_latch_w) {
+  cpu_note_communication();
   locals.replyAvail = TRUE; soundlatch2_w(0,data);
   sndbrd_data_cb(locals.brdData.boardNo, data);
 }
 
 static READ_HANDLER(wpcs_latch_r) {
+  cpu_note_communication();
   cpu_set_irq_line(locals.brdData.cpuNo, M6809_IRQ_LINE, CLEAR_LINE);
   return soundlatch_r(0);
 }
@@ -1169,6 +1176,11 @@ static WRITE_HANDLER(wpcs_ctrl_w) { /*-- a write here resets the CPU --*/
   cpunum_set_reset_line(locals.brdData.cpuNo, PULSE_LINE);
 }
 
+static void wpcs_state_postload(void) {
+  wpcs_rombank_w(0, locals.romBank);
+  wpcs_set_volume();
+}
+
 static void wpcs_init(struct sndbrdData *brdData) {
   // Use hw.gameSpecific2 to encode game-specific custom equalization.
   int hcgain = (core_gameData->hw.gameSpecific2 & 0x1ffff);
@@ -1185,6 +1197,16 @@ static void wpcs_init(struct sndbrdData *brdData) {
 	YM2151_set_mixing_levels(0, ymvol, ymvol);
   if (dacvol != 0)
 	DAC_set_mixing_level(0, dacvol);
+
+  if (!state_save_module_registered("wpcs")) {
+    state_save_register_item("wpcs", 0, locals.replyAvail);
+    state_save_register_item("wpcs", 0, locals.volume);
+    state_save_register_item("wpcs", 0, locals.romBank);
+#if HAS_YM2151_YMFM
+    state_save_register_item("wpcs", 0, locals.ym_reg_addr);
+#endif
+    state_save_register_func_postload(wpcs_state_postload);
+  }
 }
 
 /*--------------------
@@ -1227,6 +1249,7 @@ static WRITE_HANDLER(dcs_data_w);
 static READ_HANDLER(dcs_ctrl_r);
 static WRITE_HANDLER(dcs_ctrl_w);
 static void dcs_init(struct sndbrdData *brdData);
+static void adsp_register_state(void);
 
 /*-- local data --*/
 #define DCS_BUFFER_SIZE 8192  // Must be power of 2 because of how circular buffer works
@@ -1332,7 +1355,7 @@ MACHINE_DRIVER_END
 /*----------------
 / Sound interface
 /-----------------*/
-const struct sndbrdIntf dcsIntf = { "DCS", dcs_init, NULL, NULL, dcs_data_w, dcs_data_w, dcs_data_r, dcs_ctrl_w, dcs_ctrl_r };
+const struct sndbrdIntf dcsIntf = { "DCS", dcs_init, NULL, NULL, dcs_data_w, dcs_data_w, dcs_data_r, dcs_ctrl_w, dcs_ctrl_r, SNDBRD_STATESAVE };
 
 /*---------------
 /  Bank handlers
@@ -1382,6 +1405,7 @@ static data8_t *dcs_getBootROM(int soft) {
 /* These should be static but the patched ADSP core requires them */
 
 /*static*/ READ16_HANDLER(dcs_latch_r) {
+  cpu_note_communication();
   cpu_set_irq_line(dcslocals.brdData.cpuNo, ADSP2105_IRQ2, CLEAR_LINE);
 #if 1
   return soundlatch_r(0);
@@ -1391,6 +1415,7 @@ static data8_t *dcs_getBootROM(int soft) {
 }
 
 /*static*/ WRITE16_HANDLER(dcs_latch_w) {
+  cpu_note_communication();
   soundlatch2_w(0, (data8_t)data);
   dcslocals.replyAvail = TRUE;
   sndbrd_data_cb(dcslocals.brdData.boardNo, data);
@@ -1582,6 +1607,24 @@ static READ_HANDLER(dcs_ctrl_r) {
 /*-- handle bug in ADSP core */
 static OPBASE_HANDLER(opbaseoveride) { return -1; }
 
+/*-- bank pointers as offsets for save states, RAM offset -1 is the bank region --*/
+static struct {
+  UINT32 rom;
+  INT32  ram;
+} dcs_bankOfs;
+
+static void dcs_state_presave(void) {
+  dcs_bankOfs.rom = (UINT32)(dcslocals.ROMbankPtr - dcslocals.brdData.romRegion);
+  dcs_bankOfs.ram = (dcslocals.RAMbankPtr == (UINT16 *)memory_region(DCS_BANKREGION)) ? -1 :
+                    (INT32)((UINT8 *)dcslocals.RAMbankPtr - dcslocals.cpuRegion);
+}
+
+static void dcs_state_postload(void) {
+  dcslocals.ROMbankPtr = dcslocals.brdData.romRegion + dcs_bankOfs.rom;
+  dcslocals.RAMbankPtr = (dcs_bankOfs.ram < 0) ? (UINT16 *)memory_region(DCS_BANKREGION) :
+                         (UINT16 *)(dcslocals.cpuRegion + dcs_bankOfs.ram);
+}
+
 static void dcs_init(struct sndbrdData *brdData) {
   memset(&dcslocals, 0, sizeof(dcslocals));
   dcslocals.brdData = *brdData;
@@ -1611,6 +1654,19 @@ static void dcs_init(struct sndbrdData *brdData) {
 #endif
   /*-- boot ADSP2100 --*/
   adsp_boot(0);
+
+  if (!state_save_module_registered("dcs")) {
+    state_save_register_UINT16("dcs", 0, "ROMbank1", &dcslocals.ROMbank1, 1);
+    state_save_register_UINT16("dcs", 0, "ROMbank2", &dcslocals.ROMbank2, 1);
+    state_save_register_UINT16("dcs", 0, "RAMbank", &dcslocals.RAMbank, 1);
+    state_save_register_int("dcs", 0, "replyAvail", &dcslocals.replyAvail);
+    state_save_register_UINT32("dcs", 0, "ROMbankOfs", &dcs_bankOfs.rom, 1);
+    state_save_register_INT32("dcs", 0, "RAMbankOfs", &dcs_bankOfs.ram, 1);
+    state_save_register_UINT16("dcs", 0, "bankram", (UINT16 *)memory_region(DCS_BANKREGION), memory_region_length(DCS_BANKREGION)/2);
+    state_save_register_func_presave(dcs_state_presave);
+    state_save_register_func_postload(dcs_state_postload);
+    adsp_register_state();
+  }
 }
 
 /*-----------------
@@ -1816,6 +1872,22 @@ static void adsp_txCallback(int port, INT32 data) {
   adsp.txData(0, 0, 0, 0);
 }
 
+/*-- the autobuffer timer is not saved, restart it from the saved transfer --*/
+static void adsp_state_postload(void) {
+  if ((adsp.ctrlRegs[SYSCONTROL_REG] & 0x0800) && (adsp.ctrlRegs[S1_AUTOBUF_REG] & 0x0002) &&
+      adsp_aBufData.step && adsp_aBufData.size)
+    timer_adjust(adsp.irqTimer, TIME_IN_HZ(adsp_aBufData.sRate) * adsp_aBufData.size / adsp_aBufData.step / DCS_IRQSTEPS,
+                 0, TIME_IN_HZ(adsp_aBufData.sRate) * adsp_aBufData.size / adsp_aBufData.step / DCS_IRQSTEPS);
+  else
+    timer_enable(adsp.irqTimer, FALSE);
+}
+
+static void adsp_register_state(void) {
+  state_save_register_UINT16("adsp", 0, "ctrlRegs", adsp.ctrlRegs, sizeof(adsp.ctrlRegs)/sizeof(adsp.ctrlRegs[0]));
+  state_save_register_item("adsp", 0, adsp_aBufData);
+  state_save_register_func_postload(adsp_state_postload);
+}
+
 #ifdef WPCDCSSPEEDUP
 /*
  *   Speedup for DCS games from 1994 and later.
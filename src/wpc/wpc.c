@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <time.h>
 #include "driver.h"
+#include "state.h"
 #include "cpu/m6809/m6809.h"
 #include "sndbrd.h"
 #include "snd_cmd.h"
@@ -685,6 +686,7 @@ READ_HANDLER(wpc_r) {
       checksum = 0xffff - checksum;
       *timeMem++ = checksum>>8;
       *timeMem   = checksum & 0xff;
+      core_nvramWritten(0x1800);
       return systime->tm_hour;
     }
     case WPC_RTCMIN: {
@@ -1040,8 +1042,10 @@ WRITE_HANDLER(wpc_w) {
 /---------------------------*/
 static WRITE_HANDLER(wpc_ram_w) {
   if ((wpc_data[WPC_PROTMEM] == WPC_PROTMEMCODE) ||
-      ((offset & wpclocals.memProtMask) != wpclocals.memProtMask))
+      ((offset & wpclocals.memProtMask) != wpclocals.memProtMask)) {
     wpc_ram[offset] = data;
+    core_nvramWritten(offset);
+  }
   else DBGLOG(("mem prot violation. PC=%04x a=%04x d=%02x\n",activecpu_get_pc(), offset, data));
 }
 
@@ -1123,12 +1127,40 @@ static WRITE_HANDLER(snd_data_cb) { // WPCS sound generates FIRQ on reply
   wpc_firq(TRUE, WPC_FIRQ_SOUND);
 }
 
+/*-- restore the banks from the ASIC registers after loading a state --*/
+static void wpc_state_postload(void) {
+  const int bank = wpc_data[WPC_ROMBANK] & wpclocals.pageMask;
+  cpu_setbank(1, memory_region(WPC_ROMREGION) + bank * 0x4000);
+#ifdef PINMAME
+  cpu_bankid[1] = bank + ( 0x3F ^ wpclocals.pageMask );
+#endif /* PINMAME */
+  if ((core_gameData->gen & (GEN_WPCALPHA_1 | GEN_WPCALPHA_2)) == 0) {
+    cpu_setbank(4, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3000] & 0x0f) * 0x200);
+    cpu_setbank(5, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3200] & 0x0f) * 0x200);
+    cpu_setbank(6, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3400] & 0x0f) * 0x200);
+    cpu_setbank(7, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3600] & 0x0f) * 0x200);
+    cpu_setbank(2, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3800] & 0x0f) * 0x200);
+    cpu_setbank(3, memory_region(WPC_DMDREGION) + (wpc_data[DMD_PAGE3A00] & 0x0f) * 0x200);
+  }
+}
+
+static void wpc_register_state(void) {
+  if (state_save_module_registered("wpc"))
+    return;
+  state_save_register_item("wpc", 0, wpclocals);
+  state_save_register_item("wpc", 0, dmdlocals.nextDMDFrame);
+  state_save_register_UINT8("wpc", 0, "dmdram", memory_region(WPC_DMDREGION), memory_region_length(WPC_DMDREGION));
+  state_save_register_func_postload(wpc_state_postload);
+  state_save_machine_complete();
+}
+
 static MACHINE_INIT(wpc) {
                                     /*128K  256K        512K        768K       1024K*/
   static const int romLengthMask[] = {0x07, 0x0f, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x3f};
   const size_t romLength = memory_region_length(WPC_ROMREGION);
 
   memset(&wpclocals, 0, sizeof(wpclocals));
+  core_nvramTrackWrites();
 
   // map dmd banks to standard ram for games that don't use it
   cpu_setbank(4, memory_region(WPC_CPUREGION) + 0x3000);
@@ -1159,6 +1191,9 @@ static MACHINE_INIT(wpc) {
       //Sound board initialization
       sndbrd_0_init(core_gameData->gen == GEN_WPC95DCS ? SNDBRD_DCS : SNDBRD_DCS95, 1, memory_region(DCS_ROMREGION),NULL,NULL);
   }
+  // the WPCS and DCS latches note their traffic on both sides, the S11C board's PIAs do not
+  if (core_gameData->gen != GEN_WPCALPHA_1)
+    cpu_communication_instrumented();
 
   // Initialize outputs
   coreGlobals.nLamps = 64 + core_gameData->hw.lampCol * 8;
@@ -1443,6 +1478,8 @@ static MACHINE_INIT(wpc) {
     *(memory_region(WPC_CPUREGION) + 0xffec) = 0x00;
     *(memory_region(WPC_CPUREGION) + 0xffed) = 0xff;
   }
+
+  wpc_register_state();
 }
 
 static MACHINE_STOP(wpc) {